@@ -0,0 +1,38 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <dsps/FileSource.h>
+
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Wrong parameters" << std::endl;
+        std::cerr << "Usage:" << std::endl;
+        std::cerr << "\t" << argv[0] << " integer|double|complex TEXT_FILE BINARY_FILE" << std::endl;
+
+        return 1;
+    }
+
+    // Get the format of text
+    std::string type = argv[1];
+    FileSource::FileFormat format;
+    if (type == "integer") {
+        format = FileSource::FileFormat::PlainInteger;
+    }
+    else if (type == "double") {
+        format = FileSource::FileFormat::PlainDouble;
+    }
+    else if (type == "complex") {
+        format = FileSource::FileFormat::PlainComplex;
+    }
+    else {
+        std::cerr << "Unknown type '" << type << "'" << std::endl;
+        return 1;
+    }
+
+    // The binary file is read with the matching binary format
+    std::uint64_t count = FileSource::convertToBinary(argv[2], format, argv[3]);
+    std::cout << count << " values converted" << std::endl;
+
+    return 0;
+}
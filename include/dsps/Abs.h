@@ -47,6 +47,20 @@ public:
     /// \param N The window size
     /// \return True if the task was finished else false
     virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task is an elementwise operation
+    /// This is an override of Task::isElementwise.
+    ///
+    /// \return True
+    virtual bool isElementwise() const override;
+
+    /// \brief Compute the absolute values on a block
+    /// This is an override of Task::computeElementwise.
+    ///
+    /// \param inValues The input elements
+    /// \param outValues The output elements
+    /// \param size The number of elements
+    virtual void computeElementwise(const void *inValues, void *outValues, const std::size_t size) const override;
 };
 
 #endif // ABS_H
@@ -0,0 +1,69 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#ifndef ALLOCATION_H
+#define ALLOCATION_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DSP {
+    /// \brief Aligned allocations of library and allocation counters
+    /// The buffers of library (like the scratch buffers of tasks) are counted
+    /// when they are allocated. To count also every operator new of program,
+    /// include AllocationHook.h in one source file: the counters can then
+    /// check that a graph doesn't allocate anymore after its first windows.
+    namespace Allocation {
+        /// Alignment of buffers, the size of a cache line
+        constexpr std::size_t CacheLineSize = 64;
+
+        /// \brief Allocate an aligned buffer
+        /// If the buffer can't be allocated, the program exits.
+        ///
+        /// \param size Number of bytes
+        /// \param alignment Alignment in bytes (a power of two)
+        /// \return The buffer
+        void *allocateAligned(const std::size_t size, const std::size_t alignment = CacheLineSize);
+
+        /// \brief Free a buffer of allocateAligned
+        ///
+        /// \param data The buffer (can be nullptr)
+        void deallocateAligned(void *data);
+
+        /// \brief Count one allocation
+        /// This is the hook called by the allocations of library and by the
+        /// operator new of AllocationHook.h. It is thread safe and doesn't
+        /// allocate.
+        ///
+        /// \param size Number of bytes
+        void record(const std::size_t size);
+
+        /// \brief Get the number of allocations since the last reset
+        ///
+        /// \return The number of allocations
+        std::uint64_t countAllocations();
+
+        /// \brief Get the number of bytes allocated since the last reset
+        ///
+        /// \return The number of bytes
+        std::uint64_t countAllocatedBytes();
+
+        /// \brief Reset the counters
+        void resetCounters();
+    }
+}
+
+#endif // ALLOCATION_H
@@ -0,0 +1,69 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#ifndef ALLOCATION_HOOK_H
+#define ALLOCATION_HOOK_H
+
+#include <cstdlib>
+#include <new>
+
+#include "Allocation.h"
+
+// Replacement of the global operator new of program, which counts each
+// allocation with DSP::Allocation::record. This header must be included in
+// only one source file of program (like the one of main).
+
+void *operator new(std::size_t size) {
+    DSP::Allocation::record(size);
+
+    void *data = std::malloc(size == 0 ? 1 : size);
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return data;
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    DSP::Allocation::record(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void *data) noexcept {
+    std::free(data);
+}
+
+void operator delete[](void *data) noexcept {
+    std::free(data);
+}
+
+void operator delete(void *data, const std::nothrow_t&) noexcept {
+    std::free(data);
+}
+
+void operator delete[](void *data, const std::nothrow_t&) noexcept {
+    std::free(data);
+}
+
+#endif // ALLOCATION_HOOK_H
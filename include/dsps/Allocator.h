@@ -0,0 +1,227 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "Allocation.h"
+
+namespace DSP {
+    /// \brief Memory strategy of the queues and of the scratch buffers of tasks
+    /// The buffers are aligned on a cache line at least. An allocator must
+    /// outlive the channels and the tasks which use it.
+    class Allocator {
+    public:
+        /// Virtual destructor
+        virtual ~Allocator() = default;
+
+        /// \brief Allocate a buffer
+        /// If the buffer can't be allocated, the program exits.
+        ///
+        /// \param size Number of bytes
+        /// \return The buffer aligned on Allocation::CacheLineSize
+        virtual void *allocate(const std::size_t size) = 0;
+
+        /// \brief Free a buffer of this allocator
+        ///
+        /// \param data The buffer (can be nullptr)
+        /// \param size Number of bytes given to allocate
+        virtual void deallocate(void *data, const std::size_t size) = 0;
+
+        /// \brief Get the allocator used when none is set
+        /// The buffers are allocated by Allocation::allocateAligned.
+        ///
+        /// \return The default allocator
+        static Allocator& getDefault();
+    };
+
+    /// \brief Pool of aligned buffers
+    /// The freed buffers are kept by size class and given again to the next
+    /// allocations of the same class. The small buffers are rounded to a
+    /// power of two, the buffers of a huge page or more are rounded to huge
+    /// pages, aligned on a huge page and advised to the kernel as huge pages.
+    class AlignedPool: public Allocator {
+    public:
+        /// Size of a huge page
+        static constexpr std::size_t HugePageSize = 1 << 21;
+
+        /// Constructor
+        ///
+        /// \param hugePages If true, the big buffers are advised as huge pages
+        explicit AlignedPool(bool hugePages = true);
+
+        /// Destructor, all the buffers are freed
+        virtual ~AlignedPool();
+
+        AlignedPool(const AlignedPool&) = delete;
+        AlignedPool& operator=(const AlignedPool&) = delete;
+
+        /// \brief Allocate a buffer, a cached buffer of same class is reused
+        /// This is an override of Allocator::allocate.
+        ///
+        /// \param size Number of bytes
+        /// \return The buffer
+        virtual void *allocate(const std::size_t size) override;
+
+        /// \brief Give back a buffer to the pool
+        /// This is an override of Allocator::deallocate.
+        ///
+        /// \param data The buffer (can be nullptr)
+        /// \param size Number of bytes given to allocate
+        virtual void deallocate(void *data, const std::size_t size) override;
+
+        /// \brief Free the cached buffers
+        void trim();
+
+        /// \brief Get the number of cached buffers
+        ///
+        /// \return The number of buffers ready to be reused
+        std::size_t countCachedBuffers() const;
+
+    private:
+        static std::size_t roundSize(const std::size_t size);
+
+    private:
+        const bool m_hugePages;
+
+        mutable std::mutex m_mutex;
+        std::map< std::size_t, std::vector<void*> > m_freeBuffers;
+    };
+
+    /// \brief Arena of a graph freed in one shot
+    /// The buffers are cut in big chunks, a deallocate does nothing and the
+    /// memory is given back when the arena is released or destroyed. The
+    /// channels of graph should be reserved, a queue which grows or shrinks
+    /// leaves its old buffer in the arena.
+    class ArenaAllocator: public Allocator {
+    public:
+        /// Constructor
+        ///
+        /// \param chunkSize Minimal size of chunks in bytes
+        /// \param upstream Allocator of chunks
+        explicit ArenaAllocator(const std::size_t chunkSize = AlignedPool::HugePageSize, Allocator &upstream = Allocator::getDefault());
+
+        /// Destructor, all the chunks are freed
+        virtual ~ArenaAllocator();
+
+        ArenaAllocator(const ArenaAllocator&) = delete;
+        ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+        /// \brief Cut a buffer in the current chunk
+        /// This is an override of Allocator::allocate.
+        ///
+        /// \param size Number of bytes
+        /// \return The buffer
+        virtual void *allocate(const std::size_t size) override;
+
+        /// \brief Do nothing, the buffer is freed with the arena
+        /// This is an override of Allocator::deallocate.
+        ///
+        /// \param data The buffer
+        /// \param size Number of bytes given to allocate
+        virtual void deallocate(void *data, const std::size_t size) override;
+
+        /// \brief Free all the chunks at once
+        /// The buffers of arena must not be used anymore.
+        void release();
+
+        /// \brief Get the number of bytes given by the arena
+        ///
+        /// \return The number of bytes
+        std::size_t getUsedBytes() const;
+
+        /// \brief Get the number of chunks
+        ///
+        /// \return The number of chunks
+        std::size_t countChunks() const;
+
+    private:
+        struct Chunk {
+            void *data;
+            std::size_t size;
+        };
+
+        const std::size_t m_chunkSize;
+        Allocator &m_upstream;
+
+        mutable std::mutex m_mutex;
+        std::vector<Chunk> m_chunks;
+        std::size_t m_offset;
+        std::size_t m_usedBytes;
+    };
+
+    /// \brief Allocator of buffers bound to a NUMA node
+    /// The buffers are mapped and bound to the node by libnuma (mbind), so
+    /// the pages stay on the node whatever the thread which touches them
+    /// first. Without libnuma, or if the system has no NUMA support, the
+    /// buffers are allocated by Allocation::allocateAligned.
+    class NumaAllocator: public Allocator {
+    public:
+        /// Constructor
+        ///
+        /// \param node The NUMA node
+        explicit NumaAllocator(const int node);
+
+        NumaAllocator(const NumaAllocator&) = delete;
+        NumaAllocator& operator=(const NumaAllocator&) = delete;
+
+        /// \brief Allocate a buffer on the node, rounded to pages
+        /// This is an override of Allocator::allocate.
+        ///
+        /// \param size Number of bytes
+        /// \return The buffer
+        virtual void *allocate(const std::size_t size) override;
+
+        /// \brief Free a buffer
+        /// This is an override of Allocator::deallocate.
+        ///
+        /// \param data The buffer (can be nullptr)
+        /// \param size Number of bytes given to allocate
+        virtual void deallocate(void *data, const std::size_t size) override;
+
+        /// \brief Get the NUMA node
+        ///
+        /// \return The node
+        int getNode() const;
+
+        /// \brief Indicate if the buffers are bound to the node
+        ///
+        /// \return True if libnuma is used else false
+        bool isBound() const;
+
+        /// \brief Indicate if the NUMA binding is available
+        ///
+        /// \return True if the library was built with libnuma and the system supports NUMA
+        static bool isAvailable();
+
+        /// \brief Get the NUMA node of the CPU which runs the calling thread
+        ///
+        /// \return The node (0 if the NUMA binding isn't available)
+        static int getCurrentNode();
+
+    private:
+        const int m_node;
+        const bool m_bound;
+    };
+}
+
+#endif // ALLOCATOR_H
@@ -14,21 +14,132 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>
  */
-
 #ifndef AVAR_H
 #define AVAR_H
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
+/// \brief Overlapping Allan, modified Allan and Hadamard deviations of phase
+/// The averaging times are the octaves tau = m * tau0 with m = 1, 2, 4...
+/// For the averaging factor m and the phases x (in seconds, or in radians
+/// with a phase scale of 1 / (2 pi f0)), the estimators use all the
+/// overlapping terms:
+///  - AVAR = sum (x[i+2m] - 2x[i+m] + x[i])^2 / (2 m^2 tau0^2 (n - 2m))
+///  - MVAR = sum_j (sum_{i=j}^{j+m-1} x[i+2m] - 2x[i+m] + x[i])^2 / (2 m^4 tau0^2 (n - 3m + 1))
+///  - HVAR = sum (x[i+3m] - 3x[i+2m] + 3x[i+m] - x[i])^2 / (6 m^2 tau0^2 (n - 3m))
+/// Each factor costs O(n): the inner sums of MVAR are differences of
+/// running sums. The factors are computed in parallel on a whole record,
+/// or updated sample by sample in a stream with a history of 3 maxFactor
+/// phases.
 class Avar {
 public:
-    void getResult() const;
+    /// Estimator of stability
+    enum class Deviation {
+        Allan,          ///< Overlapping Allan deviation (ADEV)
+        Modified,       ///< Modified Allan deviation (MDEV)
+        Hadamard,       ///< Overlapping Hadamard deviation (HDEV)
+    };
+
+    /// Default largest averaging factor
+    static constexpr std::uint64_t DefaultMaxFactor = 1 << 20;
+
+public:
+    /// Constructor
+    ///
+    /// \param tau0 Sampling period in seconds
+    /// \param phaseScale Factor to convert the phases in seconds
+    /// \param maxFactor Largest averaging factor, it sets the history of the streaming
+    Avar(double tau0 = 1.0, double phaseScale = 1.0, std::uint64_t maxFactor = DefaultMaxFactor);
+
+    /// \brief Compute the deviations of a whole phase record
+    /// The previous results and stream are discarded.
+    ///
+    /// \param data The phases
+    /// \param numThreads Number of threads (0 to use all hardware threads)
+    void compute(const std::vector<double> &data, unsigned numThreads = 0);
+
+    /// \brief Compute the deviations of a whole phase record
+    ///
+    /// \param data The phases
+    /// \param size The number of phases
+    /// \param numThreads Number of threads (0 to use all hardware threads)
+    void compute(const double *data, std::uint64_t size, unsigned numThreads = 0);
+
+    /// \brief Compute the deviations of a phase file
+    /// The file is mapped in memory, a binary file is used in place.
+    ///
+    /// \param dataFile Path of file
+    /// \param binary True for raw doubles, false for a text file
+    /// \param numThreads Number of threads (0 to use all hardware threads)
+    void compute(const std::string &dataFile, bool binary = true, unsigned numThreads = 0);
+
+    /// \brief Add the next phases of stream
+    /// After a compute() of a whole record, a new stream is started.
+    ///
+    /// \param data The phases
+    /// \param size The number of phases
+    void push(const double *data, std::uint64_t size);
+
+    /// \brief Discard the results and the stream
+    void reset();
 
-    void compute(const std::string &dataFile);
-    void compute(const std::vector<double> &data);
+    /// \brief Get the averaging times which have at least one Allan term
+    ///
+    /// \return The averaging times in seconds
+    std::vector<double> getTaus() const;
+
+    /// \brief Get the deviations at the averaging times of getTaus()
+    /// A deviation without any term (the largest taus of MDEV and HDEV) is NaN.
+    ///
+    /// \param deviation The estimator
+    /// \return The deviations
+    std::vector<double> getResult(Deviation deviation = Deviation::Allan) const;
+
+    /// \brief Get the number of terms of each deviation, to know its confidence
+    ///
+    /// \param deviation The estimator
+    /// \return The number of terms at the averaging times of getTaus()
+    std::vector<std::uint64_t> countTerms(Deviation deviation = Deviation::Allan) const;
+
+    /// \brief Get the number of phases
+    ///
+    /// \return The number of phases of record or stream
+    std::uint64_t countSamples() const;
 
 private:
-    std::vector<double> m_result;
+    // Sums of squared terms for one averaging factor
+    struct Accumulator {
+        std::uint64_t factor;
+        double allanSum;
+        std::uint64_t allanCount;
+        double modifiedSum;
+        std::uint64_t modifiedCount;
+        double hadamardSum;
+        std::uint64_t hadamardCount;
+
+        // Running sum of the last factor second differences (Kahan compensated)
+        double window;
+        double windowCompensation;
+    };
+
+    void initAccumulators();
+    static void computeFactor(const double *data, std::uint64_t size, Accumulator &accumulator);
+    double getPhase(std::uint64_t index) const;
+
+private:
+    double m_tau0;
+    double m_phaseScale;
+    std::uint64_t m_maxFactor;
+
+    std::vector<Accumulator> m_accumulators;
+    std::uint64_t m_count;
+    bool m_streaming;
+
+    // Last phases of stream, the size is a power of two
+    std::vector<double> m_history;
+    std::uint64_t m_historyMask;
 };
 
 #endif // AVAR_H
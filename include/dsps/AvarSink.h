@@ -0,0 +1,75 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#ifndef AVAR_SINK_H
+#define AVAR_SINK_H
+
+#include <vector>
+
+#include "Avar.h"
+#include "Task.h"
+
+/// \brief Sink which streams the phases into an Allan deviation
+/// The input is a phase like the PHI output of NoiseGenerator or the output
+/// of Unwrap. The memory is fixed by the largest averaging factor.
+template<typename T>
+class AvarSink: public Task {
+public:
+    /// Constructor
+    ///
+    /// \param tau0 Sampling period in seconds
+    /// \param phaseScale Factor to convert the phases in seconds (like 1 / (2 pi f0) for radians)
+    /// \param maxFactor Largest averaging factor
+    AvarSink(double tau0, double phaseScale = 1.0, std::uint64_t maxFactor = Avar::DefaultMaxFactor);
+
+    /// \brief Add the window to the deviations
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Get the deviations of the phases received
+    ///
+    /// \return The Allan deviation engine
+    const Avar &getAvar() const;
+
+    /// \brief Discard the phases received
+    void reset();
+
+private:
+    void pushValues(const T *values, const std::uint64_t N);
+
+private:
+    Avar m_avar;
+    bool m_finished;
+    std::vector<double> m_buffer;
+};
+
+#endif // AVAR_SINK_H
@@ -0,0 +1,190 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Channel.h"
+
+/// \brief Self-describing container of signal captures
+/// A capture file starts with a header (type of samples, sample rate, number
+/// of channels, frames by chunk) followed by chunks of interleaved frames and
+/// by the chunk index. All chunks have the same number of frames except the
+/// last one, so the chunk of any frame is found without search, and each
+/// chunk is optionally compressed with zlib. The values are stored in the
+/// native byte order, like the raw binary files of FileSource.
+namespace Capture {
+    /// Compression of chunks
+    enum class Compression {
+        None,       ///< The chunks are stored raw
+        Zlib,       ///< The chunks are compressed with zlib when it makes them smaller
+    };
+
+    /// Default number of frames by chunk
+    constexpr std::uint64_t DefaultFramesPerChunk = 1 << 16;
+
+    /// \brief Writer of a capture file
+    /// The frames are appended to the current chunk, which is written when it
+    /// is full. The index and the final header are written by close.
+    class Writer {
+    public:
+        /// Constructor
+        ///
+        /// \param filename Path of capture file
+        /// \param type Type of samples
+        /// \param channels Number of channels (samples by frame)
+        /// \param sampleRate Sample rate in Hz
+        /// \param framesPerChunk Number of frames by chunk
+        /// \param compression Compression of chunks
+        Writer(const std::string &filename, ChannelType type, std::uint32_t channels, double sampleRate, std::uint64_t framesPerChunk = DefaultFramesPerChunk, Compression compression = Compression::None);
+
+        /// Destructor, the file is closed
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        /// \brief Append interleaved frames
+        ///
+        /// \param frames The frames (channels samples by frame)
+        /// \param count The number of frames
+        void write(const void *frames, std::uint64_t count);
+
+        /// \brief Write the last chunk, the index and the header
+        /// Nothing can be written after.
+        void close();
+
+        /// \brief Get the number of frames written
+        ///
+        /// \return The number of frames
+        std::uint64_t countFrames() const;
+
+    private:
+        void writeChunk();
+        void writeHeader();
+
+    private:
+        std::string m_filename;
+        int m_fd;
+        ChannelType m_type;
+        std::uint32_t m_channels;
+        double m_sampleRate;
+        std::uint64_t m_framesPerChunk;
+        Compression m_compression;
+        std::size_t m_frameSize;
+
+        std::vector<char> m_chunk;
+        std::vector<char> m_compressed;
+        std::uint64_t m_chunkFrames;
+        std::uint64_t m_frames;
+        std::uint64_t m_offset;
+
+        // Offset, stored size and flags of each chunk
+        std::vector<std::uint64_t> m_index;
+    };
+
+    /// \brief Reader of a capture file
+    /// The frames are read at any offset: the chunks are located by the
+    /// index, and the chunks of a read are decompressed in parallel. The last
+    /// decompressed chunk is kept, so the small sequential reads decompress
+    /// each chunk once.
+    class Reader {
+    public:
+        /// Constructor
+        ///
+        /// \param filename Path of capture file
+        Reader(const std::string &filename);
+
+        /// Destructor
+        ~Reader();
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /// \brief Read interleaved frames
+        ///
+        /// \param first The index of first frame
+        /// \param count The number of frames (first + count must be lower or equal to countFrames)
+        /// \param frames The frames read (channels samples by frame)
+        /// \param numThreads Number of threads to decompress the chunks (0 to use all hardware threads)
+        void read(std::uint64_t first, std::uint64_t count, void *frames, unsigned numThreads = 1);
+
+        /// \brief Get the type of samples
+        ///
+        /// \return The channel type
+        ChannelType getChannelType() const;
+
+        /// \brief Get the number of channels
+        ///
+        /// \return The number of samples by frame
+        std::uint32_t countChannels() const;
+
+        /// \brief Get the sample rate
+        ///
+        /// \return The sample rate in Hz
+        double getSampleRate() const;
+
+        /// \brief Get the number of frames by chunk
+        ///
+        /// \return The number of frames of each chunk except the last one
+        std::uint64_t getFramesPerChunk() const;
+
+        /// \brief Get the number of frames
+        ///
+        /// \return The number of frames of file
+        std::uint64_t countFrames() const;
+
+        /// \brief Get the number of chunks
+        ///
+        /// \return The number of chunks of file
+        std::uint64_t countChunks() const;
+
+        /// \brief Get the number of chunks stored compressed
+        ///
+        /// \return The number of compressed chunks
+        std::uint64_t countCompressedChunks() const;
+
+    private:
+        void loadChunk(std::uint64_t chunk, char *output, std::vector<char> &scratch) const;
+        void copyFromCache(std::uint64_t chunk, std::uint64_t first, std::uint64_t count, char *output);
+        std::uint64_t countChunkFrames(std::uint64_t chunk) const;
+
+    private:
+        std::string m_filename;
+        int m_fd;
+        ChannelType m_type;
+        std::uint32_t m_channels;
+        double m_sampleRate;
+        std::uint64_t m_framesPerChunk;
+        std::uint64_t m_frames;
+        std::size_t m_frameSize;
+
+        // Offset, stored size and flags of each chunk
+        std::vector<std::uint64_t> m_index;
+
+        // The last decompressed chunk
+        std::vector<char> m_cache;
+        std::uint64_t m_cachedChunk;
+        std::vector<char> m_scratch;
+    };
+}
+
+#endif // CAPTURE_H
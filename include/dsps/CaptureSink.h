@@ -0,0 +1,70 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef CAPTURE_SINK_H
+#define CAPTURE_SINK_H
+
+#include <string>
+#include <vector>
+
+#include "Capture.h"
+#include "Task.h"
+
+/// \brief Write a capture file, one input by channel of capture
+template<typename T>
+class CaptureSink: public Task {
+public:
+    /// Constructor
+    ///
+    /// \param filename Path of capture file
+    /// \param channels Number of channels (and of inputs)
+    /// \param sampleRate Sample rate in Hz, stored in the header
+    /// \param framesPerChunk Number of frames by chunk
+    /// \param compression Compression of chunks
+    CaptureSink(const std::string &filename, std::uint32_t channels, double sampleRate, std::uint64_t framesPerChunk = Capture::DefaultFramesPerChunk, Capture::Compression compression = Capture::Compression::None);
+
+    /// \brief Write the window of each input as interleaved frames
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Write the last chunk and the index
+    /// The file is also closed by the destructor.
+    void close();
+
+private:
+    Capture::Writer m_writer;
+    bool m_finished;
+    std::vector<T> m_frames;
+};
+
+#endif // CAPTURE_SINK_H
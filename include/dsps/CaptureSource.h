@@ -0,0 +1,94 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef CAPTURE_SOURCE_H
+#define CAPTURE_SOURCE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Capture.h"
+#include "Task.h"
+
+/// \brief Read a capture file, one output by channel of capture
+template<typename T>
+class CaptureSource: public Task {
+public:
+    /// Constructor
+    /// The type of capture must be T.
+    ///
+    /// \param filename Path of capture file
+    /// \param loop If true, the capture is read again from the start at the end of file, else the end of stream is signaled
+    /// \param numThreads Number of threads to decompress the chunks of a window (0 to use all hardware threads)
+    CaptureSource(const std::string &filename, bool loop = true, unsigned numThreads = 1);
+
+    /// \brief Read the next window of each channel
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Move the read position to a frame
+    /// The chunk of frame is found by the index of capture.
+    ///
+    /// \param frame The index of next frame to read
+    void seek(std::uint64_t frame);
+
+    /// \brief Get the read position
+    ///
+    /// \return The index of next frame to read
+    std::uint64_t getPosition() const;
+
+    /// \brief Indicate if the end of a non-looping capture was reached
+    /// The incomplete last window isn't sent.
+    ///
+    /// \return True if no more window can be read
+    bool isEndOfStream() const;
+
+    /// \brief Get the reader of capture, to know its sample rate and size
+    ///
+    /// \return The reader
+    const Capture::Reader &getReader() const;
+
+private:
+    CaptureSource(Capture::Reader *reader, bool loop, unsigned numThreads);
+
+private:
+    std::unique_ptr<Capture::Reader> m_reader;
+    bool m_loop;
+    unsigned m_numThreads;
+    std::uint64_t m_position;
+    bool m_endOfStream;
+    std::vector<T> m_frames;
+};
+
+#endif // CAPTURE_SOURCE_H
@@ -18,11 +18,16 @@
 #ifndef CHANNEL_H
 #define CHANNEL_H
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "Queue.h"
+#include "SpscRing.h"
 
 class Task;
 
@@ -51,8 +56,18 @@ public:
     /// \param values The new data to write
     template<typename T>
     void send(const std::vector<T> &values) {
+        // Lock-free path, wait if the ring is full
+        if (m_ring) {
+            m_ring->push(values.data(), values.size() * sizeof(T));
+            return;
+        }
+
+        assertNotBorrowed();
+        std::lock_guard<std::mutex> lock(m_mutex);
+
         // Write the new data
         m_data.push(values.data(), values.size() * sizeof(T));
+        m_pending.store(m_data.size(), std::memory_order_release);
     }
 
     /// \brief Receive a data from the input task
@@ -61,19 +76,157 @@ public:
     /// \param length Number of elements
     template<typename T>
     void receive(std::vector<T> &values, const std::size_t length) {
+        // Lock-free path, wait if the ring is empty
+        if (m_ring) {
+            values.resize(length);
+            m_ring->pop(values.data(), length * sizeof(T));
+            return;
+        }
+
+        assertNotBorrowed();
+        std::lock_guard<std::mutex> lock(m_mutex);
         assert((m_data.size() >= length * sizeof(T)) && "Error the channel is empty!");
 
         // Get the values
         values.resize(length);
         m_data.pop(values.data(), length * sizeof(T));
+        m_pending.store(m_data.size(), std::memory_order_release);
+    }
+
+    /// \brief Borrow a contiguous window to write the next data without copy
+    /// The window must be published with commit. On a queue channel, the
+    /// channel stays locked until the commit: the borrowing thread must not
+    /// use the channel in between (an assertion is thrown).
+    ///
+    /// \param length Number of elements to write
+    /// \return Pointor to the window
+    template<typename T>
+    T* acquireWrite(const std::size_t length) {
+        if (m_ring) {
+            return static_cast<T*>(m_ring->acquireWrite(length * sizeof(T)));
+        }
+
+        assertNotBorrowed();
+        m_mutex.lock();
+        m_borrower.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        return reinterpret_cast<T*>(m_data.acquireWrite(length * sizeof(T), alignof(T)));
+    }
+
+    /// \brief Publish the window borrowed by acquireWrite
+    ///
+    /// \param length Number of elements written
+    template<typename T>
+    void commit(const std::size_t length) {
+        if (m_ring) {
+            m_ring->commit(length * sizeof(T));
+            return;
+        }
+
+        m_data.commit(length * sizeof(T));
+        m_pending.store(m_data.size(), std::memory_order_release);
+        m_borrower.store(std::thread::id(), std::memory_order_relaxed);
+        m_mutex.unlock();
+    }
+
+    /// \brief Borrow a contiguous window of the next data without copy
+    /// The window must be given back with release. On a queue channel, the
+    /// channel stays locked until the release: the borrowing thread must not
+    /// use the channel in between (an assertion is thrown).
+    ///
+    /// \param length Number of elements to read
+    /// \return Pointor to the window
+    template<typename T>
+    const T* peek(const std::size_t length) {
+        if (m_ring) {
+            return static_cast<const T*>(m_ring->peek(length * sizeof(T)));
+        }
+
+        assertNotBorrowed();
+        m_mutex.lock();
+        m_borrower.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        assert((m_data.size() >= length * sizeof(T)) && "Error the channel is empty!");
+        return reinterpret_cast<const T*>(m_data.peek(length * sizeof(T), alignof(T)));
+    }
+
+    /// \brief Remove the window borrowed by peek
+    ///
+    /// \param length Number of elements read
+    template<typename T>
+    void release(const std::size_t length) {
+        if (m_ring) {
+            m_ring->release(length * sizeof(T));
+            return;
+        }
+
+        m_data.release(length * sizeof(T));
+        m_pending.store(m_data.size(), std::memory_order_release);
+        m_borrower.store(std::thread::id(), std::memory_order_relaxed);
+        m_mutex.unlock();
     }
 
     /// \brief Get the number of pending data in the channel
+    /// It doesn't wait for a borrowed window of a queue channel, the data of
+    /// this window aren't counted until its commit or release.
+    ///
     /// \param dataSize Size of data needed
     ///
     /// \return The number of pending data
     std::size_t size(const std::size_t dataSize) const;
 
+    /// \brief Pre-allocate the storage of channel
+    /// A ring channel is replaced by a bigger ring if needed.
+    ///
+    /// \param length Number of elements which can be stored without growing
+    /// \param dataSize Size of one element
+    void reserve(const std::size_t length, const std::size_t dataSize);
+
+    /// \brief Get the number of elements which can be stored without growing
+    ///
+    /// \param dataSize Size of one element
+    /// \return The capacity of channel
+    std::size_t capacity(const std::size_t dataSize) const;
+
+    /// \brief Enable or disable the shrink of queue when it is sparse
+    ///
+    /// \param enabled True to enable the shrink
+    void setShrinkEnabled(bool enabled);
+
+    /// \brief Allocate the queue of channel with an allocator
+    /// The pending data are kept. A ring channel keeps its own mapping.
+    ///
+    /// \param allocator The allocator of queue
+    void setAllocator(DSP::Allocator &allocator);
+
+    /// \brief Get the number of reallocations to grow the queue or the ring
+    ///
+    /// \return The number of grows
+    std::uint64_t countGrow() const;
+
+    /// \brief Get the number of reallocations to shrink the queue
+    ///
+    /// \return The number of shrinks
+    std::uint64_t countShrink() const;
+
+    /// \brief Store the data in a bounded lock-free ring instead of the queue
+    /// The channel must have one producer task and one consumer task. The
+    /// pending data are kept. This method isn't thread-safe, no task must use
+    /// the channel during the call.
+    ///
+    /// \param capacity Minimal capacity in bytes of ring
+    /// \param mode Wait mode when the ring is full or empty
+    void setRingBuffer(const std::size_t capacity, SpscRing::WaitMode mode = SpscRing::WaitMode::Block);
+
+    /// \brief Store the data in the queue again after setRingBuffer
+    /// The pending data are kept, and the ring is kept aside to be reused by
+    /// the next setRingBuffer. This method isn't thread-safe, no task must use
+    /// the channel during the call.
+    void setQueueBuffer();
+
+    /// \brief Get the capacity of ring
+    ///
+    /// \return The capacity in bytes of ring or 0 if the channel uses the queue
+    std::size_t getRingCapacity() const;
+
     /// \brief Get the input task
     /// If no input task was set an assertion was throw.
     ///
@@ -97,11 +250,29 @@ public:
     /// \param task The new output task
     void setOut(Task *task);
 
+private:
+    /// Check that the calling thread doesn't borrow the queue, it would lock itself
+    void assertNotBorrowed() const {
+        assert(m_borrower.load(std::memory_order_relaxed) != std::this_thread::get_id() && "Error the channel is borrowed by this thread!");
+    }
+
 private:
     Task *m_inputTask;
     Task *m_outputTask;
 
+    mutable std::mutex m_mutex;
+    std::atomic<std::thread::id> m_borrower;
     Queue m_data;
+    std::atomic<std::size_t> m_pending;
+    std::unique_ptr<SpscRing> m_ring;
+    std::unique_ptr<SpscRing> m_idleRing;
+    std::uint64_t m_ringGrow;
 };
 
+/// \brief Get the size in bytes of one element of a channel type
+///
+/// \param type The channel type
+/// \return The size of one element (0 for ChannelType::None)
+std::size_t sizeOfChannelType(ChannelType type);
+
 #endif // CHANNEL_H
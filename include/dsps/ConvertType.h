@@ -54,6 +54,24 @@ public:
     /// \return True if the task was finished else false
     virtual bool hasFinished(const std::uint64_t N) const override;
 
+    /// \brief Indicate if the task is an elementwise operation
+    /// This is an override of Task::isElementwise.
+    ///
+    /// \return True
+    virtual bool isElementwise() const override;
+
+    /// \brief Convert the values on a block
+    /// This is an override of Task::computeElementwise.
+    ///
+    /// \param inValues The input elements
+    /// \param outValues The output elements
+    /// \param size The number of elements
+    virtual void computeElementwise(const void *inValues, void *outValues, const std::size_t size) const override;
+
+private:
+    /// \brief Convert a window, specialized with the SIMD kernels
+    void convert(const InputType *inValues, OutputType *outValues, const std::uint64_t N) const;
+
 private:
     const InputType m_MAX_VALUE;
     const std::uint64_t m_POWER_NOB;
@@ -49,6 +49,14 @@ public:
     /// \return True if the task was finished else false
     virtual bool hasFinished(const std::uint64_t N) const override;
 
+    /// \brief Get the number of elements consumed by one compute
+    /// This is an override of Task::getInputRate.
+    ///
+    /// \param index Index of input channel
+    /// \param N The window size
+    /// \return The number of elements consumed
+    virtual std::uint64_t getInputRate(const std::size_t index, const std::uint64_t N) const override;
+
 private:
     std::uint64_t m_decimationFactor;
 };
@@ -0,0 +1,122 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef EXECUTION_CONTEXT_H
+#define EXECUTION_CONTEXT_H
+
+#include <cstddef>
+#include <vector>
+
+namespace DSP {
+    /// \brief Resources given to the execution of a graph
+    /// A context holds the set of cores of the scheduler threads and the
+    /// number of threads of the FFTW plans. It is active on a thread inside
+    /// an ExecutionContext::Scope: the thread is pinned on the cores, and the
+    /// plans created by the thread (by WrapperFFTW) use the FFTW thread count
+    /// of context. DSP::processing with a context and the workers of
+    /// ParallelProcessor open this scope. The threads of FFTW inherit the
+    /// affinity of the thread which starts them.
+    class ExecutionContext {
+    public:
+        /// Pinning of the threads of context
+        enum class Pinning {
+            CoreSet,            ///< Each thread can run on all the cores of set
+            OneCorePerThread,   ///< The thread of index i runs only on the core i modulo the size of set
+        };
+
+        /// Constructor
+        /// If a core is negative or too big, the program exits.
+        ///
+        /// \param cores The cores of scheduler threads (empty to keep the affinity of threads)
+        /// \param fftwThreads Number of threads of FFTW plans (0 for the number of cores, or of hardware threads if the set is empty)
+        /// \param pinning Pinning of the threads on the cores
+        explicit ExecutionContext(const std::vector<int> &cores = std::vector<int>(), const int fftwThreads = 0, Pinning pinning = Pinning::CoreSet);
+
+        /// \brief Get the cores of scheduler threads
+        ///
+        /// \return The cores (empty if the threads aren't pinned)
+        const std::vector<int>& getCores() const;
+
+        /// \brief Get the number of threads of FFTW plans
+        ///
+        /// \return The number of threads
+        int getFFTWThreads() const;
+
+        /// \brief Get the pinning of threads
+        ///
+        /// \return The pinning
+        Pinning getPinning() const;
+
+        /// \brief Get the number of scheduler threads which fit the context
+        ///
+        /// \return The number of cores, or of hardware threads if the set is empty
+        std::size_t countThreads() const;
+
+        /// \brief Pin the calling thread on the cores of context
+        /// This is done by pthread_setaffinity_np.
+        ///
+        /// \param threadIndex Index of thread in the scheduler (used by Pinning::OneCorePerThread)
+        /// \return True if the thread was pinned, false if the set is empty or the pinning failed
+        bool pinCurrentThread(const std::size_t threadIndex = 0) const;
+
+        /// \brief Get the context used outside of any scope
+        /// The threads aren't pinned and the FFTW plans use all the hardware threads.
+        ///
+        /// \return The default context
+        static const ExecutionContext& getDefault();
+
+        /// \brief Get the context active on the calling thread
+        ///
+        /// \return The context of innermost scope, or the default context
+        static const ExecutionContext& getCurrent();
+
+        /// \brief Activate a context on the calling thread until the end of scope
+        /// The thread is pinned on the cores of context. At the end of scope
+        /// the previous context and the previous affinity are restored.
+        class Scope {
+        public:
+            /// Constructor
+            ///
+            /// \param context The context, it must outlive the scope
+            /// \param threadIndex Index of thread in the scheduler
+            explicit Scope(const ExecutionContext &context, const std::size_t threadIndex = 0);
+
+            /// Destructor
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            /// \brief Indicate if the thread was pinned by the scope
+            ///
+            /// \return True if the thread was pinned
+            bool isPinned() const;
+
+        private:
+            const ExecutionContext *m_previous;
+            std::vector<int> m_previousCores;
+            bool m_pinned;
+        };
+
+    private:
+        std::vector<int> m_cores;
+        int m_fftwThreads;
+        Pinning m_pinning;
+    };
+}
+
+#endif // EXECUTION_CONTEXT_H
@@ -52,7 +52,7 @@ private:
     void computeFFT(const std::uint64_t N);
 
 private:
-    WrapperFFTW m_wrapperFFTW;
+    BasicWrapperFFTW<InputType> m_wrapperFFTW;
 };
 
 #endif // FFT_H
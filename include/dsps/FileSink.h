@@ -19,24 +19,33 @@
 #define _FILE_SINK_H
 
 #include "Channel.h"
+#include "FileWriter.h"
 #include "Task.h"
 #include "Utils.h"
 
-#include <iostream>
-#include <fstream>
+#include <memory>
 
 template <typename T>
 class FileSink: public Task {
 public:
     /// Constructor
+    /// The file is created by the first compute.
     ///
     /// \param filename Path od data file
     /// \param override Indicate if we keep only one windows points or if we accumulate the data
-    FileSink(const std::string filename, bool override = false)
+    /// \param bufferSize Size of each write buffer in bytes (0 to write each window synchronously)
+    /// \param numberBuffers Number of write buffers, they are written by a background thread
+    /// \param directIO If true, the full buffers are written with O_DIRECT when the file system allows it
+    /// \param syncData If true, each write is followed by fdatasync
+    FileSink(const std::string filename, bool override = false, std::size_t bufferSize = 0, std::size_t numberBuffers = 4, bool directIO = false, bool syncData = false)
         : Task(getChannelType<T>(), 1, ChannelType::None, 0)
         , m_filename(filename)
         , m_finished(false)
-        , m_mustOverride(override) {
+        , m_mustOverride(override)
+        , m_bufferSize(bufferSize)
+        , m_numberBuffers(numberBuffers)
+        , m_directIO(directIO)
+        , m_syncData(syncData) {
     }
 
     /// \brief Write the data into binary file
@@ -48,14 +57,19 @@ public:
         assert(m_inputChannels[0] != nullptr && "FileSink: No input task is connected");
 
         // Open the file
-        safeOpen();
-
-        // Get the new burst
-        std::vector<T> inValues(N);
-        m_inputChannels[0]->receive(inValues, N);
+        if (!m_writer) {
+            m_writer.reset(new FileWriter(m_filename, m_bufferSize, m_numberBuffers, m_directIO, m_syncData));
+        }
 
-        // Write file
-        m_outFile.write(reinterpret_cast<char*>(inValues.data()), N * sizeof(T));
+        // Write the new burst, the file keeps only the last one in override mode
+        const T *inValues = m_inputChannels[0]->peek<T>(N);
+        if (m_mustOverride) {
+            m_writer->overwrite(inValues, N * sizeof(T));
+        }
+        else {
+            m_writer->append(inValues, N * sizeof(T));
+        }
+        m_inputChannels[0]->release<T>(N);
 
         m_finished = true;
     }
@@ -82,30 +96,29 @@ public:
         return m_finished;
     }
 
-private:
-    void safeOpen() {
-        // If the file was already open and we don't override the data
-        if (!m_mustOverride && m_outFile.is_open()) {
-            return;
-        }
-
-        // If we override the data, we close the file
-        if (m_mustOverride && m_outFile.is_open()) {
-            m_outFile.close();
+    /// \brief Wait until the buffered data are in the file
+    void flush() {
+        if (m_writer) {
+            m_writer->flush();
         }
+    }
 
-        m_outFile.open(m_filename, std::ios_base::out|std::ios_base::binary);
-        if (!m_outFile.good()) {
-            std::cerr << "FileSink::safeOpen(): The file '" << m_filename << "' wasn't open: " << std::strerror(errno) << std::endl;
-            std::exit(-1);
-        }
+    /// \brief Get the writer of file, to know its throughput and queue depth
+    ///
+    /// \return The writer or nullptr before the first compute
+    const FileWriter *getWriter() const {
+        return m_writer.get();
     }
 
 private:
-    std::ofstream m_outFile;
+    std::unique_ptr<FileWriter> m_writer;
     std::string m_filename;
     bool m_finished;
     bool m_mustOverride;
+    std::size_t m_bufferSize;
+    std::size_t m_numberBuffers;
+    bool m_directIO;
+    bool m_syncData;
 };
 
 #endif // _FILE_SINK_H
@@ -18,7 +18,13 @@
 #ifndef FILE_SOURCE_H
 #define FILE_SOURCE_H
 
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "ReadAhead.h"
 #include "Task.h"
+#include "TextParser.h"
 
 class FileSource: public Task {
 public:
@@ -31,9 +37,27 @@ public:
         BinaryComplex,
     };
 
+    /// Way to read the file
+    enum class Access {
+        Stream,     ///< Read with a std::ifstream
+        Mapped,     ///< Copy the windows from a memory mapping (binary formats only)
+    };
+
 public:
     /// Constructor
-    FileSource(const std::string &filename, FileFormat format);
+    ///
+    /// \param filename Path of file
+    /// \param format Format of values in the file
+    /// \param access Way to read the file
+    /// \param loop If true, the file is read again from the start at the end of file, else the end of stream is signaled
+    /// \param hugePages If true, the mapping is backed by transparent huge pages when the kernel allows it (mapped access only)
+    FileSource(const std::string &filename, FileFormat format, Access access = Access::Stream, bool loop = true, bool hugePages = false);
+
+    FileSource(const FileSource&) = delete;
+    FileSource& operator=(const FileSource&) = delete;
+
+    /// Destructor
+    virtual ~FileSource();
 
     /// \brief Read the signal form a file
     /// This is an override of Task::compute.
@@ -55,32 +79,88 @@ public:
     /// \return True if the task was finished else false
     virtual bool hasFinished(const std::uint64_t N) const override;
 
+    /// \brief Indicate if the end of a non-looping file was reached
+    /// The incomplete last window isn't sent, and the task is no longer
+    /// ready once the end of stream is signaled.
+    ///
+    /// \return True if no more window can be read
+    bool isEndOfStream() const;
+
+    /// \brief Read the file ahead in a background thread (stream access only)
+    /// This must be called before the first compute.
+    ///
+    /// \param depth Number of blocks read in advance
+    /// \param blockSize Size of blocks in bytes
+    void enableReadAhead(std::size_t depth = ReadAhead::DefaultDepth, std::size_t blockSize = ReadAhead::DefaultBlockSize);
+
+    /// \brief Get the reader of file ahead, to know its stall time
+    ///
+    /// \return The reader or nullptr without read-ahead
+    const ReadAhead *getReadAhead() const;
+
+    /// \brief Convert a text file to the binary format
+    /// The binary file is read by the matching binary format, so the next
+    /// runs skip the parse of text.
+    ///
+    /// \param textFilename Path of text file
+    /// \param format Plain format of text file
+    /// \param binaryFilename Path of binary file
+    /// \return The number of values converted
+    static std::uint64_t convertToBinary(const std::string &textFilename, FileFormat format, const std::string &binaryFilename);
+
 private:
+    // The values are read in a scratch buffer of task, the channel isn't locked during the read
     template <typename T>
-    void readPlainValues(std::vector<T> &values, std::uint64_t N);
+    std::size_t readPlainValues(T *values, std::uint64_t N);
 
     template <typename T>
-    void readBinaryValues(std::vector<T> &values, std::uint64_t N) {
-        values.clear();
-
-        T value;
-        while (values.size() < N) {
-            m_file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    std::size_t readBinaryValues(T *values, std::uint64_t N) {
+        std::size_t count = 0;
+        while (count < N) {
+            m_input.read(reinterpret_cast<char*>(values + count), (N - count) * sizeof(T));
+            count += m_input.gcount() / sizeof(T);
 
             // If it's the end of file
-            if (m_file.eof()) {
-                m_file.clear();
-                m_file.seekg(0);
-                continue;
-            }
+            if (m_input.eof()) {
+                if (!m_loop) {
+                    m_endOfStream = true;
+                    return count;
+                }
 
-            values.push_back(value);
+                m_input.clear();
+                m_input.seekg(0);
+            }
         }
+
+        return count;
     }
 
+    template <typename T>
+    void sendValues(const T *values, std::size_t count, std::uint64_t N);
+
+    template <typename T>
+    void sendMappedValues(std::uint64_t N);
+
+    void openMapping(const std::string &filename, bool hugePages);
+
 private:
+    std::string m_filename;
     FileFormat m_format;
+    Access m_access;
+    bool m_loop;
+    bool m_endOfStream;
+
+    // Stream access: the values are read from the file or from the read-ahead buffer
     std::ifstream m_file;
+    std::unique_ptr<ReadAhead> m_readAhead;
+    std::istream m_input;
+    TextParser m_parser;
+
+    // Mapped access: the whole file is mapped read-only
+    int m_fd;
+    const char *m_mapping;
+    std::size_t m_mappingSize;
+    std::size_t m_mappingOffset;
 };
 
 #endif // FILE_SOURCE_H
@@ -0,0 +1,138 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef FILE_WRITER_H
+#define FILE_WRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// \brief Writer of binary file with large aligned buffers
+/// The data are appended to a buffer, and the full buffers are written by a
+/// background thread while the next ones are filled. When all buffers are
+/// waiting for the disk, the producer waits. Without buffer, the data are
+/// written at once by the caller. The file is written with pwrite at
+/// explicit offsets through a single descriptor.
+class FileWriter {
+public:
+    /// Alignment of buffers, file offsets and sizes for the direct I/O
+    static constexpr std::size_t Alignment = 4096;
+
+public:
+    /// Constructor
+    ///
+    /// \param filename Path of file (it is truncated)
+    /// \param bufferSize Size of each buffer in bytes, rounded up to the alignment (0 to write synchronously)
+    /// \param numberBuffers Number of buffers (at least 2)
+    /// \param directIO If true, the full buffers bypass the page cache with O_DIRECT when the file system allows it
+    /// \param syncData If true, each write is followed by fdatasync
+    FileWriter(const std::string &filename, std::size_t bufferSize = 0, std::size_t numberBuffers = 4, bool directIO = false, bool syncData = false);
+
+    /// Destructor, the pending data are written
+    ~FileWriter();
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    /// \brief Append data at the end of file
+    ///
+    /// \param data The data
+    /// \param size The number of bytes
+    void append(const void *data, std::size_t size);
+
+    /// \brief Replace the content of file by data
+    /// The pending data are written before, then the file is rewritten at
+    /// offset 0 and truncated to size.
+    ///
+    /// \param data The data
+    /// \param size The number of bytes
+    void overwrite(const void *data, std::size_t size);
+
+    /// \brief Wait until all data are in the file
+    void flush();
+
+    /// \brief Indicate if the direct I/O is used
+    ///
+    /// \return True if the file was open with O_DIRECT
+    bool isDirect() const;
+
+    /// \brief Get the number of bytes written in the file
+    /// The bytes of a buffer written by a flush are counted once, when the
+    /// buffer is written again.
+    ///
+    /// \return The number of bytes
+    std::uint64_t countWrittenBytes() const;
+
+    /// \brief Get the throughput of writes
+    /// Only the time spent in pwrite and fdatasync is counted.
+    ///
+    /// \return The throughput in bytes by second
+    double getWriteThroughput() const;
+
+    /// \brief Get the number of full buffers waiting for the writer thread
+    ///
+    /// \return The queue depth
+    std::size_t getQueueDepth() const;
+
+    /// \brief Get the highest number of full buffers waiting for the writer thread
+    ///
+    /// \return The peak queue depth
+    std::size_t getMaxQueueDepth() const;
+
+private:
+    struct Buffer {
+        char *data;
+        std::size_t size;
+        std::uint64_t offset;
+        std::size_t flushed;    // Bytes already written by a flush
+    };
+
+    void run();
+    void submit();
+    void writeAt(const char *data, std::size_t size, std::uint64_t offset, std::size_t rewritten = 0);
+
+private:
+    std::string m_filename;
+    int m_fd;
+    bool m_direct;
+    bool m_syncData;
+    std::size_t m_bufferSize;
+
+    // Ring of buffers: the filled ones are written by the thread
+    std::vector<Buffer> m_buffers;
+    std::size_t m_current;
+    std::size_t m_writeIndex;
+    std::size_t m_filled;
+    std::size_t m_maxFilled;
+    bool m_stop;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_bufferFilled;
+    std::condition_variable m_bufferWritten;
+    std::thread m_writer;
+
+    // Offset of next data in the file
+    std::uint64_t m_offset;
+
+    std::uint64_t m_writtenBytes;
+    std::uint64_t m_writeTime;     // In nanoseconds
+};
+
+#endif // FILE_WRITER_H
@@ -18,16 +18,33 @@
 #ifndef FIR_H
 #define FIR_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "OverlapSave.h"
 #include "Task.h"
 
 template<typename T>
 class Fir: public Task {
 public:
+    /// Algorithm of filter
+    enum class Method {
+        Auto,           ///< Overlap-save above the crossover (double and float only)
+        Direct,         ///< Direct form, O(taps) by output
+        OverlapSave,    ///< Partitioned overlap-save in frequency domain (double and float only)
+    };
+
+    /// Number of taps by decimation factor from which the overlap-save is used
+    static constexpr std::uint64_t OverlapSaveCrossover = 128;
+
     /// Constructor
-    Fir(const std::string &coeffPath, const std::uint64_t DECIM_FACTOR, const int64_t maxNOB = 0);
+    ///
+    /// \param coeffPath Path of file with the coefficients
+    /// \param DECIM_FACTOR Decimation factor
+    /// \param maxNOB Number of bits of output (int64 only, 0 to keep all bits)
+    /// \param method Algorithm of filter
+    Fir(const std::string &coeffPath, const std::uint64_t DECIM_FACTOR, const int64_t maxNOB = 0, Method method = Method::Auto);
 
     /// \brief Filter the signal
     /// This is an override of Task::compute.
@@ -49,14 +66,49 @@ public:
     /// \return True if the task was finished else false
     virtual bool hasFinished(const std::uint64_t N) const override;
 
+    /// \brief Get the number of elements consumed by one compute
+    /// This is an override of Task::getInputRate.
+    ///
+    /// \param index Index of input channel
+    /// \param N The window size
+    /// \return The number of elements consumed
+    virtual std::uint64_t getInputRate(const std::size_t index, const std::uint64_t N) const override;
+
+    /// \brief Get the number of elements kept as filter history
+    /// This is an override of Task::getInputDelay.
+    ///
+    /// \param index Index of input channel
+    /// \param N The window size
+    /// \return The number of elements kept
+    virtual std::uint64_t getInputDelay(const std::size_t index, const std::uint64_t N) const override;
+
+    /// \brief Indicate if the filter is computed by overlap-save
+    ///
+    /// \return True if the overlap-save is used
+    bool usesOverlapSave() const;
+
 private:
-    void filter(std::vector<T> &outValues, const std::uint64_t N);
+    void filter(T *outValues, const std::uint64_t N, const std::uint64_t INPUT_SIZE);
+    void computeOverlapSave(const std::uint64_t N);
+    void initOverlapSave(Method method);
 
 private:
+    /// Number of windows which fit in the input buffer before the history is moved
+    static constexpr std::uint64_t BufferWindows = 4;
+
     std::vector<T> m_coeff;
     std::uint64_t m_DECIM_FACTOR;
     std::vector<T> m_inputBuffer;
+    std::size_t m_bufferStart;
     uint64_t m_maxNOB;
+
+    // Number of history samples already received (the taps after the first compute)
+    std::size_t m_bufferedSize;
+
+    // Overlap-save state: the convolution of the last input sample is kept
+    bool m_overlapSaveEnabled;
+    std::unique_ptr< OverlapSave<T> > m_overlapSave;
+    std::vector<T> m_convolution;
 };
 
 #endif // FIR_H
@@ -0,0 +1,127 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef FUSION_H
+#define FUSION_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "Task.h"
+
+/// \brief Task which applies a chain of elementwise tasks in one pass
+/// The window is cut in blocks which stay in cache, each block goes through
+/// all the tasks of chain with Task::computeElementwise. The fused task
+/// reads the input channel of the first task and writes the output channel
+/// of the last task, the channels between the tasks of chain aren't used.
+/// The tasks of chain aren't modified.
+class FusedTask: public Task {
+public:
+    /// Number of elements of a block
+    static constexpr std::size_t BlockSize = 512;
+
+    /// Constructor
+    ///
+    /// \param chain The elementwise tasks, each one connected to the next one
+    FusedTask(const std::vector<Task*> &chain);
+
+    /// \brief Apply the chain on a window
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Get the tasks of chain
+    ///
+    /// \return The tasks in order
+    const std::vector<Task*>& getChain() const;
+
+private:
+    std::vector<Task*> m_chain;
+    Channel *m_output;
+
+    // Two blocks for the intermediate results
+    std::vector<std::uint8_t> m_blocks[2];
+};
+
+namespace DSP {
+    /// \brief Fusion of the chains of elementwise tasks of a DAG
+    /// The DAG given by DSP::dagLinearisation is scanned for the chains of at
+    /// least two tasks where each task is elementwise (Task::isElementwise)
+    /// and feeds the next one only. Each chain is replaced by a FusedTask in
+    /// the linearisation used by Fusion::processing. The tasks and channels of
+    /// DAG aren't modified, so the DAG can still be processed or inspected
+    /// without the fusion.
+    class Fusion {
+    public:
+        /// Constructor
+        /// An output task ends a chain, so its output channel is filled.
+        ///
+        /// \param sourceTask The source tasks of DAG
+        /// \param outputTask The tasks which must be finished at the end
+        Fusion(std::list<Task*> sourceTask, std::list<Task*> outputTask);
+
+        Fusion(const Fusion&) = delete;
+        Fusion& operator=(const Fusion&) = delete;
+
+        /// \brief Process the fused DAG until all output tasks have finished
+        /// This is the equivalent of DSP::processing.
+        ///
+        /// \param N The window size
+        void processing(const std::uint64_t N);
+
+        /// \brief Get the linearisation with the fused tasks
+        ///
+        /// \return The tasks in order of processing
+        const std::list<Task*>& getLinearisation() const;
+
+        /// \brief Get the number of fused tasks
+        ///
+        /// \return The number of chains
+        std::size_t countFusedTasks() const;
+
+        /// \brief Get the fused task which replaces a task
+        ///
+        /// \param task A task of DAG
+        /// \return The fused task or nullptr if the task isn't fused
+        const FusedTask* getFusedTask(const Task *task) const;
+
+    private:
+        std::list<Task*> m_sourceTask;
+        std::list<Task*> m_outputTask;
+        std::list<Task*> m_linearisation;
+        std::vector< std::unique_ptr<FusedTask> > m_fusedTasks;
+    };
+}
+
+#endif // FUSION_H
@@ -25,11 +25,15 @@
 template<typename T>
 class Mean: public Task {
 public:
-    /// Constructor
-    Mean(const std::uint64_t LIMIT_ORDER = 1);
+    /// \brief Constructor
+    ///
+    /// \param LIMIT_ORDER Number of windows before the first mean is sent on output
+    /// \param publishPeriod Number of windows between two means sent after the first one (0 to send only the first one)
+    Mean(const std::uint64_t LIMIT_ORDER = 1, const std::uint64_t publishPeriod = 0);
 
     /// \brief Compute a mean
-    /// This is an override of Task::compute.
+    /// This is an override of Task::compute. The output channel is only
+    /// written, getMean() gives the latest mean at any time.
     ///
     /// \param N The window size
     virtual void compute(const std::uint64_t N) override;
@@ -51,17 +55,24 @@ public:
     /// \brief Get the number of mean
     std::uint64_t getNumberOfMean() const;
 
+    /// \brief Get the current mean, the output channel isn't used
+    ///
+    /// \param values The mean of each element (empty before the first compute)
+    void getMean(std::vector<T> &values) const;
+
     /// \brief Rest the accumulator of mean
     void clearAccum();
 
 private:
     void initAccum(const std::uint64_t N);
+    void computeMean(T *values) const;
 
 private:
     std::vector<T> m_accum;
     std::vector<T> m_kahanCompensation;
     std::uint64_t m_order;
     const std::uint64_t m_LIMIT_ORDER;
+    const std::uint64_t m_publishPeriod;
 };
 
 #endif // MEAN_H
@@ -0,0 +1,83 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef MULTI_CHANNEL_FFT_H
+#define MULTI_CHANNEL_FFT_H
+
+#include <complex>
+#include <vector>
+
+#include "WrapperFFTW.h"
+#include "Task.h"
+
+/// \brief FFT of several input signals by one batched plan
+/// Each channel gives N bins like Fft: the N / 2 first bins of spectrum
+/// followed by N / 2 zeros.
+template<typename InputType>
+class MultiChannelFft: public Task {
+public:
+    /// Layout of output spectra
+    enum class Layout {
+        Separate,       ///< One output channel by input channel
+        Interleaved,    ///< One output channel, the bin j of channel k is at j * K + k
+    };
+
+    /// Constructor
+    ///
+    /// \param numberChannels Number of input channels K
+    /// \param layout Layout of output spectra
+    MultiChannelFft(const std::size_t numberChannels, Layout layout = Layout::Separate);
+
+    /// \brief Compute the FFT of all the input signals
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Get the number of elements produced on an output by one compute
+    /// This is an override of Task::getOutputRate.
+    ///
+    /// \param index Index of output channel
+    /// \param N The window size
+    /// \return The number of elements produced
+    virtual std::uint64_t getOutputRate(const std::size_t index, const std::uint64_t N) const override;
+
+private:
+    std::size_t m_numberChannels;
+    Layout m_layout;
+    BasicWrapperFFTW<InputType> m_wrapperFFTW;
+
+    // Windows of channels given to the batched FFT
+    std::vector<const InputType*> m_inValues;
+    std::vector< std::complex<InputType>* > m_outValues;
+};
+
+#endif // MULTI_CHANNEL_FFT_H
@@ -19,6 +19,7 @@
 #define NOISE_GENERATOR_H
 
 #include <cstddef>
+#include <complex>
 #include <cstdint>
 #include <vector>
 
@@ -80,6 +81,8 @@ private:
     void convertPhase(const std::uint64_t N);
 
     /// \brief Compute the fft then normalize the data
+    /// The forward FFT computes the half spectrum of real data, the backward
+    /// FFT computes the real data of the half spectrum.
     ///
     /// \param sign The direction of FFT (forward or backward)
     /// \param N The window size
@@ -103,7 +106,8 @@ private:
 
     OutputType m_outputType; /// Specify the unit of result
 
-    std::vector< std::complex<double> > m_data;
+    std::vector<double> m_data;
+    std::vector< std::complex<double> > m_spectrum; /// Non-redundant half of spectrum
     WrapperFFTW m_fftForward;
     WrapperFFTW m_fftBackward;
 };
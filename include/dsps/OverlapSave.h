@@ -0,0 +1,115 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef OVERLAP_SAVE_H
+#define OVERLAP_SAVE_H
+
+#include <complex>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "WrapperFFTW.h"
+
+/// \brief Streaming convolution by uniformly partitioned overlap-save
+/// The impulse response is cut in partitions of blockSize taps, and each
+/// partition is applied in frequency domain on a delay line of input block
+/// spectra. The output has no latency: an incomplete input block is
+/// convolved with zeros in place of the future samples, and computed again
+/// when it is complete. The blocks are real signals, so only the half
+/// spectra are computed (r2c and c2r transforms). The spectra of partitions
+/// are computed by the first convolve, so their FFT plan follows the
+/// execution context of processing. The FFT and the work buffers are in
+/// float precision for float streams, else in double precision.
+template<typename T>
+class OverlapSave {
+public:
+    /// Constructor
+    ///
+    /// \param impulseResponse The impulse response h of filter
+    /// \param blockSize The size of partitions (a power of two is faster)
+    OverlapSave(const std::vector<T> &impulseResponse, const std::uint64_t blockSize);
+
+    OverlapSave(const OverlapSave&) = delete;
+    OverlapSave& operator=(const OverlapSave&) = delete;
+
+    /// \brief Filter the next samples of stream
+    /// output[i] = sum_m h[m] * x[n - m] where n is the position of input[i]
+    /// in the stream (the samples before the stream start are zeros).
+    ///
+    /// \param input The next samples of stream
+    /// \param size The number of samples
+    /// \param output The filtered samples (size elements)
+    void convolve(const T *input, const std::size_t size, T *output);
+
+    /// \brief Insert zeros in the stream without computing their outputs
+    /// Before the first samples, this aligns the next samples on the blocks.
+    ///
+    /// \param size The number of zeros
+    void skip(const std::size_t size);
+
+    /// \brief Get the size of partitions
+    ///
+    /// \return The block size
+    std::uint64_t getBlockSize() const;
+
+    /// \brief Choose a block size for an impulse response
+    /// When the stream is convolved by chunks of chunkSize samples, a divisor
+    /// of chunkSize near the power of two is preferred so the chunks are made
+    /// of whole blocks.
+    ///
+    /// \param numberTaps The number of taps of filter
+    /// \param chunkSize The number of samples by convolve (0 if unknown)
+    /// \return The block size
+    static std::uint64_t defaultBlockSize(const std::uint64_t numberTaps, const std::uint64_t chunkSize = 0);
+
+private:
+    // Precision of FFT and of work buffers, float for float else double
+    typedef typename std::conditional<std::is_same<T, float>::value, float, double>::type Real;
+
+    void initPartitions();
+    void computeBlock(const std::size_t begin, const std::size_t end, T *output);
+    void commitBlock();
+
+private:
+    const std::uint64_t m_blockSize;
+    const std::uint64_t m_fftSize;
+    const std::uint64_t m_numberBins;
+    std::uint64_t m_numberPartitions;
+
+    BasicWrapperFFTW<Real> m_forward;
+    BasicWrapperFFTW<Real> m_backward;
+
+    // Half spectra of partitions and of past input blocks
+    std::vector<T> m_impulseResponse;
+    std::vector< std::complex<Real> > m_partitions;
+    std::vector< std::complex<Real> > m_delayLine;
+    std::uint64_t m_delayLineIndex;
+
+    // Sum of products with the complete past blocks
+    std::vector< std::complex<Real> > m_pastSum;
+    bool m_pastSumValid;
+
+    // Previous input block followed by the current input block
+    std::vector<Real> m_time;
+    std::vector< std::complex<Real> > m_spectrum;
+    std::vector< std::complex<Real> > m_result;
+    std::vector<Real> m_output;
+    std::size_t m_fill;
+};
+
+#endif // OVERLAP_SAVE_H
@@ -0,0 +1,120 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef PARALLEL_PROCESSOR_H
+#define PARALLEL_PROCESSOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ExecutionContext.h"
+
+class Channel;
+class Task;
+
+namespace DSP {
+    /// \brief Execute a DAG of tasks with a pool of threads
+    /// Each task is executed as soon as its input channels are ready, a task
+    /// never runs on two threads at the same time. The source tasks are
+    /// computed together, in the given order, once per round so the shared
+    /// resources (like a Random engine) are used as in DSP::processing.
+    /// A source which isn't ready (ex: at the end of stream) is skipped, and
+    /// the processing ends when no task can be computed anymore.
+    /// The produced streams are identical to DSP::processing, but some more
+    /// windows may be pending in the channels at the end of processing.
+    /// During the processing, the channels between two tasks are switched to
+    /// lock-free SPSC rings sized for the pipeline depth, so a task with
+    /// several inputs never holds the lock of a queue while it waits for
+    /// another one. They store their data in the queue again at the end of
+    /// processing.
+    class ParallelProcessor {
+    public:
+        /// Constructor
+        ///
+        /// The workers are pinned on the cores of context, and the FFTW plans
+        /// created by the tasks use its thread count.
+        ///
+        /// \param numThreads Number of worker threads (0 to use one thread by core of context)
+        /// \param pipelineDepth Maximum number of windows pending in an output channel before the task is throttled
+        /// \param context The execution context of workers
+        ParallelProcessor(std::size_t numThreads = 0, std::uint64_t pipelineDepth = 2, const ExecutionContext &context = ExecutionContext::getDefault());
+
+        /// Destructor
+        ~ParallelProcessor();
+
+        ParallelProcessor(const ParallelProcessor&) = delete;
+        ParallelProcessor& operator=(const ParallelProcessor&) = delete;
+
+        /// \brief Process the DAG until all output tasks have finished
+        /// This is the threaded equivalent of DSP::processing.
+        ///
+        /// \param sourceTask The source tasks of DAG
+        /// \param outputTask The tasks which must be finished at the end
+        /// \param N The window size
+        void processing(std::list<Task*> sourceTask, std::list<Task*> outputTask, const std::uint64_t N);
+
+        /// \brief Get the number of worker threads
+        ///
+        /// \return The number of worker threads
+        std::size_t countThreads() const;
+
+    private:
+        void workerLoop(const std::size_t index);
+        void schedule();
+        bool isThrottled(Task *task) const;
+        bool areSourcesReady() const;
+        bool areSourcesThrottled() const;
+        bool haveOutputsFinished() const;
+        void reserveRings(Task *task, const std::uint64_t length);
+        void dispatchUnthrottled(std::size_t job);
+
+    private:
+        /// Index of job which compute all source tasks
+        static constexpr std::size_t SourceRound = static_cast<std::size_t>(-1);
+
+        const std::uint64_t m_pipelineDepth;
+        const ExecutionContext m_context;
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_jobAvailable;
+        std::condition_variable m_processingDone;
+        std::deque<std::size_t> m_jobs;
+        bool m_shutdown;
+
+        // State of the current processing
+        std::uint64_t m_N;
+        std::vector<Task*> m_sources;
+        std::vector<Task*> m_tasks;
+        std::vector<Task*> m_outputs;
+        std::vector<std::size_t> m_outputIndexes;
+        std::vector<Channel*> m_rings;
+        std::vector<bool> m_running;
+        bool m_sourceRunning;
+        std::uint64_t m_numberRounds;
+        std::size_t m_numberRunning;
+        bool m_stopping;
+        bool m_done;
+    };
+}
+
+#endif // PARALLEL_PROCESSOR_H
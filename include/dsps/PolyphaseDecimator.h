@@ -0,0 +1,95 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef POLYPHASE_DECIMATOR_H
+#define POLYPHASE_DECIMATOR_H
+
+#include <string>
+#include <vector>
+
+#include "Task.h"
+
+/// \brief Decimating FIR filter in polyphase form
+/// The output is the same as Fir with the same decimation factor, but the
+/// filter is split in one sub-filter by phase of input, each applied on the
+/// deinterleaved samples of its phase at the output rate. Only the retained
+/// outputs are computed.
+template<typename T>
+class PolyphaseDecimator: public Task {
+public:
+    /// Constructor
+    ///
+    /// \param coeffPath Path of file with the coefficients
+    /// \param DECIM_FACTOR Decimation factor
+    /// \param maxNOB Number of bits of output (int64 only, 0 to keep all bits)
+    PolyphaseDecimator(const std::string &coeffPath, const std::uint64_t DECIM_FACTOR, const int64_t maxNOB = 0);
+
+    /// \brief Filter and decimate the signal
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Get the number of elements consumed by one compute
+    /// This is an override of Task::getInputRate.
+    ///
+    /// \param index Index of input channel
+    /// \param N The window size
+    /// \return The number of elements consumed
+    virtual std::uint64_t getInputRate(const std::size_t index, const std::uint64_t N) const override;
+
+    /// \brief Get the number of elements kept as filter history
+    /// This is an override of Task::getInputDelay.
+    ///
+    /// \param index Index of input channel
+    /// \param N The window size
+    /// \return The number of elements kept
+    virtual std::uint64_t getInputDelay(const std::size_t index, const std::uint64_t N) const override;
+
+private:
+    void truncate(T *outValues, const std::uint64_t N) const;
+
+private:
+    std::uint64_t m_numberTaps;
+    std::uint64_t m_DECIM_FACTOR;
+    uint64_t m_maxNOB;
+
+    // Coefficients and deinterleaved input samples of each phase
+    std::vector< std::vector<T> > m_phaseCoeff;
+    std::vector< std::vector<T> > m_phaseInput;
+
+    // Index in the phase buffers of the next output, and phase of the next input
+    std::size_t m_phaseStart;
+    std::uint64_t m_nextPhase;
+    std::size_t m_bufferedSize;
+};
+
+#endif // POLYPHASE_DECIMATOR_H
@@ -0,0 +1,83 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef POLYPHASE_INTERPOLATOR_H
+#define POLYPHASE_INTERPOLATOR_H
+
+#include <string>
+#include <vector>
+
+#include "Task.h"
+
+/// \brief Interpolating FIR filter in polyphase form
+/// The output is the convolution of the zero stuffed input with the filter,
+/// y[n] = sum_k h[k] u[n - k] with u[m * INTERP_FACTOR] = x[m] and zeros
+/// elsewhere. No gain is applied. Each output phase is computed by its own
+/// sub-filter at the input rate, so the inserted zeros are never multiplied.
+/// The window size must be a multiple of the interpolation factor.
+template<typename T>
+class PolyphaseInterpolator: public Task {
+public:
+    /// Constructor
+    ///
+    /// \param coeffPath Path of file with the coefficients
+    /// \param INTERP_FACTOR Interpolation factor
+    PolyphaseInterpolator(const std::string &coeffPath, const std::uint64_t INTERP_FACTOR);
+
+    /// \brief Interpolate and filter the signal
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Get the number of elements consumed by one compute
+    /// This is an override of Task::getInputRate.
+    ///
+    /// \param index Index of input channel
+    /// \param N The window size
+    /// \return The number of elements consumed
+    virtual std::uint64_t getInputRate(const std::size_t index, const std::uint64_t N) const override;
+
+private:
+    /// Number of windows which fit in the input buffer before the history is moved
+    static constexpr std::uint64_t BufferWindows = 4;
+
+    std::uint64_t m_INTERP_FACTOR;
+
+    // Coefficients of each phase in reverse order
+    std::vector< std::vector<T> > m_phaseCoeff;
+    std::size_t m_historySize;
+
+    std::vector<T> m_inputBuffer;
+    std::size_t m_bufferStart;
+};
+
+#endif // POLYPHASE_INTERPOLATOR_H
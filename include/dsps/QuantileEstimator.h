@@ -0,0 +1,63 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef QUANTILE_ESTIMATOR_H
+#define QUANTILE_ESTIMATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+/// \brief Streaming estimate of a quantile by the P-square algorithm
+/// Five markers follow the minimum, the quantile, the maximum and the middle
+/// of them, so the memory and the update time don't depend on the number of
+/// values. Before five values, the nearest rank of the values is returned.
+class QuantileEstimator {
+public:
+    /// Constructor
+    ///
+    /// \param quantile The estimated quantile in [0, 1]
+    QuantileEstimator(const double quantile = 0.5);
+
+    /// \brief Add a value to the estimate
+    ///
+    /// \param value The new value
+    void add(const double value);
+
+    /// \brief Get the current estimate of quantile
+    ///
+    /// \return The estimate (0 before the first value)
+    double get() const;
+
+    /// \brief Get the number of values in the estimate
+    ///
+    /// \return The number of values since the construction or the last clear
+    std::uint64_t count() const;
+
+    /// \brief Restart the estimate
+    void clear();
+
+private:
+    static constexpr std::size_t NumberMarkers = 5;
+
+    double m_quantile;
+    double m_heights[NumberMarkers];
+    double m_positions[NumberMarkers];
+    double m_desiredPositions[NumberMarkers];
+    std::uint64_t m_count;
+};
+
+#endif // QUANTILE_ESTIMATOR_H
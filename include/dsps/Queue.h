@@ -22,23 +22,34 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 
+#include "Allocator.h"
+
 class Queue {
 public:
     /// \brief Constructor
-    Queue()
-    : m_capacity(InitialCapacity)
+    ///
+    /// \param allocator Allocator of storage
+    explicit Queue(DSP::Allocator &allocator = DSP::Allocator::getDefault())
+    : m_allocator(&allocator)
+    , m_capacity(InitialCapacity)
     , m_size(0)
     , m_head(0)
     , m_tail(0)
+    , m_reservedCapacity(0)
+    , m_shrinkEnabled(true)
+    , m_numberGrow(0)
+    , m_numberShrink(0)
     {
-        m_data = m_allocator.allocate(m_capacity);
+        m_data = static_cast<std::uint8_t*>(m_allocator->allocate(m_capacity));
     }
 
     /// \brief Destructor
     ~Queue() {
-        m_allocator.deallocate(m_data, m_capacity);
+        m_allocator->deallocate(m_data, m_capacity);
     }
 
     Queue(const Queue&) = delete;
@@ -61,6 +72,62 @@ public:
         return m_size;
     }
 
+    /// \brief Get the capacity of queue in bytes
+    ///
+    /// \return The number of bytes which can be stored without growing
+    std::size_t capacity() const {
+        return m_capacity - 1;
+    }
+
+    /// \brief Pre-allocate the storage
+    /// The queue never shrinks under the reserved capacity.
+    ///
+    /// \param capacity Number of bytes which can be stored without growing
+    void reserve(std::size_t capacity) {
+        m_reservedCapacity = std::max(m_reservedCapacity, capacity + 1);
+
+        if (m_capacity < m_reservedCapacity) {
+            reallocate(m_reservedCapacity, *m_allocator);
+        }
+    }
+
+    /// \brief Move the storage to another allocator
+    /// The pending data are kept.
+    ///
+    /// \param allocator The new allocator of storage
+    void setAllocator(DSP::Allocator &allocator) {
+        if (m_allocator != &allocator) {
+            reallocate(m_capacity, allocator);
+        }
+    }
+
+    /// \brief Get the allocator of storage
+    ///
+    /// \return The allocator
+    DSP::Allocator& getAllocator() const {
+        return *m_allocator;
+    }
+
+    /// \brief Enable or disable the shrink of storage when the queue is sparse
+    ///
+    /// \param enabled True to enable the shrink
+    void setShrinkEnabled(bool enabled) {
+        m_shrinkEnabled = enabled;
+    }
+
+    /// \brief Get the number of reallocations to grow the storage
+    ///
+    /// \return The number of grows
+    std::uint64_t countGrow() const {
+        return m_numberGrow;
+    }
+
+    /// \brief Get the number of reallocations to shrink the storage
+    ///
+    /// \return The number of shrinks
+    std::uint64_t countShrink() const {
+        return m_numberShrink;
+    }
 
     /// \brief Send raw data in the queue
     ///
@@ -139,40 +206,117 @@ public:
         assert(invariant());
 
         // Shrink
-        while (m_size < std::floor(ShrinkLimit * m_capacity) && m_capacity > InitialCapacity) {
-            shrink();
+        shrinkIfNeeded();
+    }
+
+    /// \brief Borrow a contiguous space at the end of queue
+    /// The data are written directly in the queue then published by commit.
+    ///
+    /// \param size Number of bytes to write
+    /// \param alignment Alignment of the returned pointor
+    /// \return Pointor to the borrowed space
+    uint8_t *acquireWrite(std::size_t size, std::size_t alignment = 1) {
+        // We grow the queue if needed
+        while (m_size + size >= m_capacity) {
+            grow();
         }
+
+        // The space must be contiguous and aligned
+        if (m_tail + size > m_capacity || (reinterpret_cast<std::uintptr_t>(m_data + m_tail) % alignment) != 0) {
+            linearize();
+        }
+
+        assert(m_tail + size <= m_capacity);
+        return m_data + m_tail;
+    }
+
+    /// \brief Publish the data written in the reserved space
+    ///
+    /// \param size Number of bytes written
+    void commit(std::size_t size) {
+        assert(m_tail + size <= m_capacity);
+
+        m_tail += size;
+        if (m_tail == m_capacity) {
+            m_tail = 0;
+        }
+
+        m_size += size;
+        assert(invariant());
+    }
+
+    /// \brief Get a contiguous view of the first data
+    /// The data stay in the queue until release.
+    ///
+    /// \param size Number of bytes to read
+    /// \param alignment Alignment of the returned pointor
+    /// \return Pointor to the first data
+    const uint8_t *peek(std::size_t size, std::size_t alignment = 1) {
+        assert(size <= m_size);
+
+        // The data must be contiguous and aligned
+        if (m_head + size > m_capacity || (reinterpret_cast<std::uintptr_t>(m_data + m_head) % alignment) != 0) {
+            linearize();
+        }
+
+        return m_data + m_head;
+    }
+
+    /// \brief Remove the first data without copy
+    ///
+    /// \param size Number of bytes to remove
+    void release(std::size_t size) {
+        assert(size <= m_size);
+        assert(m_head + size <= m_capacity);
+
+        m_head += size;
+        if (m_head == m_capacity) {
+            m_head = 0;
+        }
+
+        m_size -= size;
+        assert(invariant());
+
+        shrinkIfNeeded();
     }
 
 private:
     void grow() {
-        std::size_t capacity = m_capacity * GrowLimit;
-        auto data = m_allocator.allocate(capacity);
+        reallocate(m_capacity * GrowLimit, *m_allocator);
+        ++m_numberGrow;
+    }
 
-        if (m_size > 0) {
-            if (m_head < m_tail) {
-                std::copy_n(m_data + m_head, m_size, data);
-            }
-            else {
-                std::size_t first = m_capacity - m_head;
-                std::size_t second = m_size - first;
-                std::copy_n(m_data + m_head, first, data);
-                std::copy_n(m_data, second, data + first);
-            }
+    void shrink() {
+        reallocate(std::max<std::size_t>(std::floor(ShrinkLimit * m_capacity), m_reservedCapacity), *m_allocator);
+        ++m_numberShrink;
+    }
+
+    void shrinkIfNeeded() {
+        if (!m_shrinkEnabled) {
+            return;
         }
 
+        while (m_size < std::floor(ShrinkLimit * m_capacity) && m_capacity > std::max(InitialCapacity, m_reservedCapacity)) {
+            shrink();
+        }
+    }
+
+    /// Move the data at the begin of buffer without allocation
+    void linearize() {
+        // Only the pending data are moved to the front, unless they wrap
+        if (m_head + m_size <= m_capacity) {
+            std::memmove(m_data, m_data + m_head, m_size);
+        }
+        else {
+            std::rotate(m_data, m_data + m_head, m_data + m_capacity);
+        }
         m_head = 0;
         m_tail = m_size;
-
-        m_allocator.deallocate(m_data, m_capacity);
-        m_data = data;
-        m_capacity = capacity;
         assert(invariant());
     }
 
-    void shrink() {
-        std::size_t capacity = std::floor(ShrinkLimit * m_capacity);
-        auto data = m_allocator.allocate(capacity);
+    void reallocate(std::size_t capacity, DSP::Allocator &allocator) {
+        auto data = static_cast<std::uint8_t*>(allocator.allocate(capacity));
 
         if (m_size > 0) {
             if (m_head < m_tail) {
@@ -189,7 +333,8 @@ private:
         m_head = 0;
         m_tail = m_size;
 
-        m_allocator.deallocate(m_data, m_capacity);
+        m_allocator->deallocate(m_data, m_capacity);
+        m_allocator = &allocator;
         m_data = data;
         m_capacity = capacity;
         assert(invariant());
@@ -212,11 +357,15 @@ private:
     static constexpr double GrowLimit = 1.10;
     static constexpr double ShrinkLimit = 0.04;
 
-    std::allocator<uint8_t> m_allocator;
+    DSP::Allocator *m_allocator;
     std::size_t m_capacity;
     std::size_t m_size;
     std::size_t m_head;
     std::size_t m_tail;
+    std::size_t m_reservedCapacity;
+    bool m_shrinkEnabled;
+    std::uint64_t m_numberGrow;
+    std::uint64_t m_numberShrink;
     uint8_t *m_data;
 };
 
@@ -21,6 +21,7 @@
 #include <complex>
 #include <cstdint>
 #include <random>
+#include <vector>
 
 class Random {
 public:
@@ -28,6 +29,7 @@ public:
     Random(std::uint64_t seed);
 
     void computeNormalPlage(const double mean, const double stddev, std::vector< std::complex<double> > &data);
+    void computeNormalPlage(const double mean, const double stddev, std::vector<double> &data);
 
 private:
     std::mt19937 m_engine;
@@ -0,0 +1,124 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef READ_AHEAD_H
+#define READ_AHEAD_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// \brief Stream buffer which reads a file ahead in a background thread
+/// A reader thread fills a ring of depth preallocated blocks with pread
+/// while the consumer parses the previous ones, so the disk latency is
+/// hidden as long as the consumer is slower than the disk. The end of file
+/// is returned once as EOF; in loop mode the reader continues at the start
+/// of file, and a seek to the start doesn't lose the blocks already read.
+/// The time spent by the consumer to wait for a block is reported, a large
+/// stall time means that the processing is I/O bound.
+class ReadAhead: public std::streambuf {
+public:
+    /// Default number of blocks in the ring
+    static constexpr std::size_t DefaultDepth = 4;
+
+    /// Default size of blocks in bytes
+    static constexpr std::size_t DefaultBlockSize = 1 << 20;
+
+public:
+    /// Constructor
+    ///
+    /// \param filename Path of file
+    /// \param loop If true, the reader continues at the start of file after the end of file
+    /// \param depth Number of blocks read in advance (at least 2)
+    /// \param blockSize Size of blocks in bytes
+    ReadAhead(const std::string &filename, bool loop, std::size_t depth = DefaultDepth, std::size_t blockSize = DefaultBlockSize);
+
+    /// Destructor
+    virtual ~ReadAhead();
+
+    ReadAhead(const ReadAhead&) = delete;
+    ReadAhead& operator=(const ReadAhead&) = delete;
+
+    /// \brief Get the number of blocks in the ring
+    ///
+    /// \return The read-ahead depth
+    std::size_t getDepth() const;
+
+    /// \brief Get the size of blocks
+    ///
+    /// \return The block size in bytes
+    std::size_t getBlockSize() const;
+
+    /// \brief Get the time waited by the consumer for a block
+    /// The wait for the first block after an open or a seek is included.
+    ///
+    /// \return The stall time in seconds
+    double getStallTime() const;
+
+    /// \brief Get the number of waits of the consumer for a block
+    ///
+    /// \return The number of stalls
+    std::uint64_t countStalls() const;
+
+protected:
+    virtual int_type underflow() override;
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+    struct Block {
+        std::vector<char> data;
+        std::size_t size;
+        std::uint64_t offset;
+        bool end;               // Marker of end of file, without data
+    };
+
+    void run(std::uint64_t offset);
+    void start(std::uint64_t offset);
+    void stop();
+    void releaseBlock();
+
+private:
+    std::string m_filename;
+    int m_fd;
+    bool m_loop;
+    std::size_t m_blockSize;
+
+    // Ring of blocks, filled by the reader thread and read by the consumer
+    std::vector<Block> m_blocks;
+    std::size_t m_readIndex;
+    std::size_t m_writeIndex;
+    std::size_t m_filled;
+    bool m_holding;             // The block at m_readIndex is in the get area
+    bool m_stop;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_blockFilled;
+    std::condition_variable m_blockFreed;
+    std::thread m_reader;
+
+    // Position of the data which follows the last block given to the consumer
+    std::uint64_t m_nextOffset;
+
+    std::uint64_t m_stallTime;  // In nanoseconds
+    std::uint64_t m_stallCount;
+};
+
+#endif // READ_AHEAD_H
@@ -0,0 +1,116 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+class Channel;
+class Task;
+
+namespace DSP {
+    /// \brief Static schedule of a synchronous dataflow DAG
+    /// The rates given by Task::getInputRate, Task::getInputDelay and
+    /// Task::getOutputRate are fixed for a window size, so the balance
+    /// equations of the DAG are solved once to get the number of computes of
+    /// each task by period. The schedule is made of a prologue, executed once
+    /// to fill the delays (like the filter histories), and of a period which
+    /// leaves the channels in the same state after each execution. No
+    /// readiness check is done during the processing.
+    ///
+    /// The schedule must be built before any processing of the DAG.
+    class Schedule {
+    public:
+        /// Constructor
+        /// If the rates of DAG are inconsistent, the program exits.
+        ///
+        /// \param sourceTask The source tasks of DAG
+        /// \param N The window size
+        Schedule(std::list<Task*> sourceTask, const std::uint64_t N);
+
+        /// \brief Process the DAG until all output tasks have finished
+        /// The channels are reserved and the prologue is executed on the
+        /// first call, then the period is executed at least once.
+        ///
+        /// \param outputTask The tasks which must be finished at the end
+        void processing(std::list<Task*> outputTask);
+
+        /// \brief Pre-allocate each channel of DAG to its buffer size
+        /// The queues never grow afterwards, and never shrink under the
+        /// reserve.
+        void reserveChannels() const;
+
+        /// \brief Get the number of computes of a task by period
+        ///
+        /// \param task The task
+        /// \return The number of computes (0 if the task isn't in the DAG)
+        std::uint64_t getFiringCount(const Task *task) const;
+
+        /// \brief Get the maximum number of elements stored in a channel
+        /// For a channel without output task, this is the number of elements
+        /// produced by period.
+        ///
+        /// \param channel The channel
+        /// \return The number of elements (0 if the channel isn't in the DAG)
+        std::uint64_t getBufferSize(const Channel *channel) const;
+
+        /// \brief Get the flat list of computes executed once at start
+        ///
+        /// \return The list of tasks to compute in order
+        const std::vector<Task*>& getPrologue() const;
+
+        /// \brief Get the flat list of computes of one period
+        ///
+        /// \return The list of tasks to compute in order
+        const std::vector<Task*>& getPeriod() const;
+
+    private:
+        struct Edge {
+            std::size_t producer;
+            std::uint64_t production;
+            std::size_t consumer;
+            std::uint64_t consumption;
+            std::uint64_t delay;
+            Channel *channel;
+        };
+
+        void sortTasks(const std::list<Task*> &sourceTask);
+        void solveBalanceEquations();
+        void computePrologue();
+        void appendFirings(std::vector<Task*> &firings, const std::vector<std::uint64_t> &counts) const;
+        void simulate(const std::vector<Task*> &firings, std::vector<std::uint64_t> &tokens, std::vector<bool> &fired);
+        std::size_t indexOf(const Task *task) const;
+
+    private:
+        const std::uint64_t m_N;
+        std::vector<Task*> m_tasks;
+        std::vector<bool> m_isSource;
+        std::vector<Edge> m_edges;
+        std::vector<std::uint64_t> m_firingCounts;
+        std::vector<std::uint64_t> m_prologueCounts;
+        std::vector<Task*> m_prologue;
+        std::vector<Task*> m_period;
+        std::vector<Channel*> m_channels;
+        std::vector<std::uint64_t> m_bufferSizes;
+        bool m_prologueDone;
+    };
+}
+
+#endif // SCHEDULE_H
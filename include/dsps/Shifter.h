@@ -46,9 +46,26 @@ public:
     /// \return True if the task was finished else false
     virtual bool hasFinished(const std::uint64_t N) const override;
 
+    /// \brief Indicate if the task is an elementwise operation
+    /// This is an override of Task::isElementwise.
+    ///
+    /// \return True
+    virtual bool isElementwise() const override;
+
+    /// \brief Shift the values on a block
+    /// This is an override of Task::computeElementwise.
+    ///
+    /// \param inValues The input elements
+    /// \param outValues The output elements
+    /// \param size The number of elements
+    virtual void computeElementwise(const void *inValues, void *outValues, const std::size_t size) const override;
+
 private:
     /// \brief Function wrapper to be able to specialize the divide operation
-    InputType divideBy(const InputType value);
+    InputType divideBy(const InputType value) const;
+
+    /// \brief Divide a window, specialized with the SIMD kernels
+    void divideBy(const InputType *inValues, InputType *outValues, const std::uint64_t N) const;
 
 private:
     const std::int16_t m_shift;
@@ -18,10 +18,13 @@
 #ifndef SIGNAL_FROM_FILE_H
 #define SIGNAL_FROM_FILE_H
 
-#include <deque>
 #include <fstream>
+#include <memory>
+#include <vector>
 
+#include "ReadAhead.h"
 #include "Task.h"
+#include "TextParser.h"
 
 class SignalFromFile : public Task {
 public:
@@ -73,6 +76,18 @@ public:
     /// \return True if the task was finished else false
     virtual bool hasFinished(const std::uint64_t N) const override;
 
+    /// \brief Read the file ahead in a background thread (stream and overlap readers only)
+    /// This must be called before the first compute.
+    ///
+    /// \param depth Number of blocks read in advance
+    /// \param blockSize Size of blocks in bytes
+    void enableReadAhead(std::size_t depth = ReadAhead::DefaultDepth, std::size_t blockSize = ReadAhead::DefaultBlockSize);
+
+    /// \brief Get the reader of file ahead, to know its stall time
+    ///
+    /// \return The reader or nullptr without read-ahead
+    const ReadAhead *getReadAhead() const;
+
 private:
     void readBuffer(const std::uint64_t N);
     void sendBuffer(const std::uint64_t N);
@@ -82,9 +97,12 @@ private:
 private:
     std::string m_path;
     std::ifstream m_file;
+    std::unique_ptr<ReadAhead> m_readAhead;
+    std::istream m_input;
+    TextParser m_parser;
     ReaderType m_reader;
     bool m_repeat;
-    std::deque<double> m_buffer;
+    std::vector<double> m_buffer;
     std::size_t m_currentIndex;
     std::uint64_t m_overlap;
 };
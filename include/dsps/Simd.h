@@ -0,0 +1,162 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+namespace DSP {
+    /// \brief Elementwise kernels with a runtime dispatch on the instruction set
+    /// The best instruction set of CPU is detected by CPUID at the first call,
+    /// the environment variable DSPS_SIMD (scalar, sse2, avx2 or avx512) can
+    /// force a lower one. A kernel which isn't vectorised for an instruction
+    /// set uses the one of the lower set.
+    ///
+    /// The arithmetic kernels (scale, multiply, accumulate, abs, shiftRight,
+    /// quantize and convert) give the same bits than the scalar loops. Only
+    /// atan2 and magnitude are approximated, their error bounds are given in
+    /// ULP (unit in the last place) of the result. The scalar set uses the
+    /// standard library and must be selected for a bit exact comparison with
+    /// the oracle files.
+    namespace Simd {
+        /// Instruction set used by the kernels
+        enum class InstructionSet {
+            Scalar,     ///< Portable loops with the standard library
+            SSE2,       ///< 128 bits vectors
+            AVX2,       ///< 256 bits vectors
+            AVX512,     ///< 512 bits vectors (AVX-512F and AVX-512DQ)
+        };
+
+        /// \brief Get the best instruction set supported by the CPU
+        ///
+        /// \return The instruction set
+        InstructionSet detectInstructionSet();
+
+        /// \brief Indicate if an instruction set can be used
+        ///
+        /// \param instructionSet The instruction set
+        /// \return True if the CPU supports the instruction set
+        bool isSupported(const InstructionSet instructionSet);
+
+        /// \brief Get the instruction set used by the kernels
+        ///
+        /// \return The instruction set
+        InstructionSet getInstructionSet();
+
+        /// \brief Select the instruction set used by the kernels
+        /// If the CPU doesn't support it, the program exits.
+        ///
+        /// \param instructionSet The instruction set
+        void setInstructionSet(const InstructionSet instructionSet);
+
+        /// \brief Get the name of an instruction set
+        ///
+        /// \param instructionSet The instruction set
+        /// \return The lower case name, like in DSPS_SIMD
+        const char* getInstructionSetName(const InstructionSet instructionSet);
+
+        /// \brief out[i] = in[i] * gain
+        ///
+        /// \param in The input values
+        /// \param gain The gain
+        /// \param out The output values (can be in)
+        /// \param size The number of values
+        void scale(const double *in, const double gain, double *out, const std::size_t size);
+        void scale(const float *in, const float gain, float *out, const std::size_t size);
+        void scale(const std::complex<double> *in, const double gain, std::complex<double> *out, const std::size_t size);
+
+        /// \brief out[i] = in1[i] * in2[i]
+        ///
+        /// \param in1 The first input values
+        /// \param in2 The second input values
+        /// \param out The output values
+        /// \param size The number of values
+        void multiply(const double *in1, const double *in2, double *out, const std::size_t size);
+        void multiply(const float *in1, const float *in2, float *out, const std::size_t size);
+
+        /// \brief accum[i] += in[i]
+        ///
+        /// \param in The input values
+        /// \param accum The accumulated values
+        /// \param size The number of values
+        void accumulate(const double *in, double *accum, const std::size_t size);
+        void accumulate(const float *in, float *accum, const std::size_t size);
+        void accumulate(const std::complex<double> *in, std::complex<double> *accum, const std::size_t size);
+        void accumulate(const std::int64_t *in, std::int64_t *accum, const std::size_t size);
+
+        /// \brief out[i] = |in[i]|
+        ///
+        /// \param in The input values
+        /// \param out The output values
+        /// \param size The number of values
+        void abs(const double *in, double *out, const std::size_t size);
+        void abs(const float *in, float *out, const std::size_t size);
+
+        /// \brief out[i] = |in[i]| for complex values
+        /// The vectorised sets are within 1 ULP of std::abs. The values out of
+        /// [2^-500, 2^500] (2^-60 and 2^60 in simple precision) and the non
+        /// finite values use std::abs.
+        ///
+        /// \param in The input values
+        /// \param out The output values
+        /// \param size The number of values
+        void magnitude(const std::complex<double> *in, double *out, const std::size_t size);
+        void magnitude(const std::complex<float> *in, float *out, const std::size_t size);
+
+        /// \brief out[i] = atan2(y[i], x[i])
+        /// The vectorised sets are within 2 ULP of std::atan2, with the same
+        /// signed zeros and multiples of pi for the zero inputs. The non
+        /// finite inputs use std::atan2.
+        ///
+        /// \param y The ordinates
+        /// \param x The abscissas
+        /// \param out The angles in [-pi, pi]
+        /// \param size The number of values
+        void atan2(const double *y, const double *x, double *out, const std::size_t size);
+
+        /// \brief out[i] = in[i] >> shift (arithmetic shift)
+        ///
+        /// \param in The input values
+        /// \param shift The shift in [0, 63]
+        /// \param out The output values
+        /// \param size The number of values
+        void shiftRight(const std::int64_t *in, const unsigned shift, std::int64_t *out, const std::size_t size);
+
+        /// \brief out[i] = round(invMax * (in[i] * gain)) rounded half away from zero
+        /// This is the conversion of ConvertType from floating point to integer.
+        ///
+        /// \param in The input values
+        /// \param gain The gain applied before the normalisation
+        /// \param invMax The inverse of maximum value
+        /// \param out The output values
+        /// \param size The number of values
+        void quantize(const double *in, const double gain, const double invMax, std::int64_t *out, const std::size_t size);
+        void quantize(const float *in, const float gain, const float invMax, std::int64_t *out, const std::size_t size);
+
+        /// \brief out[i] = static_cast<double>(in[i])
+        ///
+        /// \param in The input values
+        /// \param out The output values
+        /// \param size The number of values
+        void convert(const std::int64_t *in, double *out, const std::size_t size);
+    }
+}
+
+#endif // SIMD_H
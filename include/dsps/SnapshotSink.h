@@ -0,0 +1,148 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#ifndef SNAPSHOT_SINK_H
+#define SNAPSHOT_SINK_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Task.h"
+
+/// \brief Sink which keeps the last windows to monitor a long run
+/// Each compute copies the window into a ring of numberWindows slots and
+/// releases it, so the live channel is consumed like by any other sink. A
+/// background thread writes the content of ring (oldest window first) on
+/// demand, periodically or when a signal is received. The file is written
+/// next to its path and renamed, so a reader never sees a partial snapshot.
+template<typename T>
+class SnapshotSink: public Task {
+public:
+    /// Format of snapshot file
+    enum class Format {
+        Ascii,      ///< One value by line (real and imaginary parts separated by a tabulation)
+        Binary,     ///< Raw values
+        Gzip,       ///< Raw values compressed by gzip
+    };
+
+public:
+    /// Constructor
+    ///
+    /// \param filename Path of snapshot file (it is replaced by each dump)
+    /// \param numberWindows Number of last windows kept
+    /// \param format Format of snapshot file
+    SnapshotSink(const std::string &filename, std::size_t numberWindows, Format format = Format::Binary);
+
+    /// Destructor, the pending dump is abandoned
+    ~SnapshotSink();
+
+    SnapshotSink(const SnapshotSink&) = delete;
+    SnapshotSink& operator=(const SnapshotSink&) = delete;
+
+    /// \brief Keep the window in the ring
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Ask a dump to the background thread and return at once
+    void requestDump();
+
+    /// \brief Dump the ring and wait until the file is written
+    void dump();
+
+    /// \brief Dump the ring periodically
+    ///
+    /// \param period The period between two dumps (0 to stop the timer)
+    void setDumpPeriod(std::chrono::milliseconds period);
+
+    /// \brief Dump all snapshot sinks when the signal is received
+    /// The handler only sets a flag, which is polled by the background
+    /// threads every SignalPollPeriod.
+    ///
+    /// \param signum The signal number (like SIGUSR1)
+    static void dumpOnSignal(int signum);
+
+    /// \brief Copy the content of ring
+    ///
+    /// \param values The kept windows, the oldest first
+    void getSnapshot(std::vector<T> &values) const;
+
+    /// \brief Get the number of windows received
+    ///
+    /// \return The number of computes
+    std::uint64_t countWindows() const;
+
+    /// \brief Get the number of written snapshots
+    ///
+    /// \return The number of dumps
+    std::uint64_t countDumps() const;
+
+    /// Period of polling of the signal flag
+    static constexpr std::chrono::milliseconds SignalPollPeriod = std::chrono::milliseconds(50);
+
+private:
+    void run();
+    void copyRing(std::vector<T> &values) const;
+    void writeSnapshot(const std::vector<T> &values) const;
+
+private:
+    std::string m_filename;
+    Format m_format;
+    bool m_finished;
+
+    // Ring of last windows, the next compute writes in m_next
+    std::vector< std::vector<T> > m_windows;
+    std::size_t m_next;
+    std::uint64_t m_numberWindows;
+
+    // Dump requests served by the thread
+    mutable std::mutex m_mutex;
+    std::condition_variable m_request;
+    std::condition_variable m_served;
+    std::uint64_t m_requested;
+    std::uint64_t m_dumped;
+    std::uint64_t m_numberDumps;
+    std::uint64_t m_signalsSeen;
+    std::chrono::milliseconds m_period;
+    std::chrono::steady_clock::time_point m_deadline;
+    bool m_stop;
+    std::thread m_thread;
+
+    // Copy of ring written by the thread
+    std::vector<T> m_snapshot;
+};
+
+#endif // SNAPSHOT_SINK_H
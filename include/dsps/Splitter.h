@@ -18,6 +18,7 @@
 #ifndef SPLITTER_H
 #define SPLITTER_H
 
+#include <algorithm>
 #include <vector>
 
 #include "Task.h"
@@ -38,29 +39,14 @@ public:
         // Check if the input task is connected
         assert(m_inputChannels[0] != nullptr && "Splitter: No input task is connected");
 
-        std::vector<T> inValues(N);
-        m_inputChannels[0]->receive(inValues, N);
-
-        // Init the output channel
-        std::vector< std::vector<T> > outValues;
-        for (std::size_t i = 0; i < m_outputChannels.size(); ++i) {
-            outValues.push_back(std::vector<T>(N));
-        }
-
-        // Add the value to next output
-        for (std::size_t i = 0; i < N; ++i) {
-            T tmp = inValues[i];
-
-            for (std::size_t j = 0; j < m_outputChannels.size(); ++j) {
-                outValues[j][i] = tmp;
-            }
-        }
-
-        // Send all data
+        // Copy the input window in each output
+        const T *inValues = m_inputChannels[0]->peek<T>(N);
         for (std::size_t i = 0; i < m_outputChannels.size(); ++i) {
-            outValues.push_back(std::vector<T>(N));
-            m_outputChannels[i].send(outValues[i]);
+            T *outValues = m_outputChannels[i].acquireWrite<T>(N);
+            std::copy(inValues, inValues + N, outValues);
+            m_outputChannels[i].commit<T>(N);
         }
+        m_inputChannels[0]->release<T>(N);
     }
 
     /// \brief Indicate if the task was ready for the compute
@@ -0,0 +1,356 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// \brief Bounded lock-free byte ring for one producer and one consumer
+/// The head (consumer) and the tail (producer) are atomic counters stored on
+/// different cache lines. When the ring is full the producer waits
+/// (back-pressure), when it is empty the consumer waits.
+/// When the capacity is a multiple of the page size, the buffer is mapped
+/// twice in a row so any window of the ring is contiguous in memory.
+class SpscRing {
+public:
+    /// Behaviour of a producer (or a consumer) which must wait
+    enum class WaitMode {
+        Spin,       ///< Busy loop (lowest latency, burns a core)
+        Block,      ///< Sleep on a condition variable
+    };
+
+public:
+    /// \brief Constructor
+    ///
+    /// \param capacity Minimal capacity in bytes (rounded to the next power of two)
+    /// \param mode Wait mode when the ring is full or empty
+    SpscRing(std::size_t capacity, WaitMode mode = WaitMode::Block);
+
+    /// \brief Destructor
+    ~SpscRing();
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /// \brief Get the capacity of ring in bytes
+    ///
+    /// \return The number of bytes which can be stored
+    std::size_t capacity() const {
+        return m_capacity;
+    }
+
+    /// \brief Get the wait mode of ring
+    ///
+    /// \return The wait mode when the ring is full or empty
+    WaitMode getWaitMode() const {
+        return m_mode;
+    }
+
+    /// \brief Get the size of ring in bytes
+    /// It can be called by any thread. The head is loaded before the tail, so
+    /// a concurrent pop can't wrap the size around, and the size is bounded
+    /// by the capacity if a push happens between the two loads.
+    ///
+    /// \return The number of bytes stored in the ring
+    std::size_t size() const {
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        return std::min(tail - head, m_capacity);
+    }
+
+    /// \brief Indicate if the buffer is mapped twice in virtual memory
+    /// With a mirrored buffer, the borrowed windows never need a copy.
+    ///
+    /// \return True if the buffer is mirrored
+    bool isMirrored() const {
+        return m_mirrored;
+    }
+
+    /// \brief Check if the ring is empty
+    ///
+    /// \return True if the ring is empty
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    /// \brief Push raw data only if there are enough free space (producer side)
+    ///
+    /// \param raw Pointor of raw data
+    /// \param size Number of bytes to push
+    /// \return True if the data was pushed
+    bool tryPush(const void *raw, std::size_t size) {
+        if (freeSpace(size) < size) {
+            return false;
+        }
+
+        write(static_cast<const std::uint8_t*>(raw), size);
+        return true;
+    }
+
+    /// \brief Pop raw data only if it is available (consumer side)
+    ///
+    /// \param raw Pointor to send data
+    /// \param size Number of bytes to pop
+    /// \return True if the data was popped
+    bool tryPop(void *raw, std::size_t size) {
+        if (availableData(size) < size) {
+            return false;
+        }
+
+        read(static_cast<std::uint8_t*>(raw), size);
+        return true;
+    }
+
+    /// \brief Push raw data, wait while the ring is full (producer side)
+    /// The data bigger than the capacity are pushed by parts.
+    ///
+    /// \param raw Pointor of raw data
+    /// \param size Number of bytes to push
+    void push(const void *raw, std::size_t size) {
+        const std::uint8_t *bytes = static_cast<const std::uint8_t*>(raw);
+
+        while (size > 0) {
+            std::size_t chunk = std::min(size, freeSpace(size));
+            if (chunk == 0) {
+                wait([this]() { return freeSpace(1) > 0; });
+                continue;
+            }
+
+            write(bytes, chunk);
+            bytes += chunk;
+            size -= chunk;
+        }
+    }
+
+    /// \brief Pop raw data, wait while the ring is empty (consumer side)
+    /// The data bigger than the capacity are popped by parts.
+    ///
+    /// \param raw Pointor to send data
+    /// \param size Number of bytes to pop
+    void pop(void *raw, std::size_t size) {
+        std::uint8_t *bytes = static_cast<std::uint8_t*>(raw);
+
+        while (size > 0) {
+            std::size_t chunk = std::min(size, availableData(size));
+            if (chunk == 0) {
+                wait([this]() { return availableData(1) > 0; });
+                continue;
+            }
+
+            read(bytes, chunk);
+            bytes += chunk;
+            size -= chunk;
+        }
+    }
+
+    /// \brief Reserve a contiguous space, wait while the ring is full (producer side)
+    /// The data are written directly in the ring then published by commit.
+    ///
+    /// \param size Number of bytes to reserve (lower or equal to the capacity)
+    /// \return Pointor to the reserved space
+    void *acquireWrite(std::size_t size) {
+        assert(size <= m_capacity && "SpscRing: The window is bigger than the ring");
+
+        if (freeSpace(size) < size) {
+            wait([this, size]() { return freeSpace(size) >= size; });
+        }
+
+        // Without mirror, a window which crosses the end is staged
+        const std::size_t index = m_tail.load(std::memory_order_relaxed) & m_mask;
+        if (!m_mirrored && index + size > m_capacity) {
+            m_writeStaging.resize(size);
+            return m_writeStaging.data();
+        }
+
+        return m_data + index;
+    }
+
+    /// \brief Publish the data written in the reserved space (producer side)
+    ///
+    /// \param size Number of bytes written
+    void commit(std::size_t size) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (!m_mirrored && (tail & m_mask) + size > m_capacity) {
+            write(m_writeStaging.data(), size);
+            return;
+        }
+
+        m_tail.store(tail + size, std::memory_order_release);
+        notify();
+    }
+
+    /// \brief Get a contiguous view of the first data, wait while they aren't available (consumer side)
+    /// The data stay in the ring until release.
+    ///
+    /// \param size Number of bytes to read (lower or equal to the capacity)
+    /// \return Pointor to the first data
+    const void *peek(std::size_t size) {
+        assert(size <= m_capacity && "SpscRing: The window is bigger than the ring");
+
+        if (availableData(size) < size) {
+            wait([this, size]() { return availableData(size) >= size; });
+        }
+
+        // Without mirror, a window which crosses the end is staged
+        const std::size_t index = m_head.load(std::memory_order_relaxed) & m_mask;
+        if (!m_mirrored && index + size > m_capacity) {
+            m_readStaging.resize(size);
+            std::copy_n(m_data + index, m_capacity - index, m_readStaging.data());
+            std::copy_n(m_data, size - (m_capacity - index), m_readStaging.data() + (m_capacity - index));
+            return m_readStaging.data();
+        }
+
+        return m_data + index;
+    }
+
+    /// \brief Remove the first data without copy (consumer side)
+    ///
+    /// \param size Number of bytes to remove
+    void release(std::size_t size) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        m_head.store(head + size, std::memory_order_release);
+        notify();
+    }
+
+private:
+    static std::size_t roundCapacity(std::size_t capacity) {
+        std::size_t rounded = MinimalCapacity;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+
+        return rounded;
+    }
+
+    std::size_t freeSpace(std::size_t wanted) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        // Reload the head of consumer only if the cached value is not enough
+        if (m_capacity - (tail - m_cachedHead) < wanted) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+        }
+
+        return m_capacity - (tail - m_cachedHead);
+    }
+
+    std::size_t availableData(std::size_t wanted) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+
+        // Reload the tail of producer only if the cached value is not enough
+        if (m_cachedTail - head < wanted) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+        }
+
+        return m_cachedTail - head;
+    }
+
+    void write(const std::uint8_t *raw, std::size_t size) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t index = tail & m_mask;
+        const std::size_t first = m_mirrored ? size : std::min(size, m_capacity - index);
+
+        std::copy_n(raw, first, m_data + index);
+        std::copy_n(raw + first, size - first, m_data);
+
+        m_tail.store(tail + size, std::memory_order_release);
+        notify();
+    }
+
+    void read(std::uint8_t *raw, std::size_t size) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        const std::size_t index = head & m_mask;
+        const std::size_t first = m_mirrored ? size : std::min(size, m_capacity - index);
+
+        std::copy_n(m_data + index, first, raw);
+        std::copy_n(m_data, size - first, raw + first);
+
+        m_head.store(head + size, std::memory_order_release);
+        notify();
+    }
+
+    template <typename Predicate>
+    void wait(Predicate predicate) {
+        if (m_mode == WaitMode::Spin) {
+            while (!predicate()) {
+                std::this_thread::yield();
+            }
+            return;
+        }
+
+        // The timeout protects against a notify sent between the check and the sleep
+        m_waiters.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!predicate()) {
+                m_condition.wait_for(lock, std::chrono::milliseconds(1));
+            }
+        }
+        m_waiters.fetch_sub(1);
+    }
+
+    void notify() {
+        if (m_waiters.load() > 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_condition.notify_all();
+        }
+    }
+
+private:
+    static constexpr std::size_t CacheLineSize = 64;
+    static constexpr std::size_t MinimalCapacity = 64;
+
+    /// Map the buffer twice in a row, return false if the system doesn't support it
+    bool allocateMirrored();
+
+    std::allocator<std::uint8_t> m_allocator;
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    const WaitMode m_mode;
+    bool m_mirrored;
+    std::uint8_t *m_data;
+
+    // Consumer side
+    char m_padding0[CacheLineSize];
+    std::atomic<std::size_t> m_head;
+    std::size_t m_cachedTail;
+    std::vector<std::uint8_t> m_readStaging;
+
+    // Producer side
+    char m_padding1[CacheLineSize];
+    std::atomic<std::size_t> m_tail;
+    std::size_t m_cachedHead;
+    std::vector<std::uint8_t> m_writeStaging;
+
+    // Blocking mode
+    char m_padding2[CacheLineSize];
+    std::atomic<int> m_waiters;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,127 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <mutex>
+#include <vector>
+
+#include "QuantileEstimator.h"
+#include "Task.h"
+
+/// \brief Statistic of each bin over the successive windows
+/// The element i of the output is the statistic of the elements i of the
+/// input windows (like the bins of successive spectra). The accumulators are
+/// stored by quantity (structure of arrays), except the markers of percentile
+/// which are kept by bin, and updated in O(N) by window.
+/// The result is sent every publishPeriod windows, and it can be read at any
+/// time by getResult() without going through the output channel.
+template<typename T>
+class Statistics: public Task {
+public:
+    /// Statistic computed for each bin
+    enum class Statistic {
+        Mean,                   ///< Mean of the last length windows (all the windows if length is 0)
+        Variance,               ///< Unbiased variance of the last length windows (all the windows if length is 0)
+        ExponentialMean,        ///< Exponential moving average, m += alpha * (x - m)
+        ExponentialVariance,    ///< Exponential moving variance around the exponential moving average
+        MinHold,                ///< Minimum of the last length windows (all the windows if length is 0)
+        MaxHold,                ///< Maximum of the last length windows (all the windows if length is 0)
+        Percentile,             ///< P-square estimate of a quantile of all the windows
+    };
+
+public:
+    /// Constructor
+    ///
+    /// \param statistic The statistic computed
+    /// \param length Number of windows of the sliding statistics (0 for all the windows)
+    /// \param parameter Smoothing factor alpha in ]0, 1] of the exponential statistics, or quantile in [0, 1] of percentile
+    /// \param publishPeriod Number of windows between two results sent on output (0 to never send)
+    Statistics(Statistic statistic, std::uint64_t length = 0, double parameter = 0.5, std::uint64_t publishPeriod = 1);
+
+    /// \brief Update the statistic with a window
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Get the current statistic, the output channel isn't used
+    /// It can be called by another thread than the one of compute.
+    ///
+    /// \param values The statistic of each bin (empty before the first window)
+    void getResult(std::vector<T> &values) const;
+
+    /// \brief Send the current statistic on output
+    void publish();
+
+    /// \brief Get the number of windows in the statistic
+    ///
+    /// \return The number of windows since the construction or the last reset
+    std::uint64_t countWindows() const;
+
+    /// \brief Reset the accumulators
+    void clearAccum();
+
+private:
+    void initAccum(const std::uint64_t N);
+    void updateMoments(const T *inValues, const std::uint64_t N);
+    void updateExponential(const T *inValues, const std::uint64_t N);
+    void updateHold(const T *inValues, const std::uint64_t N);
+    void updatePercentile(const T *inValues, const std::uint64_t N);
+    void computeResult(T *values) const;
+
+private:
+    const Statistic m_statistic;
+    const std::uint64_t m_length;
+    const double m_parameter;
+    const std::uint64_t m_publishPeriod;
+
+    mutable std::mutex m_mutex;
+    std::uint64_t m_N;
+    std::uint64_t m_count;
+
+    // Last length windows of the sliding statistics
+    std::vector<T> m_history;
+
+    // Mean and sum of squared deviations (Welford), or min/max of all windows
+    std::vector<T> m_mean;
+    std::vector<T> m_m2;
+
+    // Monotonic deques of window numbers for the sliding min/max, by bin
+    std::vector<std::uint64_t> m_dequeWindows;
+    std::vector<std::uint64_t> m_dequeHead;
+    std::vector<std::uint64_t> m_dequeSize;
+
+    // P-square estimators of the quantile, by bin
+    std::vector<QuantileEstimator> m_quantiles;
+};
+
+#endif // STATISTICS_H
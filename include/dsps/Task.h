@@ -28,9 +28,10 @@ public:
     Task() = delete;
 
     /// Virtual destructor
-    virtual ~Task() {
+    virtual ~Task();
 
-    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
 
     /// \brief The specific compute of the task
     ///
@@ -49,6 +50,59 @@ public:
     /// \return True if the task was finished else false
     virtual bool hasFinished(const std::uint64_t N) const = 0;
 
+    /// \brief Get the number of elements consumed on an input by one compute
+    /// By default a task consumes one window by compute.
+    ///
+    /// \param index Index of input channel
+    /// \param N The window size
+    /// \return The number of elements consumed
+    virtual std::uint64_t getInputRate(const std::size_t index, const std::uint64_t N) const;
+
+    /// \brief Get the number of elements kept by the task after its first compute
+    /// The first compute consumes getInputRate() + getInputDelay() elements
+    /// (like the history of a filter). By default a task keeps nothing.
+    ///
+    /// \param index Index of input channel
+    /// \param N The window size
+    /// \return The number of elements kept
+    virtual std::uint64_t getInputDelay(const std::size_t index, const std::uint64_t N) const;
+
+    /// \brief Get the number of elements produced on an output by one compute
+    /// By default a task produces one window by compute.
+    ///
+    /// \param index Index of output channel
+    /// \param N The window size
+    /// \return The number of elements produced
+    virtual std::uint64_t getOutputRate(const std::size_t index, const std::uint64_t N) const;
+
+    /// \brief Indicate if the task is an elementwise operation
+    /// An elementwise task has one input and one output, computes each output
+    /// element from the input element of same index only, and keeps no state
+    /// between the windows. DSP::Fusion merges the chains of such tasks.
+    ///
+    /// \return True if Task::computeElementwise can be used
+    virtual bool isElementwise() const;
+
+    /// \brief Apply the operation of an elementwise task on a block
+    /// The channels aren't used, the elements have the types of input and
+    /// output channels.
+    ///
+    /// \param inValues The input elements
+    /// \param outValues The output elements
+    /// \param size The number of elements
+    virtual void computeElementwise(const void *inValues, void *outValues, const std::size_t size) const;
+
+    /// \brief Get the number of input channels
+    ///
+    /// \return The number of input channels
+    std::size_t countInputs() const;
+
+    /// \brief Get one input channel
+    ///
+    /// \param index Index of input channel
+    /// \return The input channel or nullptr if it isn't connected
+    Channel* getInput(const std::size_t index) const;
+
     /// \brief Get the number of next Task
     ///
     /// \return The number of next tasks
@@ -60,6 +114,16 @@ public:
     /// \return The task next task at the number i
     Task* getNextTask(const std::size_t i) const;
 
+    /// \brief Get the type of input channels
+    ///
+    /// \return The type of input channels
+    ChannelType getInputChannelType() const;
+
+    /// \brief Get the type of output channels
+    ///
+    /// \return The type of output channels
+    ChannelType getOutputChannelType() const;
+
     /// \brief Set manualy the input channel (to debug mainly)
     ///
     /// \param channel The new input channel
@@ -72,6 +136,12 @@ public:
     /// \return The output channel
     Channel& getOutput(const std::size_t index);
 
+    /// \brief Allocate the output channels and the scratch buffers with an allocator
+    /// The scratch buffers are freed, and allocated again by the next computes.
+    ///
+    /// \param allocator The allocator, it must outlive the task
+    void setAllocator(DSP::Allocator &allocator);
+
     /// \brief Connect an output of input task to an input of output task
     ///
     /// \param inputTask The reference of input task
@@ -97,11 +167,36 @@ protected:
     /// \param numOutput Number of output parameter
     Task(ChannelType inputType, const std::size_t numInput, ChannelType outputType, const std::size_t numOutput);
 
+    /// \brief Get a scratch buffer of the task
+    /// The buffer is aligned on a cache line and kept between the computes,
+    /// it is reallocated only when a bigger size is asked. So a compute
+    /// doesn't allocate anymore after the first windows.
+    ///
+    /// \param index Index of buffer (a task can use several buffers)
+    /// \param size Number of elements
+    /// \return The buffer, its content is undefined
+    template<typename T>
+    T* getScratch(const std::size_t index, const std::size_t size) {
+        return static_cast<T*>(getScratchBytes(index, size * sizeof(T)));
+    }
+
+private:
+    void *getScratchBytes(const std::size_t index, const std::size_t size);
+
 protected:
     ChannelType m_inputChannelType;
     ChannelType m_outputChannelType;
     std::vector<Channel*> m_inputChannels;
     std::vector<Channel> m_outputChannels;
+
+private:
+    struct ScratchBuffer {
+        void *data;
+        std::size_t size;
+    };
+
+    DSP::Allocator *m_allocator;
+    std::vector<ScratchBuffer> m_scratchBuffers;
 };
 
 #endif // TASK_H
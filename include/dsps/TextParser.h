@@ -0,0 +1,111 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef TEXT_PARSER_H
+#define TEXT_PARSER_H
+
+#include <complex>
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+/// \brief Locale-free parser of numbers separated by whitespaces
+/// The characters are read from the stream by large blocks and the numbers
+/// are parsed in place. A double is computed with integer arithmetic when
+/// its significand has at most 19 digits and its decimal exponent is
+/// small, else with strtod in the "C" locale; in both cases the value is
+/// the correctly rounded one, identical to operator>>.
+class TextParser {
+public:
+    /// Default number of characters read from the stream at once
+    static constexpr std::size_t DefaultBlockSize = 1 << 20;
+
+public:
+    /// Constructor
+    ///
+    /// \param input The stream of text (it must outlive the parser)
+    /// \param blockSize Number of characters read at once
+    TextParser(std::istream &input, std::size_t blockSize = DefaultBlockSize);
+
+    TextParser(const TextParser&) = delete;
+    TextParser& operator=(const TextParser&) = delete;
+
+    /// \brief Read the next number
+    /// An invalid number stops the program.
+    ///
+    /// \param value The number read
+    /// \return False at the end of stream
+    bool read(double &value);
+
+    /// \brief Read the next number
+    /// An invalid number stops the program.
+    ///
+    /// \param value The number read
+    /// \return False at the end of stream
+    bool read(std::int64_t &value);
+
+    /// \brief Read the next complex number (real and imaginary parts)
+    /// An invalid number stops the program.
+    ///
+    /// \param value The number read
+    /// \return False at the end of stream
+    bool read(std::complex<double> &value);
+
+    /// \brief Drop the buffered characters
+    /// This must be called when the position of stream changed.
+    void reset();
+
+    /// \brief Parse one number
+    ///
+    /// \param begin The first character of number
+    /// \param end The end of characters
+    /// \param value The number parsed
+    /// \return The character after the number, or begin if no number was found
+    static const char *parse(const char *begin, const char *end, double &value);
+
+    /// \brief Parse one number
+    ///
+    /// \param begin The first character of number
+    /// \param end The end of characters
+    /// \param value The number parsed
+    /// \return The character after the number, or begin if no number was found
+    static const char *parse(const char *begin, const char *end, std::int64_t &value);
+
+    /// \brief Parse all numbers of a text, by chunks in parallel
+    /// The text is cut on whitespaces, so the values are the same as a
+    /// sequential parse. The parse stops at the first invalid number.
+    ///
+    /// \param begin The first character of text
+    /// \param end The end of text
+    /// \param numThreads Number of threads (0 to use all hardware threads)
+    /// \return The numbers of text
+    template <typename T>
+    static std::vector<T> parseAll(const char *begin, const char *end, unsigned numThreads = 0);
+
+private:
+    bool nextToken(const char *&begin, const char *&end);
+    void fill();
+
+private:
+    std::istream &m_input;
+    std::size_t m_blockSize;
+    std::vector<char> m_buffer;
+    std::size_t m_position;
+    std::size_t m_size;
+};
+
+#endif // TEXT_PARSER_H
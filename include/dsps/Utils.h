@@ -18,6 +18,7 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cassert>
 #include <complex>
 #include <fstream>
 #include <iomanip>
@@ -38,8 +39,58 @@ class Task;
 #define USELESS_PARAMETER(x) (void)(x)
 
 namespace DSP {
+    class ExecutionContext;
+
+    /// \brief Process the DAG until all output tasks have finished
+    /// A source task which isn't ready (ex: at the end of stream) is skipped,
+    /// and the processing ends when no task can be computed anymore.
+    ///
+    /// \param sourceTask The source tasks of DAG
+    /// \param outputChannel The tasks which must be finished at the end
+    /// \param N The window size
     void processing(std::list<Task*> sourceTask, std::list<Task*> outputChannel, const std::uint64_t N);
 
+    /// \brief Process a linearised DAG until all output tasks have finished
+    /// This is the loop of DSP::processing: each pass computes the source
+    /// tasks once and the other tasks while they are ready, in the order of
+    /// linearisation.
+    ///
+    /// \param linearisation The tasks in computation order
+    /// \param sourceTask The source tasks of DAG
+    /// \param outputTask The tasks which must be finished at the end
+    /// \param N The window size
+    void processLinearisation(const std::list<Task*> &linearisation, const std::list<Task*> &sourceTask, const std::list<Task*> &outputTask, const std::uint64_t N);
+
+    /// \brief Process the DAG in an execution context
+    /// The calling thread is pinned on the cores of context and the FFTW
+    /// plans created during the processing use its thread count. The
+    /// previous affinity is restored at the end.
+    ///
+    /// \param sourceTask The source tasks of DAG
+    /// \param outputChannel The tasks which must be finished at the end
+    /// \param N The window size
+    /// \param context The execution context of DAG
+    void processing(std::list<Task*> sourceTask, std::list<Task*> outputChannel, const std::uint64_t N, const ExecutionContext &context);
+
+    /// \brief Pre-allocate the channels used by DSP::processing
+    /// The processing is simulated with the rates of tasks (Task::getInputRate,
+    /// Task::getInputDelay and Task::getOutputRate) until it repeats, and each
+    /// channel between two tasks is reserved for its peak occupancy. The
+    /// queues never grow afterwards, and never shrink under the reserve.
+    ///
+    /// \param sourceTask The source tasks of DAG
+    /// \param N The window size
+    void reserveChannels(std::list<Task*> sourceTask, const std::uint64_t N);
+
+    /// \brief Use an allocator for a DAG
+    /// The output channels and the scratch buffers of each task are allocated
+    /// by the allocator, like a per-graph arena or a NUMA node. This should be
+    /// called before reserveChannels.
+    ///
+    /// \param sourceTask The source tasks of DAG
+    /// \param allocator The allocator, it must outlive the tasks
+    void setAllocator(std::list<Task*> sourceTask, Allocator &allocator);
+
     std::list<Task*> dagLinearisation(std::list<Task*> sourceTask);
 }
 
@@ -71,20 +122,12 @@ public:
             file << std::scientific << std::setprecision(std::numeric_limits<double>::digits10 + 1);
         }
 
-        // If we have to skip the first data
-        if (WINDOW_SIZE != 0) {
-            std::size_t numberSkip = data.size(sizeof(T)) / WINDOW_SIZE - 1;
-            for (std::size_t j = 0; j < numberSkip; ++j) {
-                std::vector<T> dataSkiped;
-                data.receive(dataSkiped, WINDOW_SIZE);
-                data.send(dataSkiped);
-            }
-        }
-
-        // Read the all data and resend
-        const std::size_t LIMIT = (WINDOW_SIZE == 0) ? data.size(sizeof(T)) : WINDOW_SIZE;
-        std::vector<T> dataToWrite;
-        data.receive(dataToWrite, LIMIT);
+        // Borrow the data without removing them, the first windows are skipped
+        const std::size_t SIZE = data.size(sizeof(T));
+        const std::size_t LIMIT = (WINDOW_SIZE == 0) ? SIZE : WINDOW_SIZE;
+        assert(SIZE >= LIMIT && "Writer: The channel has less than one window");
+        const std::size_t OFFSET = (WINDOW_SIZE == 0) ? 0 : (SIZE / WINDOW_SIZE - 1) * WINDOW_SIZE;
+        const T *dataToWrite = data.peek<T>(SIZE) + OFFSET;
 
         for(std::size_t i = 0; i < LIMIT; ++i) {
             if (std::is_same<T, std::complex<double>>::value) {
@@ -96,7 +139,7 @@ public:
             }
         }
 
-        data.send(dataToWrite);
+        data.release<T>(0);
         file.close();
     }
 
@@ -116,26 +159,16 @@ public:
             file.open(path, std::ios::binary);
         }
 
-        // If we have to skip the first data
-        if (WINDOW_SIZE != 0) {
-            std::size_t numberSkip = data.size(sizeof(T)) / WINDOW_SIZE - 1;
-            for (std::size_t j = 0; j < numberSkip; ++j) {
-                std::vector<T> dataSkiped;
-                data.receive(dataSkiped, WINDOW_SIZE);
-                data.send(dataSkiped);
-            }
-        }
-
-        // Read the all data and resend
-        const std::size_t LIMIT = (WINDOW_SIZE == 0) ? data.size(sizeof(T)) : WINDOW_SIZE;
-        std::vector<T> dataToWrite;
-        data.receive(dataToWrite, LIMIT);
+        // Borrow the data without removing them, the first windows are skipped
+        const std::size_t SIZE = data.size(sizeof(T));
+        const std::size_t LIMIT = (WINDOW_SIZE == 0) ? SIZE : WINDOW_SIZE;
+        assert(SIZE >= LIMIT && "Writer: The channel has less than one window");
+        const std::size_t OFFSET = (WINDOW_SIZE == 0) ? 0 : (SIZE / WINDOW_SIZE - 1) * WINDOW_SIZE;
+        const T *dataToWrite = data.peek<T>(SIZE) + OFFSET;
 
-        for(std::size_t i = 0; i < LIMIT; ++i) {
-            file.write(reinterpret_cast<char*>(&(dataToWrite[i])), sizeof(T));
-        }
+        file.write(reinterpret_cast<const char*>(dataToWrite), LIMIT * sizeof(T));
 
-        data.send(dataToWrite);
+        data.release<T>(0);
         file.close();
     }
 
@@ -168,25 +201,18 @@ public:
         boost::iostreams::filtering_streambuf<boost::iostreams::input> out;
         out.push(boost::iostreams::gzip_compressor());
 
-        // If we have to skip the first data
-        if (WINDOW_SIZE != 0) {
-            std::size_t numberSkip = data.size(sizeof(T)) / WINDOW_SIZE - 1;
-            for (std::size_t j = 0; j < numberSkip; ++j) {
-                std::vector<T> dataSkiped;
-                data.receive(dataSkiped, WINDOW_SIZE);
-                data.send(dataSkiped);
-            }
-        }
-
-        // Read the all data and resend
-        const std::size_t LIMIT = (WINDOW_SIZE == 0) ? data.size(sizeof(T)) : WINDOW_SIZE;
-        std::vector<T> dataToWrite;
-        data.receive(dataToWrite, LIMIT);
-        data.send(dataToWrite);
+        // Borrow the data without removing them, the first windows are skipped
+        const std::size_t SIZE = data.size(sizeof(T));
+        const std::size_t LIMIT = (WINDOW_SIZE == 0) ? SIZE : WINDOW_SIZE;
+        assert(SIZE >= LIMIT && "Writer: The channel has less than one window");
+        const std::size_t OFFSET = (WINDOW_SIZE == 0) ? 0 : (SIZE / WINDOW_SIZE - 1) * WINDOW_SIZE;
+        const T *dataToWrite = data.peek<T>(SIZE) + OFFSET;
 
         // Create the gzip file
-        out.push(boost::iostreams::array_source(reinterpret_cast<char*>(dataToWrite.data()), dataToWrite.size() * sizeof(T)));
+        out.push(boost::iostreams::array_source(reinterpret_cast<const char*>(dataToWrite), LIMIT * sizeof(T)));
         boost::iostreams::copy(out, file);
+
+        data.release<T>(0);
         file.close();
     }
 };
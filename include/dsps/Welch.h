@@ -0,0 +1,127 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef WELCH_H
+#define WELCH_H
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "QuantileEstimator.h"
+#include "Task.h"
+#include "WrapperFFTW.h"
+
+/// \brief Power spectral density by the Welch method
+/// The input stream is cut in segments of nfft samples which share overlap
+/// samples. Each segment is windowed, its periodogram is averaged in one
+/// running estimate, so the memory is O(nfft) whatever the stream length.
+/// The one-sided PSD (nfft / 2 + 1 bins, unit^2/Hz) is sent every
+/// segmentsByOutput segments.
+class Welch: public Task {
+public:
+    /// Window applied on each segment
+    enum class Window {
+        Rectangular,    ///< No window
+        Hanning,        ///< Periodic Hann window
+        Hamming,        ///< Periodic Hamming window
+        Blackman,       ///< Periodic Blackman window
+    };
+
+    /// Averaging of periodograms
+    enum class Averaging {
+        Linear,         ///< Mean of all the segments
+        Exponential,    ///< Exponential moving average, the weight of new segment is alpha
+        Median,         ///< Streaming median estimate (P-square), corrected by 1/ln(2)
+    };
+
+    /// Constructor
+    ///
+    /// \param nfft Number of samples of segments
+    /// \param overlap Number of samples shared by two consecutive segments
+    /// \param fs Sampling rate of input signal
+    /// \param window Window applied on each segment
+    /// \param averaging Averaging of periodograms
+    /// \param alpha Weight of new segment for the exponential averaging
+    /// \param segmentsByOutput Number of segments between two sent PSD
+    Welch(const std::uint64_t nfft, const std::uint64_t overlap, const double fs, Window window = Window::Hanning, Averaging averaging = Averaging::Linear, const double alpha = 0.1, const std::uint64_t segmentsByOutput = 1);
+
+    /// \brief Consume N samples and update the PSD
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    virtual void compute(const std::uint64_t N) override;
+
+    /// \brief Indicate if the task was ready for the compute
+    /// This is an override of Task::compute.
+    ///
+    /// \param N The window size
+    /// \return True if the task was ready else false
+    virtual bool isReady(const std::uint64_t N) const override;
+
+    /// \brief Indicate if the task was finished the compute
+    /// A PSD was sent.
+    /// This is an override of Task::hasFinished.
+    ///
+    /// \param N The window size
+    /// \return True if the task was finished else false
+    virtual bool hasFinished(const std::uint64_t N) const override;
+
+    /// \brief Get the current PSD estimate
+    ///
+    /// \return The one-sided PSD (nfft / 2 + 1 bins)
+    std::vector<double> getPsd() const;
+
+    /// \brief Get the number of averaged segments
+    ///
+    /// \return The number of segments
+    std::uint64_t getNumberOfSegments() const;
+
+    /// \brief Restart the averaging, the samples of current segment are kept
+    void reset();
+
+private:
+    void initWindow(Window window);
+    void computeSegment();
+    void sendPsd();
+    void copyPsd(double *psd) const;
+
+private:
+    const std::uint64_t m_nfft;
+    const std::uint64_t m_overlap;
+    const Averaging m_averaging;
+    const double m_alpha;
+    const std::uint64_t m_segmentsByOutput;
+
+    // Window and PSD scale of bins
+    std::vector<double> m_window;
+    std::vector<double> m_scale;
+
+    // Current segment and its spectrum
+    std::vector<double> m_segment;
+    std::uint64_t m_fill;
+    std::vector<double> m_windowedSegment;
+    std::vector< std::complex<double> > m_spectrum;
+    WrapperFFTW m_wrapperFFTW;
+
+    // Running estimate
+    std::vector<double> m_accum;
+    std::vector<QuantileEstimator> m_medians;
+    std::uint64_t m_numberSegments;
+};
+
+#endif // WELCH_H
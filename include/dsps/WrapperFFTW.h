@@ -20,8 +20,10 @@
 
 #include <fftw3.h>
 
+#include <cassert>
 #include <complex>
-#include <mutex>
+#include <memory>
+#include <string>
 #include <vector>
 
 /// Enum to handle the direction of FFT, the values are based on FFTW values
@@ -30,19 +32,58 @@ enum class FFTDirection : int {
     Backward = FFTW_BACKWARD, ///< Inverse FFT
 };
 
-class WrapperFFTW {
+/// Enum to handle the planner effort of FFTW, the values are based on FFTW flags
+enum class FFTPlanner : unsigned {
+    Estimate = FFTW_ESTIMATE, ///< Heuristic plan, no measure
+    Measure = FFTW_MEASURE, ///< Measure some algorithms
+    Patient = FFTW_PATIENT, ///< Measure a wide range of algorithms
+    Exhaustive = FFTW_EXHAUSTIVE, ///< Measure all the algorithms
+};
+
+/// Enum to handle the precision of plans
+enum class FFTPrecision {
+    Double, ///< fftw_plan
+    Float, ///< fftwf_plan
+};
+
+/// Types of FFTW library for a precision
+template <typename R>
+struct FFTWTypes;
+
+template <>
+struct FFTWTypes<double> {
+    typedef fftw_complex Complex;
+    typedef fftw_plan_s Plan;
+};
+
+template <>
+struct FFTWTypes<float> {
+    typedef fftwf_complex Complex;
+    typedef fftwf_plan_s Plan;
+};
+
+/// \brief Wrapper of FFTW plans
+/// The FFT is computed with the precision R: fftw for double and fftwf for
+/// float. A plan uses the FFTW thread count of the DSP::ExecutionContext
+/// active on the thread which creates it.
+///
+/// \tparam R Type of FFTW real values (double or float)
+template <typename R>
+class BasicWrapperFFTW {
 public:
     /// Constructor
     ///
     /// \param direction Direction of FFT (direct or inverse)
-    WrapperFFTW(FFTDirection direction);
+    BasicWrapperFFTW(FFTDirection direction);
 
     // Rule of three
-    virtual ~WrapperFFTW();
-    WrapperFFTW (const WrapperFFTW& other) = delete;
-    WrapperFFTW& operator= (const WrapperFFTW& other) = delete;
+    virtual ~BasicWrapperFFTW();
+    BasicWrapperFFTW (const BasicWrapperFFTW& other) = delete;
+    BasicWrapperFFTW& operator= (const BasicWrapperFFTW& other) = delete;
 
     /// \brief Compute a FFT
+    /// The real input of a forward wrapper is computed by a r2c transform,
+    /// the upper half of spectrum is filled by Hermitian symmetry.
     ///
     /// \tparam T Type of input data (expected float or double)
     /// \param inputData Real value for the input
@@ -50,16 +91,149 @@ public:
     /// \param windowSize Size of FFT window
     template <typename T>
     void compute(const std::vector<T> &inputData, std::vector< std::complex<T> > &outputData, const std::uint64_t windowSize) {
-        // Cast data to complex
-        std::vector< std::complex<T> > dataComplex(windowSize);
+        if (m_fftSign == FFTDirection::Backward) {
+            // The real data are copied as complex in the plan buffer
+            initPlan(windowSize, false, false, 1);
+            for (std::uint64_t i = 0; i < windowSize; ++i) {
+                m_inputData[i][0] = inputData[i];
+                m_inputData[i][1] = 0.0;
+            }
+
+            compute();
+
+            outputData.resize(windowSize);
+            for (std::uint64_t i = 0; i < windowSize; ++i) {
+                outputData[i] = std::complex<T>(m_outputData[i][0], m_outputData[i][1]);
+            }
+            return;
+        }
+
+        outputData.resize(windowSize);
+        computeR2C(inputData.data(), outputData.data(), windowSize);
+
+        for (std::uint64_t i = windowSize / 2 + 1; i < windowSize; ++i) {
+            outputData[i] = std::conj(outputData[windowSize - i]);
+        }
+    }
+
+    /// \brief Compute the non-redundant half of the FFT of a real signal
+    /// The output has windowSize / 2 + 1 bins, the wrapper must be forward.
+    ///
+    /// \tparam T Type of input data (expected float or double)
+    /// \param inputData Real value for the input
+    /// \param outputData Computed complex data
+    /// \param windowSize Size of FFT window
+    template <typename T>
+    void computeR2C(const std::vector<T> &inputData, std::vector< std::complex<T> > &outputData, const std::uint64_t windowSize) {
+        outputData.resize(windowSize / 2 + 1);
+        computeR2C(inputData.data(), outputData.data(), windowSize);
+    }
+
+    /// \brief Compute the non-redundant half of the FFT of a real signal
+    ///
+    /// \tparam T Type of input data (expected float or double)
+    /// \param inputData Real value for the input (windowSize elements)
+    /// \param outputData Computed complex data (windowSize / 2 + 1 elements)
+    /// \param windowSize Size of FFT window
+    template <typename T>
+    void computeR2C(const T *inputData, std::complex<T> *outputData, const std::uint64_t windowSize) {
+        assert(m_fftSign == FFTDirection::Forward && "WrapperFFTW: The r2c transform is forward");
 
+        // Create the plan
+        initPlan(windowSize, false, true, 1);
+
+        // Copy data
         for (std::uint64_t i = 0; i < windowSize; ++i) {
-            dataComplex[i].real(inputData[i]);
-            dataComplex[i].imag(0.0);
+            m_realData[i] = inputData[i];
         }
 
-        // Call the fft
-        compute(dataComplex, outputData, windowSize);
+        // Compute
+        compute();
+
+        // Send data
+        for (std::uint64_t i = 0; i < windowSize / 2 + 1; ++i) {
+            outputData[i] = std::complex<T>(m_outputData[i][0], m_outputData[i][1]);
+        }
+    }
+
+    /// \brief Compute the non-redundant halves of the FFT of a batch of real signals
+    /// All the signals are computed by one plan, the wrapper must be forward.
+    /// The bin j of signal k is written in outputData[k][j * outputStride].
+    ///
+    /// \tparam T Type of input data (expected float or double)
+    /// \param inputData Real values of each signal (windowSize elements)
+    /// \param outputData Computed complex data of each signal (windowSize / 2 + 1 bins)
+    /// \param outputStride Distance between two bins of a signal
+    /// \param windowSize Size of FFT window
+    template <typename T>
+    void computeBatchR2C(const std::vector<const T*> &inputData, const std::vector< std::complex<T>* > &outputData, const std::size_t outputStride, const std::uint64_t windowSize) {
+        assert(m_fftSign == FFTDirection::Forward && "WrapperFFTW: The r2c transform is forward");
+        assert(inputData.size() == outputData.size() && "WrapperFFTW: The number of inputs and outputs differ");
+
+        const std::size_t batch = inputData.size();
+        const std::uint64_t bins = windowSize / 2 + 1;
+
+        // Create the plan
+        initPlan(windowSize, false, true, batch);
+
+        // Copy data, the signals are contiguous
+        for (std::size_t k = 0; k < batch; ++k) {
+            for (std::uint64_t i = 0; i < windowSize; ++i) {
+                m_realData[k * windowSize + i] = inputData[k][i];
+            }
+        }
+
+        // Compute
+        compute();
+
+        // Send data
+        for (std::size_t k = 0; k < batch; ++k) {
+            for (std::uint64_t j = 0; j < bins; ++j) {
+                outputData[k][j * outputStride] = std::complex<T>(m_outputData[k * bins + j][0], m_outputData[k * bins + j][1]);
+            }
+        }
+    }
+
+    /// \brief Compute the inverse FFT of a Hermitian spectrum
+    /// Only the non-redundant half of spectrum is read, the wrapper must be
+    /// backward.
+    ///
+    /// \tparam T Type of output data (expected float or double)
+    /// \param inputData Complex value for the input (windowSize / 2 + 1 elements)
+    /// \param outputData Computed real data
+    /// \param windowSize Size of FFT window
+    template <typename T>
+    void computeC2R(const std::vector< std::complex<T> > &inputData, std::vector<T> &outputData, const std::uint64_t windowSize) {
+        outputData.resize(windowSize);
+        computeC2R(inputData.data(), outputData.data(), windowSize);
+    }
+
+    /// \brief Compute the inverse FFT of a Hermitian spectrum
+    ///
+    /// \tparam T Type of output data (expected float or double)
+    /// \param inputData Complex value for the input (windowSize / 2 + 1 elements)
+    /// \param outputData Computed real data (windowSize elements)
+    /// \param windowSize Size of FFT window
+    template <typename T>
+    void computeC2R(const std::complex<T> *inputData, T *outputData, const std::uint64_t windowSize) {
+        assert(m_fftSign == FFTDirection::Backward && "WrapperFFTW: The c2r transform is backward");
+
+        // Create the plan
+        initPlan(windowSize, false, true, 1);
+
+        // Copy data, the c2r transform overwrites its input
+        for (std::uint64_t i = 0; i < windowSize / 2 + 1; ++i) {
+            m_inputData[i][0] = inputData[i].real();
+            m_inputData[i][1] = inputData[i].imag();
+        }
+
+        // Compute
+        compute();
+
+        // Send data
+        for (std::uint64_t i = 0; i < windowSize; ++i) {
+            outputData[i] = m_realData[i];
+        }
     }
 
     /// \brief Compute a FFT
@@ -70,8 +244,11 @@ public:
     /// \param windowSize Size of FFT window
     template <typename T>
     void compute(const std::vector< std::complex<T> > &inputData, std::vector< std::complex<T> > &outputData, const std::uint64_t windowSize) {
+        // Same vector for input and output: the in-place plan needs only one buffer
+        const bool inPlace = (&inputData == &outputData);
+
         // Create the plan
-        initPlan(windowSize);
+        initPlan(windowSize, inPlace, false, 1);
 
         // Copy data
         for (std::uint64_t i = 0; i < windowSize; ++i) {
@@ -89,27 +266,79 @@ public:
         }
     }
 
+    /// \brief Set the planner effort of the next plans
+    /// The effort is shared by all the precisions, the plans already in cache
+    /// are kept. The default effort is
+    /// FFTPlanner::Estimate, or the value of DSPS_FFTW_PLANNER environment
+    /// variable (estimate, measure, patient or exhaustive).
+    ///
+    /// \param planner The planner effort
+    static void setPlannerEffort(FFTPlanner planner);
+
+    /// \brief Get the planner effort of the next plans
+    ///
+    /// \return The planner effort
+    static FFTPlanner getPlannerEffort();
+
+    /// \brief Import the FFTW wisdom of precision R from a file
+    /// If the DSPS_FFTW_WISDOM environment variable is set, its file is
+    /// imported before the first plan and exported at the exit. The float
+    /// wisdom is in the same path with the '.float' suffix.
+    ///
+    /// \param path Path of wisdom file
+    /// \return True if the wisdom was imported else false
+    static bool importWisdom(const std::string &path);
+
+    /// \brief Export the FFTW wisdom of precision R in a file
+    ///
+    /// \param path Path of wisdom file
+    /// \return True if the wisdom was exported else false
+    static bool exportWisdom(const std::string &path);
+
+    /// \brief Get the number of plans in the process-wide cache
+    /// The cache is shared by all the precisions.
+    ///
+    /// \return The number of plans
+    static std::size_t countCachedPlans();
+
+    /// \brief Remove the plans of cache
+    /// The plans used by a wrapper are destroyed with the wrapper.
+    static void clearPlanCache();
+
 private:
     /// Call the FFTW routine (maybe useless)
     void compute();
 
-    /// Create and alloc the fftw plan and data
+    /// Get the fftw plan from the cache and alloc the data
+    /// The plan is created again if the FFTW thread count of the current
+    /// execution context has changed.
     ///
     /// \param windowSize Size of window
-    void initPlan(const std::uint64_t windowSize);
+    /// \param inPlace True if the output is written in the input buffer
+    /// \param real True for a r2c (forward) or c2r (backward) plan
+    /// \param batch Number of signals computed by the plan (r2c only if greater than 1)
+    void initPlan(const std::uint64_t windowSize, const bool inPlace, const bool real, const std::size_t batch);
 
     /// Free the data and the plan
     void freePlan();
 
 private:
-    static std::mutex mutexFFTW;
-    static bool alreadyInit;
-
     std::uint64_t m_windowSize;
+    bool m_inPlace;
+    bool m_real;
+    std::size_t m_batch;
+    int m_threads;
     FFTDirection m_fftSign;
-    fftw_plan m_fftPlan;
-    fftw_complex *m_inputData;
-    fftw_complex *m_outputData;
+    std::shared_ptr<typename FFTWTypes<R>::Plan> m_fftPlan;
+    typename FFTWTypes<R>::Complex *m_inputData;
+    typename FFTWTypes<R>::Complex *m_outputData;
+    R *m_realData;
 };
 
+/// Double precision FFT
+typedef BasicWrapperFFTW<double> WrapperFFTW;
+
+/// Single precision FFT
+typedef BasicWrapperFFTW<float> WrapperFFTWF;
+
 #endif // WRAPPER_FFTW_H
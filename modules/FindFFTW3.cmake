@@ -4,7 +4,7 @@
 # Find the native FFTW includes and library
 #
 #  FFTW_INCLUDES    - where to find fftw3.h
-#  FFTW_LIBRARIES   - List of libraries when using FFTW.
+#  FFTW_LIBRARIES   - List of libraries when using FFTW (double and float).
 #  FFTW_FOUND       - True if FFTW found.
 
 if (FFTW_INCLUDES)
@@ -18,11 +18,15 @@ find_path (FFTW_INCLUDES fftw3.h)
 find_library (FFTW_CORE NAMES fftw3)
 find_library (FFTW_THREADS NAMES fftw3_threads)
 
-list(INSERT FFTW_LIBRARIES 0 ${FFTW_CORE} ${FFTW_THREADS})
+# Get the single precision core and threads library
+find_library (FFTWF_CORE NAMES fftw3f)
+find_library (FFTWF_THREADS NAMES fftw3f_threads)
+
+list(INSERT FFTW_LIBRARIES 0 ${FFTW_CORE} ${FFTW_THREADS} ${FFTWF_CORE} ${FFTWF_THREADS})
 
 # handle the QUIETLY and REQUIRED arguments and set FFTW_FOUND to TRUE if
 # all listed variables are TRUE
 include (FindPackageHandleStandardArgs)
-find_package_handle_standard_args(FFTW DEFAULT_MSG FFTW_LIBRARIES FFTW_INCLUDES)
+find_package_handle_standard_args(FFTW DEFAULT_MSG FFTW_LIBRARIES FFTW_INCLUDES FFTW_CORE FFTW_THREADS FFTWF_CORE FFTWF_THREADS)
 
 mark_as_advanced (FFTW_LIBRARIES FFTW_INCLUDES)
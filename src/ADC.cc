@@ -37,10 +37,9 @@ void ADC::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert(m_inputChannels[0] != nullptr && "ADC: No input task is connected");
 
-    std::vector<double> noiseValues(N);
-    std::vector<double> outValues(N);
-
-    m_inputChannels[0]->receive(noiseValues, N);
+    // Work directly in the channel windows
+    const double *noiseValues = m_inputChannels[0]->peek<double>(N);
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
 
     const double STEP = 2.0 * M_PI * m_FC * (1.0 / m_FS) / m_indexStep;
     for (std::size_t i = 0; i < N; ++i) {
@@ -52,7 +51,8 @@ void ADC::compute(const std::uint64_t N) {
         outValues[i] = signal;
     }
 
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<double>(N);
+    m_inputChannels[0]->release<double>(N);
 }
 
 bool ADC::isReady(const std::uint64_t N) const {
@@ -17,10 +17,28 @@
 
 #include <dsps/Abs.h>
 
-#include <cmath>
 #include <complex>
 
 #include <dsps/Channel.h>
+#include <dsps/Simd.h>
+
+namespace {
+    void absValues(const double *inValues, double *outValues, const std::size_t N) {
+        DSP::Simd::abs(inValues, outValues, N);
+    }
+
+    void absValues(const float *inValues, float *outValues, const std::size_t N) {
+        DSP::Simd::abs(inValues, outValues, N);
+    }
+
+    void absValues(const std::complex<double> *inValues, double *outValues, const std::size_t N) {
+        DSP::Simd::magnitude(inValues, outValues, N);
+    }
+
+    void absValues(const std::complex<float> *inValues, float *outValues, const std::size_t N) {
+        DSP::Simd::magnitude(inValues, outValues, N);
+    }
+}
 
 template<typename InputType, typename OutputType>
 Abs<InputType, OutputType>::Abs()
@@ -36,16 +54,14 @@ void Abs<InputType, OutputType>::compute(const std::uint64_t N) {
     Channel &in = *m_inputChannels[0];
     Channel &out = m_outputChannels[0];
 
-    std::vector<InputType> inValues(N);
-    std::vector<OutputType> outValues(N);
+    // Work directly in the channel windows
+    const InputType *inValues = in.peek<InputType>(N);
+    OutputType *outValues = out.acquireWrite<OutputType>(N);
 
-    in.receive(inValues, N);
+    computeElementwise(inValues, outValues, N);
 
-    for (std::size_t i = 0; i < N; ++i) {
-        outValues[i] = std::abs(inValues[i]);
-    }
-
-    out.send(outValues);
+    out.commit<OutputType>(N);
+    in.release<InputType>(N);
 }
 
 template<typename InputType, typename OutputType>
@@ -61,6 +77,16 @@ bool Abs<InputType, OutputType>::hasFinished(const std::uint64_t N) const {
     return m_outputChannels[0].size(sizeof(OutputType)) >= N;
 }
 
+template<typename InputType, typename OutputType>
+bool Abs<InputType, OutputType>::isElementwise() const {
+    return true;
+}
+
+template<typename InputType, typename OutputType>
+void Abs<InputType, OutputType>::computeElementwise(const void *inValues, void *outValues, const std::size_t size) const {
+    absValues(static_cast<const InputType*>(inValues), static_cast<OutputType*>(outValues), size);
+}
+
 template class Abs<double, double>;
 template class Abs<float, float>;
 template class Abs<std::complex<double>, double>;
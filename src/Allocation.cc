@@ -0,0 +1,63 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#include <dsps/Allocation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+    std::atomic<std::uint64_t> numberAllocations(0);
+    std::atomic<std::uint64_t> allocatedBytes(0);
+}
+
+void *DSP::Allocation::allocateAligned(const std::size_t size, const std::size_t alignment) {
+    assert((alignment & (alignment - 1)) == 0 && "Allocation: The alignment must be a power of two");
+
+    void *data = nullptr;
+    if (posix_memalign(&data, std::max(alignment, sizeof(void*)), size == 0 ? 1 : size) != 0) {
+        std::cerr << "DSP::Allocation::allocateAligned(): " << size << " bytes weren't allocated" << std::endl;
+        std::exit(-1);
+    }
+
+    record(size);
+    return data;
+}
+
+void DSP::Allocation::deallocateAligned(void *data) {
+    std::free(data);
+}
+
+void DSP::Allocation::record(const std::size_t size) {
+    numberAllocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+std::uint64_t DSP::Allocation::countAllocations() {
+    return numberAllocations.load(std::memory_order_relaxed);
+}
+
+std::uint64_t DSP::Allocation::countAllocatedBytes() {
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+void DSP::Allocation::resetCounters() {
+    numberAllocations.store(0, std::memory_order_relaxed);
+    allocatedBytes.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,265 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/Allocator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+#include <sys/mman.h>
+
+#include <dsps/Utils.h>
+
+#ifdef DSPS_HAVE_NUMA
+#include <numa.h>
+#include <sched.h>
+#endif
+
+namespace {
+    class DefaultAllocator: public DSP::Allocator {
+    public:
+        virtual void *allocate(const std::size_t size) override {
+            return DSP::Allocation::allocateAligned(size);
+        }
+
+        virtual void deallocate(void *data, const std::size_t size) override {
+            USELESS_PARAMETER(size);
+            DSP::Allocation::deallocateAligned(data);
+        }
+    };
+
+    std::size_t roundUp(const std::size_t size, const std::size_t alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+}
+
+DSP::Allocator& DSP::Allocator::getDefault() {
+    // Never destroyed: the channels of static objects can be freed after the exit
+    static Allocator *allocator = new DefaultAllocator;
+    return *allocator;
+}
+
+DSP::AlignedPool::AlignedPool(bool hugePages)
+: m_hugePages(hugePages) {
+}
+
+DSP::AlignedPool::~AlignedPool() {
+    trim();
+}
+
+void *DSP::AlignedPool::allocate(const std::size_t size) {
+    const std::size_t rounded = roundSize(size);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_freeBuffers.find(rounded);
+        if (it != m_freeBuffers.end() && !it->second.empty()) {
+            void *data = it->second.back();
+            it->second.pop_back();
+            return data;
+        }
+    }
+
+    if (rounded < HugePageSize) {
+        return Allocation::allocateAligned(rounded);
+    }
+
+    // The advice is only a hint, a refusal of kernel isn't an error
+    void *data = Allocation::allocateAligned(rounded, HugePageSize);
+#ifdef MADV_HUGEPAGE
+    if (m_hugePages) {
+        madvise(data, rounded, MADV_HUGEPAGE);
+    }
+#endif
+
+    return data;
+}
+
+void DSP::AlignedPool::deallocate(void *data, const std::size_t size) {
+    if (data == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_freeBuffers[roundSize(size)].push_back(data);
+}
+
+void DSP::AlignedPool::trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &freeBuffers: m_freeBuffers) {
+        for (void *data: freeBuffers.second) {
+            Allocation::deallocateAligned(data);
+        }
+    }
+    m_freeBuffers.clear();
+}
+
+std::size_t DSP::AlignedPool::countCachedBuffers() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::size_t count = 0;
+    for (const auto &freeBuffers: m_freeBuffers) {
+        count += freeBuffers.second.size();
+    }
+
+    return count;
+}
+
+std::size_t DSP::AlignedPool::roundSize(const std::size_t size) {
+    if (size >= HugePageSize) {
+        return roundUp(size, HugePageSize);
+    }
+
+    std::size_t rounded = Allocation::CacheLineSize;
+    while (rounded < size) {
+        rounded *= 2;
+    }
+
+    return rounded;
+}
+
+DSP::ArenaAllocator::ArenaAllocator(const std::size_t chunkSize, Allocator &upstream)
+: m_chunkSize(roundUp(std::max<std::size_t>(chunkSize, 1), Allocation::CacheLineSize))
+, m_upstream(upstream)
+, m_offset(0)
+, m_usedBytes(0) {
+}
+
+DSP::ArenaAllocator::~ArenaAllocator() {
+    release();
+}
+
+void *DSP::ArenaAllocator::allocate(const std::size_t size) {
+    const std::size_t rounded = roundUp(std::max<std::size_t>(size, 1), Allocation::CacheLineSize);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // A new chunk is needed, the end of current one is lost
+    if (m_chunks.empty() || m_offset + rounded > m_chunks.back().size) {
+        const std::size_t chunkSize = std::max(m_chunkSize, rounded);
+        m_chunks.push_back(Chunk{ m_upstream.allocate(chunkSize), chunkSize });
+        m_offset = 0;
+    }
+
+    void *data = static_cast<char*>(m_chunks.back().data) + m_offset;
+    m_offset += rounded;
+    m_usedBytes += rounded;
+
+    return data;
+}
+
+void DSP::ArenaAllocator::deallocate(void *data, const std::size_t size) {
+    USELESS_PARAMETER(data);
+    USELESS_PARAMETER(size);
+}
+
+void DSP::ArenaAllocator::release() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Chunk &chunk: m_chunks) {
+        m_upstream.deallocate(chunk.data, chunk.size);
+    }
+    m_chunks.clear();
+    m_offset = 0;
+    m_usedBytes = 0;
+}
+
+std::size_t DSP::ArenaAllocator::getUsedBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usedBytes;
+}
+
+std::size_t DSP::ArenaAllocator::countChunks() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_chunks.size();
+}
+
+DSP::NumaAllocator::NumaAllocator(const int node)
+: m_node(node)
+, m_bound(isAvailable()) {
+    assert(m_node >= 0 && "NumaAllocator: The node must be positive");
+#ifdef DSPS_HAVE_NUMA
+    if (m_bound && m_node > numa_max_node()) {
+        std::cerr << "DSP::NumaAllocator::NumaAllocator(): The node " << m_node << " doesn't exist" << std::endl;
+        std::exit(-1);
+    }
+#endif
+}
+
+void *DSP::NumaAllocator::allocate(const std::size_t size) {
+#ifdef DSPS_HAVE_NUMA
+    if (m_bound) {
+        // Mapped pages bound to the node, so aligned on a page
+        void *data = numa_alloc_onnode(std::max<std::size_t>(size, 1), m_node);
+        if (data == nullptr) {
+            std::cerr << "DSP::NumaAllocator::allocate(): " << size << " bytes weren't allocated on the node " << m_node << std::endl;
+            std::exit(-1);
+        }
+
+        Allocation::record(size);
+        return data;
+    }
+#endif
+
+    return Allocation::allocateAligned(size);
+}
+
+void DSP::NumaAllocator::deallocate(void *data, const std::size_t size) {
+    if (data == nullptr) {
+        return;
+    }
+
+#ifdef DSPS_HAVE_NUMA
+    if (m_bound) {
+        numa_free(data, std::max<std::size_t>(size, 1));
+        return;
+    }
+#endif
+
+    USELESS_PARAMETER(size);
+    Allocation::deallocateAligned(data);
+}
+
+int DSP::NumaAllocator::getNode() const {
+    return m_node;
+}
+
+bool DSP::NumaAllocator::isBound() const {
+    return m_bound;
+}
+
+bool DSP::NumaAllocator::isAvailable() {
+#ifdef DSPS_HAVE_NUMA
+    return numa_available() >= 0;
+#else
+    return false;
+#endif
+}
+
+int DSP::NumaAllocator::getCurrentNode() {
+#ifdef DSPS_HAVE_NUMA
+    if (isAvailable()) {
+        const int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            return std::max(numa_node_of_cpu(cpu), 0);
+        }
+    }
+#endif
+
+    return 0;
+}
@@ -17,9 +17,8 @@
 
 #include <dsps/Atan2.h>
 
-#include <cmath>
-
 #include <dsps/Channel.h>
+#include <dsps/Simd.h>
 
 Atan2::Atan2()
 : Task(ChannelType::Double, 2, ChannelType::Double, 1) {
@@ -29,18 +28,16 @@ void Atan2::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert((m_inputChannels[0] != nullptr && m_inputChannels[1] != nullptr) && "Atan2: No input task is connected");
 
-    std::vector<double> in1Values(N);
-    std::vector<double> in2Values(N);
-    std::vector<double> outValues(N);
-
-    m_inputChannels[0]->receive(in1Values, N);
-    m_inputChannels[1]->receive(in2Values, N);
+    // Work directly in the channel windows
+    const double *in1Values = m_inputChannels[0]->peek<double>(N);
+    const double *in2Values = m_inputChannels[1]->peek<double>(N);
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
 
-    for (std::size_t i = 0; i < N; ++i) {
-        outValues[i] = std::atan2(in1Values[i], in2Values[i]);
-    }
+    DSP::Simd::atan2(in1Values, in2Values, outValues, N);
 
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<double>(N);
+    m_inputChannels[0]->release<double>(N);
+    m_inputChannels[1]->release<double>(N);
 }
 
 bool Atan2::isReady(const std::uint64_t N) const {
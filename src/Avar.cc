@@ -14,19 +14,324 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>
  */
-
 #include <dsps/Avar.h>
 
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <dsps/TextParser.h>
+
+namespace {
+    // The squared terms are summed by blocks to limit the rounding errors of long records
+    constexpr std::uint64_t SumBlockSize = 4096;
+
+    template<typename Term>
+    double sumSquares(std::uint64_t count, Term term) {
+        double sum = 0.0;
+        for (std::uint64_t begin = 0; begin < count; begin += SumBlockSize) {
+            const std::uint64_t end = std::min(count, begin + SumBlockSize);
+            double block = 0.0;
+            for (std::uint64_t i = begin; i < end; ++i) {
+                const double value = term(i);
+                block += value * value;
+            }
+            sum += block;
+        }
+
+        return sum;
+    }
+}
+
+constexpr std::uint64_t Avar::DefaultMaxFactor;
+
+Avar::Avar(double tau0, double phaseScale, std::uint64_t maxFactor)
+: m_tau0(tau0)
+, m_phaseScale(phaseScale)
+, m_maxFactor(maxFactor)
+, m_count(0)
+, m_streaming(false)
+, m_historyMask(0) {
+    assert(tau0 > 0.0 && "Avar: The sampling period must be positive");
+    assert(maxFactor >= 1 && "Avar: The largest averaging factor must be at least 1");
+
+    initAccumulators();
+}
+
+void Avar::compute(const std::vector<double> &data, unsigned numThreads) {
+    compute(data.data(), data.size(), numThreads);
+}
+
+void Avar::compute(const double *data, std::uint64_t size, unsigned numThreads) {
+    initAccumulators();
+    m_count = size;
+    m_streaming = false;
+    std::vector<double>().swap(m_history);
+
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = std::min<std::uint64_t>(numThreads, m_accumulators.size());
+
+    // Each factor costs O(n), the threads take the next one until the end
+    std::atomic<std::size_t> next(0);
+    auto worker = [this, data, size, &next]() {
+        for (std::size_t index = next++; index < m_accumulators.size(); index = next++) {
+            computeFactor(data, size, m_accumulators[index]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < numThreads; ++i) {
+        threads.push_back(std::thread(worker));
+    }
+    worker();
+
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+}
+
+void Avar::compute(const std::string &dataFile, bool binary, unsigned numThreads) {
+    int fd = open(dataFile.c_str(), O_RDONLY);
+    if (fd == -1) {
+        std::cerr << "Avar::compute(): The file '" << dataFile << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        std::cerr << "Avar::compute(): The size of file '" << dataFile << "' is unknown: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    const std::size_t size = status.st_size;
+    if (size == 0) {
+        close(fd);
+        compute(nullptr, 0, numThreads);
+        return;
+    }
+
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Avar::compute(): The file '" << dataFile << "' wasn't mapped: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+    madvise(mapping, size, MADV_WILLNEED);
+
+    if (binary) {
+        compute(static_cast<const double*>(mapping), size / sizeof(double), numThreads);
+    }
+    else {
+        const char *text = static_cast<const char*>(mapping);
+        compute(TextParser::parseAll<double>(text, text + size, numThreads), numThreads);
+    }
+
+    munmap(mapping, size);
+    close(fd);
+}
+
+void Avar::push(const double *data, std::uint64_t size) {
+    // The history keeps the phases up to 3 maxFactor samples in the past
+    if (!m_streaming) {
+        reset();
+
+        std::uint64_t historySize = 1;
+        while (historySize < 3 * m_maxFactor + 1) {
+            historySize *= 2;
+        }
+        m_history.assign(historySize, 0.0);
+        m_historyMask = historySize - 1;
+        m_streaming = true;
+    }
+
+    for (std::uint64_t s = 0; s < size; ++s) {
+        const std::uint64_t k = m_count;
+        const double x = data[s];
+        m_history[k & m_historyMask] = x;
+
+        // The accumulators are sorted by factor
+        for (Accumulator &accumulator: m_accumulators) {
+            const std::uint64_t m = accumulator.factor;
+            if (k < 2 * m) {
+                break;
+            }
 
-void Avar::getResult() const {
-    return m_result;
+            const double x1 = getPhase(k - m);
+            const double x2 = getPhase(k - 2 * m);
+            const double difference = x - 2.0 * x1 + x2;
+            accumulator.allanSum += difference * difference;
+            ++accumulator.allanCount;
+
+            // The window of second differences slides by one
+            double increment = difference;
+            if (k >= 3 * m) {
+                const double x3 = getPhase(k - 3 * m);
+                const double hadamard = x - 3.0 * x1 + 3.0 * x2 - x3;
+                accumulator.hadamardSum += hadamard * hadamard;
+                ++accumulator.hadamardCount;
+
+                increment -= x1 - 2.0 * x2 + x3;
+            }
+
+            const double y = increment - accumulator.windowCompensation;
+            const double t = accumulator.window + y;
+            accumulator.windowCompensation = (t - accumulator.window) - y;
+            accumulator.window = t;
+
+            if (k + 1 >= 3 * m) {
+                accumulator.modifiedSum += accumulator.window * accumulator.window;
+                ++accumulator.modifiedCount;
+            }
+        }
+
+        ++m_count;
+    }
+}
+
+void Avar::reset() {
+    initAccumulators();
+    m_count = 0;
+    m_streaming = false;
+    std::vector<double>().swap(m_history);
+    m_historyMask = 0;
+}
+
+std::vector<double> Avar::getTaus() const {
+    std::vector<double> taus;
+    for (const Accumulator &accumulator: m_accumulators) {
+        if (accumulator.allanCount > 0) {
+            taus.push_back(accumulator.factor * m_tau0);
+        }
+    }
+
+    return taus;
+}
+
+std::vector<double> Avar::getResult(Deviation deviation) const {
+    std::vector<double> result;
+    for (const Accumulator &accumulator: m_accumulators) {
+        if (accumulator.allanCount == 0) {
+            break;
+        }
+
+        const double m = static_cast<double>(accumulator.factor);
+        const double tau2 = m * m * m_tau0 * m_tau0;
+        double variance = std::numeric_limits<double>::quiet_NaN();
+        switch (deviation) {
+            case Deviation::Allan:
+                variance = accumulator.allanSum / (2.0 * tau2 * accumulator.allanCount);
+                break;
+
+            case Deviation::Modified:
+                if (accumulator.modifiedCount > 0) {
+                    variance = accumulator.modifiedSum / (2.0 * m * m * tau2 * accumulator.modifiedCount);
+                }
+                break;
+
+            case Deviation::Hadamard:
+                if (accumulator.hadamardCount > 0) {
+                    variance = accumulator.hadamardSum / (6.0 * tau2 * accumulator.hadamardCount);
+                }
+                break;
+        }
+
+        result.push_back(std::sqrt(variance) * std::abs(m_phaseScale));
+    }
+
+    return result;
+}
+
+std::vector<std::uint64_t> Avar::countTerms(Deviation deviation) const {
+    std::vector<std::uint64_t> counts;
+    for (const Accumulator &accumulator: m_accumulators) {
+        if (accumulator.allanCount == 0) {
+            break;
+        }
+
+        switch (deviation) {
+            case Deviation::Allan:
+                counts.push_back(accumulator.allanCount);
+                break;
+
+            case Deviation::Modified:
+                counts.push_back(accumulator.modifiedCount);
+                break;
+
+            case Deviation::Hadamard:
+                counts.push_back(accumulator.hadamardCount);
+                break;
+        }
+    }
+
+    return counts;
 }
 
-void Avar::compute(const std::string &dataFile) {
+std::uint64_t Avar::countSamples() const {
+    return m_count;
+}
+
+void Avar::initAccumulators() {
+    m_accumulators.clear();
+    for (std::uint64_t m = 1; m <= m_maxFactor; m *= 2) {
+        Accumulator accumulator;
+        std::memset(&accumulator, 0, sizeof(accumulator));
+        accumulator.factor = m;
+        m_accumulators.push_back(accumulator);
+    }
+}
+
+void Avar::computeFactor(const double *x, std::uint64_t size, Accumulator &accumulator) {
+    const std::uint64_t m = accumulator.factor;
+    auto difference = [x, m](std::uint64_t i) {
+        return x[i + 2 * m] - 2.0 * x[i + m] + x[i];
+    };
+
+    if (size >= 2 * m + 1) {
+        accumulator.allanCount = size - 2 * m;
+        accumulator.allanSum = sumSquares(accumulator.allanCount, difference);
+    }
+
+    if (size >= 3 * m + 1) {
+        accumulator.hadamardCount = size - 3 * m;
+        accumulator.hadamardSum = sumSquares(accumulator.hadamardCount, [x, m](std::uint64_t i) {
+            return x[i + 3 * m] - 3.0 * x[i + 2 * m] + 3.0 * x[i + m] - x[i];
+        });
+    }
+
+    // The sum of m second differences is a difference of running sums
+    if (size >= 3 * m) {
+        double window = 0.0;
+        double compensation = 0.0;
+        for (std::uint64_t i = 0; i < m; ++i) {
+            window += difference(i);
+        }
 
+        accumulator.modifiedCount = size - 3 * m + 1;
+        accumulator.modifiedSum = sumSquares(accumulator.modifiedCount, [&](std::uint64_t j) {
+            if (j > 0) {
+                const double y = difference(j + m - 1) - difference(j - 1) - compensation;
+                const double t = window + y;
+                compensation = (t - window) - y;
+                window = t;
+            }
+            return window;
+        });
+    }
 }
 
-void Avar::compute(const std::vector<double> &data) {
-    m_result.clear();
+double Avar::getPhase(std::uint64_t index) const {
+    return m_history[index & m_historyMask];
 }
@@ -0,0 +1,78 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#include <dsps/AvarSink.h>
+
+#include <cassert>
+
+#include <dsps/Channel.h>
+
+template<typename T>
+AvarSink<T>::AvarSink(double tau0, double phaseScale, std::uint64_t maxFactor)
+: Task(getChannelType<T>(), 1, ChannelType::None, 0)
+, m_avar(tau0, phaseScale, maxFactor)
+, m_finished(false) {
+}
+
+template<typename T>
+void AvarSink<T>::compute(const std::uint64_t N) {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "AvarSink: No input task is connected");
+
+    const T *inValues = m_inputChannels[0]->peek<T>(N);
+    pushValues(inValues, N);
+    m_inputChannels[0]->release<T>(N);
+
+    m_finished = true;
+}
+
+template<typename T>
+bool AvarSink<T>::isReady(const std::uint64_t N) const {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "AvarSink: No input task is connected");
+
+    return m_inputChannels[0]->size(sizeof(T)) >= N;
+}
+
+template<typename T>
+bool AvarSink<T>::hasFinished(const std::uint64_t N) const {
+    USELESS_PARAMETER(N);
+    return m_finished;
+}
+
+template<typename T>
+const Avar &AvarSink<T>::getAvar() const {
+    return m_avar;
+}
+
+template<typename T>
+void AvarSink<T>::reset() {
+    m_avar.reset();
+}
+
+template<>
+void AvarSink<double>::pushValues(const double *values, const std::uint64_t N) {
+    m_avar.push(values, N);
+}
+
+template<typename T>
+void AvarSink<T>::pushValues(const T *values, const std::uint64_t N) {
+    m_buffer.assign(values, values + N);
+    m_avar.push(m_buffer.data(), N);
+}
+
+template class AvarSink<double>;
+template class AvarSink<float>;
@@ -0,0 +1,400 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/Capture.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+namespace {
+    const char Magic[8] = {'D', 'S', 'P', 'S', 'C', 'A', 'P', '1'};
+    constexpr std::uint32_t Version = 1;
+    constexpr std::size_t HeaderSize = 64;
+
+    // Each index entry has an offset, a stored size and flags
+    constexpr std::size_t IndexFields = 3;
+    constexpr std::uint64_t CompressedFlag = 1;
+
+    // The codes of types are stored in the file, they must not change
+    std::uint32_t typeCode(ChannelType type) {
+        switch (type) {
+        case ChannelType::Double:
+            return 0;
+        case ChannelType::ComplexDouble:
+            return 1;
+        case ChannelType::Float:
+            return 2;
+        case ChannelType::ComplexFloat:
+            return 3;
+        case ChannelType::Int64:
+            return 4;
+        case ChannelType::None:
+            break;
+        }
+
+        assert(false && "Capture: The channel type must have a value");
+        return 0;
+    }
+
+    bool typeFromCode(std::uint32_t code, ChannelType &type) {
+        const ChannelType types[] = {ChannelType::Double, ChannelType::ComplexDouble, ChannelType::Float, ChannelType::ComplexFloat, ChannelType::Int64};
+        if (code >= sizeof(types) / sizeof(types[0])) {
+            return false;
+        }
+
+        type = types[code];
+        return true;
+    }
+
+    template <typename T>
+    void store(char *header, std::size_t offset, T value) {
+        std::memcpy(header + offset, &value, sizeof(T));
+    }
+
+    template <typename T>
+    T load(const char *header, std::size_t offset) {
+        T value;
+        std::memcpy(&value, header + offset, sizeof(T));
+        return value;
+    }
+
+    void writeAll(int fd, const void *data, std::size_t size, std::uint64_t offset, const std::string &filename) {
+        const char *bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t count = pwrite(fd, bytes, size, offset);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count < 0) {
+                std::cerr << "Capture::Writer: The file '" << filename << "' wasn't written: " << std::strerror(errno) << std::endl;
+                std::exit(-1);
+            }
+
+            bytes += count;
+            size -= count;
+            offset += count;
+        }
+    }
+
+    void readAll(int fd, void *data, std::size_t size, std::uint64_t offset, const std::string &filename) {
+        char *bytes = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t count = pread(fd, bytes, size, offset);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count <= 0) {
+                std::cerr << "Capture::Reader: The file '" << filename << "' is truncated or unreadable" << std::endl;
+                std::exit(-1);
+            }
+
+            bytes += count;
+            size -= count;
+            offset += count;
+        }
+    }
+}
+
+Capture::Writer::Writer(const std::string &filename, ChannelType type, std::uint32_t channels, double sampleRate, std::uint64_t framesPerChunk, Compression compression)
+: m_filename(filename)
+, m_fd(-1)
+, m_type(type)
+, m_channels(channels)
+, m_sampleRate(sampleRate)
+, m_framesPerChunk(framesPerChunk)
+, m_compression(compression)
+, m_frameSize(sizeOfChannelType(type) * channels)
+, m_chunk(m_frameSize * framesPerChunk)
+, m_chunkFrames(0)
+, m_frames(0)
+, m_offset(HeaderSize) {
+    assert(channels > 0 && "Capture::Writer: The number of channels must be positive");
+    assert(framesPerChunk > 0 && "Capture::Writer: The number of frames by chunk must be positive");
+    assert(m_frameSize > 0 && "Capture::Writer: The channel type must have a value");
+
+    m_fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (m_fd == -1) {
+        std::cerr << "Capture::Writer::Writer(): The file '" << filename << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    // Without chunks and index, the file is known as unfinished until the close
+    writeHeader();
+}
+
+Capture::Writer::~Writer() {
+    close();
+}
+
+void Capture::Writer::write(const void *frames, std::uint64_t count) {
+    assert(m_fd != -1 && "Capture::Writer: The file is closed");
+
+    const char *bytes = static_cast<const char*>(frames);
+    while (count > 0) {
+        const std::uint64_t size = std::min(count, m_framesPerChunk - m_chunkFrames);
+        std::memcpy(m_chunk.data() + m_chunkFrames * m_frameSize, bytes, size * m_frameSize);
+
+        m_chunkFrames += size;
+        m_frames += size;
+        bytes += size * m_frameSize;
+        count -= size;
+
+        if (m_chunkFrames == m_framesPerChunk) {
+            writeChunk();
+        }
+    }
+}
+
+void Capture::Writer::close() {
+    if (m_fd == -1) {
+        return;
+    }
+
+    if (m_chunkFrames > 0) {
+        writeChunk();
+    }
+
+    // The index follows the last chunk, then the header is completed
+    writeAll(m_fd, m_index.data(), m_index.size() * sizeof(std::uint64_t), m_offset, m_filename);
+    writeHeader();
+
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+std::uint64_t Capture::Writer::countFrames() const {
+    return m_frames;
+}
+
+void Capture::Writer::writeChunk() {
+    const char *data = m_chunk.data();
+    std::uint64_t size = m_chunkFrames * m_frameSize;
+    std::uint64_t flags = 0;
+
+    // A chunk which doesn't shrink is stored raw
+    if (m_compression == Compression::Zlib) {
+        uLongf compressedSize = compressBound(size);
+        m_compressed.resize(compressedSize);
+        if (compress2(reinterpret_cast<Bytef*>(m_compressed.data()), &compressedSize, reinterpret_cast<const Bytef*>(data), size, Z_DEFAULT_COMPRESSION) == Z_OK && compressedSize < size) {
+            data = m_compressed.data();
+            size = compressedSize;
+            flags |= CompressedFlag;
+        }
+    }
+
+    writeAll(m_fd, data, size, m_offset, m_filename);
+    m_index.push_back(m_offset);
+    m_index.push_back(size);
+    m_index.push_back(flags);
+
+    m_offset += size;
+    m_chunkFrames = 0;
+}
+
+void Capture::Writer::writeHeader() {
+    char header[HeaderSize] = {};
+    std::memcpy(header, Magic, sizeof(Magic));
+    store<std::uint32_t>(header, 8, Version);
+    store<std::uint32_t>(header, 12, typeCode(m_type));
+    store<std::uint32_t>(header, 16, m_channels);
+    store<double>(header, 24, m_sampleRate);
+    store<std::uint64_t>(header, 32, m_framesPerChunk);
+    store<std::uint64_t>(header, 40, m_frames);
+    store<std::uint64_t>(header, 48, m_index.size() / IndexFields);
+    store<std::uint64_t>(header, 56, m_index.empty() ? 0 : m_offset);
+
+    writeAll(m_fd, header, HeaderSize, 0, m_filename);
+}
+
+Capture::Reader::Reader(const std::string &filename)
+: m_filename(filename)
+, m_fd(-1)
+, m_cachedChunk(0) {
+    m_fd = open(filename.c_str(), O_RDONLY);
+    if (m_fd == -1) {
+        std::cerr << "Capture::Reader::Reader(): The file '" << filename << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    char header[HeaderSize];
+    readAll(m_fd, header, HeaderSize, 0, m_filename);
+    if (std::memcmp(header, Magic, sizeof(Magic)) != 0 || load<std::uint32_t>(header, 8) != Version) {
+        std::cerr << "Capture::Reader::Reader(): The file '" << filename << "' isn't a capture" << std::endl;
+        std::exit(-1);
+    }
+
+    if (!typeFromCode(load<std::uint32_t>(header, 12), m_type)) {
+        std::cerr << "Capture::Reader::Reader(): The file '" << filename << "' has an unknown type" << std::endl;
+        std::exit(-1);
+    }
+
+    m_channels = load<std::uint32_t>(header, 16);
+    m_sampleRate = load<double>(header, 24);
+    m_framesPerChunk = load<std::uint64_t>(header, 32);
+    m_frames = load<std::uint64_t>(header, 40);
+    m_frameSize = sizeOfChannelType(m_type) * m_channels;
+
+    const std::uint64_t chunks = load<std::uint64_t>(header, 48);
+    const std::uint64_t indexOffset = load<std::uint64_t>(header, 56);
+    if (m_framesPerChunk == 0 || chunks != (m_frames + m_framesPerChunk - 1) / m_framesPerChunk || (chunks > 0 && indexOffset == 0)) {
+        std::cerr << "Capture::Reader::Reader(): The file '" << filename << "' wasn't closed" << std::endl;
+        std::exit(-1);
+    }
+
+    m_index.resize(chunks * IndexFields);
+    readAll(m_fd, m_index.data(), m_index.size() * sizeof(std::uint64_t), indexOffset, m_filename);
+
+    // No chunk is cached yet
+    m_cachedChunk = chunks;
+    m_cache.resize(m_framesPerChunk * m_frameSize);
+}
+
+Capture::Reader::~Reader() {
+    close(m_fd);
+}
+
+void Capture::Reader::read(std::uint64_t first, std::uint64_t count, void *frames, unsigned numThreads) {
+    assert(first + count <= m_frames && "Capture::Reader: The frames are after the end of file");
+
+    if (count == 0) {
+        return;
+    }
+
+    char *output = static_cast<char*>(frames);
+    const std::uint64_t firstChunk = first / m_framesPerChunk;
+    const std::uint64_t lastChunk = (first + count - 1) / m_framesPerChunk;
+
+    // The chunks read completely are decompressed in place by the threads
+    std::uint64_t beginFull = (first % m_framesPerChunk == 0) ? firstChunk : firstChunk + 1;
+    std::uint64_t endFull = ((first + count) % m_framesPerChunk == 0 || first + count == m_frames) ? lastChunk + 1 : lastChunk;
+    endFull = std::max(beginFull, endFull);
+
+    if (endFull > beginFull) {
+        if (numThreads == 0) {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        numThreads = static_cast<unsigned>(std::min<std::uint64_t>(numThreads, endFull - beginFull));
+
+        auto worker = [this, first, output, beginFull, endFull, numThreads](unsigned index) {
+            std::vector<char> scratch;
+            for (std::uint64_t chunk = beginFull + index; chunk < endFull; chunk += numThreads) {
+                loadChunk(chunk, output + (chunk * m_framesPerChunk - first) * m_frameSize, scratch);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < numThreads; ++i) {
+            threads.emplace_back(worker, i);
+        }
+        worker(0);
+
+        for (std::thread &thread: threads) {
+            thread.join();
+        }
+    }
+
+    // The partial chunks go through the cache, for the next sequential read
+    if (firstChunk < beginFull) {
+        copyFromCache(firstChunk, first, count, output);
+    }
+
+    if (lastChunk >= endFull && !(lastChunk == firstChunk && firstChunk < beginFull)) {
+        copyFromCache(lastChunk, first, count, output);
+    }
+}
+
+ChannelType Capture::Reader::getChannelType() const {
+    return m_type;
+}
+
+std::uint32_t Capture::Reader::countChannels() const {
+    return m_channels;
+}
+
+double Capture::Reader::getSampleRate() const {
+    return m_sampleRate;
+}
+
+std::uint64_t Capture::Reader::getFramesPerChunk() const {
+    return m_framesPerChunk;
+}
+
+std::uint64_t Capture::Reader::countFrames() const {
+    return m_frames;
+}
+
+std::uint64_t Capture::Reader::countChunks() const {
+    return m_index.size() / IndexFields;
+}
+
+std::uint64_t Capture::Reader::countCompressedChunks() const {
+    std::uint64_t count = 0;
+    for (std::size_t i = 0; i < m_index.size(); i += IndexFields) {
+        count += (m_index[i + 2] & CompressedFlag) ? 1 : 0;
+    }
+
+    return count;
+}
+
+void Capture::Reader::loadChunk(std::uint64_t chunk, char *output, std::vector<char> &scratch) const {
+    const std::uint64_t offset = m_index[chunk * IndexFields];
+    const std::uint64_t size = m_index[chunk * IndexFields + 1];
+    const std::uint64_t flags = m_index[chunk * IndexFields + 2];
+    const std::uint64_t rawSize = countChunkFrames(chunk) * m_frameSize;
+
+    if (!(flags & CompressedFlag)) {
+        assert(size == rawSize);
+        readAll(m_fd, output, rawSize, offset, m_filename);
+        return;
+    }
+
+    scratch.resize(size);
+    readAll(m_fd, scratch.data(), size, offset, m_filename);
+
+    uLongf outputSize = rawSize;
+    if (uncompress(reinterpret_cast<Bytef*>(output), &outputSize, reinterpret_cast<const Bytef*>(scratch.data()), size) != Z_OK || outputSize != rawSize) {
+        std::cerr << "Capture::Reader: The chunk " << chunk << " of '" << m_filename << "' is corrupted" << std::endl;
+        std::exit(-1);
+    }
+}
+
+void Capture::Reader::copyFromCache(std::uint64_t chunk, std::uint64_t first, std::uint64_t count, char *output) {
+    if (m_cachedChunk != chunk) {
+        loadChunk(chunk, m_cache.data(), m_scratch);
+        m_cachedChunk = chunk;
+    }
+
+    const std::uint64_t chunkBegin = chunk * m_framesPerChunk;
+    const std::uint64_t begin = std::max(first, chunkBegin);
+    const std::uint64_t end = std::min(first + count, chunkBegin + countChunkFrames(chunk));
+    std::memcpy(output + (begin - first) * m_frameSize, m_cache.data() + (begin - chunkBegin) * m_frameSize, (end - begin) * m_frameSize);
+}
+
+std::uint64_t Capture::Reader::countChunkFrames(std::uint64_t chunk) const {
+    return std::min(m_framesPerChunk, m_frames - chunk * m_framesPerChunk);
+}
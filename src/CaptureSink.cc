@@ -0,0 +1,87 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/CaptureSink.h>
+
+#include <cassert>
+#include <complex>
+
+template<typename T>
+CaptureSink<T>::CaptureSink(const std::string &filename, std::uint32_t channels, double sampleRate, std::uint64_t framesPerChunk, Capture::Compression compression)
+: Task(getChannelType<T>(), channels, ChannelType::None, 0)
+, m_writer(filename, getChannelType<T>(), channels, sampleRate, framesPerChunk, compression)
+, m_finished(false) {
+}
+
+template<typename T>
+void CaptureSink<T>::compute(const std::uint64_t N) {
+    const std::size_t channels = m_inputChannels.size();
+
+    // A single channel is written from the input queue
+    if (channels == 1) {
+        assert(m_inputChannels[0] != nullptr && "CaptureSink: No input task is connected");
+
+        m_writer.write(m_inputChannels[0]->peek<T>(N), N);
+        m_inputChannels[0]->release<T>(N);
+        m_finished = true;
+        return;
+    }
+
+    m_frames.resize(N * channels);
+    for (std::size_t c = 0; c < channels; ++c) {
+        assert(m_inputChannels[c] != nullptr && "CaptureSink: No input task is connected");
+
+        const T *inValues = m_inputChannels[c]->peek<T>(N);
+        for (std::uint64_t i = 0; i < N; ++i) {
+            m_frames[i * channels + c] = inValues[i];
+        }
+        m_inputChannels[c]->release<T>(N);
+    }
+
+    m_writer.write(m_frames.data(), N);
+    m_finished = true;
+}
+
+template<typename T>
+bool CaptureSink<T>::isReady(const std::uint64_t N) const {
+    for (const Channel *channel: m_inputChannels) {
+        assert(channel != nullptr && "CaptureSink: No input task is connected");
+
+        if (channel->size(sizeof(T)) < N) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename T>
+bool CaptureSink<T>::hasFinished(const std::uint64_t N) const {
+    USELESS_PARAMETER(N);
+    return m_finished;
+}
+
+template<typename T>
+void CaptureSink<T>::close() {
+    m_writer.close();
+}
+
+template class CaptureSink<double>;
+template class CaptureSink<float>;
+template class CaptureSink<std::int64_t>;
+template class CaptureSink< std::complex<double> >;
+template class CaptureSink< std::complex<float> >;
@@ -0,0 +1,138 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/CaptureSource.h>
+
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <iostream>
+
+template<typename T>
+CaptureSource<T>::CaptureSource(const std::string &filename, bool loop, unsigned numThreads)
+: CaptureSource(new Capture::Reader(filename), loop, numThreads) {
+}
+
+template<typename T>
+CaptureSource<T>::CaptureSource(Capture::Reader *reader, bool loop, unsigned numThreads)
+: Task(ChannelType::None, 0, getChannelType<T>(), reader->countChannels())
+, m_reader(reader)
+, m_loop(loop)
+, m_numThreads(numThreads)
+, m_position(0)
+, m_endOfStream(reader->countFrames() == 0) {
+    if (m_reader->getChannelType() != getChannelType<T>()) {
+        std::cerr << "CaptureSource::CaptureSource(): The type of capture doesn't match the task" << std::endl;
+        std::exit(-1);
+    }
+
+    if (m_loop && m_endOfStream) {
+        std::cerr << "CaptureSource::CaptureSource(): The capture is empty!" << std::endl;
+        std::exit(-1);
+    }
+}
+
+template<typename T>
+void CaptureSource<T>::compute(const std::uint64_t N) {
+    if (m_endOfStream) {
+        return;
+    }
+
+    const std::uint64_t frames = m_reader->countFrames();
+    if (!m_loop && m_position + N > frames) {
+        m_endOfStream = true;
+        return;
+    }
+
+    // A single channel is read in place
+    const std::size_t channels = m_outputChannels.size();
+    T *values = nullptr;
+    if (channels == 1) {
+        values = m_outputChannels[0].acquireWrite<T>(N);
+    }
+    else {
+        m_frames.resize(N * channels);
+        values = m_frames.data();
+    }
+
+    // Read the window, wrapping at the end of capture
+    std::uint64_t done = 0;
+    while (done < N) {
+        const std::uint64_t count = std::min(N - done, frames - m_position);
+        m_reader->read(m_position, count, values + done * channels, m_numThreads);
+        done += count;
+        m_position = (m_position + count) % frames;
+    }
+
+    if (channels == 1) {
+        m_outputChannels[0].commit<T>(N);
+    }
+    else {
+        for (std::size_t c = 0; c < channels; ++c) {
+            T *outValues = m_outputChannels[c].acquireWrite<T>(N);
+            for (std::uint64_t i = 0; i < N; ++i) {
+                outValues[i] = m_frames[i * channels + c];
+            }
+            m_outputChannels[c].commit<T>(N);
+        }
+    }
+
+    if (!m_loop && m_position == 0) {
+        m_endOfStream = true;
+    }
+}
+
+template<typename T>
+bool CaptureSource<T>::isReady(const std::uint64_t N) const {
+    USELESS_PARAMETER(N);
+
+    return !m_endOfStream;
+}
+
+template<typename T>
+bool CaptureSource<T>::hasFinished(const std::uint64_t N) const {
+    return m_outputChannels[0].size(sizeof(T)) >= N;
+}
+
+template<typename T>
+void CaptureSource<T>::seek(std::uint64_t frame) {
+    assert(frame < m_reader->countFrames() && "CaptureSource: The frame is after the end of capture");
+
+    m_position = frame;
+    m_endOfStream = false;
+}
+
+template<typename T>
+std::uint64_t CaptureSource<T>::getPosition() const {
+    return m_position;
+}
+
+template<typename T>
+bool CaptureSource<T>::isEndOfStream() const {
+    return m_endOfStream;
+}
+
+template<typename T>
+const Capture::Reader &CaptureSource<T>::getReader() const {
+    return *m_reader;
+}
+
+template class CaptureSource<double>;
+template class CaptureSource<float>;
+template class CaptureSource<std::int64_t>;
+template class CaptureSource< std::complex<double> >;
+template class CaptureSource< std::complex<float> >;
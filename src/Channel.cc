@@ -17,9 +17,15 @@
 
 #include <dsps/Channel.h>
 
+#include <algorithm>
+#include <complex>
+
 Channel::Channel()
 : m_inputTask(nullptr)
-, m_outputTask(nullptr) {
+, m_outputTask(nullptr)
+, m_borrower(std::thread::id())
+, m_pending(0)
+, m_ringGrow(0) {
 
 }
 
@@ -31,7 +37,111 @@ Channel::Channel()
 // }
 
 std::size_t Channel::size(const std::size_t dataSize) const {
-    return m_data.size() / dataSize;
+    if (m_ring) {
+        return m_ring->size() / dataSize;
+    }
+
+    // Updated under the lock, a borrowed queue doesn't block the caller
+    return m_pending.load(std::memory_order_acquire) / dataSize;
+}
+
+void Channel::reserve(const std::size_t length, const std::size_t dataSize) {
+    if (m_ring) {
+        if (m_ring->capacity() < length * dataSize) {
+            setRingBuffer(length * dataSize, m_ring->getWaitMode());
+        }
+        return;
+    }
+
+    assertNotBorrowed();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_data.reserve(length * dataSize);
+}
+
+std::size_t Channel::capacity(const std::size_t dataSize) const {
+    if (m_ring) {
+        return m_ring->capacity() / dataSize;
+    }
+
+    assertNotBorrowed();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_data.capacity() / dataSize;
+}
+
+void Channel::setShrinkEnabled(bool enabled) {
+    assertNotBorrowed();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_data.setShrinkEnabled(enabled);
+}
+
+void Channel::setAllocator(DSP::Allocator &allocator) {
+    assertNotBorrowed();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_data.setAllocator(allocator);
+}
+
+std::uint64_t Channel::countGrow() const {
+    assertNotBorrowed();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_data.countGrow() + m_ringGrow;
+}
+
+std::uint64_t Channel::countShrink() const {
+    assertNotBorrowed();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_data.countShrink();
+}
+
+void Channel::setRingBuffer(const std::size_t capacity, SpscRing::WaitMode mode) {
+    // Move the pending data into the new ring
+    const std::size_t pending = size(1);
+    std::vector<std::uint8_t> data(pending);
+    if (m_ring) {
+        m_ring->pop(data.data(), pending);
+    }
+    else {
+        m_data.pop(data.data(), pending);
+        m_pending.store(0, std::memory_order_release);
+    }
+
+    // Reuse the idle ring if it is big enough
+    const std::size_t CAPACITY = std::max(capacity, pending);
+    if (m_idleRing && m_idleRing->capacity() >= CAPACITY && m_idleRing->getWaitMode() == mode) {
+        m_ring = std::move(m_idleRing);
+    }
+    else {
+        if (m_ring || m_idleRing) {
+            ++m_ringGrow;
+        }
+        m_ring.reset(new SpscRing(CAPACITY, mode));
+    }
+    m_idleRing.reset();
+    m_ring->push(data.data(), pending);
+}
+
+void Channel::setQueueBuffer() {
+    if (!m_ring) {
+        return;
+    }
+
+    // Move the pending data into the queue
+    const std::size_t pending = m_ring->size();
+    std::vector<std::uint8_t> data(pending);
+    m_ring->pop(data.data(), pending);
+
+    m_idleRing = std::move(m_ring);
+    assertNotBorrowed();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_data.push(data.data(), pending);
+    m_pending.store(m_data.size(), std::memory_order_release);
+}
+
+std::size_t Channel::getRingCapacity() const {
+    if (m_ring) {
+        return m_ring->capacity();
+    }
+
+    return 0;
 }
 
 Task* Channel::getIn() const {
@@ -55,3 +165,22 @@ void Channel::setOut(Task *task) {
 
     m_outputTask = task;
 }
+
+std::size_t sizeOfChannelType(ChannelType type) {
+    switch (type) {
+    case ChannelType::Double:
+        return sizeof(double);
+    case ChannelType::ComplexDouble:
+        return sizeof(std::complex<double>);
+    case ChannelType::Float:
+        return sizeof(float);
+    case ChannelType::ComplexFloat:
+        return sizeof(std::complex<float>);
+    case ChannelType::Int64:
+        return sizeof(std::int64_t);
+    case ChannelType::None:
+        break;
+    }
+
+    return 0;
+}
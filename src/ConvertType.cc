@@ -21,6 +21,7 @@
 #include <iostream>
 
 #include <dsps/Channel.h>
+#include <dsps/Simd.h>
 #include <dsps/Utils.h>
 
 template <typename InputType, typename OutputType>
@@ -54,11 +55,42 @@ void ConvertType<InputType, OutputType>::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert(m_inputChannels[0] != nullptr && "ConvertType: No input task is connected");
 
-    std::vector<InputType> inValues(N);
-    std::vector<OutputType> outValues(N);
+    // Work directly in the channel windows
+    const InputType *inValues = m_inputChannels[0]->peek<InputType>(N);
+    OutputType *outValues = m_outputChannels[0].acquireWrite<OutputType>(N);
 
-    m_inputChannels[0]->receive(inValues, N);
+    computeElementwise(inValues, outValues, N);
 
+    m_outputChannels[0].commit<OutputType>(N);
+    m_inputChannels[0]->release<InputType>(N);
+}
+
+template <typename InputType, typename OutputType>
+bool ConvertType<InputType, OutputType>::isReady(const std::uint64_t N) const {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "ConvertType: No input task is connected");
+
+    return m_inputChannels[0]->size(sizeof(InputType)) >= N;
+}
+
+template <typename InputType, typename OutputType>
+bool ConvertType<InputType, OutputType>::hasFinished(const std::uint64_t N) const {
+
+    return m_outputChannels[0].size(sizeof(OutputType)) >= N;
+}
+
+template <typename InputType, typename OutputType>
+bool ConvertType<InputType, OutputType>::isElementwise() const {
+    return true;
+}
+
+template <typename InputType, typename OutputType>
+void ConvertType<InputType, OutputType>::computeElementwise(const void *inValues, void *outValues, const std::size_t size) const {
+    convert(static_cast<const InputType*>(inValues), static_cast<OutputType*>(outValues), size);
+}
+
+template <typename InputType, typename OutputType>
+void ConvertType<InputType, OutputType>::convert(const InputType *inValues, OutputType *outValues, const std::uint64_t N) const {
     for (std::size_t i = 0; i < N; ++i) {
         InputType value = inValues[i];
 
@@ -74,22 +106,21 @@ void ConvertType<InputType, OutputType>::compute(const std::uint64_t N) {
         // Cast and send the value
         outValues[i] = static_cast<OutputType>(value);
     }
-
-    m_outputChannels[0].send(outValues);
 }
 
-template <typename InputType, typename OutputType>
-bool ConvertType<InputType, OutputType>::isReady(const std::uint64_t N) const {
-    // Check if the input task is connected
-    assert(m_inputChannels[0] != nullptr && "ConvertType: No input task is connected");
-
-    return m_inputChannels[0]->size(sizeof(InputType)) >= N;
+template <>
+void ConvertType<double, std::int64_t>::convert(const double *inValues, std::int64_t *outValues, const std::uint64_t N) const {
+    DSP::Simd::quantize(inValues, static_cast<double>(m_POWER_NOB), 1 / m_MAX_VALUE, outValues, N);
 }
 
-template <typename InputType, typename OutputType>
-bool ConvertType<InputType, OutputType>::hasFinished(const std::uint64_t N) const {
+template <>
+void ConvertType<float, std::int64_t>::convert(const float *inValues, std::int64_t *outValues, const std::uint64_t N) const {
+    DSP::Simd::quantize(inValues, static_cast<float>(m_POWER_NOB), 1 / m_MAX_VALUE, outValues, N);
+}
 
-    return m_outputChannels[0].size(sizeof(OutputType)) >= N;
+template <>
+void ConvertType<std::int64_t, double>::convert(const std::int64_t *inValues, double *outValues, const std::uint64_t N) const {
+    DSP::Simd::convert(inValues, outValues, N);
 }
 
 template class ConvertType<double, std::int64_t>;
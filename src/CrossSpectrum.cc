@@ -17,6 +17,7 @@
 
 #include <dsps/CrossSpectrum.h>
 
+#include <algorithm>
 #include <complex>
 
 #include <dsps/Channel.h>
@@ -29,34 +30,19 @@ void CrossSpectrum::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert((m_inputChannels[0] != nullptr && m_inputChannels[1] != nullptr) && "CrossSpectrum: No input task is connected");
 
-    std::vector< std::complex<double> > in1Values(N);
-    std::vector< std::complex<double> > in2Values(N);
-    std::vector<double> outValues(N);
+    const std::complex<double> *in1Values = m_inputChannels[0]->peek< std::complex<double> >(N);
+    const std::complex<double> *in2Values = m_inputChannels[1]->peek< std::complex<double> >(N);
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
 
-    m_inputChannels[0]->receive(in1Values, N);
-    m_inputChannels[1]->receive(in2Values, N);
-
-    // Compute the data
-    for (std::size_t i = 0; i < N; ++i) {
-        std::complex<double> tmp1 = in1Values[i];
-        std::complex<double> tmp2 = in2Values[i];
-
-        double a = tmp1.real();
-        double b = tmp1.imag();
-        double c = tmp2.real();
-        double d = tmp2.imag();
-
-        if (i < N/2) {
-            // Compute the data
-            outValues[i] = a * c + b * d;
-        }
-        else {
-            // 0 padding
-            outValues[i] = 0.0;
-        }
+    // Only the lower half of spectra is computed, the upper half is 0 padding
+    for (std::size_t i = 0; i < N / 2; ++i) {
+        outValues[i] = in1Values[i].real() * in2Values[i].real() + in1Values[i].imag() * in2Values[i].imag();
     }
+    std::fill(outValues + N / 2, outValues + N, 0.0);
 
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<double>(N);
+    m_inputChannels[1]->release< std::complex<double> >(N);
+    m_inputChannels[0]->release< std::complex<double> >(N);
 }
 
 bool CrossSpectrum::isReady(const std::uint64_t N) const {
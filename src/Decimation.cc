@@ -30,17 +30,16 @@ void Decimation::compute(const std::uint64_t N) {
 
     // Get the input data
     const std::uint64_t LIMIT = N * m_decimationFactor;
-    std::vector<double> inValues(LIMIT);
-    std::vector<double> outValues(N);
-
-    m_inputChannels[0]->receive(inValues, LIMIT);
+    const double *inValues = m_inputChannels[0]->peek<double>(LIMIT);
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
 
     // Decim the flux
     for (std::size_t i = 0, j = 0; i < LIMIT; i += m_decimationFactor, ++j) {
         outValues[j] = inValues[i];
     }
 
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<double>(N);
+    m_inputChannels[0]->release<double>(LIMIT);
 }
 
 bool Decimation::isReady(const std::uint64_t N) const {
@@ -53,3 +52,8 @@ bool Decimation::isReady(const std::uint64_t N) const {
 bool Decimation::hasFinished(const std::uint64_t N) const {
     return m_outputChannels[0].size(sizeof(double)) >= N;
 }
+
+std::uint64_t Decimation::getInputRate(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    return N * m_decimationFactor;
+}
@@ -43,11 +43,10 @@ void Demodulation::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert(m_inputChannels[0] != nullptr && "Demodulation: No input task is connected");
 
-    std::vector<double> inValues(N);
-    std::vector<double> iValues(N);
-    std::vector<double> qValues(N);
-
-    m_inputChannels[0]->receive(inValues, N);
+    // Work directly in the channel windows
+    const double *inValues = m_inputChannels[0]->peek<double>(N);
+    double *iValues = m_outputChannels[0].acquireWrite<double>(N);
+    double *qValues = m_outputChannels[1].acquireWrite<double>(N);
 
     for (std::size_t i = 0; i < N; ++i) {
         double tmp = inValues[i];
@@ -57,8 +56,9 @@ void Demodulation::compute(const std::uint64_t N) {
         m_index = (m_index + m_indexStep) % m_LUT_SIZE;
     }
 
-    m_outputChannels[0].send(iValues);
-    m_outputChannels[1].send(qValues);
+    m_outputChannels[0].commit<double>(N);
+    m_outputChannels[1].commit<double>(N);
+    m_inputChannels[0]->release<double>(N);
 }
 
 bool Demodulation::isReady(const std::uint64_t N) const {
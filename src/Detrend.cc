@@ -43,23 +43,21 @@ void Detrend::compute(const std::uint64_t N) {
     // Init the reglin if needed
     if (m_currentWindowSize != N) {
         m_currentWindowSize = N;
+        initLinReg();
     }
 
-    initLinReg();
-
     // Get the values
-    std::vector<double> values(N);
-    m_inputChannels[0]->receive(values, N);
+    const double *values = m_inputChannels[0]->peek<double>(N);
 
     double a = 0.0;
     double b = 0.0;
 
-    reg_lin(&a, &b, values.data(), m_xMxB.data(), N, m_xBarre, N, m_xSquare);
+    reg_lin(&a, &b, values, m_xMxB.data(), N, m_xBarre, N, m_xSquare);
 
     // If a output compensation is avaible
     if (m_outputChannels.size() == 2) {
         const double STEP = 1 / m_fs;
-        std::vector<double> valuesComp(N);
+        double *valuesComp = m_outputChannels[1].acquireWrite<double>(N);
 
         for (std::size_t i = 0; i < N; ++i) {
 
@@ -67,14 +65,16 @@ void Detrend::compute(const std::uint64_t N) {
             ++ m_currentIndexTime;
         }
 
-        m_outputChannels[1].send(valuesComp);
+        m_outputChannels[1].commit<double>(N);
     }
 
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
     for (std::size_t i = 0; i < N; ++i) {
-        values[i] = values[i] - (a * i + b);
+        outValues[i] = values[i] - (a * i + b);
     }
 
-    m_outputChannels[0].send(values);
+    m_outputChannels[0].commit<double>(N);
+    m_inputChannels[0]->release<double>(N);
 }
 
 bool Detrend::isReady(const std::uint64_t N) const {
@@ -0,0 +1,150 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/ExecutionContext.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace {
+    // Innermost scope of the calling thread
+    thread_local const DSP::ExecutionContext *currentContext = nullptr;
+
+    bool setAffinity(const std::vector<int> &cores) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int core: cores) {
+            CPU_SET(core, &set);
+        }
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    bool getAffinity(std::vector<int> &cores) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            return false;
+        }
+
+        cores.clear();
+        for (int core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &set)) {
+                cores.push_back(core);
+            }
+        }
+
+        return true;
+    }
+
+    int countHardwareThreads() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+DSP::ExecutionContext::ExecutionContext(const std::vector<int> &cores, const int fftwThreads, Pinning pinning)
+: m_cores(cores)
+, m_fftwThreads(fftwThreads)
+, m_pinning(pinning) {
+    for (int core: m_cores) {
+        if (core < 0 || core >= CPU_SETSIZE) {
+            std::cerr << "DSP::ExecutionContext::ExecutionContext(): The core " << core << " is invalid" << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    // The duplicated cores would be given twice by Pinning::OneCorePerThread
+    std::sort(m_cores.begin(), m_cores.end());
+    m_cores.erase(std::unique(m_cores.begin(), m_cores.end()), m_cores.end());
+
+    if (m_fftwThreads <= 0) {
+        m_fftwThreads = static_cast<int>(countThreads());
+    }
+}
+
+const std::vector<int>& DSP::ExecutionContext::getCores() const {
+    return m_cores;
+}
+
+int DSP::ExecutionContext::getFFTWThreads() const {
+    return m_fftwThreads;
+}
+
+DSP::ExecutionContext::Pinning DSP::ExecutionContext::getPinning() const {
+    return m_pinning;
+}
+
+std::size_t DSP::ExecutionContext::countThreads() const {
+    if (m_cores.empty()) {
+        return countHardwareThreads();
+    }
+
+    return m_cores.size();
+}
+
+bool DSP::ExecutionContext::pinCurrentThread(const std::size_t threadIndex) const {
+    if (m_cores.empty()) {
+        return false;
+    }
+
+    if (m_pinning == Pinning::OneCorePerThread) {
+        return setAffinity(std::vector<int>(1, m_cores[threadIndex % m_cores.size()]));
+    }
+
+    return setAffinity(m_cores);
+}
+
+const DSP::ExecutionContext& DSP::ExecutionContext::getDefault() {
+    static const ExecutionContext context;
+    return context;
+}
+
+const DSP::ExecutionContext& DSP::ExecutionContext::getCurrent() {
+    if (currentContext == nullptr) {
+        return getDefault();
+    }
+
+    return *currentContext;
+}
+
+DSP::ExecutionContext::Scope::Scope(const ExecutionContext &context, const std::size_t threadIndex)
+: m_previous(currentContext)
+, m_pinned(false) {
+    // The affinity is restored only if it is known
+    if (!context.getCores().empty() && getAffinity(m_previousCores)) {
+        m_pinned = context.pinCurrentThread(threadIndex);
+    }
+
+    currentContext = &context;
+}
+
+DSP::ExecutionContext::Scope::~Scope() {
+    if (m_pinned) {
+        setAffinity(m_previousCores);
+    }
+
+    currentContext = m_previous;
+}
+
+bool DSP::ExecutionContext::Scope::isPinned() const {
+    return m_pinned;
+}
@@ -17,8 +17,8 @@
 
 #include <dsps/Fft.h>
 
+#include <algorithm>
 #include <complex>
-#include <mutex>
 
 #include <dsps/Channel.h>
 #include <dsps/Utils.h>
@@ -46,27 +46,17 @@ void Fft<InputType>::compute(const std::uint64_t N) {
 
 template<typename InputType>
 void Fft<InputType>::computeFFT(const std::uint64_t N) {
-    std::vector<InputType> inValues(N);
-    std::vector< std::complex<InputType> > outValues(N);
-
     // Get the input values
-    m_inputChannels[0]->receive(inValues, N);
+    const InputType *inValues = m_inputChannels[0]->peek<InputType>(N);
+    std::complex<InputType> *outValues = m_outputChannels[0].acquireWrite< std::complex<InputType> >(N);
 
-    // Compute fft
-    m_wrapperFFTW.compute(inValues, outValues, N);
+    // Compute the non-redundant half of the fft (N / 2 + 1 bins)
+    m_wrapperFFTW.computeR2C(inValues, outValues, N);
+    m_inputChannels[0]->release<InputType>(N);
 
-    // Return the result
-    for (std::size_t i = 0; i < N; ++i) {
-        if (i < N/2) {
-            // Send the result
-            outValues[i] = outValues[i];
-        }
-        else {
-            // 0 padding
-            outValues[i] = std::complex<InputType>(0.0, 0.0);
-        }
-    }
-    m_outputChannels[0].send(outValues);
+    // 0 padding of the upper half
+    std::fill(outValues + N / 2, outValues + N, std::complex<InputType>(0.0, 0.0));
+    m_outputChannels[0].commit< std::complex<InputType> >(N);
 }
 
 template<typename InputType>
@@ -17,54 +17,113 @@
 
 #include <dsps/FileSource.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <dsps/Channel.h>
 
-template <>
-void FileSource::readPlainValues(std::vector< std::complex<double> > &values, std::uint64_t N) {
-    values.clear();
+namespace {
+    template <typename T>
+    std::uint64_t convertValues(TextParser &parser, std::ofstream &output) {
+        std::vector<T> values;
+        values.reserve(1 << 16);
+
+        std::uint64_t count = 0;
+        T value;
+        bool more = true;
+        while (more) {
+            values.clear();
+            while (values.size() < values.capacity() && (more = parser.read(value))) {
+                values.push_back(value);
+            }
+
+            output.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+            count += values.size();
+        }
 
-    double real = 0.0;
-    double imag = 0.0;
-    while (values.size() < N) {
-        m_file >> real;
-        m_file >> imag;
+        return count;
+    }
+}
 
+template <typename T>
+std::size_t FileSource::readPlainValues(T *values, std::uint64_t N) {
+    std::size_t count = 0;
+    while (count < N) {
         // If it's the end of file
-        if (m_file.eof()) {
-            m_file.clear();
-            m_file.seekg(0);
+        if (!m_parser.read(values[count])) {
+            if (!m_loop) {
+                m_endOfStream = true;
+                return count;
+            }
+
+            m_input.clear();
+            m_input.seekg(0);
+            m_parser.reset();
             continue;
         }
 
-        values.push_back(std::complex<double>(real, imag));
+        ++count;
+    }
+
+    return count;
+}
+
+template <typename T>
+void FileSource::sendValues(const T *values, std::size_t count, std::uint64_t N) {
+    // The incomplete last window of a non-looping file is dropped
+    if (count == N) {
+        T *outValues = m_outputChannels[0].acquireWrite<T>(N);
+        std::copy(values, values + N, outValues);
+        m_outputChannels[0].commit<T>(N);
     }
 }
 
 template <typename T>
-void FileSource::readPlainValues(std::vector<T> &values, std::uint64_t N) {
-    values.clear();
+void FileSource::sendMappedValues(std::uint64_t N) {
+    const std::size_t count = m_mappingSize / sizeof(T);
 
-    T value;
-    while (values.size() < N) {
-        m_file >> value;
+    if (!m_loop && m_mappingOffset + N > count) {
+        m_endOfStream = true;
+        return;
+    }
 
-        // If it's the end of file
-        if (m_file.eof()) {
-            m_file.clear();
-            m_file.seekg(0);
-            continue;
-        }
+    // Copy the window from the mapping, wrapping at the end of file
+    T *outValues = m_outputChannels[0].acquireWrite<T>(N);
+    std::size_t done = 0;
+    while (done < N) {
+        const std::size_t size = std::min<std::size_t>(N - done, count - m_mappingOffset);
+        std::memcpy(outValues + done, m_mapping + m_mappingOffset * sizeof(T), size * sizeof(T));
+        done += size;
+        m_mappingOffset = (m_mappingOffset + size) % count;
+    }
+    m_outputChannels[0].commit<T>(N);
 
-        values.push_back(value);
+    if (!m_loop && m_mappingOffset == 0) {
+        m_endOfStream = true;
     }
 }
 
-FileSource::FileSource(const std::string &filename, FileFormat format)
+FileSource::FileSource(const std::string &filename, FileFormat format, Access access, bool loop, bool hugePages)
 : Task(ChannelType::None, 0, ChannelType::None, 1)
+, m_filename(filename)
 , m_format(format)
-, m_file(filename) {
+, m_access(access)
+, m_loop(loop)
+, m_endOfStream(false)
+, m_input(nullptr)
+, m_parser(m_input)
+, m_fd(-1)
+, m_mapping(nullptr)
+, m_mappingSize(0)
+, m_mappingOffset(0) {
     // Set the right output type
     switch(m_format){
         case FileFormat::PlainInteger:
@@ -83,62 +142,141 @@ FileSource::FileSource(const std::string &filename, FileFormat format)
             break;
     }
 
+    if (m_access == Access::Mapped) {
+        openMapping(filename, hugePages);
+        return;
+    }
+
+    m_file.open(filename);
+
     // Check the state of file
     assert(m_file.good());
+    m_input.rdbuf(m_file.rdbuf());
+}
+
+FileSource::~FileSource() {
+    if (m_mapping != nullptr) {
+        munmap(const_cast<char*>(m_mapping), m_mappingSize);
+    }
+
+    if (m_fd != -1) {
+        close(m_fd);
+    }
+}
+
+void FileSource::openMapping(const std::string &filename, bool hugePages) {
+    if (m_format != FileFormat::BinaryInteger && m_format != FileFormat::BinaryDouble && m_format != FileFormat::BinaryComplex) {
+        std::cerr << "FileSource::FileSource(): The mapped access needs a binary format" << std::endl;
+        std::exit(-1);
+    }
+
+    m_fd = open(filename.c_str(), O_RDONLY);
+    if (m_fd == -1) {
+        std::cerr << "FileSource::FileSource(): The file '" << filename << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    struct stat status;
+    if (fstat(m_fd, &status) == -1) {
+        std::cerr << "FileSource::FileSource(): The size of '" << filename << "' is unknown: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+    m_mappingSize = static_cast<std::size_t>(status.st_size);
+
+    // An empty file can't be mapped, the stream is already finished
+    if (m_mappingSize < sizeOfChannelType(m_outputChannelType)) {
+        if (m_loop) {
+            std::cerr << "FileSource::FileSource(): The file '" << filename << "' is empty!" << std::endl;
+            std::exit(-1);
+        }
+
+        m_endOfStream = true;
+        return;
+    }
+
+    void *mapping = mmap(nullptr, m_mappingSize, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "FileSource::FileSource(): The file '" << filename << "' wasn't mapped: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+    m_mapping = static_cast<const char*>(mapping);
+
+    // The advices are only hints, a refusal of kernel isn't an error
+    madvise(mapping, m_mappingSize, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    if (hugePages) {
+        madvise(mapping, m_mappingSize, MADV_HUGEPAGE);
+    }
+#else
+    USELESS_PARAMETER(hugePages);
+#endif
 }
 
 void FileSource::compute(const std::uint64_t N) {
+    if (m_endOfStream) {
+        return;
+    }
+
     switch(m_format){
         case FileFormat::PlainInteger:
         {
-            std::vector<std::int64_t> outValues;
-            readPlainValues(outValues, N);
-            m_outputChannels[0].send(outValues);
+            std::int64_t *values = getScratch<std::int64_t>(0, N);
+            sendValues(values, readPlainValues(values, N), N);
 
             break;
         }
 
         case FileFormat::BinaryInteger:
         {
-            std::vector<std::int64_t> outValues;
-            readBinaryValues(outValues, N);
-            m_outputChannels[0].send(outValues);
+            if (m_access == Access::Mapped) {
+                sendMappedValues<std::int64_t>(N);
+                break;
+            }
+
+            std::int64_t *values = getScratch<std::int64_t>(0, N);
+            sendValues(values, readBinaryValues(values, N), N);
 
             break;
         }
 
         case FileFormat::PlainDouble:
         {
-            std::vector<double> outValues;
-            readPlainValues(outValues, N);
-            m_outputChannels[0].send(outValues);
+            double *values = getScratch<double>(0, N);
+            sendValues(values, readPlainValues(values, N), N);
 
             break;
         }
 
         case FileFormat::BinaryDouble:
         {
-            std::vector<double> outValues;
-            readBinaryValues(outValues, N);
-            m_outputChannels[0].send(outValues);
+            if (m_access == Access::Mapped) {
+                sendMappedValues<double>(N);
+                break;
+            }
+
+            double *values = getScratch<double>(0, N);
+            sendValues(values, readBinaryValues(values, N), N);
 
             break;
         }
 
         case FileFormat::PlainComplex:
         {
-            std::vector< std::complex<double> > outValues;
-            readPlainValues(outValues, N);
-            m_outputChannels[0].send(outValues);
+            std::complex<double> *values = getScratch< std::complex<double> >(0, N);
+            sendValues(values, readPlainValues(values, N), N);
 
             break;
         }
 
         case FileFormat::BinaryComplex:
         {
-            std::vector< std::complex<double> > outValues;
-            readBinaryValues(outValues, N);
-            m_outputChannels[0].send(outValues);
+            if (m_access == Access::Mapped) {
+                sendMappedValues< std::complex<double> >(N);
+                break;
+            }
+
+            std::complex<double> *values = getScratch< std::complex<double> >(0, N);
+            sendValues(values, readBinaryValues(values, N), N);
 
             break;
         }
@@ -148,7 +286,7 @@ void FileSource::compute(const std::uint64_t N) {
 bool FileSource::isReady(const std::uint64_t N) const {
     USELESS_PARAMETER(N);
 
-    return true;
+    return !m_endOfStream;
 }
 
 bool FileSource::hasFinished(const std::uint64_t N) const {
@@ -168,3 +306,60 @@ bool FileSource::hasFinished(const std::uint64_t N) const {
 
     return false;
 }
+
+bool FileSource::isEndOfStream() const {
+    return m_endOfStream;
+}
+
+void FileSource::enableReadAhead(std::size_t depth, std::size_t blockSize) {
+    assert(m_access == Access::Stream && "FileSource: The read-ahead needs the stream access");
+
+    m_readAhead.reset(new ReadAhead(m_filename, m_loop, depth, blockSize));
+    m_input.rdbuf(m_readAhead.get());
+    m_file.close();
+}
+
+const ReadAhead *FileSource::getReadAhead() const {
+    return m_readAhead.get();
+}
+
+std::uint64_t FileSource::convertToBinary(const std::string &textFilename, FileFormat format, const std::string &binaryFilename) {
+    std::ifstream input(textFilename);
+    if (!input.good()) {
+        std::cerr << "FileSource::convertToBinary(): The file '" << textFilename << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    std::ofstream output(binaryFilename, std::ios::binary);
+    if (!output.good()) {
+        std::cerr << "FileSource::convertToBinary(): The file '" << binaryFilename << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    TextParser parser(input);
+    std::uint64_t count = 0;
+    switch (format) {
+        case FileFormat::PlainInteger:
+            count = convertValues<std::int64_t>(parser, output);
+            break;
+
+        case FileFormat::PlainDouble:
+            count = convertValues<double>(parser, output);
+            break;
+
+        case FileFormat::PlainComplex:
+            count = convertValues< std::complex<double> >(parser, output);
+            break;
+
+        default:
+            std::cerr << "FileSource::convertToBinary(): The file format must be a plain format" << std::endl;
+            std::exit(-1);
+    }
+
+    if (!output.good()) {
+        std::cerr << "FileSource::convertToBinary(): The file '" << binaryFilename << "' wasn't written" << std::endl;
+        std::exit(-1);
+    }
+
+    return count;
+}
@@ -0,0 +1,267 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/FileWriter.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+constexpr std::size_t FileWriter::Alignment;
+
+FileWriter::FileWriter(const std::string &filename, std::size_t bufferSize, std::size_t numberBuffers, bool directIO, bool syncData)
+: m_filename(filename)
+, m_fd(-1)
+, m_direct(false)
+, m_syncData(syncData)
+, m_bufferSize((bufferSize + Alignment - 1) / Alignment * Alignment)
+, m_current(0)
+, m_writeIndex(0)
+, m_filled(0)
+, m_maxFilled(0)
+, m_stop(false)
+, m_offset(0)
+, m_writtenBytes(0)
+, m_writeTime(0) {
+    assert((bufferSize == 0 || numberBuffers >= 2) && "FileWriter: The number of buffers must be at least 2");
+
+    // The direct I/O isn't supported by all file systems (like tmpfs)
+    if (directIO && m_bufferSize > 0) {
+        m_fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+        m_direct = (m_fd != -1);
+    }
+
+    if (m_fd == -1) {
+        m_fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+
+    if (m_fd == -1) {
+        std::cerr << "FileWriter::FileWriter(): The file '" << filename << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    if (m_bufferSize == 0) {
+        return;
+    }
+
+    m_buffers.resize(numberBuffers);
+    for (Buffer &buffer: m_buffers) {
+        void *data = nullptr;
+        if (posix_memalign(&data, Alignment, m_bufferSize) != 0) {
+            std::cerr << "FileWriter::FileWriter(): The buffers weren't allocated" << std::endl;
+            std::exit(-1);
+        }
+
+        buffer.data = static_cast<char*>(data);
+        buffer.size = 0;
+        buffer.offset = 0;
+        buffer.flushed = 0;
+    }
+
+    m_writer = std::thread(&FileWriter::run, this);
+}
+
+FileWriter::~FileWriter() {
+    flush();
+
+    if (m_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_bufferFilled.notify_one();
+        m_writer.join();
+    }
+
+    for (Buffer &buffer: m_buffers) {
+        free(buffer.data);
+    }
+
+    close(m_fd);
+}
+
+void FileWriter::append(const void *data, std::size_t size) {
+    const char *bytes = static_cast<const char*>(data);
+
+    if (m_bufferSize == 0) {
+        writeAt(bytes, size, m_offset);
+        m_offset += size;
+        return;
+    }
+
+    while (size > 0) {
+        Buffer &buffer = m_buffers[m_current];
+        const std::size_t count = std::min(size, m_bufferSize - buffer.size);
+        std::memcpy(buffer.data + buffer.size, bytes, count);
+
+        buffer.size += count;
+        m_offset += count;
+        bytes += count;
+        size -= count;
+
+        if (buffer.size == m_bufferSize) {
+            submit();
+        }
+    }
+}
+
+void FileWriter::overwrite(const void *data, std::size_t size) {
+    flush();
+
+    writeAt(static_cast<const char*>(data), size, 0);
+    if (ftruncate(m_fd, size) != 0) {
+        std::cerr << "FileWriter::overwrite(): The file '" << m_filename << "' wasn't truncated: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    m_offset = size;
+    if (m_bufferSize > 0) {
+        m_buffers[m_current].size = 0;
+        m_buffers[m_current].offset = m_offset;
+        m_buffers[m_current].flushed = 0;
+    }
+}
+
+void FileWriter::flush() {
+    if (m_bufferSize == 0) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_bufferWritten.wait(lock, [this]() { return m_filled == 0; });
+    }
+
+    // The current buffer is kept, it is written again when it is full
+    Buffer &buffer = m_buffers[m_current];
+    if (buffer.size > buffer.flushed) {
+        writeAt(buffer.data, buffer.size, buffer.offset, buffer.flushed);
+        buffer.flushed = buffer.size;
+    }
+}
+
+bool FileWriter::isDirect() const {
+    return m_direct;
+}
+
+std::uint64_t FileWriter::countWrittenBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_writtenBytes;
+}
+
+double FileWriter::getWriteThroughput() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_writeTime == 0) {
+        return 0.0;
+    }
+
+    return static_cast<double>(m_writtenBytes) / (static_cast<double>(m_writeTime) * 1e-9);
+}
+
+std::size_t FileWriter::getQueueDepth() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_filled;
+}
+
+std::size_t FileWriter::getMaxQueueDepth() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxFilled;
+}
+
+void FileWriter::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_bufferFilled.wait(lock, [this]() { return m_stop || m_filled > 0; });
+        if (m_filled == 0) {
+            return;
+        }
+
+        // The producer doesn't touch the filled buffers
+        const Buffer &buffer = m_buffers[m_writeIndex];
+        lock.unlock();
+        writeAt(buffer.data, buffer.size, buffer.offset, buffer.flushed);
+        lock.lock();
+
+        m_writeIndex = (m_writeIndex + 1) % m_buffers.size();
+        --m_filled;
+        m_bufferWritten.notify_one();
+    }
+}
+
+void FileWriter::submit() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_filled;
+    m_maxFilled = std::max(m_maxFilled, m_filled);
+    m_bufferFilled.notify_one();
+
+    // Wait for a free buffer
+    m_bufferWritten.wait(lock, [this]() { return m_filled < m_buffers.size(); });
+    m_current = (m_current + 1) % m_buffers.size();
+    m_buffers[m_current].size = 0;
+    m_buffers[m_current].offset = m_offset;
+    m_buffers[m_current].flushed = 0;
+}
+
+void FileWriter::writeAt(const char *data, std::size_t size, std::uint64_t offset, std::size_t rewritten) {
+    auto begin = std::chrono::steady_clock::now();
+
+    // The direct I/O needs aligned memory, size and offset, the other
+    // writes go through the page cache (only one thread writes at a time)
+    const bool aligned = (reinterpret_cast<std::uintptr_t>(data) % Alignment == 0) && (size % Alignment == 0) && (offset % Alignment == 0);
+    const int flags = fcntl(m_fd, F_GETFL);
+    if (m_direct && !aligned) {
+        fcntl(m_fd, F_SETFL, flags & ~O_DIRECT);
+    }
+
+    std::size_t done = 0;
+    while (done < size) {
+        ssize_t count = pwrite(m_fd, data + done, size - done, offset + done);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (count < 0) {
+            std::cerr << "FileWriter::writeAt(): The file '" << m_filename << "' wasn't written: " << std::strerror(errno) << std::endl;
+            std::exit(-1);
+        }
+
+        done += count;
+    }
+
+    if (m_direct && !aligned) {
+        fcntl(m_fd, F_SETFL, flags);
+    }
+
+    if (m_syncData && fdatasync(m_fd) != 0) {
+        std::cerr << "FileWriter::writeAt(): The file '" << m_filename << "' wasn't synchronised: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    // The start of a flushed buffer is already counted
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_writtenBytes += size - rewritten;
+    m_writeTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+}
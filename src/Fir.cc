@@ -1,5 +1,6 @@
 #include <dsps/Fir.h>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -10,10 +11,16 @@
 #include <dsps/Channel.h>
 
 template<typename T>
-Fir<T>::Fir(const std::string &coeffPath, const std::uint64_t DECIM_FACTOR, const int64_t maxNOB)
+constexpr std::uint64_t Fir<T>::OverlapSaveCrossover;
+
+template<typename T>
+Fir<T>::Fir(const std::string &coeffPath, const std::uint64_t DECIM_FACTOR, const int64_t maxNOB, Method method)
 : Task(getChannelType<T>(), 1, getChannelType<T>(), 1)
 , m_DECIM_FACTOR(DECIM_FACTOR)
-, m_maxNOB(maxNOB) {
+, m_bufferStart(0)
+, m_maxNOB(maxNOB)
+, m_bufferedSize(0)
+, m_overlapSaveEnabled(false) {
     // Load the coefficients
     std::ifstream inFile;
     inFile.open(coeffPath);
@@ -33,6 +40,8 @@ Fir<T>::Fir(const std::string &coeffPath, const std::uint64_t DECIM_FACTOR, cons
         std::cerr << "Fir::Fir(): The file '" << coeffPath << "' is empty!" << std::endl;
         std::exit(1);
     }
+
+    initOverlapSave(method);
 }
 
 template<typename T>
@@ -40,23 +49,38 @@ void Fir<T>::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert(m_inputChannels[0] != nullptr && "FIR: No input task is connected");
 
-    std::vector<T> inValues(N);
-    std::vector<T> outValues(N);
+    if (m_overlapSaveEnabled) {
+        computeOverlapSave(N);
+        return;
+    }
 
-    // Load the input data
     const std::uint64_t INPUT_SIZE = N * m_DECIM_FACTOR + m_coeff.size();
-    const std::uint64_t INPUT_SIZE_DIFF = INPUT_SIZE - m_inputBuffer.size();
+    const std::uint64_t INPUT_SIZE_DIFF = INPUT_SIZE - m_bufferedSize;
 
-    m_inputChannels[0]->receive(inValues, INPUT_SIZE_DIFF);
-    m_inputBuffer.insert(m_inputBuffer.end(), inValues.begin(), inValues.end());
+    // The window slides in the buffer, the history is moved back to the
+    // begin only when the next window doesn't fit
+    if (m_bufferStart + INPUT_SIZE > m_inputBuffer.size()) {
+        std::copy_n(m_inputBuffer.begin() + m_bufferStart, m_bufferedSize, m_inputBuffer.begin());
+        m_bufferStart = 0;
 
-    // Call the right method
-    filter(outValues, INPUT_SIZE);
+        if (m_inputBuffer.size() < INPUT_SIZE * BufferWindows) {
+            m_inputBuffer.resize(INPUT_SIZE * BufferWindows);
+        }
+    }
 
-    m_outputChannels[0].send(outValues);
+    // Load the input data
+    const T *inValues = m_inputChannels[0]->peek<T>(INPUT_SIZE_DIFF);
+    std::copy_n(inValues, INPUT_SIZE_DIFF, m_inputBuffer.begin() + m_bufferStart + m_bufferedSize);
+    m_inputChannels[0]->release<T>(INPUT_SIZE_DIFF);
 
-    // Clear input data
-    m_inputBuffer.erase(m_inputBuffer.begin(), m_inputBuffer.begin() + (N * m_DECIM_FACTOR));
+    // Call the right method
+    T *outValues = m_outputChannels[0].acquireWrite<T>(N);
+    filter(outValues, N, INPUT_SIZE);
+    m_outputChannels[0].commit<T>(N);
+
+    // Keep the history
+    m_bufferStart += N * m_DECIM_FACTOR;
+    m_bufferedSize = m_coeff.size();
 }
 
 template<typename T>
@@ -64,7 +88,7 @@ bool Fir<T>::isReady(const std::uint64_t N) const {
     // Check if the input task is connected
     assert(m_inputChannels[0] != nullptr && "FIR: No input task is connected");
 
-    return (m_inputChannels[0]->size(sizeof(T)) + m_inputBuffer.size()) >= (N * m_DECIM_FACTOR + m_coeff.size());
+    return (m_inputChannels[0]->size(sizeof(T)) + m_bufferedSize) >= (N * m_DECIM_FACTOR + m_coeff.size());
 }
 
 template<typename T>
@@ -72,36 +96,122 @@ bool Fir<T>::hasFinished(const std::uint64_t N) const {
     return m_outputChannels[0].size(sizeof(T)) >= N;
 }
 
+template<typename T>
+std::uint64_t Fir<T>::getInputRate(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    return N * m_DECIM_FACTOR;
+}
+
+template<typename T>
+std::uint64_t Fir<T>::getInputDelay(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    USELESS_PARAMETER(N);
+    return m_coeff.size();
+}
+
+template<typename T>
+bool Fir<T>::usesOverlapSave() const {
+    return m_overlapSaveEnabled;
+}
+
+template<typename T>
+void Fir<T>::computeOverlapSave(const std::uint64_t N) {
+    // Same window as the direct form, but the last L samples are already convolved
+    const std::uint64_t INPUT_SIZE = N * m_DECIM_FACTOR + m_coeff.size();
+    const std::uint64_t INPUT_SIZE_DIFF = INPUT_SIZE - m_bufferedSize;
+
+    // The blocks are chosen with the first window so the next ones are made of whole blocks
+    if (!m_overlapSave) {
+        // The coefficients are stored in reverse order
+        std::vector<T> impulseResponse(m_coeff.rbegin(), m_coeff.rend());
+        const std::uint64_t blockSize = OverlapSave<T>::defaultBlockSize(m_coeff.size(), N * m_DECIM_FACTOR);
+        m_overlapSave.reset(new OverlapSave<T>(impulseResponse, blockSize));
+
+        // Zeros before the stream align the end of the first window on a block
+        m_overlapSave->skip((blockSize - INPUT_SIZE_DIFF % blockSize) % blockSize);
+    }
+
+    const std::size_t offset = m_convolution.size();
+    m_convolution.resize(offset + INPUT_SIZE_DIFF);
+
+    const T *inValues = m_inputChannels[0]->peek<T>(INPUT_SIZE_DIFF);
+    m_overlapSave->convolve(inValues, INPUT_SIZE_DIFF, m_convolution.data() + offset);
+    m_inputChannels[0]->release<T>(INPUT_SIZE_DIFF);
+
+    // The output j is the convolution at the last sample of its window
+    const std::size_t first = (m_bufferedSize == 0) ? m_coeff.size() - 1 : 0;
+    T *outValues = m_outputChannels[0].acquireWrite<T>(N);
+    for (std::size_t j = 0; j < N; ++j) {
+        outValues[j] = m_convolution[first + j * m_DECIM_FACTOR];
+    }
+    m_outputChannels[0].commit<T>(N);
+
+    // Only the convolution of the last sample is needed by the next window
+    m_convolution.front() = m_convolution.back();
+    m_convolution.resize(1);
+    m_bufferedSize = m_coeff.size();
+}
+
+template<typename T>
+void Fir<T>::initOverlapSave(Method method) {
+    if (method == Method::Auto && m_coeff.size() >= OverlapSaveCrossover * m_DECIM_FACTOR) {
+        method = Method::OverlapSave;
+    }
+
+    // The filter is created by the first compute, when the window size is known
+    m_overlapSaveEnabled = (method == Method::OverlapSave);
+}
+
+template<>
+void Fir<std::int64_t>::initOverlapSave(Method method) {
+    // Only the direct form is exact for integers
+    assert(method != Method::OverlapSave && "Fir: The overlap-save isn't available for int64");
+    USELESS_PARAMETER(method);
+}
+
 template<>
-void Fir<double>::filter(std::vector<double> &outValues, const std::uint64_t INPUT_SIZE) {
+void Fir<std::int64_t>::computeOverlapSave(const std::uint64_t N) {
+    USELESS_PARAMETER(N);
+    assert(false && "Fir: The overlap-save isn't available for int64");
+}
+
+template<>
+void Fir<double>::filter(double *outValues, const std::uint64_t N, const std::uint64_t INPUT_SIZE) {
+    USELESS_PARAMETER(N);
+
     // Compute the fir
-    fir_double(m_inputBuffer.data(), INPUT_SIZE, m_coeff.data(), m_coeff.size(), m_DECIM_FACTOR, outValues.data());
+    fir_double(m_inputBuffer.data() + m_bufferStart, INPUT_SIZE, m_coeff.data(), m_coeff.size(), m_DECIM_FACTOR, outValues);
 }
 
 template<>
-void Fir<float>::filter(std::vector<float> &outValues, const std::uint64_t INPUT_SIZE) {
+void Fir<float>::filter(float *outValues, const std::uint64_t N, const std::uint64_t INPUT_SIZE) {
+    USELESS_PARAMETER(N);
+
     // Compute the fir
-    fir_float(m_inputBuffer.data(), INPUT_SIZE, m_coeff.data(), m_coeff.size(), m_DECIM_FACTOR, outValues.data());
+    fir_float(m_inputBuffer.data() + m_bufferStart, INPUT_SIZE, m_coeff.data(), m_coeff.size(), m_DECIM_FACTOR, outValues);
 }
 
 template<>
-void Fir<std::int64_t>::filter(std::vector<std::int64_t> &outValues, const std::uint64_t INPUT_SIZE) {
+void Fir<std::int64_t>::filter(std::int64_t *outValues, const std::uint64_t N, const std::uint64_t INPUT_SIZE) {
     // Compute the fir
-    fir_int64(m_inputBuffer.data(), INPUT_SIZE, m_coeff.data(), m_coeff.size(), m_DECIM_FACTOR, outValues.data());
+    fir_int64(m_inputBuffer.data() + m_bufferStart, INPUT_SIZE, m_coeff.data(), m_coeff.size(), m_DECIM_FACTOR, outValues);
 
     // Send result
     if (m_maxNOB > 0) {
       uint64_t dataSize = sizeof(int64_t) * 8;
       assert(m_maxNOB < dataSize);
       uint64_t shift = dataSize - m_maxNOB;
-      for (size_t i = 0; i < outValues.size(); ++i) {
+      for (size_t i = 0; i < N; ++i) {
         outValues[i] = (outValues[i] << shift) >> shift;
       }
     }
 }
 
 template<typename T>
-void Fir<T>::filter(std::vector<T> &outValues, const std::uint64_t N) {
+void Fir<T>::filter(T *outValues, const std::uint64_t N, const std::uint64_t INPUT_SIZE) {
+    USELESS_PARAMETER(outValues);
+    USELESS_PARAMETER(N);
+    USELESS_PARAMETER(INPUT_SIZE);
     std::string error = std::string(typeid(T).name()) + " wasn't a supported type.";
     assert(false && error.data());
 }
@@ -0,0 +1,265 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/Fusion.h>
+
+#include <algorithm>
+#include <cassert>
+#include <complex>
+
+#include <dsps/Channel.h>
+#include <dsps/Utils.h>
+
+namespace {
+    // Untyped access to the windows of channels, the alignment of the type is kept
+    const void* peekWindow(Channel &channel, const ChannelType type, const std::uint64_t N) {
+        switch (type) {
+        case ChannelType::Double:
+            return channel.peek<double>(N);
+        case ChannelType::ComplexDouble:
+            return channel.peek< std::complex<double> >(N);
+        case ChannelType::Float:
+            return channel.peek<float>(N);
+        case ChannelType::ComplexFloat:
+            return channel.peek< std::complex<float> >(N);
+        case ChannelType::Int64:
+            return channel.peek<std::int64_t>(N);
+        case ChannelType::None:
+            break;
+        }
+
+        assert(false && "FusedTask: Invalid channel type");
+        return nullptr;
+    }
+
+    void releaseWindow(Channel &channel, const ChannelType type, const std::uint64_t N) {
+        switch (type) {
+        case ChannelType::Double:
+            channel.release<double>(N);
+            break;
+        case ChannelType::ComplexDouble:
+            channel.release< std::complex<double> >(N);
+            break;
+        case ChannelType::Float:
+            channel.release<float>(N);
+            break;
+        case ChannelType::ComplexFloat:
+            channel.release< std::complex<float> >(N);
+            break;
+        case ChannelType::Int64:
+            channel.release<std::int64_t>(N);
+            break;
+        case ChannelType::None:
+            assert(false && "FusedTask: Invalid channel type");
+            break;
+        }
+    }
+
+    void* acquireWindow(Channel &channel, const ChannelType type, const std::uint64_t N) {
+        switch (type) {
+        case ChannelType::Double:
+            return channel.acquireWrite<double>(N);
+        case ChannelType::ComplexDouble:
+            return channel.acquireWrite< std::complex<double> >(N);
+        case ChannelType::Float:
+            return channel.acquireWrite<float>(N);
+        case ChannelType::ComplexFloat:
+            return channel.acquireWrite< std::complex<float> >(N);
+        case ChannelType::Int64:
+            return channel.acquireWrite<std::int64_t>(N);
+        case ChannelType::None:
+            break;
+        }
+
+        assert(false && "FusedTask: Invalid channel type");
+        return nullptr;
+    }
+
+    void commitWindow(Channel &channel, const ChannelType type, const std::uint64_t N) {
+        switch (type) {
+        case ChannelType::Double:
+            channel.commit<double>(N);
+            break;
+        case ChannelType::ComplexDouble:
+            channel.commit< std::complex<double> >(N);
+            break;
+        case ChannelType::Float:
+            channel.commit<float>(N);
+            break;
+        case ChannelType::ComplexFloat:
+            channel.commit< std::complex<float> >(N);
+            break;
+        case ChannelType::Int64:
+            channel.commit<std::int64_t>(N);
+            break;
+        case ChannelType::None:
+            assert(false && "FusedTask: Invalid channel type");
+            break;
+        }
+    }
+
+    // A task which can be in a chain
+    bool isFusable(const Task *task) {
+        return task->isElementwise() && task->countInputs() == 1 && task->countNextTask() == 1;
+    }
+}
+
+constexpr std::size_t FusedTask::BlockSize;
+
+FusedTask::FusedTask(const std::vector<Task*> &chain)
+: Task(chain.front()->getInputChannelType(), 1, chain.back()->getOutputChannelType(), 0)
+, m_chain(chain)
+, m_output(&chain.back()->getOutput(0)) {
+    assert(chain.front()->getInput(0) != nullptr && "FusedTask: No input task is connected");
+
+    // Read the input channel of chain without connecting it to the fused task
+    m_inputChannels[0] = chain.front()->getInput(0);
+
+    std::size_t maxDataSize = 0;
+    for (std::size_t i = 0; i + 1 < m_chain.size(); ++i) {
+        maxDataSize = std::max(maxDataSize, sizeOfChannelType(m_chain[i]->getOutputChannelType()));
+    }
+    m_blocks[0].resize(BlockSize * maxDataSize);
+    m_blocks[1].resize(BlockSize * maxDataSize);
+}
+
+void FusedTask::compute(const std::uint64_t N) {
+    const std::size_t inDataSize = sizeOfChannelType(m_inputChannelType);
+    const std::size_t outDataSize = sizeOfChannelType(m_outputChannelType);
+
+    // Work directly in the channel windows
+    const std::uint8_t *inValues = static_cast<const std::uint8_t*>(peekWindow(*m_inputChannels[0], m_inputChannelType, N));
+    std::uint8_t *outValues = static_cast<std::uint8_t*>(acquireWindow(*m_output, m_outputChannelType, N));
+
+    // Each block goes through all the tasks, the intermediate results alternate between two blocks
+    for (std::uint64_t offset = 0; offset < N; offset += BlockSize) {
+        const std::size_t size = std::min<std::uint64_t>(BlockSize, N - offset);
+
+        const void *blockIn = inValues + offset * inDataSize;
+        for (std::size_t i = 0; i < m_chain.size(); ++i) {
+            void *blockOut = (i + 1 == m_chain.size()) ? static_cast<void*>(outValues + offset * outDataSize) : m_blocks[i % 2].data();
+            m_chain[i]->computeElementwise(blockIn, blockOut, size);
+            blockIn = blockOut;
+        }
+    }
+
+    commitWindow(*m_output, m_outputChannelType, N);
+    releaseWindow(*m_inputChannels[0], m_inputChannelType, N);
+}
+
+bool FusedTask::isReady(const std::uint64_t N) const {
+    return m_inputChannels[0]->size(sizeOfChannelType(m_inputChannelType)) >= N;
+}
+
+bool FusedTask::hasFinished(const std::uint64_t N) const {
+    return m_output->size(sizeOfChannelType(m_outputChannelType)) >= N;
+}
+
+const std::vector<Task*>& FusedTask::getChain() const {
+    return m_chain;
+}
+
+DSP::Fusion::Fusion(std::list<Task*> sourceTask, std::list<Task*> outputTask)
+: m_sourceTask(sourceTask)
+, m_outputTask(outputTask) {
+    // The linearisation can list a task several times
+    std::vector<Task*> tasks;
+    for (Task *task: dagLinearisation(sourceTask)) {
+        if (tasks.end() == std::find(tasks.begin(), tasks.end(), task)) {
+            tasks.push_back(task);
+        }
+    }
+
+    auto contains = [](const std::list<Task*> &list, const Task *task) {
+        return list.end() != std::find(list.begin(), list.end(), task);
+    };
+    auto inDAG = [&tasks](const Task *task) {
+        return tasks.end() != std::find(tasks.begin(), tasks.end(), task);
+    };
+
+    // The chain continues with the next task if it reads only the output of task
+    auto nextInChain = [&](Task *task) -> Task* {
+        if (!isFusable(task) || contains(m_sourceTask, task) || contains(m_outputTask, task)) {
+            return nullptr;
+        }
+
+        Task *nextTask = task->getNextTask(0);
+        if (nextTask == nullptr || !inDAG(nextTask) || !isFusable(nextTask) || nextTask->getInput(0) != &task->getOutput(0)) {
+            return nullptr;
+        }
+
+        return nextTask;
+    };
+
+    // Build the chains from the tasks which don't continue a chain
+    std::vector<Task*> heads;
+    for (Task *task: tasks) {
+        if (!isFusable(task) || contains(m_sourceTask, task)) {
+            continue;
+        }
+
+        Channel *input = task->getInput(0);
+        Task *previousTask = (input != nullptr) ? input->getIn() : nullptr;
+        if (previousTask != nullptr && inDAG(previousTask) && nextInChain(previousTask) == task) {
+            continue;
+        }
+
+        std::vector<Task*> chain = { task };
+        for (Task *nextTask = nextInChain(task); nextTask != nullptr; nextTask = nextInChain(nextTask)) {
+            chain.push_back(nextTask);
+        }
+
+        if (chain.size() >= 2) {
+            m_fusedTasks.emplace_back(new FusedTask(chain));
+            heads.push_back(task);
+        }
+    }
+
+    // The fused task takes the place of the first task of its chain
+    for (Task *task: tasks) {
+        auto head = std::find(heads.begin(), heads.end(), task);
+        if (head != heads.end()) {
+            m_linearisation.push_back(m_fusedTasks[head - heads.begin()].get());
+        }
+        else if (getFusedTask(task) == nullptr) {
+            m_linearisation.push_back(task);
+        }
+    }
+}
+
+void DSP::Fusion::processing(const std::uint64_t N) {
+    processLinearisation(m_linearisation, m_sourceTask, m_outputTask, N);
+}
+
+const std::list<Task*>& DSP::Fusion::getLinearisation() const {
+    return m_linearisation;
+}
+
+std::size_t DSP::Fusion::countFusedTasks() const {
+    return m_fusedTasks.size();
+}
+
+const FusedTask* DSP::Fusion::getFusedTask(const Task *task) const {
+    for (const std::unique_ptr<FusedTask> &fusedTask: m_fusedTasks) {
+        const std::vector<Task*> &chain = fusedTask->getChain();
+        if (chain.end() != std::find(chain.begin(), chain.end(), task)) {
+            return fusedTask.get();
+        }
+    }
+
+    return nullptr;
+}
@@ -20,6 +20,7 @@
 #include <complex>
 
 #include <dsps/Channel.h>
+#include <dsps/Simd.h>
 
 template<typename T>
 Gain<T>::Gain(const double gain)
@@ -32,16 +33,14 @@ void Gain<T>::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert(m_inputChannels[0] != nullptr && "Gain: No input task is connected");
 
-    std::vector<T> inValues(N);
-    std::vector<T> outValues(N);
+    // Work directly in the channel windows
+    const T *inValues = m_inputChannels[0]->peek<T>(N);
+    T *outValues = m_outputChannels[0].acquireWrite<T>(N);
 
-    m_inputChannels[0]->receive(inValues, N);
+    computeElementwise(inValues, outValues, N);
 
-    for (std::size_t i = 0; i < N; ++i) {
-        outValues[i] = inValues[i] * m_gain;
-    }
-
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<T>(N);
+    m_inputChannels[0]->release<T>(N);
 }
 
 template<typename T>
@@ -57,5 +56,15 @@ bool Gain<T>::hasFinished(const std::uint64_t N) const {
     return m_outputChannels[0].size(sizeof(T)) >= N;
 }
 
+template<typename T>
+bool Gain<T>::isElementwise() const {
+    return true;
+}
+
+template<typename T>
+void Gain<T>::computeElementwise(const void *inValues, void *outValues, const std::size_t size) const {
+    DSP::Simd::scale(static_cast<const T*>(inValues), m_gain, static_cast<T*>(outValues), size);
+}
+
 template class Gain<double>;
 template class Gain<std::complex<double>>;
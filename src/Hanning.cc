@@ -31,15 +31,15 @@ void Hanning::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert(m_inputChannels[0] != nullptr && "Hanning: No input task is connected");
 
-    std::vector<double> inValues(N);
-    std::vector<double> outValues(N);
-
-    m_inputChannels[0]->receive(inValues, N);
+    // Work directly in the channel windows
+    const double *inValues = m_inputChannels[0]->peek<double>(N);
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
 
     // Compute the hanning window
-    hanning_window(inValues.data(), outValues.data(), N);
+    hanning_window(const_cast<double*>(inValues), outValues, N);
 
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<double>(N);
+    m_inputChannels[0]->release<double>(N);
 }
 
 bool Hanning::isReady(const std::uint64_t N) const {
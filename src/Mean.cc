@@ -17,16 +17,17 @@
 
 #include <dsps/Mean.h>
 
+#include <algorithm>
 #include <complex>
-#include <typeinfo>
 
 #include <dsps/Channel.h>
 
 template<typename T>
-Mean<T>::Mean(const std::uint64_t LIMIT_ORDER)
+Mean<T>::Mean(const std::uint64_t LIMIT_ORDER, const std::uint64_t publishPeriod)
 : Task(getChannelType<T>(), 1, getChannelType<T>(), 1)
 , m_order(0)
-, m_LIMIT_ORDER(LIMIT_ORDER) {
+, m_LIMIT_ORDER(LIMIT_ORDER)
+, m_publishPeriod(publishPeriod) {
 }
 
 template<typename T>
@@ -42,29 +43,26 @@ void Mean<T>::compute(const std::uint64_t N) {
     // Update the order
     ++m_order;
 
-    std::vector<T> inValues(N);
-    std::vector<T> outValues(N);
-
-    m_inputChannels[0]->receive(inValues, N);
-
     // Accum new input
+    const T *inValues = m_inputChannels[0]->peek<T>(N);
     for (std::size_t i = 0; i < N; ++i) {
         T y = inValues[i] - m_kahanCompensation[i];
         T t = m_accum[i] + y;
         m_kahanCompensation[i] = (t - m_accum[i]) - y;
         m_accum[i] = t;
-        outValues[i] = m_accum[i] / static_cast<double>(m_order);
     }
+    m_inputChannels[0]->release<T>(N);
 
-    // Discard N previous values
-    if (m_outputChannels[0].size(sizeof(T)) >= N) {
-        std::vector<T> tmpValues(N);
-        m_outputChannels[0].receive(tmpValues, N);
+    // Return result at the limit order, then every publish period
+    if (m_order < m_LIMIT_ORDER) {
+        return;
     }
 
-    // Return result
-    if (m_order >= m_LIMIT_ORDER) {
-        m_outputChannels[0].send(outValues);
+    const std::uint64_t elapsed = m_order - std::max<std::uint64_t>(m_LIMIT_ORDER, 1);
+    if (elapsed == 0 || (m_publishPeriod > 0 && elapsed % m_publishPeriod == 0)) {
+        T *outValues = m_outputChannels[0].acquireWrite<T>(N);
+        computeMean(outValues);
+        m_outputChannels[0].commit<T>(N);
     }
 }
 
@@ -94,38 +92,21 @@ void Mean<T>::clearAccum() {
 }
 
 template<typename T>
-void Mean<T>::initAccum(const std::uint64_t N) {
-    std::string error = std::string(typeid(T).name()) + " wasn't a supported type.";
-    assert(false && error.data());
-}
-
-template<>
-void Mean<double>::initAccum(const std::uint64_t N) {
-    m_accum.clear();
-    m_kahanCompensation.clear();
-    for (std::size_t i = 0; i < N; ++i) {
-        m_accum.push_back(0.0);
-        m_kahanCompensation.push_back(0.0);
-    }
+void Mean<T>::getMean(std::vector<T> &values) const {
+    values.resize(m_accum.size());
+    computeMean(values.data());
 }
 
-template<>
-void Mean<float>::initAccum(const std::uint64_t N) {
-    m_accum.clear();
-    m_kahanCompensation.clear();
-    for (std::size_t i = 0; i < N; ++i) {
-        m_accum.push_back(0.0f);
-        m_kahanCompensation.push_back(0.0f);
-    }
+template<typename T>
+void Mean<T>::initAccum(const std::uint64_t N) {
+    m_accum.assign(N, T(0));
+    m_kahanCompensation.assign(N, T(0));
 }
 
-template<>
-void Mean<std::complex<double>>::initAccum(const std::uint64_t N) {
-    m_accum.clear();
-    m_kahanCompensation.clear();
-    for (std::size_t i = 0; i < N; ++i) {
-        m_accum.push_back(std::complex<double>(0.0, 0.0));
-        m_kahanCompensation.push_back(std::complex<double>(0.0, 0.0));
+template<typename T>
+void Mean<T>::computeMean(T *values) const {
+    for (std::size_t i = 0; i < m_accum.size(); ++i) {
+        values[i] = m_accum[i] / static_cast<T>(m_order);
     }
 }
 
@@ -18,6 +18,7 @@
 #include <dsps/Mixer.h>
 
 #include <dsps/Channel.h>
+#include <dsps/Simd.h>
 
 Mixer::Mixer()
 : Task(ChannelType::Double, 3, ChannelType::Double, 2) {
@@ -27,27 +28,23 @@ void Mixer::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert((m_inputChannels[0] != nullptr && m_inputChannels[1] != nullptr && m_inputChannels[2] != nullptr) && "Mixer: No input task is connected");
 
-    // Get the input data
-    std::vector<double> signalValues(N);
-    std::vector<double> ncoCosValues(N);
-    std::vector<double> ncoSinValues(N);
-    std::vector<double> iValues(N);
-    std::vector<double> qValues(N);
-
-    m_inputChannels[0]->receive(signalValues, N);
-    m_inputChannels[1]->receive(ncoCosValues, N);
-    m_inputChannels[2]->receive(ncoSinValues, N);
+    // Work directly in the channel windows
+    const double *signalValues = m_inputChannels[0]->peek<double>(N);
+    const double *ncoCosValues = m_inputChannels[1]->peek<double>(N);
+    const double *ncoSinValues = m_inputChannels[2]->peek<double>(N);
+    double *iValues = m_outputChannels[0].acquireWrite<double>(N);
+    double *qValues = m_outputChannels[1].acquireWrite<double>(N);
 
     // Compute
-    for (std::uint64_t i = 0; i < N; ++i) {
-        double value = signalValues[i];
-        iValues[i] = value * ncoCosValues[i];
-        qValues[i] = value * ncoSinValues[i];
-    }
+    DSP::Simd::multiply(signalValues, ncoCosValues, iValues, N);
+    DSP::Simd::multiply(signalValues, ncoSinValues, qValues, N);
 
     // Send the results
-    m_outputChannels[0].send(iValues);
-    m_outputChannels[1].send(qValues);
+    m_outputChannels[0].commit<double>(N);
+    m_outputChannels[1].commit<double>(N);
+    m_inputChannels[0]->release<double>(N);
+    m_inputChannels[1]->release<double>(N);
+    m_inputChannels[2]->release<double>(N);
 }
 
 bool Mixer::isReady(const std::uint64_t N) const {
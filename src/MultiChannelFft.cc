@@ -0,0 +1,109 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/MultiChannelFft.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <dsps/Channel.h>
+#include <dsps/Utils.h>
+
+template<typename InputType>
+MultiChannelFft<InputType>::MultiChannelFft(const std::size_t numberChannels, Layout layout)
+: Task(getChannelType<InputType>(), numberChannels, getChannelType< std::complex<InputType> >(), (layout == Layout::Separate) ? numberChannels : 1)
+, m_numberChannels(numberChannels)
+, m_layout(layout)
+, m_wrapperFFTW(FFTDirection::Forward)
+, m_inValues(numberChannels)
+, m_outValues(numberChannels) {
+    assert(m_numberChannels > 0 && "MultiChannelFft: No channel");
+}
+
+template<typename InputType>
+void MultiChannelFft<InputType>::compute(const std::uint64_t N) {
+    // Get the input values
+    for (std::size_t k = 0; k < m_numberChannels; ++k) {
+        // Check if the input task is connected
+        assert(m_inputChannels[k] != nullptr && "MultiChannelFft: No input task is connected");
+        m_inValues[k] = m_inputChannels[k]->peek<InputType>(N);
+    }
+
+    // Compute the non-redundant halves (N / 2 + 1 bins) then 0 padding of the upper halves
+    if (m_layout == Layout::Separate) {
+        for (std::size_t k = 0; k < m_numberChannels; ++k) {
+            m_outValues[k] = m_outputChannels[k].acquireWrite< std::complex<InputType> >(N);
+        }
+
+        m_wrapperFFTW.computeBatchR2C(m_inValues, m_outValues, 1, N);
+
+        for (std::size_t k = 0; k < m_numberChannels; ++k) {
+            std::fill(m_outValues[k] + N / 2, m_outValues[k] + N, std::complex<InputType>(0.0, 0.0));
+            m_outputChannels[k].commit< std::complex<InputType> >(N);
+        }
+    }
+    else {
+        std::complex<InputType> *outValues = m_outputChannels[0].acquireWrite< std::complex<InputType> >(N * m_numberChannels);
+        for (std::size_t k = 0; k < m_numberChannels; ++k) {
+            m_outValues[k] = outValues + k;
+        }
+
+        // The bin N / 2 is written before the 0 padding
+        m_wrapperFFTW.computeBatchR2C(m_inValues, m_outValues, m_numberChannels, N);
+
+        std::fill(outValues + (N / 2) * m_numberChannels, outValues + N * m_numberChannels, std::complex<InputType>(0.0, 0.0));
+        m_outputChannels[0].commit< std::complex<InputType> >(N * m_numberChannels);
+    }
+
+    for (std::size_t k = 0; k < m_numberChannels; ++k) {
+        m_inputChannels[k]->release<InputType>(N);
+    }
+}
+
+template<typename InputType>
+bool MultiChannelFft<InputType>::isReady(const std::uint64_t N) const {
+    for (std::size_t k = 0; k < m_numberChannels; ++k) {
+        // Check if the input task is connected
+        assert(m_inputChannels[k] != nullptr && "MultiChannelFft: No input task is connected");
+
+        if (m_inputChannels[k]->size(sizeof(InputType)) < N) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename InputType>
+bool MultiChannelFft<InputType>::hasFinished(const std::uint64_t N) const {
+    for (std::size_t i = 0; i < m_outputChannels.size(); ++i) {
+        if (m_outputChannels[i].size(sizeof(std::complex<InputType>)) < getOutputRate(i, N)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename InputType>
+std::uint64_t MultiChannelFft<InputType>::getOutputRate(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    return (m_layout == Layout::Separate) ? N : N * m_numberChannels;
+}
+
+template class MultiChannelFft<double>;
+template class MultiChannelFft<float>;
@@ -41,8 +41,8 @@ Nco::Nco(double amplitude, const double signalFrequency, const double sampleFreq
 }
 
 void Nco::compute(const std::uint64_t N) {
-    std::vector<double> cosValues(N);
-    std::vector<double> sinValues(N);
+    double *cosValues = m_outputChannels[0].acquireWrite<double>(N);
+    double *sinValues = m_outputChannels[1].acquireWrite<double>(N);
 
     // Generate a perfect signal
     for (std::size_t i = 0; i < N; ++i) {
@@ -51,8 +51,8 @@ void Nco::compute(const std::uint64_t N) {
         m_index = (m_index + m_indexStep) % m_LUT_SIZE;
     }
 
-    m_outputChannels[0].send(cosValues);
-    m_outputChannels[1].send(sinValues);
+    m_outputChannels[0].commit<double>(N);
+    m_outputChannels[1].commit<double>(N);
 
     /// 100% equal to Unit test
     // static double STEP = 2.0 * M_PI * m_signalFrequency * (1.0 / m_sampleFrequency);
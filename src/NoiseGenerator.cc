@@ -42,10 +42,8 @@ void NoiseGenerator<T>::compute(const std::uint64_t N) {
     // Generate the normal noise
     generateNoise(N);
 
-    std::complex<double> cplx;
-
-    // Convert into deque
-    std::vector<double> outValues(N);
+    // Write into the output window
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
     switch (m_outputType) {
     case OutputType::XTT:
     case OutputType::PHI:
@@ -54,19 +52,19 @@ void NoiseGenerator<T>::compute(const std::uint64_t N) {
             // Compute the mean
             double mean = 0.0;
             for (std::size_t i = 0; i < N; ++i) {
-                mean += m_data[i].real();
+                mean += m_data[i];
             }
             mean /= m_data.size();
 
             // Substract the mean and return value
             for (std::size_t i = 0; i < N; ++i) {
-                outValues[i] = m_data[i].real() - mean;
+                outValues[i] = m_data[i] - mean;
             }
         }
         break;
     case OutputType::ARBITRARY_UNIT:
         for (std::size_t i = 0; i < N; ++i) {
-            outValues[i] = m_data[i].real();
+            outValues[i] = m_data[i];
         }
         break;
     case OutputType::YTT:
@@ -74,7 +72,7 @@ void NoiseGenerator<T>::compute(const std::uint64_t N) {
         break;
     }
 
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<double>(N);
 }
 
 template <typename T>
@@ -101,8 +99,9 @@ void NoiseGenerator<T>::filter(const std::uint64_t N) {
 
     double cor = sqrt(0.0 / TAU0); /// 0 au lieu de h0
 
-    m_data[0].real(m_data[0].real() * cor); /* on filtre l'amplitude de la fréquence nulle à part :    */
-    m_data[0].imag(m_data[0].imag() * cor); /* seul h0 intervient pour ne pas multiplier par 0 cette   */
+    /* on filtre l'amplitude de la fréquence nulle à part :    */
+    /* seul h0 intervient pour ne pas multiplier par 0 cette   */
+    m_spectrum[0] *= cor;
 
     for(std::size_t i = 1; i < LIMIT; ++i) {
         cor = static_cast<double>(i) / static_cast<double>(N);
@@ -114,10 +113,8 @@ void NoiseGenerator<T>::filter(const std::uint64_t N) {
         // std::sqrt(std::abs(static_cast<double>(hm3/R2i/Ri + hm2/R2i + hm1/Ri + h0 + hp1*Ri + hp2*R2i))/tau0)
         Rx = std::sqrt(static_cast<double>(0.0 / R2i / Ri + 0.0 / R2i + 0.0 / Ri + 0.0 + 0.0 * Ri + m_hp2 * R2i) / TAU0);
 
-        m_data[i].real(m_data[i].real() * Rx);           /* fréquences "positives" */
-        m_data[i].imag(m_data[i].imag() * Rx);
-        m_data[N - i].real(m_data[N - i].real() * Rx);   /* fréquences "négatives" */
-        m_data[N - i].imag(m_data[N - i].imag() * Rx);
+        // The "negative" frequencies are the conjugates of "positive" ones
+        m_spectrum[i] *= Rx;
     }
 
     Ri  = 0.5 / TAU0;
@@ -127,8 +124,7 @@ void NoiseGenerator<T>::filter(const std::uint64_t N) {
     // std::sqrt(std::abs(static_cast<double>(hm3/R2i/Ri + hm2/R2i + hm1/Ri + h0 + hp1*Ri + hp2*R2i))/tau0)
     Rx = std::sqrt(std::abs(static_cast<double>(0.0 / R2i / Ri + 0.0 / R2i + 0.0 / Ri + 0.0 + 0.0 * Ri + m_hp2 * R2i)) / TAU0);
 
-    m_data[LIMIT].real(m_data[LIMIT].real() * Rx);
-    m_data[LIMIT].imag(m_data[LIMIT].imag() * Rx);
+    m_spectrum[LIMIT] *= Rx;
 
     // Compute the inverse FFT
     computeFFT(FFTDirection::Backward, N);
@@ -139,40 +135,40 @@ void NoiseGenerator<T>::convertXTT(double x0, const std::uint64_t N) {
     const double TAU0 = 1 / m_freqSamples;
     double xint, yint;
 
-    yint = m_data[0].real();
-    m_data[0].real(x0);
+    yint = m_data[0];
+    m_data[0] = x0;
 
     for(std::size_t i = 0; i < N - 1; ++i) {
-        xint = m_data[i].real() + yint * TAU0;
-        yint = m_data[i+1].real();
-        m_data[i+1].real(xint);
+        xint = m_data[i] + yint * TAU0;
+        yint = m_data[i+1];
+        m_data[i+1] = xint;
     }
 }
 
 template <typename T>
 void NoiseGenerator<T>::convertPhase(const std::uint64_t N) {
     for(std::size_t i = 0; i < N; ++i) {
-        m_data[i].real(2 * M_PI * m_freqSignal * m_data[i].real());
+        m_data[i] = 2 * M_PI * m_freqSignal * m_data[i];
     }
 }
 
 template <typename T>
 void NoiseGenerator<T>::computeFFT(FFTDirection sign, const std::uint64_t N) {
-    // Compute the FFT
+    // Compute the FFT and normalize
     switch(sign) {
     case FFTDirection::Forward:
-        m_fftForward.compute(m_data, m_data, N);
+        m_fftForward.computeR2C(m_data, m_spectrum, N);
+        for (auto &value: m_spectrum) {
+            value /= std::sqrt(static_cast<double>(N));
+        }
         break;
     case FFTDirection::Backward:
-        m_fftBackward.compute(m_data, m_data, N);
+        m_fftBackward.computeC2R(m_spectrum, m_data, N);
+        for (auto &value: m_data) {
+            value /= std::sqrt(static_cast<double>(N));
+        }
         break;
     }
-
-    // Normalize
-    for (std::size_t i = 0; i < N; ++i) {
-       m_data[i].real(m_data[i].real() / std::sqrt(static_cast<double>(N)));
-       m_data[i].imag(m_data[i].imag() / std::sqrt(static_cast<double>(N)));
-    }
 }
 
 template <typename T>
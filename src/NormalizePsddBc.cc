@@ -34,15 +34,15 @@ void NormalizePsddBc::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert(m_inputChannels[0] != nullptr && "NormalizePsddBc: No input task is connected");
 
-    std::vector<double> inValues(N);
-    std::vector<double> outValues(N);
-
-    m_inputChannels[0]->receive(inValues, N);
+    // Work directly in the channel windows
+    const double *inValues = m_inputChannels[0]->peek<double>(N);
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
 
     // Normalize
-    normalize_psd_dBc(inValues.data(), N, m_FS, outValues.data());
+    normalize_psd_dBc(inValues, N, m_FS, outValues);
 
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<double>(N);
+    m_inputChannels[0]->release<double>(N);
 }
 
 bool NormalizePsddBc::isReady(const std::uint64_t N) const {
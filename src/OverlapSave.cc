@@ -0,0 +1,182 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+
+#include <dsps/OverlapSave.h>
+
+#include <algorithm>
+#include <cassert>
+
+template<typename T>
+OverlapSave<T>::OverlapSave(const std::vector<T> &impulseResponse, const std::uint64_t blockSize)
+: m_blockSize(blockSize)
+, m_fftSize(2 * blockSize)
+, m_numberBins(blockSize + 1)
+, m_numberPartitions((impulseResponse.size() + blockSize - 1) / blockSize)
+, m_forward(FFTDirection::Forward)
+, m_backward(FFTDirection::Backward)
+, m_impulseResponse(impulseResponse)
+, m_partitions()
+, m_delayLine(m_numberPartitions * m_numberBins)
+, m_delayLineIndex(0)
+, m_pastSum(m_numberBins)
+, m_pastSumValid(false)
+, m_time(m_fftSize, Real(0))
+, m_spectrum(m_numberBins)
+, m_result(m_numberBins)
+, m_output(m_fftSize)
+, m_fill(0) {
+    assert(m_blockSize > 0 && "OverlapSave: The block size must be positive");
+    assert(m_numberPartitions > 0 && "OverlapSave: The impulse response is empty");
+}
+
+template<typename T>
+void OverlapSave<T>::convolve(const T *input, const std::size_t size, T *output) {
+    // The partitions are transformed in the context of processing
+    if (m_partitions.empty()) {
+        initPartitions();
+    }
+
+    std::size_t done = 0;
+
+    while (done < size) {
+        // Fill the current block
+        const std::size_t begin = m_fill;
+        const std::size_t count = std::min<std::size_t>(size - done, m_blockSize - m_fill);
+        for (std::size_t i = 0; i < count; ++i) {
+            m_time[m_blockSize + m_fill + i] = static_cast<Real>(input[done + i]);
+        }
+        m_fill += count;
+
+        // The missing samples of an incomplete block are zeros
+        std::fill(m_time.begin() + m_blockSize + m_fill, m_time.end(), Real(0));
+        computeBlock(begin, m_fill, output + done);
+        done += count;
+
+        if (m_fill == m_blockSize) {
+            commitBlock();
+        }
+    }
+}
+
+template<typename T>
+void OverlapSave<T>::skip(const std::size_t size) {
+    std::size_t done = 0;
+
+    while (done < size) {
+        const std::size_t count = std::min<std::size_t>(size - done, m_blockSize - m_fill);
+        std::fill_n(m_time.begin() + m_blockSize + m_fill, count, Real(0));
+        m_fill += count;
+        done += count;
+
+        // Only the spectrum of a complete block is needed
+        if (m_fill == m_blockSize) {
+            m_forward.computeR2C(m_time.data(), m_spectrum.data(), m_fftSize);
+            commitBlock();
+        }
+    }
+}
+
+template<typename T>
+std::uint64_t OverlapSave<T>::getBlockSize() const {
+    return m_blockSize;
+}
+
+template<typename T>
+std::uint64_t OverlapSave<T>::defaultBlockSize(const std::uint64_t numberTaps, const std::uint64_t chunkSize) {
+    // Four partitions balance the FFT cost and the delay line products
+    std::uint64_t blockSize = 64;
+    while (blockSize < 4096 && 4 * blockSize < numberTaps) {
+        blockSize *= 2;
+    }
+
+    // The nearest divisor of chunks between the half and the double of the power of two
+    if (chunkSize > 0 && chunkSize % blockSize != 0) {
+        for (std::uint64_t delta = 1; delta <= blockSize; ++delta) {
+            if (delta <= blockSize / 2 && chunkSize % (blockSize - delta) == 0) {
+                return blockSize - delta;
+            }
+
+            if (chunkSize % (blockSize + delta) == 0) {
+                return blockSize + delta;
+            }
+        }
+    }
+
+    return blockSize;
+}
+
+template<typename T>
+void OverlapSave<T>::initPartitions() {
+    m_partitions.resize(m_numberPartitions * m_numberBins);
+
+    // Half spectra of zero padded partitions, normalised for the inverse FFT
+    const Real scale = Real(1) / static_cast<Real>(m_fftSize);
+    std::vector<Real> partition(m_fftSize);
+    for (std::uint64_t p = 0; p < m_numberPartitions; ++p) {
+        std::fill(partition.begin(), partition.end(), Real(0));
+        for (std::uint64_t i = 0; i < m_blockSize && p * m_blockSize + i < m_impulseResponse.size(); ++i) {
+            partition[i] = static_cast<Real>(m_impulseResponse[p * m_blockSize + i]) * scale;
+        }
+
+        m_forward.computeR2C(partition.data(), m_partitions.data() + p * m_numberBins, m_fftSize);
+    }
+}
+
+template<typename T>
+void OverlapSave<T>::computeBlock(const std::size_t begin, const std::size_t end, T *output) {
+    // The products with the complete past blocks don't change until the commit
+    if (!m_pastSumValid) {
+        std::fill(m_pastSum.begin(), m_pastSum.end(), std::complex<Real>(0, 0));
+        for (std::uint64_t p = 1; p < m_numberPartitions; ++p) {
+            const std::uint64_t slot = (m_delayLineIndex + m_numberPartitions - p) % m_numberPartitions;
+            const std::complex<Real> *past = m_delayLine.data() + slot * m_numberBins;
+            const std::complex<Real> *partition = m_partitions.data() + p * m_numberBins;
+            for (std::uint64_t k = 0; k < m_numberBins; ++k) {
+                m_pastSum[k] += partition[k] * past[k];
+            }
+        }
+        m_pastSumValid = true;
+    }
+
+    // Half spectrum of the previous and current blocks
+    m_forward.computeR2C(m_time.data(), m_spectrum.data(), m_fftSize);
+    for (std::uint64_t k = 0; k < m_numberBins; ++k) {
+        m_result[k] = m_pastSum[k] + m_partitions[k] * m_spectrum[k];
+    }
+
+    // The second half is free of circular aliasing
+    m_backward.computeC2R(m_result.data(), m_output.data(), m_fftSize);
+    for (std::size_t i = begin; i < end; ++i) {
+        output[i - begin] = static_cast<T>(m_output[m_blockSize + i]);
+    }
+}
+
+template<typename T>
+void OverlapSave<T>::commitBlock() {
+    // Store the spectrum of complete block
+    std::copy(m_spectrum.begin(), m_spectrum.end(), m_delayLine.begin() + m_delayLineIndex * m_numberBins);
+    m_delayLineIndex = (m_delayLineIndex + 1) % m_numberPartitions;
+    m_pastSumValid = false;
+
+    // The current block becomes the previous one
+    std::copy(m_time.begin() + m_blockSize, m_time.end(), m_time.begin());
+    m_fill = 0;
+}
+
+template class OverlapSave<double>;
+template class OverlapSave<float>;
@@ -0,0 +1,319 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/ParallelProcessor.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <dsps/Channel.h>
+#include <dsps/Task.h>
+#include <dsps/Utils.h>
+
+constexpr std::size_t DSP::ParallelProcessor::SourceRound;
+
+DSP::ParallelProcessor::ParallelProcessor(std::size_t numThreads, std::uint64_t pipelineDepth, const ExecutionContext &context)
+: m_pipelineDepth(pipelineDepth)
+, m_context(context)
+, m_shutdown(false)
+, m_N(0)
+, m_sourceRunning(false)
+, m_numberRounds(0)
+, m_numberRunning(0)
+, m_stopping(false)
+, m_done(true) {
+    assert(m_pipelineDepth > 0 && "ParallelProcessor: The pipeline depth must be positive");
+
+    if (numThreads == 0) {
+        numThreads = m_context.countThreads();
+    }
+
+    for (std::size_t i = 0; i < numThreads; ++i) {
+        m_workers.emplace_back(&ParallelProcessor::workerLoop, this, i);
+    }
+}
+
+DSP::ParallelProcessor::~ParallelProcessor() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_jobAvailable.notify_all();
+
+    for (auto &worker: m_workers) {
+        worker.join();
+    }
+}
+
+void DSP::ParallelProcessor::processing(std::list<Task*> sourceTask, std::list<Task*> outputTask, const std::uint64_t N) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    assert(m_done && "ParallelProcessor: A processing is already running");
+
+    // Linearisation of DAG without the source tasks (computed by round)
+    m_sources.assign(sourceTask.begin(), sourceTask.end());
+    m_tasks.clear();
+    for (Task *task: dagLinearisation(sourceTask)) {
+        if (m_sources.end() == std::find(m_sources.begin(), m_sources.end(), task) && m_tasks.end() == std::find(m_tasks.begin(), m_tasks.end(), task)) {
+            m_tasks.push_back(task);
+        }
+    }
+
+    // Find the index of output tasks
+    m_outputs.assign(outputTask.begin(), outputTask.end());
+    m_outputIndexes.clear();
+    for (Task *task: m_outputs) {
+        auto it = std::find(m_tasks.begin(), m_tasks.end(), task);
+        m_outputIndexes.push_back((it == m_tasks.end()) ? SourceRound : static_cast<std::size_t>(it - m_tasks.begin()));
+    }
+
+    // A producer can fire while its output has less than pipelineDepth windows
+    for (Task *task: m_sources) {
+        reserveRings(task, (m_pipelineDepth + 1) * N);
+    }
+    for (Task *task: m_tasks) {
+        reserveRings(task, (m_pipelineDepth + 1) * N);
+    }
+
+    // Reset the state
+    m_N = N;
+    m_running.assign(m_tasks.size(), false);
+    m_sourceRunning = false;
+    m_numberRounds = 0;
+    m_numberRunning = 0;
+    m_stopping = false;
+    m_done = false;
+
+    schedule();
+    m_processingDone.wait(lock, [this]() {
+        return m_done;
+    });
+
+    // The channels use their queue again, no task is running
+    for (Channel *channel: m_rings) {
+        channel->setQueueBuffer();
+    }
+    m_rings.clear();
+}
+
+std::size_t DSP::ParallelProcessor::countThreads() const {
+    return m_workers.size();
+}
+
+void DSP::ParallelProcessor::workerLoop(const std::size_t index) {
+    // The worker stays in the context until the shutdown
+    ExecutionContext::Scope scope(m_context, index);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+        m_jobAvailable.wait(lock, [this]() {
+            return m_shutdown || !m_jobs.empty();
+        });
+
+        if (m_jobs.empty()) {
+            return;
+        }
+
+        std::size_t job = m_jobs.front();
+        m_jobs.pop_front();
+
+        // Compute without lock, the task is owned by this thread
+        lock.unlock();
+        if (job == SourceRound) {
+            for (Task *task: m_sources) {
+                if (task->isReady(m_N)) {
+                    task->compute(m_N);
+                }
+            }
+        }
+        else {
+            m_tasks[job]->compute(m_N);
+        }
+        lock.lock();
+
+        // Release the task and find the next jobs
+        if (job == SourceRound) {
+            m_sourceRunning = false;
+            ++m_numberRounds;
+        }
+        else {
+            m_running[job] = false;
+        }
+        --m_numberRunning;
+
+        schedule();
+    }
+}
+
+void DSP::ParallelProcessor::schedule() {
+    if (m_done) {
+        return;
+    }
+
+    // Like DSP::processing, we compute at least one round before checking the output tasks
+    if (!m_stopping && m_numberRounds > 0 && haveOutputsFinished()) {
+        m_stopping = true;
+    }
+
+    std::size_t numberJobs = m_jobs.size();
+
+    // Compute all ready tasks which aren't throttled
+    for (std::size_t i = 0; i < m_tasks.size(); ++i) {
+        if (!m_running[i] && m_tasks[i]->isReady(m_N) && (m_stopping || !isThrottled(m_tasks[i]))) {
+            m_running[i] = true;
+            m_jobs.push_back(i);
+            ++m_numberRunning;
+        }
+    }
+
+    // Start a new round of source tasks
+    if (!m_stopping && !m_sourceRunning && areSourcesReady() && !areSourcesThrottled()) {
+        m_sourceRunning = true;
+        m_jobs.push_back(SourceRound);
+        ++m_numberRunning;
+    }
+
+    if (m_numberRunning == 0) {
+        // Nothing remains to compute
+        if (m_stopping) {
+            m_done = true;
+            m_processingDone.notify_all();
+            return;
+        }
+
+        // The graph is stalled because a task needs more than the pipeline depth (ex: a FIR)
+        for (std::size_t i = 0; i < m_tasks.size(); ++i) {
+            if (m_tasks[i]->isReady(m_N)) {
+                dispatchUnthrottled(i);
+            }
+        }
+
+        if (m_numberRunning == 0 && areSourcesReady()) {
+            dispatchUnthrottled(SourceRound);
+        }
+
+        // All sources are at the end of stream and nothing remains to compute
+        if (m_numberRunning == 0) {
+            m_done = true;
+            m_processingDone.notify_all();
+            return;
+        }
+    }
+
+    // Wake up the workers
+    for (std::size_t i = numberJobs; i < m_jobs.size(); ++i) {
+        m_jobAvailable.notify_one();
+    }
+}
+
+void DSP::ParallelProcessor::dispatchUnthrottled(std::size_t job) {
+    // No task is running, so the rings can be grown safely
+    if (job == SourceRound) {
+        for (Task *task: m_sources) {
+            reserveRings(task, m_N);
+        }
+    }
+    else {
+        reserveRings(m_tasks[job], m_N);
+    }
+
+    if (job == SourceRound) {
+        m_sourceRunning = true;
+    }
+    else {
+        m_running[job] = true;
+    }
+    m_jobs.push_back(job);
+    ++m_numberRunning;
+}
+
+void DSP::ParallelProcessor::reserveRings(Task *task, const std::uint64_t length) {
+    const std::size_t DATA_SIZE = sizeOfChannelType(task->getOutputChannelType());
+    if (DATA_SIZE == 0) {
+        return;
+    }
+
+    // Only the channels with a consumer use a ring
+    for (std::size_t i = 0; i < task->countNextTask(); ++i) {
+        Channel &channel = task->getOutput(i);
+        const std::size_t REQUIRED = channel.size(1) + length * DATA_SIZE;
+
+        if (task->getNextTask(i) != nullptr && channel.getRingCapacity() < REQUIRED) {
+            // Grow with a margin to avoid many reallocation
+            if (channel.getRingCapacity() == 0) {
+                m_rings.push_back(&channel);
+                channel.setRingBuffer(REQUIRED);
+            }
+            else {
+                channel.setRingBuffer(2 * REQUIRED);
+            }
+        }
+    }
+}
+
+bool DSP::ParallelProcessor::isThrottled(Task *task) const {
+    const std::size_t DATA_SIZE = sizeOfChannelType(task->getOutputChannelType());
+    if (DATA_SIZE == 0) {
+        return false;
+    }
+
+    // Only the channels with a consumer are limited
+    for (std::size_t i = 0; i < task->countNextTask(); ++i) {
+        if (task->getNextTask(i) != nullptr && task->getOutput(i).size(DATA_SIZE) >= m_pipelineDepth * m_N) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DSP::ParallelProcessor::areSourcesReady() const {
+    // The round is useful while one source isn't at the end of stream
+    for (Task *task: m_sources) {
+        if (task->isReady(m_N)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DSP::ParallelProcessor::areSourcesThrottled() const {
+    for (Task *task: m_sources) {
+        if (isThrottled(task)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DSP::ParallelProcessor::haveOutputsFinished() const {
+    for (std::size_t i = 0; i < m_outputs.size(); ++i) {
+        // A running task can't be checked
+        const std::size_t INDEX = m_outputIndexes[i];
+        if ((INDEX == SourceRound && m_sourceRunning) || (INDEX != SourceRound && m_running[INDEX])) {
+            return false;
+        }
+
+        if (!m_outputs[i]->hasFinished(m_N)) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,163 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/PolyphaseDecimator.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <dsps/Channel.h>
+
+template<typename T>
+PolyphaseDecimator<T>::PolyphaseDecimator(const std::string &coeffPath, const std::uint64_t DECIM_FACTOR, const int64_t maxNOB)
+: Task(getChannelType<T>(), 1, getChannelType<T>(), 1)
+, m_numberTaps(0)
+, m_DECIM_FACTOR(DECIM_FACTOR)
+, m_maxNOB(maxNOB)
+, m_phaseCoeff(DECIM_FACTOR)
+, m_phaseInput(DECIM_FACTOR)
+, m_phaseStart(0)
+, m_nextPhase(0)
+, m_bufferedSize(0) {
+    assert(m_DECIM_FACTOR > 0 && "PolyphaseDecimator: The decimation factor must be positive");
+
+    // Load the coefficients in reverse order, like Fir
+    std::ifstream inFile;
+    inFile.open(coeffPath);
+
+    if (inFile.fail()) {
+        std::cerr << "PolyphaseDecimator::PolyphaseDecimator(): The file '" << coeffPath << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(1);
+    }
+
+    std::vector<T> coeffs;
+    T coeff;
+    while (inFile >> coeff) {
+        coeffs.insert(coeffs.begin(), coeff);
+    }
+    inFile.close();
+
+    if (coeffs.size() == 0) {
+        std::cerr << "PolyphaseDecimator::PolyphaseDecimator(): The file '" << coeffPath << "' is empty!" << std::endl;
+        std::exit(1);
+    }
+
+    // The phase p gets the coefficients p, p + D, p + 2D...
+    m_numberTaps = coeffs.size();
+    for (std::size_t k = 0; k < coeffs.size(); ++k) {
+        m_phaseCoeff[k % m_DECIM_FACTOR].push_back(coeffs[k]);
+    }
+}
+
+template<typename T>
+void PolyphaseDecimator<T>::compute(const std::uint64_t N) {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "PolyphaseDecimator: No input task is connected");
+
+    const std::uint64_t INPUT_SIZE = N * m_DECIM_FACTOR + m_numberTaps;
+    const std::uint64_t INPUT_SIZE_DIFF = INPUT_SIZE - m_bufferedSize;
+
+    // Move the unused samples back to the begin when the consumed part is the largest
+    if (m_phaseStart > 0 && m_phaseStart >= m_phaseInput[0].size() - m_phaseStart) {
+        for (std::vector<T> &phase: m_phaseInput) {
+            phase.erase(phase.begin(), phase.begin() + std::min(m_phaseStart, phase.size()));
+        }
+        m_phaseStart = 0;
+    }
+
+    // Deinterleave the input data: the sample n * D + p goes to the phase p
+    const T *inValues = m_inputChannels[0]->peek<T>(INPUT_SIZE_DIFF);
+    for (std::uint64_t i = 0; i < INPUT_SIZE_DIFF; ++i) {
+        m_phaseInput[m_nextPhase].push_back(inValues[i]);
+        m_nextPhase = (m_nextPhase + 1 == m_DECIM_FACTOR) ? 0 : m_nextPhase + 1;
+    }
+    m_inputChannels[0]->release<T>(INPUT_SIZE_DIFF);
+
+    // out[j] = sum_p sum_m x[(j + m) * D + p] * c[m * D + p]
+    T *outValues = m_outputChannels[0].acquireWrite<T>(N);
+    std::fill(outValues, outValues + N, T(0));
+    for (std::uint64_t p = 0; p < m_DECIM_FACTOR; ++p) {
+        const std::vector<T> &coeffs = m_phaseCoeff[p];
+        const T *phaseValues = m_phaseInput[p].data() + m_phaseStart;
+
+        for (std::uint64_t j = 0; j < N; ++j) {
+            T sum = 0;
+            for (std::size_t m = 0; m < coeffs.size(); ++m) {
+                sum += phaseValues[j + m] * coeffs[m];
+            }
+            outValues[j] += sum;
+        }
+    }
+    truncate(outValues, N);
+    m_outputChannels[0].commit<T>(N);
+
+    // Keep the history
+    m_phaseStart += N;
+    m_bufferedSize = m_numberTaps;
+}
+
+template<typename T>
+bool PolyphaseDecimator<T>::isReady(const std::uint64_t N) const {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "PolyphaseDecimator: No input task is connected");
+
+    return (m_inputChannels[0]->size(sizeof(T)) + m_bufferedSize) >= (N * m_DECIM_FACTOR + m_numberTaps);
+}
+
+template<typename T>
+bool PolyphaseDecimator<T>::hasFinished(const std::uint64_t N) const {
+    return m_outputChannels[0].size(sizeof(T)) >= N;
+}
+
+template<typename T>
+std::uint64_t PolyphaseDecimator<T>::getInputRate(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    return N * m_DECIM_FACTOR;
+}
+
+template<typename T>
+std::uint64_t PolyphaseDecimator<T>::getInputDelay(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    USELESS_PARAMETER(N);
+    return m_numberTaps;
+}
+
+template<>
+void PolyphaseDecimator<std::int64_t>::truncate(std::int64_t *outValues, const std::uint64_t N) const {
+    // Same wrap as Fir
+    if (m_maxNOB > 0) {
+      uint64_t dataSize = sizeof(int64_t) * 8;
+      assert(m_maxNOB < dataSize);
+      uint64_t shift = dataSize - m_maxNOB;
+      for (size_t i = 0; i < N; ++i) {
+        outValues[i] = (outValues[i] << shift) >> shift;
+      }
+    }
+}
+
+template<typename T>
+void PolyphaseDecimator<T>::truncate(T *outValues, const std::uint64_t N) const {
+    // Only the integers are truncated
+    USELESS_PARAMETER(outValues);
+    USELESS_PARAMETER(N);
+}
+
+template class PolyphaseDecimator<double>;
+template class PolyphaseDecimator<float>;
+template class PolyphaseDecimator<std::int64_t>;
@@ -0,0 +1,132 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/PolyphaseInterpolator.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <dsps/Channel.h>
+
+template<typename T>
+PolyphaseInterpolator<T>::PolyphaseInterpolator(const std::string &coeffPath, const std::uint64_t INTERP_FACTOR)
+: Task(getChannelType<T>(), 1, getChannelType<T>(), 1)
+, m_INTERP_FACTOR(INTERP_FACTOR)
+, m_phaseCoeff(INTERP_FACTOR)
+, m_historySize(0)
+, m_bufferStart(0) {
+    assert(m_INTERP_FACTOR > 0 && "PolyphaseInterpolator: The interpolation factor must be positive");
+
+    // Load the coefficients
+    std::ifstream inFile;
+    inFile.open(coeffPath);
+
+    if (inFile.fail()) {
+        std::cerr << "PolyphaseInterpolator::PolyphaseInterpolator(): The file '" << coeffPath << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(1);
+    }
+
+    std::vector<T> coeffs;
+    T coeff;
+    while (inFile >> coeff) {
+        coeffs.push_back(coeff);
+    }
+    inFile.close();
+
+    if (coeffs.size() == 0) {
+        std::cerr << "PolyphaseInterpolator::PolyphaseInterpolator(): The file '" << coeffPath << "' is empty!" << std::endl;
+        std::exit(1);
+    }
+
+    // The phase p gets h[p], h[p + I], h[p + 2I]... stored in reverse order
+    for (std::size_t k = 0; k < coeffs.size(); ++k) {
+        m_phaseCoeff[k % m_INTERP_FACTOR].insert(m_phaseCoeff[k % m_INTERP_FACTOR].begin(), coeffs[k]);
+    }
+
+    // The inputs before the stream start are zeros
+    m_historySize = m_phaseCoeff[0].size() - 1;
+    m_inputBuffer.assign(m_historySize, T(0));
+}
+
+template<typename T>
+void PolyphaseInterpolator<T>::compute(const std::uint64_t N) {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "PolyphaseInterpolator: No input task is connected");
+    assert(N % m_INTERP_FACTOR == 0 && "PolyphaseInterpolator: The window size must be a multiple of interpolation factor");
+
+    const std::uint64_t INPUT_SIZE = N / m_INTERP_FACTOR;
+
+    // The window slides in the buffer, the history is moved back to the
+    // begin only when the next window doesn't fit
+    if (m_bufferStart + m_historySize + INPUT_SIZE > m_inputBuffer.size()) {
+        std::copy_n(m_inputBuffer.begin() + m_bufferStart, m_historySize, m_inputBuffer.begin());
+        m_bufferStart = 0;
+
+        if (m_inputBuffer.size() < m_historySize + INPUT_SIZE * BufferWindows) {
+            m_inputBuffer.resize(m_historySize + INPUT_SIZE * BufferWindows);
+        }
+    }
+
+    // Load the input data
+    const T *inValues = m_inputChannels[0]->peek<T>(INPUT_SIZE);
+    std::copy_n(inValues, INPUT_SIZE, m_inputBuffer.begin() + m_bufferStart + m_historySize);
+    m_inputChannels[0]->release<T>(INPUT_SIZE);
+
+    // y[m * I + p] = sum_q h[q * I + p] * x[m - q]
+    T *outValues = m_outputChannels[0].acquireWrite<T>(N);
+    for (std::uint64_t p = 0; p < m_INTERP_FACTOR; ++p) {
+        const std::vector<T> &coeffs = m_phaseCoeff[p];
+        const T *inputValues = m_inputBuffer.data() + m_bufferStart + m_historySize + 1 - coeffs.size();
+
+        for (std::uint64_t m = 0; m < INPUT_SIZE; ++m) {
+            T sum = 0;
+            for (std::size_t q = 0; q < coeffs.size(); ++q) {
+                sum += inputValues[m + q] * coeffs[q];
+            }
+            outValues[m * m_INTERP_FACTOR + p] = sum;
+        }
+    }
+    m_outputChannels[0].commit<T>(N);
+
+    // Keep the history
+    m_bufferStart += INPUT_SIZE;
+}
+
+template<typename T>
+bool PolyphaseInterpolator<T>::isReady(const std::uint64_t N) const {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "PolyphaseInterpolator: No input task is connected");
+
+    return m_inputChannels[0]->size(sizeof(T)) >= N / m_INTERP_FACTOR;
+}
+
+template<typename T>
+bool PolyphaseInterpolator<T>::hasFinished(const std::uint64_t N) const {
+    return m_outputChannels[0].size(sizeof(T)) >= N;
+}
+
+template<typename T>
+std::uint64_t PolyphaseInterpolator<T>::getInputRate(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    return N / m_INTERP_FACTOR;
+}
+
+template class PolyphaseInterpolator<double>;
+template class PolyphaseInterpolator<float>;
+template class PolyphaseInterpolator<std::int64_t>;
@@ -0,0 +1,120 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/QuantileEstimator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+constexpr std::size_t QuantileEstimator::NumberMarkers;
+
+QuantileEstimator::QuantileEstimator(const double quantile)
+: m_quantile(quantile)
+, m_count(0) {
+    assert(quantile >= 0.0 && quantile <= 1.0 && "QuantileEstimator: The quantile must be in [0, 1]");
+}
+
+void QuantileEstimator::add(const double value) {
+    // Increments by value of the desired positions of markers
+    const double increments[NumberMarkers] = { 0.0, m_quantile / 2.0, m_quantile, (1.0 + m_quantile) / 2.0, 1.0 };
+
+    // The first values are the initial markers
+    if (m_count < NumberMarkers) {
+        m_heights[m_count++] = value;
+        if (m_count == NumberMarkers) {
+            std::sort(m_heights, m_heights + NumberMarkers);
+            for (std::size_t i = 0; i < NumberMarkers; ++i) {
+                m_positions[i] = static_cast<double>(i);
+                m_desiredPositions[i] = 4.0 * increments[i];
+            }
+        }
+        return;
+    }
+    ++m_count;
+
+    // Cell of value, the extreme markers follow the min and the max
+    std::size_t cell = 0;
+    if (value < m_heights[0]) {
+        m_heights[0] = value;
+    }
+    else if (value >= m_heights[4]) {
+        m_heights[4] = value;
+        cell = 3;
+    }
+    else {
+        while (value >= m_heights[cell + 1]) {
+            ++cell;
+        }
+    }
+
+    for (std::size_t i = cell + 1; i < NumberMarkers; ++i) {
+        m_positions[i] += 1.0;
+    }
+    for (std::size_t i = 0; i < NumberMarkers; ++i) {
+        m_desiredPositions[i] += increments[i];
+    }
+
+    // Move the middle markers to their desired positions
+    double *q = m_heights;
+    double *n = m_positions;
+    for (std::size_t i = 1; i < NumberMarkers - 1; ++i) {
+        const double delta = m_desiredPositions[i] - n[i];
+        if ((delta >= 1.0 && n[i + 1] - n[i] > 1.0) || (delta <= -1.0 && n[i - 1] - n[i] < -1.0)) {
+            const double sign = (delta > 0.0) ? 1.0 : -1.0;
+
+            // Piecewise parabolic prediction, else linear
+            const double parabolic = q[i] + sign / (n[i + 1] - n[i - 1])
+                * ((n[i] - n[i - 1] + sign) * (q[i + 1] - q[i]) / (n[i + 1] - n[i])
+                + (n[i + 1] - n[i] - sign) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+
+            if (q[i - 1] < parabolic && parabolic < q[i + 1]) {
+                q[i] = parabolic;
+            }
+            else {
+                const std::size_t neighbour = (sign > 0.0) ? i + 1 : i - 1;
+                q[i] += sign * (q[neighbour] - q[i]) / (n[neighbour] - n[i]);
+            }
+            n[i] += sign;
+        }
+    }
+}
+
+double QuantileEstimator::get() const {
+    if (m_count == 0) {
+        return 0.0;
+    }
+
+    if (m_count >= NumberMarkers) {
+        return m_heights[2];
+    }
+
+    // Nearest rank of the first values
+    double values[NumberMarkers];
+    std::copy(m_heights, m_heights + m_count, values);
+    const std::size_t rank = static_cast<std::size_t>(std::round(m_quantile * (m_count - 1)));
+    std::nth_element(values, values + rank, values + m_count);
+    return values[rank];
+}
+
+std::uint64_t QuantileEstimator::count() const {
+    return m_count;
+}
+
+void QuantileEstimator::clear() {
+    m_count = 0;
+}
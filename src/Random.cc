@@ -45,3 +45,10 @@ void Random::computeNormalPlage(const double mean, const double stddev, std::vec
         d.imag(0.0);
     }
 }
+
+void Random::computeNormalPlage(const double mean, const double stddev, std::vector<double> &data) {
+    std::normal_distribution<double> dist(mean, stddev);
+    for (auto &d: data) {
+        d = dist(m_engine);
+    }
+}
@@ -0,0 +1,263 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/ReadAhead.h>
+
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+constexpr std::size_t ReadAhead::DefaultDepth;
+constexpr std::size_t ReadAhead::DefaultBlockSize;
+
+ReadAhead::ReadAhead(const std::string &filename, bool loop, std::size_t depth, std::size_t blockSize)
+: m_filename(filename)
+, m_fd(-1)
+, m_loop(loop)
+, m_blockSize(blockSize)
+, m_blocks(depth)
+, m_readIndex(0)
+, m_writeIndex(0)
+, m_filled(0)
+, m_holding(false)
+, m_stop(false)
+, m_nextOffset(0)
+, m_stallTime(0)
+, m_stallCount(0) {
+    assert(depth >= 2 && "ReadAhead: The depth must be at least 2");
+    assert(blockSize > 0 && "ReadAhead: The block size must be positive");
+
+    m_fd = open(filename.c_str(), O_RDONLY);
+    if (m_fd == -1) {
+        std::cerr << "ReadAhead::ReadAhead(): The file '" << filename << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    // The blocks are allocated once, the reader thread only fills them
+    for (Block &block: m_blocks) {
+        block.data.resize(m_blockSize);
+    }
+
+    start(0);
+}
+
+ReadAhead::~ReadAhead() {
+    stop();
+    close(m_fd);
+}
+
+std::size_t ReadAhead::getDepth() const {
+    return m_blocks.size();
+}
+
+std::size_t ReadAhead::getBlockSize() const {
+    return m_blockSize;
+}
+
+double ReadAhead::getStallTime() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<double>(m_stallTime) * 1e-9;
+}
+
+std::uint64_t ReadAhead::countStalls() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stallCount;
+}
+
+ReadAhead::int_type ReadAhead::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Without loop, the reader is stopped after the end of file
+    if (m_holding && m_blocks[m_readIndex].end && !m_loop) {
+        return traits_type::eof();
+    }
+
+    releaseBlock();
+
+    if (m_filled == 0) {
+        auto begin = std::chrono::steady_clock::now();
+        m_blockFilled.wait(lock, [this]() { return m_filled > 0; });
+        auto end = std::chrono::steady_clock::now();
+
+        m_stallTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+        ++m_stallCount;
+    }
+
+    Block &block = m_blocks[m_readIndex];
+    m_holding = true;
+
+    if (block.end) {
+        m_nextOffset = m_loop ? 0 : block.offset;
+        setg(nullptr, nullptr, nullptr);
+        return traits_type::eof();
+    }
+
+    m_nextOffset = block.offset + block.size;
+    setg(block.data.data(), block.data.data(), block.data.data() + block.size);
+    return traits_type::to_int_type(*gptr());
+}
+
+ReadAhead::pos_type ReadAhead::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+    if (!(which & std::ios_base::in) || dir == std::ios_base::end) {
+        return pos_type(off_type(-1));
+    }
+
+    // The position in the file of next character
+    std::uint64_t current = m_nextOffset;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_holding && !m_blocks[m_readIndex].end) {
+            current = m_blocks[m_readIndex].offset + (gptr() - eback());
+        }
+    }
+
+    if (dir == std::ios_base::cur) {
+        if (off == 0) {
+            return pos_type(current);
+        }
+
+        return seekpos(pos_type(current + off), which);
+    }
+
+    return seekpos(pos_type(off), which);
+}
+
+ReadAhead::pos_type ReadAhead::seekpos(pos_type pos, std::ios_base::openmode which) {
+    if (!(which & std::ios_base::in) || off_type(pos) < 0) {
+        return pos_type(off_type(-1));
+    }
+
+    const std::uint64_t position = off_type(pos);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Inside the current block, only the get area moves
+        if (m_holding && !m_blocks[m_readIndex].end) {
+            const Block &block = m_blocks[m_readIndex];
+            if (position >= block.offset && position <= block.offset + block.size) {
+                setg(eback(), eback() + (position - block.offset), egptr());
+                return pos;
+            }
+        }
+
+        // The blocks already read follow the position (the rewind of a loop)
+        if (position == m_nextOffset && !(m_holding && m_blocks[m_readIndex].end && !m_loop)) {
+            releaseBlock();
+            setg(nullptr, nullptr, nullptr);
+            return pos;
+        }
+    }
+
+    // Else the blocks read in advance are useless
+    stop();
+    start(position);
+    return pos;
+}
+
+void ReadAhead::run(std::uint64_t offset) {
+    for (;;) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_blockFreed.wait(lock, [this]() { return m_stop || m_filled < m_blocks.size(); });
+        if (m_stop) {
+            return;
+        }
+
+        // The consumer doesn't touch the blocks which aren't filled
+        Block &block = m_blocks[m_writeIndex];
+        lock.unlock();
+
+        block.offset = offset;
+        block.size = 0;
+        while (block.size < m_blockSize) {
+            ssize_t count = pread(m_fd, block.data.data() + block.size, m_blockSize - block.size, offset + block.size);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (count < 0) {
+                std::cerr << "ReadAhead::run(): The file '" << m_filename << "' wasn't read: " << std::strerror(errno) << std::endl;
+                std::exit(-1);
+            }
+
+            if (count == 0) {
+                break;
+            }
+
+            block.size += count;
+        }
+        block.end = (block.size == 0);
+        offset += block.size;
+
+        lock.lock();
+        m_writeIndex = (m_writeIndex + 1) % m_blocks.size();
+        ++m_filled;
+        m_blockFilled.notify_one();
+
+        if (block.end) {
+            if (!m_loop) {
+                return;
+            }
+
+            offset = 0;
+        }
+    }
+}
+
+void ReadAhead::start(std::uint64_t offset) {
+    m_readIndex = 0;
+    m_writeIndex = 0;
+    m_filled = 0;
+    m_holding = false;
+    m_stop = false;
+    m_nextOffset = offset;
+    setg(nullptr, nullptr, nullptr);
+
+    m_reader = std::thread(&ReadAhead::run, this, offset);
+}
+
+void ReadAhead::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_blockFreed.notify_one();
+
+    if (m_reader.joinable()) {
+        m_reader.join();
+    }
+}
+
+void ReadAhead::releaseBlock() {
+    if (!m_holding) {
+        return;
+    }
+
+    m_readIndex = (m_readIndex + 1) % m_blocks.size();
+    --m_filled;
+    m_holding = false;
+    m_blockFreed.notify_one();
+}
@@ -0,0 +1,382 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/Schedule.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+
+#include <dsps/Channel.h>
+#include <dsps/Task.h>
+
+namespace {
+    std::uint64_t gcd(std::uint64_t a, std::uint64_t b) {
+        while (b != 0) {
+            std::uint64_t r = a % b;
+            a = b;
+            b = r;
+        }
+
+        return a;
+    }
+
+    std::uint64_t divideCeil(std::uint64_t a, std::uint64_t b) {
+        return (a + b - 1) / b;
+    }
+
+    /// Number of elements consumed by the first computes of a task
+    std::uint64_t consumed(std::uint64_t firings, std::uint64_t consumption, std::uint64_t delay) {
+        return (firings == 0) ? 0 : firings * consumption + delay;
+    }
+}
+
+DSP::Schedule::Schedule(std::list<Task*> sourceTask, const std::uint64_t N)
+: m_N(N)
+, m_prologueDone(false) {
+    assert(m_N > 0 && "Schedule: The window size must be positive");
+
+    sortTasks(sourceTask);
+    solveBalanceEquations();
+    computePrologue();
+
+    // The sources are interleaved like in DSP::processing, then each other
+    // task is computed in topological order
+    appendFirings(m_prologue, m_prologueCounts);
+    appendFirings(m_period, m_firingCounts);
+
+    // Compute the buffer sizes by execution of prologue and one period
+    std::vector<std::uint64_t> tokens(m_edges.size(), 0);
+    std::vector<bool> fired(m_tasks.size(), false);
+    simulate(m_prologue, tokens, fired);
+    std::vector<std::uint64_t> periodStart = tokens;
+    simulate(m_period, tokens, fired);
+
+    for (std::size_t i = 0; i < m_edges.size(); ++i) {
+        if (tokens[i] != periodStart[i]) {
+            std::cerr << "DSP::Schedule::Schedule(): The period isn't balanced!" << std::endl;
+            std::exit(-1);
+        }
+    }
+}
+
+void DSP::Schedule::processing(std::list<Task*> outputTask) {
+    if (!m_prologueDone) {
+        reserveChannels();
+        for (Task *task: m_prologue) {
+            task->compute(m_N);
+        }
+        m_prologueDone = true;
+    }
+
+    bool finished = false;
+    do {
+        for (Task *task: m_period) {
+            task->compute(m_N);
+        }
+
+        // Check if the DAG was completed
+        finished = true;
+        for (auto it = outputTask.begin(); it != outputTask.end() && finished; ++it) {
+            if (!(*it)->hasFinished(m_N)) {
+                finished = false;
+            }
+        }
+    } while (!finished);
+}
+
+void DSP::Schedule::reserveChannels() const {
+    for (std::size_t i = 0; i < m_channels.size(); ++i) {
+        Channel *channel = m_channels[i];
+        channel->reserve(m_bufferSizes[i], sizeOfChannelType(channel->getIn()->getOutputChannelType()));
+    }
+}
+
+std::uint64_t DSP::Schedule::getFiringCount(const Task *task) const {
+    std::size_t index = indexOf(task);
+    if (index == m_tasks.size()) {
+        return 0;
+    }
+
+    return m_firingCounts[index];
+}
+
+std::uint64_t DSP::Schedule::getBufferSize(const Channel *channel) const {
+    auto it = std::find(m_channels.begin(), m_channels.end(), channel);
+    if (it == m_channels.end()) {
+        return 0;
+    }
+
+    return m_bufferSizes[it - m_channels.begin()];
+}
+
+const std::vector<Task*>& DSP::Schedule::getPrologue() const {
+    return m_prologue;
+}
+
+const std::vector<Task*>& DSP::Schedule::getPeriod() const {
+    return m_period;
+}
+
+void DSP::Schedule::sortTasks(const std::list<Task*> &sourceTask) {
+    // Find all tasks of DAG
+    std::vector<Task*> tasks(sourceTask.begin(), sourceTask.end());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        for (std::size_t j = 0; j < tasks[i]->countNextTask(); ++j) {
+            Task *nextTask = tasks[i]->getNextTask(j);
+            if (nextTask != nullptr && tasks.end() == std::find(tasks.begin(), tasks.end(), nextTask)) {
+                tasks.push_back(nextTask);
+            }
+        }
+    }
+
+    // Count the inputs of each task
+    std::vector<std::size_t> numberInputs(tasks.size(), 0);
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        for (std::size_t j = 0; j < tasks[i]->countInputs(); ++j) {
+            Channel *channel = tasks[i]->getInput(j);
+            if (channel == nullptr || tasks.end() == std::find(tasks.begin(), tasks.end(), channel->getIn())) {
+                std::cerr << "DSP::Schedule::sortTasks(): An input of task isn't connected to the DAG!" << std::endl;
+                std::exit(-1);
+            }
+        }
+        numberInputs[i] = tasks[i]->countInputs();
+    }
+
+    // Topological sort (Kahn)
+    std::deque<std::size_t> readyTasks;
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        if (numberInputs[i] == 0) {
+            readyTasks.push_back(i);
+        }
+    }
+
+    while (!readyTasks.empty()) {
+        Task *task = tasks[readyTasks.front()];
+        readyTasks.pop_front();
+        m_tasks.push_back(task);
+        m_isSource.push_back(task->countInputs() == 0);
+
+        for (std::size_t j = 0; j < task->countNextTask(); ++j) {
+            Task *nextTask = task->getNextTask(j);
+            if (nextTask == nullptr) {
+                continue;
+            }
+
+            std::size_t next = std::find(tasks.begin(), tasks.end(), nextTask) - tasks.begin();
+            if (--numberInputs[next] == 0) {
+                readyTasks.push_back(next);
+            }
+        }
+    }
+
+    if (m_tasks.size() != tasks.size()) {
+        std::cerr << "DSP::Schedule::sortTasks(): The graph has a cycle!" << std::endl;
+        std::exit(-1);
+    }
+
+    // List the channels
+    for (std::size_t producer = 0; producer < m_tasks.size(); ++producer) {
+        Task *task = m_tasks[producer];
+        for (std::size_t j = 0; j < task->countNextTask(); ++j) {
+            Channel *channel = &task->getOutput(j);
+            m_channels.push_back(channel);
+
+            Task *nextTask = channel->getOut();
+            if (nextTask == nullptr) {
+                continue;
+            }
+
+            Edge edge;
+            edge.producer = producer;
+            edge.production = task->getOutputRate(j, m_N);
+            edge.consumer = indexOf(nextTask);
+            edge.consumption = 0;
+            edge.delay = 0;
+            edge.channel = channel;
+            for (std::size_t k = 0; k < nextTask->countInputs(); ++k) {
+                if (nextTask->getInput(k) == channel) {
+                    edge.consumption = nextTask->getInputRate(k, m_N);
+                    edge.delay = nextTask->getInputDelay(k, m_N);
+                }
+            }
+
+            assert(edge.production > 0 && edge.consumption > 0 && "Schedule: The rates must be positive");
+            m_edges.push_back(edge);
+        }
+    }
+}
+
+void DSP::Schedule::solveBalanceEquations() {
+    // Fraction of computes relative to the first task of each connected part
+    std::vector<std::uint64_t> numerators(m_tasks.size(), 0);
+    std::vector<std::uint64_t> denominators(m_tasks.size(), 1);
+    m_firingCounts.assign(m_tasks.size(), 0);
+
+    for (std::size_t root = 0; root < m_tasks.size(); ++root) {
+        if (numerators[root] != 0) {
+            continue;
+        }
+
+        // Propagate the rates in the connected part
+        std::vector<std::size_t> part = { root };
+        numerators[root] = 1;
+        for (std::size_t i = 0; i < part.size(); ++i) {
+            std::size_t current = part[i];
+
+            for (const Edge &edge: m_edges) {
+                std::size_t other;
+                std::uint64_t numerator;
+                std::uint64_t denominator;
+
+                // q[consumer] = q[producer] * production / consumption
+                if (edge.producer == current) {
+                    other = edge.consumer;
+                    numerator = numerators[current] * edge.production;
+                    denominator = denominators[current] * edge.consumption;
+                }
+                else if (edge.consumer == current) {
+                    other = edge.producer;
+                    numerator = numerators[current] * edge.consumption;
+                    denominator = denominators[current] * edge.production;
+                }
+                else {
+                    continue;
+                }
+
+                std::uint64_t divisor = gcd(numerator, denominator);
+                numerator /= divisor;
+                denominator /= divisor;
+
+                if (numerators[other] == 0) {
+                    numerators[other] = numerator;
+                    denominators[other] = denominator;
+                    part.push_back(other);
+                }
+                else if (numerators[other] != numerator || denominators[other] != denominator) {
+                    std::cerr << "DSP::Schedule::solveBalanceEquations(): The rates of DAG are inconsistent!" << std::endl;
+                    std::exit(-1);
+                }
+            }
+        }
+
+        // Smallest integer solution
+        std::uint64_t multiple = 1;
+        for (std::size_t task: part) {
+            multiple = multiple / gcd(multiple, denominators[task]) * denominators[task];
+        }
+
+        std::uint64_t divisor = 0;
+        for (std::size_t task: part) {
+            m_firingCounts[task] = numerators[task] * (multiple / denominators[task]);
+            divisor = gcd(divisor, m_firingCounts[task]);
+        }
+
+        for (std::size_t task: part) {
+            m_firingCounts[task] /= divisor;
+        }
+    }
+}
+
+void DSP::Schedule::computePrologue() {
+    // A task with a delay must be computed once in the prologue, and its
+    // producers must be computed enough to feed it
+    m_prologueCounts.assign(m_tasks.size(), 0);
+
+    for (std::size_t i = m_tasks.size(); i-- > 0;) {
+        for (const Edge &edge: m_edges) {
+            if (edge.consumer == i && edge.delay > 0) {
+                m_prologueCounts[i] = std::max<std::uint64_t>(m_prologueCounts[i], 1);
+            }
+        }
+
+        for (const Edge &edge: m_edges) {
+            if (edge.producer == i) {
+                std::uint64_t needed = consumed(m_prologueCounts[edge.consumer], edge.consumption, edge.delay);
+                m_prologueCounts[i] = std::max(m_prologueCounts[i], divideCeil(needed, edge.production));
+            }
+        }
+    }
+}
+
+void DSP::Schedule::appendFirings(std::vector<Task*> &firings, const std::vector<std::uint64_t> &counts) const {
+    std::uint64_t maxSourceCount = 0;
+    for (std::size_t i = 0; i < m_tasks.size(); ++i) {
+        if (m_isSource[i]) {
+            maxSourceCount = std::max(maxSourceCount, counts[i]);
+        }
+    }
+
+    for (std::uint64_t round = 0; round < maxSourceCount; ++round) {
+        for (std::size_t i = 0; i < m_tasks.size(); ++i) {
+            if (m_isSource[i] && round < counts[i]) {
+                firings.push_back(m_tasks[i]);
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < m_tasks.size(); ++i) {
+        if (!m_isSource[i]) {
+            firings.insert(firings.end(), counts[i], m_tasks[i]);
+        }
+    }
+}
+
+void DSP::Schedule::simulate(const std::vector<Task*> &firings, std::vector<std::uint64_t> &tokens, std::vector<bool> &fired) {
+    m_bufferSizes.resize(m_channels.size(), 0);
+
+    for (Task *task: firings) {
+        std::size_t index = indexOf(task);
+
+        for (std::size_t i = 0; i < m_edges.size(); ++i) {
+            const Edge &edge = m_edges[i];
+            if (edge.consumer == index) {
+                std::uint64_t needed = edge.consumption + (fired[index] ? 0 : edge.delay);
+                assert(tokens[i] >= needed && "Schedule: A task is computed without enough input data");
+                tokens[i] -= needed;
+            }
+        }
+        fired[index] = true;
+
+        for (std::size_t i = 0; i < m_edges.size(); ++i) {
+            const Edge &edge = m_edges[i];
+            if (edge.producer == index) {
+                tokens[i] += edge.production;
+
+                std::size_t channel = std::find(m_channels.begin(), m_channels.end(), edge.channel) - m_channels.begin();
+                m_bufferSizes[channel] = std::max(m_bufferSizes[channel], tokens[i]);
+            }
+        }
+    }
+
+    // The channels without output task grow by the production of one period
+    for (std::size_t producer = 0; producer < m_tasks.size(); ++producer) {
+        Task *task = m_tasks[producer];
+        for (std::size_t j = 0; j < task->countNextTask(); ++j) {
+            if (task->getNextTask(j) == nullptr) {
+                std::size_t channel = std::find(m_channels.begin(), m_channels.end(), &task->getOutput(j)) - m_channels.begin();
+                m_bufferSizes[channel] = m_firingCounts[producer] * task->getOutputRate(j, m_N);
+            }
+        }
+    }
+}
+
+std::size_t DSP::Schedule::indexOf(const Task *task) const {
+    return std::find(m_tasks.begin(), m_tasks.end(), task) - m_tasks.begin();
+}
@@ -17,6 +17,12 @@
 
 #include <dsps/Shifter.h>
 
+#include <cmath>
+#include <cstdlib>
+
+#include <dsps/Channel.h>
+#include <dsps/Simd.h>
+
 template<typename InputType>
 Shifter<InputType>::Shifter(const std::int16_t shift)
 : Task(getChannelType<InputType>(), 1, getChannelType<InputType>(), 1)
@@ -28,18 +34,14 @@ void Shifter<InputType>::compute(const std::uint64_t N) {
     // Check if the input task is connected
     assert(m_inputChannels[0] != nullptr && "Shifter: No input task is connected");
 
-    std::vector<InputType> inValues(N);
-    std::vector<InputType> outValues(N);
+    // Work directly in the channel windows
+    const InputType *inValues = m_inputChannels[0]->peek<InputType>(N);
+    InputType *outValues = m_outputChannels[0].acquireWrite<InputType>(N);
 
-    m_inputChannels[0]->receive(inValues, N);
-
-    // Case for intger values
-    for (std::size_t i = 0; i < N; ++i) {
-        outValues[i] = divideBy(inValues[i]);
-    }
-    // Case for floating point values
+    computeElementwise(inValues, outValues, N);
 
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<InputType>(N);
+    m_inputChannels[0]->release<InputType>(N);
 }
 
 template<typename InputType>
@@ -56,16 +58,64 @@ bool Shifter<InputType>::hasFinished(const std::uint64_t N) const {
 }
 
 template<typename InputType>
-InputType Shifter<InputType>::divideBy(const InputType value) {
+bool Shifter<InputType>::isElementwise() const {
+    return true;
+}
+
+template<typename InputType>
+void Shifter<InputType>::computeElementwise(const void *inValues, void *outValues, const std::size_t size) const {
+    divideBy(static_cast<const InputType*>(inValues), static_cast<InputType*>(outValues), size);
+}
+
+template<typename InputType>
+InputType Shifter<InputType>::divideBy(const InputType value) const {
     return value / std::pow(2, m_shift);
 }
 
 // Specialization for int64
 template<>
-std::int64_t Shifter<std::int64_t>::divideBy(const std::int64_t value) {
+std::int64_t Shifter<std::int64_t>::divideBy(const std::int64_t value) const {
     return value >> m_shift;
 }
 
+template<typename InputType>
+void Shifter<InputType>::divideBy(const InputType *inValues, InputType *outValues, const std::uint64_t N) const {
+    for (std::size_t i = 0; i < N; ++i) {
+        outValues[i] = divideBy(inValues[i]);
+    }
+}
+
+// The product by 2^-shift is the same as the division while 2^-shift is a
+// normal number
+template<>
+void Shifter<double>::divideBy(const double *inValues, double *outValues, const std::uint64_t N) const {
+    if (std::abs(m_shift) > 1022) {
+        for (std::size_t i = 0; i < N; ++i) {
+            outValues[i] = divideBy(inValues[i]);
+        }
+        return;
+    }
+
+    DSP::Simd::scale(inValues, std::pow(2.0, -m_shift), outValues, N);
+}
+
+template<>
+void Shifter<float>::divideBy(const float *inValues, float *outValues, const std::uint64_t N) const {
+    if (std::abs(m_shift) > 126) {
+        for (std::size_t i = 0; i < N; ++i) {
+            outValues[i] = divideBy(inValues[i]);
+        }
+        return;
+    }
+
+    DSP::Simd::scale(inValues, static_cast<float>(std::pow(2.0, -m_shift)), outValues, N);
+}
+
+template<>
+void Shifter<std::int64_t>::divideBy(const std::int64_t *inValues, std::int64_t *outValues, const std::uint64_t N) const {
+    DSP::Simd::shiftRight(inValues, m_shift, outValues, N);
+}
+
 template class Shifter<float>;
 template class Shifter<double>;
 template class Shifter<std::int64_t>;
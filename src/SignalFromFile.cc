@@ -17,6 +17,8 @@
 
 #include <dsps/SignalFromFile.h>
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 
 #include <dsps/Channel.h>
@@ -25,6 +27,8 @@
 SignalFromFile::SignalFromFile(const std::string &path)
 : Task(ChannelType::None, 0, ChannelType::Double, 1)
 , m_path(path)
+, m_input(nullptr)
+, m_parser(m_input)
 , m_reader(ReaderType::RAM)
 , m_repeat(false)
 , m_currentIndex(0)
@@ -38,6 +42,8 @@ SignalFromFile::SignalFromFile(const std::string &path)
 SignalFromFile::SignalFromFile(const std::string &path, bool repeat)
 : Task(ChannelType::None, 0, ChannelType::Double, 1)
 , m_path(path)
+, m_input(nullptr)
+, m_parser(m_input)
 , m_reader(ReaderType::STREAM)
 , m_repeat(repeat)
 , m_currentIndex(0)
@@ -49,6 +55,8 @@ SignalFromFile::SignalFromFile(const std::string &path, bool repeat)
 SignalFromFile::SignalFromFile(const std::string &path, bool repeat, std::uint64_t overlap)
 : Task(ChannelType::None, 0, ChannelType::Double, 1)
 , m_path(path)
+, m_input(nullptr)
+, m_parser(m_input)
 , m_reader(ReaderType::OVERLAPS)
 , m_repeat(repeat)
 , m_currentIndex(0)
@@ -62,14 +70,13 @@ void SignalFromFile::compute(const std::uint64_t N) {
     switch (m_reader) {
     case ReaderType::RAM:
     {
-        std::vector<double> outValues(N);
-
         // Send the data
+        double *outValues = m_outputChannels[0].acquireWrite<double>(N);
         for (std::size_t i = 0; i < N; ++i) {
             outValues[i] = m_buffer[(m_currentIndex + i) % m_buffer.size()];
         }
 
-        m_outputChannels[0].send(outValues);
+        m_outputChannels[0].commit<double>(N);
 
         // Update the current index
         m_currentIndex = (m_currentIndex + N) % m_buffer.size();
@@ -84,10 +91,8 @@ void SignalFromFile::compute(const std::uint64_t N) {
         readBuffer(N);
         sendBuffer(N);
 
-        // Shift the buffer
-        for (std::size_t i = 0; i < m_overlap; ++i) {
-            m_buffer.pop_front();
-        }
+        // Shift the buffer, its capacity is kept for the next windows
+        m_buffer.erase(m_buffer.begin(), m_buffer.begin() + std::min<std::size_t>(m_overlap, m_buffer.size()));
         break;
     }
 }
@@ -102,15 +107,27 @@ bool SignalFromFile::hasFinished(const std::uint64_t N) const {
     return m_outputChannels[0].size(sizeof(double)) >= N;
 }
 
+void SignalFromFile::enableReadAhead(std::size_t depth, std::size_t blockSize) {
+    assert(m_reader != ReaderType::RAM && "SignalFromFile: The file is already in RAM");
+
+    m_readAhead.reset(new ReadAhead(m_path, m_repeat, depth, blockSize));
+    m_input.rdbuf(m_readAhead.get());
+    m_file.close();
+}
+
+const ReadAhead *SignalFromFile::getReadAhead() const {
+    return m_readAhead.get();
+}
+
 void SignalFromFile::readBuffer(const std::uint64_t N) {
     double d = 0.0;
     for (std::size_t i = m_buffer.size(); i < N; ++i) {
-        m_file >> d;
-        if (m_file.eof()) {
+        if (!m_parser.read(d)) {
             if (m_repeat) {
-                m_file.clear();
-                m_file.seekg(0);
-                m_file >> d;
+                m_input.clear();
+                m_input.seekg(0);
+                m_parser.reset();
+                m_parser.read(d);
             }
             else {
                 std::cerr << "Data input missing" << std::endl;
@@ -122,14 +139,10 @@ void SignalFromFile::readBuffer(const std::uint64_t N) {
 }
 
 void SignalFromFile::sendBuffer(const std::uint64_t N) {
-    std::vector<double> outValues(N);
-
     // Send the data
-    for (std::size_t i = 0; i < N; ++i) {
-        outValues[i] = m_buffer[i];
-    }
-
-    m_outputChannels[0].send(outValues);
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
+    std::copy_n(m_buffer.begin(), N, outValues);
+    m_outputChannels[0].commit<double>(N);
 }
 
 void SignalFromFile::checkFile() {
@@ -138,14 +151,21 @@ void SignalFromFile::checkFile() {
         std::cerr << "Error: no data file \"" << m_path << "\" not found!" << std::endl;
         std::exit(1);
     }
+
+    m_input.rdbuf(m_file.rdbuf());
 }
 
 void SignalFromFile::loadToRam() {
-    double d;
-    while (m_file >> d) {
-        m_buffer.push_back(d);
+    // Load the text at once, then parse it by chunks in parallel
+    std::vector<char> text;
+    char block[1 << 16];
+    while (m_input.read(block, sizeof(block)) || m_input.gcount() > 0) {
+        text.insert(text.end(), block, block + m_input.gcount());
     }
 
+    std::vector<double> values = TextParser::parseAll<double>(text.data(), text.data() + text.size());
+    m_buffer.assign(values.begin(), values.end());
+
     // Check if the data was not empty
     if (m_buffer.size() == 0) {
         std::cerr << "Error: Not recognized file format or file was empty!" << std::endl;
@@ -41,7 +41,7 @@ SignalGenerator::SignalGenerator(double amplitude, double signalFrequency, doubl
 }
 
 void SignalGenerator::compute(const std::uint64_t N) {
-    std::vector<double> outValues(N);
+    double *outValues = m_outputChannels[0].acquireWrite<double>(N);
 
     // Generate a perfect signal
     for (std::size_t i = 0; i < N; ++i) {
@@ -49,7 +49,7 @@ void SignalGenerator::compute(const std::uint64_t N) {
         m_index = (m_index + m_indexStep) % m_LUT_SIZE;
     }
 
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<double>(N);
 }
 
 bool SignalGenerator::isReady(const std::uint64_t N) const {
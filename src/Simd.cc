@@ -0,0 +1,373 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/Simd.h>
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "SimdKernels.h"
+
+namespace {
+    using DSP::Simd::InstructionSet;
+    using DSP::Simd::KernelTable;
+
+    constexpr std::size_t NumberInstructionSets = 4;
+
+    void scaleDouble(const double *in, const double gain, double *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = in[i] * gain;
+        }
+    }
+
+    void scaleFloat(const float *in, const float gain, float *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = in[i] * gain;
+        }
+    }
+
+    void multiplyDouble(const double *in1, const double *in2, double *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = in1[i] * in2[i];
+        }
+    }
+
+    void multiplyFloat(const float *in1, const float *in2, float *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = in1[i] * in2[i];
+        }
+    }
+
+    void accumulateDouble(const double *in, double *accum, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            accum[i] += in[i];
+        }
+    }
+
+    void accumulateFloat(const float *in, float *accum, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            accum[i] += in[i];
+        }
+    }
+
+    void accumulateInt64(const std::int64_t *in, std::int64_t *accum, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            accum[i] += in[i];
+        }
+    }
+
+    void absDouble(const double *in, double *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = std::abs(in[i]);
+        }
+    }
+
+    void absFloat(const float *in, float *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = std::abs(in[i]);
+        }
+    }
+
+    void magnitudeDouble(const double *in, double *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = std::abs(std::complex<double>(in[2 * i], in[2 * i + 1]));
+        }
+    }
+
+    void magnitudeFloat(const float *in, float *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = std::abs(std::complex<float>(in[2 * i], in[2 * i + 1]));
+        }
+    }
+
+    void atan2Double(const double *y, const double *x, double *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = std::atan2(y[i], x[i]);
+        }
+    }
+
+    void shiftRightInt64(const std::int64_t *in, const unsigned shift, std::int64_t *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = in[i] >> shift;
+        }
+    }
+
+    template<typename T>
+    void quantize(const T *in, const T gain, const T invMax, std::int64_t *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = static_cast<std::int64_t>(std::round(invMax * (in[i] * gain)));
+        }
+    }
+
+    void convertInt64(const std::int64_t *in, double *out, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] = static_cast<double>(in[i]);
+        }
+    }
+
+    const KernelTable ScalarKernels = {
+        &scaleDouble,
+        &scaleFloat,
+        &multiplyDouble,
+        &multiplyFloat,
+        &accumulateDouble,
+        &accumulateFloat,
+        &accumulateInt64,
+        &absDouble,
+        &absFloat,
+        &magnitudeDouble,
+        &magnitudeFloat,
+        &atan2Double,
+        &shiftRightInt64,
+        &quantize<double>,
+        &quantize<float>,
+        &convertInt64,
+    };
+
+    // Replace the kernels of base by the non null kernels of overlay
+    template<typename Kernel>
+    void overlayKernel(Kernel &base, const Kernel overlay) {
+        if (overlay != nullptr) {
+            base = overlay;
+        }
+    }
+
+    void overlayKernels(KernelTable &base, const KernelTable &overlay) {
+        overlayKernel(base.scaleDouble, overlay.scaleDouble);
+        overlayKernel(base.scaleFloat, overlay.scaleFloat);
+        overlayKernel(base.multiplyDouble, overlay.multiplyDouble);
+        overlayKernel(base.multiplyFloat, overlay.multiplyFloat);
+        overlayKernel(base.accumulateDouble, overlay.accumulateDouble);
+        overlayKernel(base.accumulateFloat, overlay.accumulateFloat);
+        overlayKernel(base.accumulateInt64, overlay.accumulateInt64);
+        overlayKernel(base.absDouble, overlay.absDouble);
+        overlayKernel(base.absFloat, overlay.absFloat);
+        overlayKernel(base.magnitudeDouble, overlay.magnitudeDouble);
+        overlayKernel(base.magnitudeFloat, overlay.magnitudeFloat);
+        overlayKernel(base.atan2Double, overlay.atan2Double);
+        overlayKernel(base.shiftRightInt64, overlay.shiftRightInt64);
+        overlayKernel(base.quantizeDouble, overlay.quantizeDouble);
+        overlayKernel(base.quantizeFloat, overlay.quantizeFloat);
+        overlayKernel(base.convertInt64, overlay.convertInt64);
+    }
+
+    struct Dispatcher {
+        Dispatcher()
+        : bestSet(DSP::Simd::detectInstructionSet()) {
+            // Each set falls back to the kernels of the lower sets. The
+            // tables of the sets not supported by the CPU are never read,
+            // their files are compiled for those sets.
+            tables[0] = ScalarKernels;
+            for (std::size_t i = 1; i < NumberInstructionSets; ++i) {
+                tables[i] = tables[i - 1];
+                if (i > static_cast<std::size_t>(bestSet)) {
+                    continue;
+                }
+
+                switch (static_cast<InstructionSet>(i)) {
+                case InstructionSet::SSE2:
+                    overlayKernels(tables[i], DSP::Simd::getSse2Kernels());
+                    break;
+
+                case InstructionSet::AVX2:
+                    overlayKernels(tables[i], DSP::Simd::getAvx2Kernels());
+                    break;
+
+                case InstructionSet::AVX512:
+                    overlayKernels(tables[i], DSP::Simd::getAvx512Kernels());
+                    break;
+
+                default:
+                    break;
+                }
+            }
+
+            // The environment can force a lower set
+            InstructionSet selectedSet = bestSet;
+            const char *env = std::getenv("DSPS_SIMD");
+            if (env != nullptr && env[0] != '\0') {
+                bool found = false;
+                for (std::size_t i = 0; i < NumberInstructionSets && !found; ++i) {
+                    if (std::strcmp(env, DSP::Simd::getInstructionSetName(static_cast<InstructionSet>(i))) == 0) {
+                        selectedSet = static_cast<InstructionSet>(i);
+                        found = true;
+                    }
+                }
+
+                if (!found) {
+                    std::cerr << "DSP::Simd: The instruction set '" << env << "' of DSPS_SIMD is unknown!" << std::endl;
+                    std::exit(-1);
+                }
+
+                if (selectedSet > bestSet) {
+                    std::cerr << "DSP::Simd: The instruction set '" << env << "' of DSPS_SIMD isn't supported by the CPU!" << std::endl;
+                    std::exit(-1);
+                }
+            }
+
+            current.store(&tables[static_cast<std::size_t>(selectedSet)]);
+        }
+
+        const InstructionSet bestSet;
+        KernelTable tables[NumberInstructionSets];
+        std::atomic<const KernelTable*> current;
+    };
+
+    Dispatcher& getDispatcher() {
+        static Dispatcher dispatcher;
+        return dispatcher;
+    }
+
+    const KernelTable& kernels() {
+        return *getDispatcher().current.load(std::memory_order_relaxed);
+    }
+}
+
+DSP::Simd::InstructionSet DSP::Simd::detectInstructionSet() {
+#if defined(__x86_64__) || defined(__i386__)
+    // CPUID with the check of the registers saved by the OS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return InstructionSet::AVX512;
+    }
+
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX2;
+    }
+
+    if (__builtin_cpu_supports("sse2")) {
+        return InstructionSet::SSE2;
+    }
+#endif
+
+    return InstructionSet::Scalar;
+}
+
+bool DSP::Simd::isSupported(const InstructionSet instructionSet) {
+    return instructionSet <= getDispatcher().bestSet;
+}
+
+DSP::Simd::InstructionSet DSP::Simd::getInstructionSet() {
+    Dispatcher &dispatcher = getDispatcher();
+    return static_cast<InstructionSet>(dispatcher.current.load() - dispatcher.tables);
+}
+
+void DSP::Simd::setInstructionSet(const InstructionSet instructionSet) {
+    if (!isSupported(instructionSet)) {
+        std::cerr << "DSP::Simd::setInstructionSet(): The instruction set '" << getInstructionSetName(instructionSet) << "' isn't supported by the CPU!" << std::endl;
+        std::exit(-1);
+    }
+
+    Dispatcher &dispatcher = getDispatcher();
+    dispatcher.current.store(&dispatcher.tables[static_cast<std::size_t>(instructionSet)]);
+}
+
+const char* DSP::Simd::getInstructionSetName(const InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case InstructionSet::Scalar:
+        return "scalar";
+
+    case InstructionSet::SSE2:
+        return "sse2";
+
+    case InstructionSet::AVX2:
+        return "avx2";
+
+    case InstructionSet::AVX512:
+        return "avx512";
+    }
+
+    return "unknown";
+}
+
+void DSP::Simd::scale(const double *in, const double gain, double *out, const std::size_t size) {
+    kernels().scaleDouble(in, gain, out, size);
+}
+
+void DSP::Simd::scale(const float *in, const float gain, float *out, const std::size_t size) {
+    kernels().scaleFloat(in, gain, out, size);
+}
+
+void DSP::Simd::scale(const std::complex<double> *in, const double gain, std::complex<double> *out, const std::size_t size) {
+    // The complex values are pairs of doubles
+    kernels().scaleDouble(reinterpret_cast<const double*>(in), gain, reinterpret_cast<double*>(out), 2 * size);
+}
+
+void DSP::Simd::multiply(const double *in1, const double *in2, double *out, const std::size_t size) {
+    kernels().multiplyDouble(in1, in2, out, size);
+}
+
+void DSP::Simd::multiply(const float *in1, const float *in2, float *out, const std::size_t size) {
+    kernels().multiplyFloat(in1, in2, out, size);
+}
+
+void DSP::Simd::accumulate(const double *in, double *accum, const std::size_t size) {
+    kernels().accumulateDouble(in, accum, size);
+}
+
+void DSP::Simd::accumulate(const float *in, float *accum, const std::size_t size) {
+    kernels().accumulateFloat(in, accum, size);
+}
+
+void DSP::Simd::accumulate(const std::complex<double> *in, std::complex<double> *accum, const std::size_t size) {
+    kernels().accumulateDouble(reinterpret_cast<const double*>(in), reinterpret_cast<double*>(accum), 2 * size);
+}
+
+void DSP::Simd::accumulate(const std::int64_t *in, std::int64_t *accum, const std::size_t size) {
+    kernels().accumulateInt64(in, accum, size);
+}
+
+void DSP::Simd::abs(const double *in, double *out, const std::size_t size) {
+    kernels().absDouble(in, out, size);
+}
+
+void DSP::Simd::abs(const float *in, float *out, const std::size_t size) {
+    kernels().absFloat(in, out, size);
+}
+
+void DSP::Simd::magnitude(const std::complex<double> *in, double *out, const std::size_t size) {
+    kernels().magnitudeDouble(reinterpret_cast<const double*>(in), out, size);
+}
+
+void DSP::Simd::magnitude(const std::complex<float> *in, float *out, const std::size_t size) {
+    kernels().magnitudeFloat(reinterpret_cast<const float*>(in), out, size);
+}
+
+void DSP::Simd::atan2(const double *y, const double *x, double *out, const std::size_t size) {
+    kernels().atan2Double(y, x, out, size);
+}
+
+void DSP::Simd::shiftRight(const std::int64_t *in, const unsigned shift, std::int64_t *out, const std::size_t size) {
+    assert(shift < 64 && "DSP::Simd::shiftRight(): The shift must be lower than 64");
+    kernels().shiftRightInt64(in, shift, out, size);
+}
+
+void DSP::Simd::quantize(const double *in, const double gain, const double invMax, std::int64_t *out, const std::size_t size) {
+    kernels().quantizeDouble(in, gain, invMax, out, size);
+}
+
+void DSP::Simd::quantize(const float *in, const float gain, const float invMax, std::int64_t *out, const std::size_t size) {
+    kernels().quantizeFloat(in, gain, invMax, out, size);
+}
+
+void DSP::Simd::convert(const std::int64_t *in, double *out, const std::size_t size) {
+    kernels().convertInt64(in, out, size);
+}
@@ -0,0 +1,159 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "SimdKernels.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#include "SimdGeneric.h"
+
+namespace {
+    struct DoubleVec {
+        typedef double Scalar;
+        typedef __m256d Type;
+        typedef __m256d Mask;
+        static constexpr std::size_t Width = 4;
+
+        static Type load(const double *in) { return _mm256_loadu_pd(in); }
+        static void store(double *out, const Type a) { _mm256_storeu_pd(out, a); }
+        static Type set1(const double value) { return _mm256_set1_pd(value); }
+
+        static Type add(const Type a, const Type b) { return _mm256_add_pd(a, b); }
+        static Type sub(const Type a, const Type b) { return _mm256_sub_pd(a, b); }
+        static Type mul(const Type a, const Type b) { return _mm256_mul_pd(a, b); }
+        static Type div(const Type a, const Type b) { return _mm256_div_pd(a, b); }
+        static Type sqrt(const Type a) { return _mm256_sqrt_pd(a); }
+        static Type min(const Type a, const Type b) { return _mm256_min_pd(a, b); }
+        static Type max(const Type a, const Type b) { return _mm256_max_pd(a, b); }
+        static Type abs(const Type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+        static Type andBits(const Type a, const Type b) { return _mm256_and_pd(a, b); }
+        static Type orBits(const Type a, const Type b) { return _mm256_or_pd(a, b); }
+        static Type trunc(const Type a) { return _mm256_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+
+        static Mask less(const Type a, const Type b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+        static Mask lessEqual(const Type a, const Type b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+        static Mask equal(const Type a, const Type b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+        static Mask maskAnd(const Mask a, const Mask b) { return _mm256_and_pd(a, b); }
+        static Mask maskOr(const Mask a, const Mask b) { return _mm256_or_pd(a, b); }
+        static bool all(const Mask m) { return _mm256_movemask_pd(m) == 0xF; }
+        static Type select(const Mask m, const Type a, const Type b) { return _mm256_blendv_pd(b, a, m); }
+        static Mask negative(const Type a) { return _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_setzero_si256(), _mm256_castpd_si256(a))); }
+
+        static void deinterleave(const double *in, Type &re, Type &im) {
+            // The unpack works by 128 bits lane
+            const Type a = _mm256_loadu_pd(in);
+            const Type b = _mm256_loadu_pd(in + 4);
+            re = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+            im = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        }
+
+        static double hypot(const double re, const double im) { return ::hypot(re, im); }
+    };
+
+    struct FloatVec {
+        typedef float Scalar;
+        typedef __m256 Type;
+        typedef __m256 Mask;
+        static constexpr std::size_t Width = 8;
+
+        static Type load(const float *in) { return _mm256_loadu_ps(in); }
+        static void store(float *out, const Type a) { _mm256_storeu_ps(out, a); }
+        static Type set1(const float value) { return _mm256_set1_ps(value); }
+
+        static Type add(const Type a, const Type b) { return _mm256_add_ps(a, b); }
+        static Type sub(const Type a, const Type b) { return _mm256_sub_ps(a, b); }
+        static Type mul(const Type a, const Type b) { return _mm256_mul_ps(a, b); }
+        static Type div(const Type a, const Type b) { return _mm256_div_ps(a, b); }
+        static Type sqrt(const Type a) { return _mm256_sqrt_ps(a); }
+        static Type min(const Type a, const Type b) { return _mm256_min_ps(a, b); }
+        static Type max(const Type a, const Type b) { return _mm256_max_ps(a, b); }
+        static Type abs(const Type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+        static Type andBits(const Type a, const Type b) { return _mm256_and_ps(a, b); }
+        static Type orBits(const Type a, const Type b) { return _mm256_or_ps(a, b); }
+        static Type trunc(const Type a) { return _mm256_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+
+        static Mask less(const Type a, const Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static Mask lessEqual(const Type a, const Type b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+        static Mask equal(const Type a, const Type b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+        static Mask maskAnd(const Mask a, const Mask b) { return _mm256_and_ps(a, b); }
+        static Mask maskOr(const Mask a, const Mask b) { return _mm256_or_ps(a, b); }
+        static bool all(const Mask m) { return _mm256_movemask_ps(m) == 0xFF; }
+        static Type select(const Mask m, const Type a, const Type b) { return _mm256_blendv_ps(b, a, m); }
+
+        static void deinterleave(const float *in, Type &re, Type &im) {
+            // The shuffle works by 128 bits lane, the pairs are put back in order after
+            const Type a = _mm256_loadu_ps(in);
+            const Type b = _mm256_loadu_ps(in + 8);
+            re = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+            im = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+
+        static float hypot(const float re, const float im) { return ::hypotf(re, im); }
+    };
+
+    struct Int64Vec {
+        typedef std::int64_t Scalar;
+        typedef __m256i Type;
+        static constexpr std::size_t Width = 4;
+
+        static Type load(const std::int64_t *in) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in)); }
+        static void store(std::int64_t *out, const Type a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), a); }
+
+        static Type add(const Type a, const Type b) { return _mm256_add_epi64(a, b); }
+
+        static Type shiftRight(const Type a, const unsigned shift) {
+            // Logical shift, then the sign in the high bits
+            const Type sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), a);
+            const Type logical = _mm256_srl_epi64(a, _mm_cvtsi32_si128(shift));
+            return _mm256_or_si256(logical, _mm256_sll_epi64(sign, _mm_cvtsi32_si128(64 - shift)));
+        }
+    };
+}
+
+const DSP::Simd::KernelTable& DSP::Simd::getAvx2Kernels() {
+    static const KernelTable table = {
+        &Generic::scale<DoubleVec>,
+        &Generic::scale<FloatVec>,
+        &Generic::multiply<DoubleVec>,
+        &Generic::multiply<FloatVec>,
+        &Generic::accumulate<DoubleVec>,
+        &Generic::accumulate<FloatVec>,
+        &Generic::accumulate<Int64Vec>,
+        &Generic::abs<DoubleVec>,
+        &Generic::abs<FloatVec>,
+        &Generic::magnitudeDouble<DoubleVec>,
+        &Generic::magnitudeFloat<FloatVec>,
+        &Generic::atan2<DoubleVec>,
+        &Generic::shiftRight<Int64Vec>,
+        &Generic::quantize<DoubleVec>,
+        &Generic::quantize<FloatVec>,
+        nullptr,
+    };
+
+    return table;
+}
+
+#else
+
+const DSP::Simd::KernelTable& DSP::Simd::getAvx2Kernels() {
+    static const KernelTable table = {};
+    return table;
+}
+
+#endif
@@ -0,0 +1,162 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "SimdKernels.h"
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+
+// The undefined vectors of the AVX-512 intrinsics give false warnings with GCC 12
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+#include <immintrin.h>
+
+#include "SimdGeneric.h"
+
+namespace {
+    struct DoubleVec {
+        typedef double Scalar;
+        typedef __m512d Type;
+        typedef __mmask8 Mask;
+        static constexpr std::size_t Width = 8;
+
+        static Type load(const double *in) { return _mm512_loadu_pd(in); }
+        static void store(double *out, const Type a) { _mm512_storeu_pd(out, a); }
+        static Type set1(const double value) { return _mm512_set1_pd(value); }
+
+        static Type add(const Type a, const Type b) { return _mm512_add_pd(a, b); }
+        static Type sub(const Type a, const Type b) { return _mm512_sub_pd(a, b); }
+        static Type mul(const Type a, const Type b) { return _mm512_mul_pd(a, b); }
+        static Type div(const Type a, const Type b) { return _mm512_div_pd(a, b); }
+        static Type sqrt(const Type a) { return _mm512_sqrt_pd(a); }
+        static Type min(const Type a, const Type b) { return _mm512_min_pd(a, b); }
+        static Type max(const Type a, const Type b) { return _mm512_max_pd(a, b); }
+        static Type abs(const Type a) { return _mm512_abs_pd(a); }
+        static Type andBits(const Type a, const Type b) { return _mm512_and_pd(a, b); }
+        static Type orBits(const Type a, const Type b) { return _mm512_or_pd(a, b); }
+        static Type trunc(const Type a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+
+        static Mask less(const Type a, const Type b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+        static Mask lessEqual(const Type a, const Type b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+        static Mask equal(const Type a, const Type b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+        static Mask maskAnd(const Mask a, const Mask b) { return static_cast<Mask>(a & b); }
+        static Mask maskOr(const Mask a, const Mask b) { return static_cast<Mask>(a | b); }
+        static bool all(const Mask m) { return m == 0xFF; }
+        static Type select(const Mask m, const Type a, const Type b) { return _mm512_mask_blend_pd(m, b, a); }
+        static Mask negative(const Type a) { return _mm512_movepi64_mask(_mm512_castpd_si512(a)); }
+
+        static void deinterleave(const double *in, Type &re, Type &im) {
+            const Type a = _mm512_loadu_pd(in);
+            const Type b = _mm512_loadu_pd(in + 8);
+            re = _mm512_permutex2var_pd(a, _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0), b);
+            im = _mm512_permutex2var_pd(a, _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1), b);
+        }
+
+        static double hypot(const double re, const double im) { return ::hypot(re, im); }
+    };
+
+    struct FloatVec {
+        typedef float Scalar;
+        typedef __m512 Type;
+        typedef __mmask16 Mask;
+        static constexpr std::size_t Width = 16;
+
+        static Type load(const float *in) { return _mm512_loadu_ps(in); }
+        static void store(float *out, const Type a) { _mm512_storeu_ps(out, a); }
+        static Type set1(const float value) { return _mm512_set1_ps(value); }
+
+        static Type add(const Type a, const Type b) { return _mm512_add_ps(a, b); }
+        static Type sub(const Type a, const Type b) { return _mm512_sub_ps(a, b); }
+        static Type mul(const Type a, const Type b) { return _mm512_mul_ps(a, b); }
+        static Type div(const Type a, const Type b) { return _mm512_div_ps(a, b); }
+        static Type sqrt(const Type a) { return _mm512_sqrt_ps(a); }
+        static Type min(const Type a, const Type b) { return _mm512_min_ps(a, b); }
+        static Type max(const Type a, const Type b) { return _mm512_max_ps(a, b); }
+        static Type abs(const Type a) { return _mm512_abs_ps(a); }
+        static Type andBits(const Type a, const Type b) { return _mm512_and_ps(a, b); }
+        static Type orBits(const Type a, const Type b) { return _mm512_or_ps(a, b); }
+        static Type trunc(const Type a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+
+        static Mask less(const Type a, const Type b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+        static Mask lessEqual(const Type a, const Type b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+        static Mask equal(const Type a, const Type b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+        static Mask maskAnd(const Mask a, const Mask b) { return static_cast<Mask>(a & b); }
+        static Mask maskOr(const Mask a, const Mask b) { return static_cast<Mask>(a | b); }
+        static bool all(const Mask m) { return m == 0xFFFF; }
+        static Type select(const Mask m, const Type a, const Type b) { return _mm512_mask_blend_ps(m, b, a); }
+
+        static void deinterleave(const float *in, Type &re, Type &im) {
+            const Type a = _mm512_loadu_ps(in);
+            const Type b = _mm512_loadu_ps(in + 16);
+            re = _mm512_permutex2var_ps(a, _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16, 14, 12, 10, 8, 6, 4, 2, 0), b);
+            im = _mm512_permutex2var_ps(a, _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1), b);
+        }
+
+        static float hypot(const float re, const float im) { return ::hypotf(re, im); }
+    };
+
+    struct Int64Vec {
+        typedef std::int64_t Scalar;
+        typedef __m512i Type;
+        static constexpr std::size_t Width = 8;
+
+        static Type load(const std::int64_t *in) { return _mm512_loadu_si512(in); }
+        static void store(std::int64_t *out, const Type a) { _mm512_storeu_si512(out, a); }
+
+        static Type add(const Type a, const Type b) { return _mm512_add_epi64(a, b); }
+        static Type shiftRight(const Type a, const unsigned shift) { return _mm512_sra_epi64(a, _mm_cvtsi32_si128(shift)); }
+    };
+
+    void convertInt64(const std::int64_t *in, double *out, const std::size_t size) {
+        DSP::Simd::Generic::forEachBlock<Int64Vec>(size, [&](const std::size_t i, const std::size_t count) {
+            const __m512d values = _mm512_cvtepi64_pd(DSP::Simd::Generic::loadPartial<Int64Vec>(in + i, count));
+            DSP::Simd::Generic::storePartial<DoubleVec>(out + i, values, count);
+        });
+    }
+}
+
+const DSP::Simd::KernelTable& DSP::Simd::getAvx512Kernels() {
+    static const KernelTable table = {
+        &Generic::scale<DoubleVec>,
+        &Generic::scale<FloatVec>,
+        &Generic::multiply<DoubleVec>,
+        &Generic::multiply<FloatVec>,
+        &Generic::accumulate<DoubleVec>,
+        &Generic::accumulate<FloatVec>,
+        &Generic::accumulate<Int64Vec>,
+        &Generic::abs<DoubleVec>,
+        &Generic::abs<FloatVec>,
+        &Generic::magnitudeDouble<DoubleVec>,
+        &Generic::magnitudeFloat<FloatVec>,
+        &Generic::atan2<DoubleVec>,
+        &Generic::shiftRight<Int64Vec>,
+        &Generic::quantize<DoubleVec>,
+        &Generic::quantize<FloatVec>,
+        &convertInt64,
+    };
+
+    return table;
+}
+
+#else
+
+const DSP::Simd::KernelTable& DSP::Simd::getAvx512Kernels() {
+    static const KernelTable table = {};
+    return table;
+}
+
+#endif
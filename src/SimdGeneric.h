@@ -0,0 +1,284 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef SIMD_GENERIC_H
+#define SIMD_GENERIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <math.h>
+
+// Internal header of DSP::Simd: the kernels written once for a vector
+// policy V, which gives the type of vector, its width and the operations.
+// Each instruction set defines its policies in an anonymous namespace, so
+// the instances never mix the code of two sets.
+//
+// The files of vectorised sets are compiled with the flags of their set:
+// they must only call the C library, any inline function of the standard
+// library could be shared with the other files.
+namespace DSP {
+    namespace Simd {
+        namespace Generic {
+            // Apply a block function on the complete vectors, then on a zero
+            // padded copy of the last values, so a value doesn't depend on its
+            // position in the window.
+            template<typename V, typename Block>
+            void forEachBlock(const std::size_t size, Block block) {
+                std::size_t i = 0;
+                for (; i + V::Width <= size; i += V::Width) {
+                    block(i, V::Width);
+                }
+
+                if (i < size) {
+                    block(i, size - i);
+                }
+            }
+
+            template<typename V>
+            typename V::Type loadPartial(const typename V::Scalar *in, const std::size_t count) {
+                if (count == V::Width) {
+                    return V::load(in);
+                }
+
+                typename V::Scalar buffer[V::Width] = {};
+                std::memcpy(buffer, in, count * sizeof(typename V::Scalar));
+                return V::load(buffer);
+            }
+
+            template<typename V>
+            void storePartial(typename V::Scalar *out, const typename V::Type value, const std::size_t count) {
+                if (count == V::Width) {
+                    V::store(out, value);
+                    return;
+                }
+
+                typename V::Scalar buffer[V::Width];
+                V::store(buffer, value);
+                std::memcpy(out, buffer, count * sizeof(typename V::Scalar));
+            }
+
+            // Instantiated by policy, like all the functions of this file
+            template<typename V>
+            typename V::Scalar absValue(const typename V::Scalar value) {
+                return (value < 0) ? -value : value;
+            }
+
+            template<typename V>
+            void scale(const typename V::Scalar *in, const typename V::Scalar gain, typename V::Scalar *out, const std::size_t size) {
+                const typename V::Type vgain = V::set1(gain);
+                forEachBlock<V>(size, [&](const std::size_t i, const std::size_t count) {
+                    storePartial<V>(out + i, V::mul(loadPartial<V>(in + i, count), vgain), count);
+                });
+            }
+
+            template<typename V>
+            void multiply(const typename V::Scalar *in1, const typename V::Scalar *in2, typename V::Scalar *out, const std::size_t size) {
+                forEachBlock<V>(size, [&](const std::size_t i, const std::size_t count) {
+                    storePartial<V>(out + i, V::mul(loadPartial<V>(in1 + i, count), loadPartial<V>(in2 + i, count)), count);
+                });
+            }
+
+            template<typename V>
+            void accumulate(const typename V::Scalar *in, typename V::Scalar *accum, const std::size_t size) {
+                forEachBlock<V>(size, [&](const std::size_t i, const std::size_t count) {
+                    storePartial<V>(accum + i, V::add(loadPartial<V>(accum + i, count), loadPartial<V>(in + i, count)), count);
+                });
+            }
+
+            template<typename V>
+            void abs(const typename V::Scalar *in, typename V::Scalar *out, const std::size_t size) {
+                forEachBlock<V>(size, [&](const std::size_t i, const std::size_t count) {
+                    storePartial<V>(out + i, V::abs(loadPartial<V>(in + i, count)), count);
+                });
+            }
+
+            template<typename V>
+            void shiftRight(const std::int64_t *in, const unsigned shift, std::int64_t *out, const std::size_t size) {
+                forEachBlock<V>(size, [&](const std::size_t i, const std::size_t count) {
+                    storePartial<V>(out + i, V::shiftRight(loadPartial<V>(in + i, count), shift), count);
+                });
+            }
+
+            // The magnitude is sqrt(re^2 + im^2) when the squares can't
+            // overflow or underflow, otherwise hypot is used
+            template<typename V>
+            void magnitude(const typename V::Scalar *in, typename V::Scalar *out, const std::size_t size, const typename V::Scalar low, const typename V::Scalar high) {
+                typedef typename V::Scalar Scalar;
+                typedef typename V::Type Type;
+
+                const Type vlow = V::set1(low);
+                const Type vhigh = V::set1(high);
+                const Type vzero = V::set1(0);
+                forEachBlock<V>(size, [&](const std::size_t i, const std::size_t count) {
+                    Type re;
+                    Type im;
+                    if (count == V::Width) {
+                        V::deinterleave(in + 2 * i, re, im);
+                    }
+                    else {
+                        Scalar buffer[2 * V::Width] = {};
+                        std::memcpy(buffer, in + 2 * i, 2 * count * sizeof(Scalar));
+                        V::deinterleave(buffer, re, im);
+                    }
+
+                    const Type maxValue = V::max(V::abs(re), V::abs(im));
+                    const Type result = V::sqrt(V::add(V::mul(re, re), V::mul(im, im)));
+                    storePartial<V>(out + i, result, count);
+
+                    // NaN, infinite and extreme values
+                    const typename V::Mask valid = V::maskAnd(V::lessEqual(maxValue, vhigh), V::maskOr(V::lessEqual(vlow, maxValue), V::equal(maxValue, vzero)));
+                    if (!V::all(valid)) {
+                        for (std::size_t k = 0; k < count; ++k) {
+                            const Scalar reValue = in[2 * (i + k)];
+                            const Scalar imValue = in[2 * (i + k) + 1];
+                            const Scalar absMax = absValue<V>(reValue) > absValue<V>(imValue) ? absValue<V>(reValue) : absValue<V>(imValue);
+                            if (!(absMax <= high && (absMax >= low || absMax == 0))) {
+                                out[i + k] = V::hypot(reValue, imValue);
+                            }
+                        }
+                    }
+                });
+            }
+
+            template<typename V>
+            void magnitudeDouble(const double *in, double *out, const std::size_t size) {
+                // [2^-500, 2^500]
+                magnitude<V>(in, out, size, 3.054936363499605e-151, 3.273390607896142e+150);
+            }
+
+            template<typename V>
+            void magnitudeFloat(const float *in, float *out, const std::size_t size) {
+                // [2^-60, 2^60]
+                magnitude<V>(in, out, size, 8.6736173798840355e-19f, 1.1529215046068470e+18f);
+            }
+
+            // atan(r) for r in [0, 1] with the rational approximation of
+            // Cephes, and a reduction by pi/4 above 0.66
+            template<typename V>
+            typename V::Type atanUnit(const typename V::Type r) {
+                typedef typename V::Type Type;
+
+                static const double P[] = {
+                    -8.750608600031904122785E-1,
+                    -1.615753718733365076637E1,
+                    -7.500855792314704667340E1,
+                    -1.228866684490136173410E2,
+                    -6.485021904942025371773E1,
+                };
+                static const double Q[] = {
+                    2.485846490142306297962E1,
+                    1.650270098316988542046E2,
+                    4.328810604912902668951E2,
+                    4.853903996359136964868E2,
+                    1.945506571482613964425E2,
+                };
+                static const double PIO4 = 7.85398163397448309616E-1;
+                static const double MOREBITS = 6.123233995736765886130E-17;
+
+                const Type one = V::set1(1.0);
+                const typename V::Mask reduced = V::less(V::set1(0.66), r);
+                const Type x = V::select(reduced, V::div(V::sub(r, one), V::add(r, one)), r);
+
+                const Type z = V::mul(x, x);
+                Type p = V::set1(P[0]);
+                for (std::size_t k = 1; k < 5; ++k) {
+                    p = V::add(V::mul(p, z), V::set1(P[k]));
+                }
+                Type q = V::add(z, V::set1(Q[0]));
+                for (std::size_t k = 1; k < 5; ++k) {
+                    q = V::add(V::mul(q, z), V::set1(Q[k]));
+                }
+
+                Type result = V::add(V::mul(x, V::div(V::mul(z, p), q)), x);
+                result = V::add(result, V::select(reduced, V::set1(0.5 * MOREBITS), V::set1(0.0)));
+                return V::add(V::select(reduced, V::set1(PIO4), V::set1(0.0)), result);
+            }
+
+            template<typename V>
+            void atan2(const double *y, const double *x, double *out, const std::size_t size) {
+                typedef typename V::Type Type;
+
+                static const double PIO2 = 1.57079632679489661923;
+                static const double PI = 3.14159265358979323846;
+                static const double MOREBITS = 6.123233995736765886130E-17;
+                static const double MAX = 1.79769313486231570815e+308;
+
+                const Type zero = V::set1(0.0);
+                const Type signMask = V::set1(-0.0);
+                forEachBlock<V>(size, [&](const std::size_t i, const std::size_t count) {
+                    const Type yValues = loadPartial<V>(y + i, count);
+                    const Type xValues = loadPartial<V>(x + i, count);
+                    const Type ay = V::abs(yValues);
+                    const Type ax = V::abs(xValues);
+
+                    // Angle in [0, pi/4] from the ratio of the smallest by the largest
+                    const Type maxValue = V::max(ay, ax);
+                    const Type ratio = V::select(V::less(zero, maxValue), V::div(V::min(ay, ax), maxValue), zero);
+                    Type result = atanUnit<V>(ratio);
+
+                    // Angle in [0, pi/2] then in [0, pi]
+                    result = V::select(V::less(ax, ay), V::add(V::sub(V::set1(PIO2), result), V::set1(MOREBITS)), result);
+                    result = V::select(V::negative(xValues), V::add(V::sub(V::set1(PI), result), V::set1(2.0 * MOREBITS)), result);
+
+                    // Sign of y
+                    result = V::orBits(result, V::andBits(yValues, signMask));
+                    storePartial<V>(out + i, result, count);
+
+                    // NaN and infinite values
+                    const typename V::Mask finite = V::maskAnd(V::lessEqual(ay, V::set1(MAX)), V::lessEqual(ax, V::set1(MAX)));
+                    if (!V::all(finite)) {
+                        for (std::size_t k = 0; k < count; ++k) {
+                            if (!(y[i + k] <= MAX && y[i + k] >= -MAX && x[i + k] <= MAX && x[i + k] >= -MAX)) {
+                                out[i + k] = ::atan2(y[i + k], x[i + k]);
+                            }
+                        }
+                    }
+                });
+            }
+
+            // std::round: the truncated value moved by one when the fraction
+            // is at least one half
+            template<typename V>
+            void quantize(const typename V::Scalar *in, const typename V::Scalar gain, const typename V::Scalar invMax, std::int64_t *out, const std::size_t size) {
+                typedef typename V::Scalar Scalar;
+                typedef typename V::Type Type;
+
+                const Type vgain = V::set1(gain);
+                const Type vinvMax = V::set1(invMax);
+                const Type half = V::set1(0.5);
+                const Type one = V::set1(1.0);
+                const Type signMask = V::set1(-0.0);
+                forEachBlock<V>(size, [&](const std::size_t i, const std::size_t count) {
+                    const Type value = V::mul(vinvMax, V::mul(loadPartial<V>(in + i, count), vgain));
+                    const Type truncated = V::trunc(value);
+                    const Type step = V::orBits(one, V::andBits(value, signMask));
+                    const Type rounded = V::select(V::lessEqual(half, V::abs(V::sub(value, truncated))), V::add(truncated, step), truncated);
+
+                    Scalar buffer[V::Width];
+                    V::store(buffer, rounded);
+                    for (std::size_t k = 0; k < count; ++k) {
+                        out[i + k] = static_cast<std::int64_t>(buffer[k]);
+                    }
+                });
+            }
+        }
+    }
+}
+
+#endif // SIMD_GENERIC_H
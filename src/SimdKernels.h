@@ -0,0 +1,55 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Internal header of DSP::Simd: each instruction set fills a table of
+// kernels, a null entry falls back to the kernel of the lower set. The
+// complex values are given as interleaved real and imaginary parts.
+namespace DSP {
+    namespace Simd {
+        struct KernelTable {
+            void (*scaleDouble)(const double *in, const double gain, double *out, const std::size_t size);
+            void (*scaleFloat)(const float *in, const float gain, float *out, const std::size_t size);
+            void (*multiplyDouble)(const double *in1, const double *in2, double *out, const std::size_t size);
+            void (*multiplyFloat)(const float *in1, const float *in2, float *out, const std::size_t size);
+            void (*accumulateDouble)(const double *in, double *accum, const std::size_t size);
+            void (*accumulateFloat)(const float *in, float *accum, const std::size_t size);
+            void (*accumulateInt64)(const std::int64_t *in, std::int64_t *accum, const std::size_t size);
+            void (*absDouble)(const double *in, double *out, const std::size_t size);
+            void (*absFloat)(const float *in, float *out, const std::size_t size);
+            void (*magnitudeDouble)(const double *in, double *out, const std::size_t size);
+            void (*magnitudeFloat)(const float *in, float *out, const std::size_t size);
+            void (*atan2Double)(const double *y, const double *x, double *out, const std::size_t size);
+            void (*shiftRightInt64)(const std::int64_t *in, const unsigned shift, std::int64_t *out, const std::size_t size);
+            void (*quantizeDouble)(const double *in, const double gain, const double invMax, std::int64_t *out, const std::size_t size);
+            void (*quantizeFloat)(const float *in, const float gain, const float invMax, std::int64_t *out, const std::size_t size);
+            void (*convertInt64)(const std::int64_t *in, double *out, const std::size_t size);
+        };
+
+        // The tables are empty when the instruction set isn't compiled
+        const KernelTable& getSse2Kernels();
+        const KernelTable& getAvx2Kernels();
+        const KernelTable& getAvx512Kernels();
+    }
+}
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,179 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "SimdKernels.h"
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#include "SimdGeneric.h"
+
+namespace {
+    struct DoubleVec {
+        typedef double Scalar;
+        typedef __m128d Type;
+        typedef __m128d Mask;
+        static constexpr std::size_t Width = 2;
+
+        static Type load(const double *in) { return _mm_loadu_pd(in); }
+        static void store(double *out, const Type a) { _mm_storeu_pd(out, a); }
+        static Type set1(const double value) { return _mm_set1_pd(value); }
+
+        static Type add(const Type a, const Type b) { return _mm_add_pd(a, b); }
+        static Type sub(const Type a, const Type b) { return _mm_sub_pd(a, b); }
+        static Type mul(const Type a, const Type b) { return _mm_mul_pd(a, b); }
+        static Type div(const Type a, const Type b) { return _mm_div_pd(a, b); }
+        static Type sqrt(const Type a) { return _mm_sqrt_pd(a); }
+        static Type min(const Type a, const Type b) { return _mm_min_pd(a, b); }
+        static Type max(const Type a, const Type b) { return _mm_max_pd(a, b); }
+        static Type abs(const Type a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+        static Type andBits(const Type a, const Type b) { return _mm_and_pd(a, b); }
+        static Type orBits(const Type a, const Type b) { return _mm_or_pd(a, b); }
+
+        static Mask less(const Type a, const Type b) { return _mm_cmplt_pd(a, b); }
+        static Mask lessEqual(const Type a, const Type b) { return _mm_cmple_pd(a, b); }
+        static Mask equal(const Type a, const Type b) { return _mm_cmpeq_pd(a, b); }
+        static Mask maskAnd(const Mask a, const Mask b) { return _mm_and_pd(a, b); }
+        static Mask maskOr(const Mask a, const Mask b) { return _mm_or_pd(a, b); }
+        static bool all(const Mask m) { return _mm_movemask_pd(m) == 0x3; }
+        static Type select(const Mask m, const Type a, const Type b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+
+        static Mask negative(const Type a) {
+            // Sign of the high 32 bits spread to the 64 bits
+            return _mm_castsi128_pd(_mm_srai_epi32(_mm_shuffle_epi32(_mm_castpd_si128(a), _MM_SHUFFLE(3, 3, 1, 1)), 31));
+        }
+
+        static Type trunc(const Type a) {
+            // Round to nearest of |a| by adding 2^52, then floor and sign
+            const Type magic = _mm_set1_pd(4503599627370496.0);
+            const Type absValue = abs(a);
+            Type result = _mm_sub_pd(_mm_add_pd(absValue, magic), magic);
+            result = _mm_sub_pd(result, _mm_and_pd(_mm_cmpgt_pd(result, absValue), _mm_set1_pd(1.0)));
+            result = _mm_or_pd(result, _mm_and_pd(a, _mm_set1_pd(-0.0)));
+            return select(_mm_cmpge_pd(absValue, magic), a, result);
+        }
+
+        static void deinterleave(const double *in, Type &re, Type &im) {
+            const Type a = _mm_loadu_pd(in);
+            const Type b = _mm_loadu_pd(in + 2);
+            re = _mm_unpacklo_pd(a, b);
+            im = _mm_unpackhi_pd(a, b);
+        }
+
+        static double hypot(const double re, const double im) { return ::hypot(re, im); }
+    };
+
+    struct FloatVec {
+        typedef float Scalar;
+        typedef __m128 Type;
+        typedef __m128 Mask;
+        static constexpr std::size_t Width = 4;
+
+        static Type load(const float *in) { return _mm_loadu_ps(in); }
+        static void store(float *out, const Type a) { _mm_storeu_ps(out, a); }
+        static Type set1(const float value) { return _mm_set1_ps(value); }
+
+        static Type add(const Type a, const Type b) { return _mm_add_ps(a, b); }
+        static Type sub(const Type a, const Type b) { return _mm_sub_ps(a, b); }
+        static Type mul(const Type a, const Type b) { return _mm_mul_ps(a, b); }
+        static Type div(const Type a, const Type b) { return _mm_div_ps(a, b); }
+        static Type sqrt(const Type a) { return _mm_sqrt_ps(a); }
+        static Type min(const Type a, const Type b) { return _mm_min_ps(a, b); }
+        static Type max(const Type a, const Type b) { return _mm_max_ps(a, b); }
+        static Type abs(const Type a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+        static Type andBits(const Type a, const Type b) { return _mm_and_ps(a, b); }
+        static Type orBits(const Type a, const Type b) { return _mm_or_ps(a, b); }
+
+        static Mask less(const Type a, const Type b) { return _mm_cmplt_ps(a, b); }
+        static Mask lessEqual(const Type a, const Type b) { return _mm_cmple_ps(a, b); }
+        static Mask equal(const Type a, const Type b) { return _mm_cmpeq_ps(a, b); }
+        static Mask maskAnd(const Mask a, const Mask b) { return _mm_and_ps(a, b); }
+        static Mask maskOr(const Mask a, const Mask b) { return _mm_or_ps(a, b); }
+        static bool all(const Mask m) { return _mm_movemask_ps(m) == 0xF; }
+        static Type select(const Mask m, const Type a, const Type b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+        static Type trunc(const Type a) {
+            // Round to nearest of |a| by adding 2^23, then floor and sign
+            const Type magic = _mm_set1_ps(8388608.0f);
+            const Type absValue = abs(a);
+            Type result = _mm_sub_ps(_mm_add_ps(absValue, magic), magic);
+            result = _mm_sub_ps(result, _mm_and_ps(_mm_cmpgt_ps(result, absValue), _mm_set1_ps(1.0f)));
+            result = _mm_or_ps(result, _mm_and_ps(a, _mm_set1_ps(-0.0f)));
+            return select(_mm_cmpge_ps(absValue, magic), a, result);
+        }
+
+        static void deinterleave(const float *in, Type &re, Type &im) {
+            const Type a = _mm_loadu_ps(in);
+            const Type b = _mm_loadu_ps(in + 4);
+            re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+
+        static float hypot(const float re, const float im) { return ::hypotf(re, im); }
+    };
+
+    struct Int64Vec {
+        typedef std::int64_t Scalar;
+        typedef __m128i Type;
+        static constexpr std::size_t Width = 2;
+
+        static Type load(const std::int64_t *in) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)); }
+        static void store(std::int64_t *out, const Type a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), a); }
+
+        static Type add(const Type a, const Type b) { return _mm_add_epi64(a, b); }
+
+        static Type shiftRight(const Type a, const unsigned shift) {
+            // Logical shift, then the sign in the high bits
+            const Type sign = _mm_srai_epi32(_mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 1, 1)), 31);
+            const Type logical = _mm_srl_epi64(a, _mm_cvtsi32_si128(shift));
+            return _mm_or_si128(logical, _mm_sll_epi64(sign, _mm_cvtsi32_si128(64 - shift)));
+        }
+    };
+}
+
+const DSP::Simd::KernelTable& DSP::Simd::getSse2Kernels() {
+    static const KernelTable table = {
+        &Generic::scale<DoubleVec>,
+        &Generic::scale<FloatVec>,
+        &Generic::multiply<DoubleVec>,
+        &Generic::multiply<FloatVec>,
+        &Generic::accumulate<DoubleVec>,
+        &Generic::accumulate<FloatVec>,
+        &Generic::accumulate<Int64Vec>,
+        &Generic::abs<DoubleVec>,
+        &Generic::abs<FloatVec>,
+        &Generic::magnitudeDouble<DoubleVec>,
+        &Generic::magnitudeFloat<FloatVec>,
+        &Generic::atan2<DoubleVec>,
+        &Generic::shiftRight<Int64Vec>,
+        &Generic::quantize<DoubleVec>,
+        &Generic::quantize<FloatVec>,
+        nullptr,
+    };
+
+    return table;
+}
+
+#else
+
+const DSP::Simd::KernelTable& DSP::Simd::getSse2Kernels() {
+    static const KernelTable table = {};
+    return table;
+}
+
+#endif
@@ -0,0 +1,302 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#include <dsps/SnapshotSink.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+
+#include <signal.h>
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_streambuf.hpp>
+
+#include <dsps/Channel.h>
+#include <dsps/Utils.h>
+
+namespace {
+    // Number of received signals, shared by all snapshot sinks
+    std::atomic<std::uint64_t> receivedSignals(0);
+
+    void signalHandler(int signum) {
+        USELESS_PARAMETER(signum);
+        receivedSignals.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    void writeAsciiValue(std::ostream &file, const T &value) {
+        file << value << std::endl;
+    }
+
+    template<typename T>
+    void writeAsciiValue(std::ostream &file, const std::complex<T> &value) {
+        file << value.real() << "\t" << value.imag() << std::endl;
+    }
+}
+
+template<typename T>
+constexpr std::chrono::milliseconds SnapshotSink<T>::SignalPollPeriod;
+
+template<typename T>
+SnapshotSink<T>::SnapshotSink(const std::string &filename, std::size_t numberWindows, Format format)
+: Task(getChannelType<T>(), 1, ChannelType::None, 0)
+, m_filename(filename)
+, m_format(format)
+, m_finished(false)
+, m_windows(numberWindows)
+, m_next(0)
+, m_numberWindows(0)
+, m_requested(0)
+, m_dumped(0)
+, m_numberDumps(0)
+, m_signalsSeen(receivedSignals.load())
+, m_period(0)
+, m_stop(false) {
+    assert(numberWindows > 0 && "SnapshotSink: The number of windows must be positive");
+    m_thread = std::thread(&SnapshotSink<T>::run, this);
+}
+
+template<typename T>
+SnapshotSink<T>::~SnapshotSink() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_request.notify_one();
+    m_thread.join();
+}
+
+template<typename T>
+void SnapshotSink<T>::compute(const std::uint64_t N) {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "SnapshotSink: No input task is connected");
+
+    // The slots are allocated by the first turn of ring
+    const T *inValues = m_inputChannels[0]->peek<T>(N);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<T> &window = m_windows[m_next];
+        window.assign(inValues, inValues + N);
+        m_next = (m_next + 1) % m_windows.size();
+        ++m_numberWindows;
+    }
+    m_inputChannels[0]->release<T>(N);
+
+    m_finished = true;
+}
+
+template<typename T>
+bool SnapshotSink<T>::isReady(const std::uint64_t N) const {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "SnapshotSink: No input task is connected");
+
+    return m_inputChannels[0]->size(sizeof(T)) >= N;
+}
+
+template<typename T>
+bool SnapshotSink<T>::hasFinished(const std::uint64_t N) const {
+    USELESS_PARAMETER(N);
+    return m_finished;
+}
+
+template<typename T>
+void SnapshotSink<T>::requestDump() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_requested;
+    }
+    m_request.notify_one();
+}
+
+template<typename T>
+void SnapshotSink<T>::dump() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const std::uint64_t ticket = ++m_requested;
+    m_request.notify_one();
+    m_served.wait(lock, [this, ticket]{ return m_dumped >= ticket; });
+}
+
+template<typename T>
+void SnapshotSink<T>::setDumpPeriod(std::chrono::milliseconds period) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_period = period;
+        m_deadline = std::chrono::steady_clock::now() + period;
+    }
+    m_request.notify_one();
+}
+
+template<typename T>
+void SnapshotSink<T>::dumpOnSignal(int signum) {
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = signalHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    if (sigaction(signum, &action, nullptr) != 0) {
+        std::cerr << "SnapshotSink::dumpOnSignal(): The handler of signal " << signum << " wasn't installed: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+}
+
+template<typename T>
+void SnapshotSink<T>::getSnapshot(std::vector<T> &values) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    copyRing(values);
+}
+
+template<typename T>
+std::uint64_t SnapshotSink<T>::countWindows() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numberWindows;
+}
+
+template<typename T>
+std::uint64_t SnapshotSink<T>::countDumps() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numberDumps;
+}
+
+template<typename T>
+void SnapshotSink<T>::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+        // Wake up for a request, the timer or the polling of signal flag
+        auto wakeUp = std::chrono::steady_clock::now() + SignalPollPeriod;
+        if (m_period.count() > 0 && m_deadline < wakeUp) {
+            wakeUp = m_deadline;
+        }
+        m_request.wait_until(lock, wakeUp, [this]{ return m_stop || m_requested > m_dumped; });
+
+        if (m_stop) {
+            break;
+        }
+
+        bool due = (m_requested > m_dumped);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (m_period.count() > 0 && now >= m_deadline) {
+            m_deadline = now + m_period;
+            due = true;
+        }
+
+        const std::uint64_t signals = receivedSignals.load(std::memory_order_relaxed);
+        if (signals != m_signalsSeen) {
+            m_signalsSeen = signals;
+            due = true;
+        }
+
+        if (!due) {
+            continue;
+        }
+
+        // Only the copy of ring holds the lock
+        const std::uint64_t ticket = m_requested;
+        copyRing(m_snapshot);
+
+        lock.unlock();
+        writeSnapshot(m_snapshot);
+        lock.lock();
+
+        m_dumped = ticket;
+        ++m_numberDumps;
+        m_served.notify_all();
+    }
+}
+
+template<typename T>
+void SnapshotSink<T>::copyRing(std::vector<T> &values) const {
+    const std::size_t numberSlots = m_windows.size();
+    const std::size_t numberKept = std::min<std::uint64_t>(m_numberWindows, numberSlots);
+    const std::size_t first = (m_next + numberSlots - numberKept) % numberSlots;
+
+    values.clear();
+    for (std::size_t i = 0; i < numberKept; ++i) {
+        const std::vector<T> &window = m_windows[(first + i) % numberSlots];
+        values.insert(values.end(), window.begin(), window.end());
+    }
+}
+
+template<typename T>
+void SnapshotSink<T>::writeSnapshot(const std::vector<T> &values) const {
+    const std::string temporary = m_filename + ".tmp";
+
+    std::ofstream file;
+    if (m_format == Format::Ascii) {
+        file.open(temporary);
+    }
+    else {
+        file.open(temporary, std::ios::binary);
+    }
+
+    if (!file.is_open()) {
+        std::cerr << "SnapshotSink::writeSnapshot(): The file '" << temporary << "' wasn't open: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+
+    const char *bytes = reinterpret_cast<const char*>(values.data());
+    switch (m_format) {
+        case Format::Ascii:
+            // Set the max precision write
+            if (!std::is_integral<T>::value) {
+                file << std::scientific << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+            }
+
+            for (const T &value: values) {
+                writeAsciiValue(file, value);
+            }
+            break;
+
+        case Format::Binary:
+            file.write(bytes, values.size() * sizeof(T));
+            break;
+
+        case Format::Gzip: {
+            boost::iostreams::filtering_streambuf<boost::iostreams::input> out;
+            out.push(boost::iostreams::gzip_compressor());
+            out.push(boost::iostreams::array_source(bytes, values.size() * sizeof(T)));
+            boost::iostreams::copy(out, file);
+            break;
+        }
+    }
+    file.close();
+
+    if (std::rename(temporary.c_str(), m_filename.c_str()) != 0) {
+        std::cerr << "SnapshotSink::writeSnapshot(): The file '" << m_filename << "' wasn't replaced: " << std::strerror(errno) << std::endl;
+        std::exit(-1);
+    }
+}
+
+template class SnapshotSink<double>;
+template class SnapshotSink<float>;
+template class SnapshotSink<std::int64_t>;
+template class SnapshotSink<std::complex<double>>;
+template class SnapshotSink<std::complex<float>>;
@@ -0,0 +1,91 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/SpscRing.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+SpscRing::SpscRing(std::size_t capacity, WaitMode mode)
+: m_capacity(roundCapacity(capacity))
+, m_mask(m_capacity - 1)
+, m_mode(mode)
+, m_mirrored(false)
+, m_data(nullptr)
+, m_head(0)
+, m_cachedTail(0)
+, m_tail(0)
+, m_cachedHead(0)
+, m_waiters(0) {
+    if (!allocateMirrored()) {
+        m_data = m_allocator.allocate(m_capacity);
+    }
+}
+
+SpscRing::~SpscRing() {
+    if (m_mirrored) {
+        munmap(m_data, 2 * m_capacity);
+    }
+    else {
+        m_allocator.deallocate(m_data, m_capacity);
+    }
+}
+
+bool SpscRing::allocateMirrored() {
+#if defined(__linux__) && defined(SYS_memfd_create)
+    // The two views must be aligned on pages
+    const long PAGE_SIZE = sysconf(_SC_PAGESIZE);
+    if (PAGE_SIZE <= 0 || m_capacity % PAGE_SIZE != 0) {
+        return false;
+    }
+
+    int fd = syscall(SYS_memfd_create, "dsps-ring", 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    if (ftruncate(fd, m_capacity) != 0) {
+        close(fd);
+        return false;
+    }
+
+    // Reserve the address space then map the same file twice
+    void *area = mmap(nullptr, 2 * m_capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    std::uint8_t *base = static_cast<std::uint8_t*>(area);
+    void *first = mmap(base, m_capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    void *second = mmap(base + m_capacity, m_capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    close(fd);
+
+    if (first == MAP_FAILED || second == MAP_FAILED) {
+        munmap(area, 2 * m_capacity);
+        return false;
+    }
+
+    m_data = base;
+    m_mirrored = true;
+    return true;
+#else
+    return false;
+#endif
+}
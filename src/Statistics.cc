@@ -0,0 +1,332 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#include <dsps/Statistics.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <dsps/Channel.h>
+
+template<typename T>
+Statistics<T>::Statistics(Statistic statistic, std::uint64_t length, double parameter, std::uint64_t publishPeriod)
+: Task(getChannelType<T>(), 1, getChannelType<T>(), 1)
+, m_statistic(statistic)
+, m_length(length)
+, m_parameter(parameter)
+, m_publishPeriod(publishPeriod)
+, m_N(0)
+, m_count(0) {
+    const bool exponential = (statistic == Statistic::ExponentialMean || statistic == Statistic::ExponentialVariance);
+    assert((!exponential || (parameter > 0.0 && parameter <= 1.0)) && "Statistics: The smoothing factor must be in ]0, 1]");
+    assert((statistic != Statistic::Percentile || (parameter >= 0.0 && parameter <= 1.0)) && "Statistics: The quantile must be in [0, 1]");
+    assert(((!exponential && statistic != Statistic::Percentile) || length == 0) && "Statistics: This statistic has no sliding window");
+    USELESS_PARAMETER(exponential);
+}
+
+template<typename T>
+void Statistics<T>::compute(const std::uint64_t N) {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "Statistics: No input task is connected");
+
+    const T *inValues = m_inputChannels[0]->peek<T>(N);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_N != N) {
+            initAccum(N);
+        }
+
+        switch (m_statistic) {
+            case Statistic::Mean:
+            case Statistic::Variance:
+                updateMoments(inValues, N);
+                break;
+
+            case Statistic::ExponentialMean:
+            case Statistic::ExponentialVariance:
+                updateExponential(inValues, N);
+                break;
+
+            case Statistic::MinHold:
+            case Statistic::MaxHold:
+                updateHold(inValues, N);
+                break;
+
+            case Statistic::Percentile:
+                updatePercentile(inValues, N);
+                break;
+        }
+
+        ++m_count;
+    }
+    m_inputChannels[0]->release<T>(N);
+
+    if (m_publishPeriod > 0 && m_count % m_publishPeriod == 0) {
+        publish();
+    }
+}
+
+template<typename T>
+bool Statistics<T>::isReady(const std::uint64_t N) const {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "Statistics: No input task is connected");
+
+    return m_inputChannels[0]->size(sizeof(T)) >= N;
+}
+
+template<typename T>
+bool Statistics<T>::hasFinished(const std::uint64_t N) const {
+    if (m_publishPeriod == 0) {
+        return countWindows() > 0;
+    }
+
+    return m_outputChannels[0].size(sizeof(T)) >= N;
+}
+
+template<typename T>
+void Statistics<T>::getResult(std::vector<T> &values) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_count == 0) {
+        values.clear();
+        return;
+    }
+
+    values.resize(m_N);
+    computeResult(values.data());
+}
+
+template<typename T>
+void Statistics<T>::publish() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_count == 0) {
+        return;
+    }
+
+    T *outValues = m_outputChannels[0].acquireWrite<T>(m_N);
+    computeResult(outValues);
+    m_outputChannels[0].commit<T>(m_N);
+}
+
+template<typename T>
+std::uint64_t Statistics<T>::countWindows() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_count;
+}
+
+template<typename T>
+void Statistics<T>::clearAccum() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_N = 0;
+    m_count = 0;
+}
+
+template<typename T>
+void Statistics<T>::initAccum(const std::uint64_t N) {
+    m_N = N;
+    m_count = 0;
+
+    const bool sliding = (m_length > 0);
+    m_history.assign(sliding ? m_length * N : 0, T(0));
+    m_mean.assign(N, T(0));
+    m_m2.assign(N, T(0));
+
+    const bool slidingHold = sliding && (m_statistic == Statistic::MinHold || m_statistic == Statistic::MaxHold);
+    m_dequeWindows.assign(slidingHold ? m_length * N : 0, 0);
+    m_dequeHead.assign(slidingHold ? N : 0, 0);
+    m_dequeSize.assign(slidingHold ? N : 0, 0);
+
+    const bool percentile = (m_statistic == Statistic::Percentile);
+    m_quantiles.assign(percentile ? N : 0, QuantileEstimator(percentile ? m_parameter : 0.5));
+}
+
+template<typename T>
+void Statistics<T>::updateMoments(const T *inValues, const std::uint64_t N) {
+    T *mean = m_mean.data();
+    T *m2 = m_m2.data();
+
+    // Welford update until the sliding window is full
+    if (m_length == 0 || m_count < m_length) {
+        const T k = static_cast<T>(m_count + 1);
+        for (std::size_t i = 0; i < N; ++i) {
+            const T delta = inValues[i] - mean[i];
+            mean[i] += delta / k;
+            m2[i] += delta * (inValues[i] - mean[i]);
+        }
+
+        if (m_length > 0) {
+            std::copy_n(inValues, N, m_history.begin() + m_count * N);
+        }
+        return;
+    }
+
+    // The oldest window leaves and the new one takes its slot
+    T *oldValues = m_history.data() + (m_count % m_length) * N;
+    const T length = static_cast<T>(m_length);
+    for (std::size_t i = 0; i < N; ++i) {
+        const T oldMean = mean[i];
+        const T delta = inValues[i] - oldValues[i];
+        mean[i] += delta / length;
+        m2[i] += delta * (inValues[i] - mean[i] + oldValues[i] - oldMean);
+        oldValues[i] = inValues[i];
+    }
+
+    // The rounding errors of sliding updates are removed once by turn of history
+    if ((m_count + 1) % m_length == 0) {
+        std::fill(m_mean.begin(), m_mean.end(), T(0));
+        std::fill(m_m2.begin(), m_m2.end(), T(0));
+        for (std::uint64_t w = 0; w < m_length; ++w) {
+            const T *values = m_history.data() + w * N;
+            for (std::size_t i = 0; i < N; ++i) {
+                mean[i] += values[i];
+            }
+        }
+        for (std::size_t i = 0; i < N; ++i) {
+            mean[i] /= length;
+        }
+        for (std::uint64_t w = 0; w < m_length; ++w) {
+            const T *values = m_history.data() + w * N;
+            for (std::size_t i = 0; i < N; ++i) {
+                const T delta = values[i] - mean[i];
+                m2[i] += delta * delta;
+            }
+        }
+    }
+}
+
+template<typename T>
+void Statistics<T>::updateExponential(const T *inValues, const std::uint64_t N) {
+    T *mean = m_mean.data();
+    T *m2 = m_m2.data();
+
+    if (m_count == 0) {
+        std::copy_n(inValues, N, mean);
+        return;
+    }
+
+    const T alpha = static_cast<T>(m_parameter);
+    for (std::size_t i = 0; i < N; ++i) {
+        const T delta = inValues[i] - mean[i];
+        const T increment = alpha * delta;
+        mean[i] += increment;
+        m2[i] = (T(1) - alpha) * (m2[i] + delta * increment);
+    }
+}
+
+template<typename T>
+void Statistics<T>::updateHold(const T *inValues, const std::uint64_t N) {
+    const bool isMax = (m_statistic == Statistic::MaxHold);
+    T *hold = m_mean.data();
+
+    if (m_length == 0) {
+        if (m_count == 0) {
+            std::copy_n(inValues, N, hold);
+        }
+        else if (isMax) {
+            for (std::size_t i = 0; i < N; ++i) {
+                hold[i] = std::max(hold[i], inValues[i]);
+            }
+        }
+        else {
+            for (std::size_t i = 0; i < N; ++i) {
+                hold[i] = std::min(hold[i], inValues[i]);
+            }
+        }
+        return;
+    }
+
+    // The window m_count replaces the window m_count - length in the history
+    std::copy_n(inValues, N, m_history.begin() + (m_count % m_length) * N);
+
+    // Each deque keeps the windows which can still become the extremum, the
+    // front is the current extremum
+    for (std::size_t i = 0; i < N; ++i) {
+        std::uint64_t head = m_dequeHead[i];
+        std::uint64_t size = m_dequeSize[i];
+
+        if (size > 0 && m_count >= m_length && m_dequeWindows[head * N + i] <= m_count - m_length) {
+            head = (head + 1) % m_length;
+            --size;
+        }
+
+        while (size > 0) {
+            const std::uint64_t window = m_dequeWindows[((head + size - 1) % m_length) * N + i];
+            const T value = m_history[(window % m_length) * N + i];
+            if (isMax ? (value > inValues[i]) : (value < inValues[i])) {
+                break;
+            }
+            --size;
+        }
+
+        m_dequeWindows[((head + size) % m_length) * N + i] = m_count;
+        m_dequeHead[i] = head;
+        m_dequeSize[i] = size + 1;
+    }
+}
+
+template<typename T>
+void Statistics<T>::updatePercentile(const T *inValues, const std::uint64_t N) {
+    for (std::size_t i = 0; i < N; ++i) {
+        m_quantiles[i].add(static_cast<double>(inValues[i]));
+    }
+}
+
+template<typename T>
+void Statistics<T>::computeResult(T *values) const {
+    const std::uint64_t N = m_N;
+
+    switch (m_statistic) {
+        case Statistic::Mean:
+        case Statistic::ExponentialMean:
+            std::copy_n(m_mean.begin(), N, values);
+            break;
+
+        case Statistic::Variance: {
+            const std::uint64_t count = (m_length == 0) ? m_count : std::min(m_count, m_length);
+            const T scale = (count < 2) ? T(0) : T(1) / static_cast<T>(count - 1);
+            for (std::size_t i = 0; i < N; ++i) {
+                values[i] = std::max(T(0), m_m2[i] * scale);
+            }
+            break;
+        }
+
+        case Statistic::ExponentialVariance:
+            std::copy_n(m_m2.begin(), N, values);
+            break;
+
+        case Statistic::MinHold:
+        case Statistic::MaxHold:
+            if (m_length == 0) {
+                std::copy_n(m_mean.begin(), N, values);
+            }
+            else {
+                for (std::size_t i = 0; i < N; ++i) {
+                    const std::uint64_t window = m_dequeWindows[m_dequeHead[i] * N + i];
+                    values[i] = m_history[(window % m_length) * N + i];
+                }
+            }
+            break;
+
+        case Statistic::Percentile:
+            for (std::size_t i = 0; i < N; ++i) {
+                values[i] = static_cast<T>(m_quantiles[i].get());
+            }
+            break;
+    }
+}
+
+template class Statistics<double>;
+template class Statistics<float>;
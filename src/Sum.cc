@@ -17,10 +17,12 @@
 
 #include <dsps/Sum.h>
 
+#include <algorithm>
 #include <complex>
 #include <typeinfo>
 
 #include <dsps/Channel.h>
+#include <dsps/Simd.h>
 
 template<typename T>
 Sum<T>::Sum(const std::size_t numberInput)
@@ -36,26 +38,17 @@ void Sum<T>::compute(const std::uint64_t N) {
     }
     assert(allInputDefined && "Sum: No input task is connected");
 
-    // Init the input channel
-    std::vector< std::vector<T> > inValues;
-    for (std::size_t i = 0; i < m_inputChannels.size(); ++i) {
-        inValues.push_back(std::vector<T>(N));
-        m_inputChannels[i]->receive(inValues.back(), N);
-    }
-
-    std::vector<T> outValues(N);
+    // Accumulate each input directly in the output window
+    T *outValues = m_outputChannels[0].acquireWrite<T>(N);
+    std::fill(outValues, outValues + N, initAccum());
 
-    // Compute the sum
-    for (std::size_t i = 0; i < N; ++i) {
-        T sum = initAccum();
-        for (std::size_t j = 0; j < m_inputChannels.size(); ++j) {
-            sum += inValues[j][i];
-        }
-        outValues[i] = sum;
+    for (std::size_t j = 0; j < m_inputChannels.size(); ++j) {
+        const T *inValues = m_inputChannels[j]->peek<T>(N);
+        DSP::Simd::accumulate(inValues, outValues, N);
+        m_inputChannels[j]->release<T>(N);
     }
 
-    // Send the result
-    m_outputChannels[0].send(outValues);
+    m_outputChannels[0].commit<T>(N);
 }
 
 template<typename T>
@@ -19,6 +19,24 @@
 
 #include <cassert>
 
+Task::~Task() {
+    for (ScratchBuffer &buffer: m_scratchBuffers) {
+        m_allocator->deallocate(buffer.data, buffer.size);
+    }
+}
+
+void Task::setAllocator(DSP::Allocator &allocator) {
+    for (ScratchBuffer &buffer: m_scratchBuffers) {
+        m_allocator->deallocate(buffer.data, buffer.size);
+    }
+    m_scratchBuffers.clear();
+    m_allocator = &allocator;
+
+    for (Channel &channel: m_outputChannels) {
+        channel.setAllocator(allocator);
+    }
+}
+
 void Task::setInput(Channel &channel, const std::size_t index) {
     m_inputChannels[index] = &channel;
     channel.setOut(this);
@@ -28,6 +46,53 @@ Channel& Task::getOutput(const std::size_t index) {
     return m_outputChannels[index];
 }
 
+ChannelType Task::getInputChannelType() const {
+    return m_inputChannelType;
+}
+
+ChannelType Task::getOutputChannelType() const {
+    return m_outputChannelType;
+}
+
+std::uint64_t Task::getInputRate(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    return N;
+}
+
+std::uint64_t Task::getInputDelay(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    USELESS_PARAMETER(N);
+    return 0;
+}
+
+std::uint64_t Task::getOutputRate(const std::size_t index, const std::uint64_t N) const {
+    USELESS_PARAMETER(index);
+    return N;
+}
+
+bool Task::isElementwise() const {
+    return false;
+}
+
+void Task::computeElementwise(const void *inValues, void *outValues, const std::size_t size) const {
+    USELESS_PARAMETER(inValues);
+    USELESS_PARAMETER(outValues);
+    USELESS_PARAMETER(size);
+    assert(false && "Task: The task isn't elementwise");
+}
+
+std::size_t Task::countInputs() const {
+    return m_inputChannels.size();
+}
+
+Channel* Task::getInput(const std::size_t index) const {
+    if (index >= m_inputChannels.size()) {
+        return nullptr;
+    }
+
+    return m_inputChannels[index];
+}
+
 std::size_t Task::countNextTask() const {
     return m_outputChannels.size();
 }
@@ -60,9 +125,26 @@ Task::Task(ChannelType inputType, const std::size_t numInput, ChannelType output
 : m_inputChannelType(inputType)
 , m_outputChannelType(outputType)
 , m_inputChannels(numInput)
-, m_outputChannels(numOutput) {
+, m_outputChannels(numOutput)
+, m_allocator(&DSP::Allocator::getDefault()) {
     // Connect all input task
     for (auto &channel: m_outputChannels) {
         channel.setIn(this);
     }
 }
+
+void *Task::getScratchBytes(const std::size_t index, const std::size_t size) {
+    if (index >= m_scratchBuffers.size()) {
+        m_scratchBuffers.resize(index + 1, ScratchBuffer{ nullptr, 0 });
+    }
+
+    // The old content is useless, the buffer is replaced without copy
+    ScratchBuffer &buffer = m_scratchBuffers[index];
+    if (buffer.size < size) {
+        m_allocator->deallocate(buffer.data, buffer.size);
+        buffer.data = m_allocator->allocate(size);
+        buffer.size = size;
+    }
+
+    return buffer.data;
+}
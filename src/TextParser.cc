@@ -0,0 +1,438 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/TextParser.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+
+#include <locale.h>
+
+namespace {
+    __extension__ typedef unsigned __int128 uint128;
+
+    /// Minimal size of text by thread for parseAll
+    constexpr std::size_t MinimalChunkSize = 1 << 20;
+
+    inline bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    inline bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    const char *tokenEnd(const char *begin, const char *end) {
+        while (begin < end && !isSpace(*begin)) {
+            ++begin;
+        }
+
+        return begin;
+    }
+
+    int bitLength(uint128 value) {
+        const std::uint64_t high = static_cast<std::uint64_t>(value >> 64);
+        const std::uint64_t low = static_cast<std::uint64_t>(value);
+        if (high != 0) {
+            return 128 - __builtin_clzll(high);
+        }
+
+        return (low != 0) ? 64 - __builtin_clzll(low) : 0;
+    }
+
+    // The powers of ten which are exact in double
+    const double ExactPowers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    uint128 powerOfTen(int exponent) {
+        struct Powers {
+            uint128 values[39];
+
+            Powers() {
+                values[0] = 1;
+                for (int i = 1; i < 39; ++i) {
+                    values[i] = values[i - 1] * 10;
+                }
+            }
+        };
+
+        static const Powers powers;
+        return powers.values[exponent];
+    }
+
+    // Correctly rounded numerator / denominator, the quotient is computed
+    // with 54 or 55 bits and the remainder decides the ties
+    double divideRounded(uint128 numerator, uint128 denominator) {
+        const int shift = 54 + bitLength(denominator) - bitLength(numerator);
+        if (shift >= 0) {
+            numerator <<= shift;
+        }
+        else {
+            denominator <<= -shift;
+        }
+
+        const uint128 quotient = numerator / denominator;
+        const bool sticky = (numerator % denominator) != 0;
+
+        int extra = bitLength(quotient) - 53;
+        std::uint64_t mantissa = static_cast<std::uint64_t>(quotient >> extra);
+        const std::uint64_t rest = static_cast<std::uint64_t>(quotient) & ((std::uint64_t(1) << extra) - 1);
+        const std::uint64_t half = std::uint64_t(1) << (extra - 1);
+
+        if (rest > half || (rest == half && (sticky || (mantissa & 1)))) {
+            ++mantissa;
+            if (mantissa == (std::uint64_t(1) << 53)) {
+                mantissa >>= 1;
+                ++extra;
+            }
+        }
+
+        return std::ldexp(static_cast<double>(mantissa), extra - shift);
+    }
+
+    // Compute significand * 10^exponent, false if the exact methods can't be used
+    bool computeExact(std::uint64_t significand, int exponent, double &value) {
+        // Both operands are exact doubles, the single operation is rounded once
+        if (significand < (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+            value = static_cast<double>(significand);
+            value = (exponent < 0) ? value / ExactPowers[-exponent] : value * ExactPowers[exponent];
+            return true;
+        }
+
+        // The fraction must fit in 128 bits with 54 bits of quotient
+        if (exponent < 0) {
+            if (exponent < -22) {
+                return false;
+            }
+
+            value = divideRounded(significand, powerOfTen(-exponent));
+            return true;
+        }
+
+        if (exponent > 38 || bitLength(significand) + bitLength(powerOfTen(exponent)) > 128) {
+            return false;
+        }
+
+        value = divideRounded(significand * powerOfTen(exponent), 1);
+        return true;
+    }
+
+    const char *parseWithLibc(const char *begin, const char *end, double &value) {
+        static locale_t cLocale = newlocale(LC_ALL_MASK, "C", static_cast<locale_t>(0));
+
+        // The text isn't null terminated
+        std::string token(begin, tokenEnd(begin, end));
+        char *last = nullptr;
+        value = strtod_l(token.c_str(), &last, cLocale);
+
+        return begin + (last - token.c_str());
+    }
+
+    template <typename T>
+    bool parseChunk(const char *begin, const char *end, std::vector<T> &values) {
+        T value;
+        for (;;) {
+            while (begin < end && isSpace(*begin)) {
+                ++begin;
+            }
+
+            if (begin == end) {
+                return true;
+            }
+
+            const char *last = tokenEnd(begin, end);
+            if (TextParser::parse(begin, last, value) != last) {
+                return false;
+            }
+
+            values.push_back(value);
+            begin = last;
+        }
+    }
+}
+
+constexpr std::size_t TextParser::DefaultBlockSize;
+
+TextParser::TextParser(std::istream &input, std::size_t blockSize)
+: m_input(input)
+, m_blockSize(blockSize)
+, m_buffer()
+, m_position(0)
+, m_size(0) {
+}
+
+bool TextParser::read(double &value) {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    if (!nextToken(begin, end)) {
+        return false;
+    }
+
+    if (parse(begin, end, value) != end) {
+        std::cerr << "TextParser::read(): Invalid number '" << std::string(begin, end) << "'" << std::endl;
+        std::exit(-1);
+    }
+
+    return true;
+}
+
+bool TextParser::read(std::int64_t &value) {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    if (!nextToken(begin, end)) {
+        return false;
+    }
+
+    if (parse(begin, end, value) != end) {
+        std::cerr << "TextParser::read(): Invalid integer '" << std::string(begin, end) << "'" << std::endl;
+        std::exit(-1);
+    }
+
+    return true;
+}
+
+bool TextParser::read(std::complex<double> &value) {
+    double real = 0.0;
+    double imag = 0.0;
+    if (!read(real) || !read(imag)) {
+        return false;
+    }
+
+    value = std::complex<double>(real, imag);
+    return true;
+}
+
+void TextParser::reset() {
+    m_position = 0;
+    m_size = 0;
+}
+
+const char *TextParser::parse(const char *begin, const char *end, double &value) {
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // The significand without the leading and the trailing zeros
+    std::uint64_t significand = 0;
+    int numberDigits = 0;
+    int trailingZeros = 0;
+    int fractionDigits = 0;
+    bool tooLong = false;
+    bool hasDigits = false;
+    bool fraction = false;
+
+    for (; p < end; ++p) {
+        if (*p == '.' && !fraction) {
+            fraction = true;
+            continue;
+        }
+
+        if (!isDigit(*p)) {
+            break;
+        }
+
+        hasDigits = true;
+        fractionDigits += fraction ? 1 : 0;
+
+        const int digit = *p - '0';
+        if (digit == 0) {
+            trailingZeros += (numberDigits > 0) ? 1 : 0;
+            continue;
+        }
+
+        if (numberDigits + trailingZeros + 1 > 19) {
+            tooLong = true;
+            continue;
+        }
+
+        for (; trailingZeros > 0; --trailingZeros, ++numberDigits) {
+            significand *= 10;
+        }
+        significand = significand * 10 + digit;
+        ++numberDigits;
+    }
+
+    // Infinity, NaN and hexadecimal numbers
+    if (!hasDigits) {
+        return parseWithLibc(begin, end, value);
+    }
+
+    // The exponent is a part of number only if it has digits
+    int exponent = 0;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool negativeExponent = false;
+        if (q < end && (*q == '+' || *q == '-')) {
+            negativeExponent = (*q == '-');
+            ++q;
+        }
+
+        if (q < end && isDigit(*q)) {
+            for (; q < end && isDigit(*q); ++q) {
+                exponent = std::min(exponent * 10 + (*q - '0'), 100000);
+            }
+            exponent = negativeExponent ? -exponent : exponent;
+            p = q;
+        }
+    }
+
+    if (tooLong) {
+        return parseWithLibc(begin, end, value);
+    }
+
+    if (significand == 0) {
+        value = negative ? -0.0 : 0.0;
+        return p;
+    }
+
+    if (!computeExact(significand, exponent - fractionDigits + trailingZeros, value)) {
+        return parseWithLibc(begin, end, value);
+    }
+
+    value = negative ? -value : value;
+    return p;
+}
+
+const char *TextParser::parse(const char *begin, const char *end, std::int64_t &value) {
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    if (p == end || !isDigit(*p)) {
+        return begin;
+    }
+
+    // The magnitude of the lowest integer is one more than the highest
+    const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + (negative ? 1 : 0);
+    std::uint64_t magnitude = 0;
+    for (; p < end && isDigit(*p); ++p) {
+        const std::uint64_t digit = *p - '0';
+        if (magnitude > (limit - digit) / 10) {
+            return begin;
+        }
+
+        magnitude = magnitude * 10 + digit;
+    }
+
+    value = negative ? static_cast<std::int64_t>(0 - magnitude) : static_cast<std::int64_t>(magnitude);
+    return p;
+}
+
+template <typename T>
+std::vector<T> TextParser::parseAll(const char *begin, const char *end, unsigned numThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const std::size_t size = end - begin;
+    numThreads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(numThreads, size / MinimalChunkSize)));
+
+    // The chunks are cut after a number
+    std::vector<const char*> bounds(numThreads + 1, end);
+    bounds[0] = begin;
+    for (unsigned i = 1; i < numThreads; ++i) {
+        bounds[i] = tokenEnd(std::max(bounds[i - 1], begin + size * i / numThreads), end);
+    }
+
+    std::vector< std::vector<T> > chunks(numThreads);
+    std::vector<char> valid(numThreads, 0);
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < numThreads; ++i) {
+        threads.emplace_back([&bounds, &chunks, &valid, i]() {
+            valid[i] = parseChunk(bounds[i], bounds[i + 1], chunks[i]);
+        });
+    }
+    valid[0] = parseChunk(bounds[0], bounds[1], chunks[0]);
+
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    // The values after an invalid number are dropped
+    std::size_t count = 0;
+    for (const std::vector<T> &chunk: chunks) {
+        count += chunk.size();
+    }
+
+    std::vector<T> values;
+    values.reserve(count);
+    for (unsigned i = 0; i < numThreads; ++i) {
+        values.insert(values.end(), chunks[i].begin(), chunks[i].end());
+        if (!valid[i]) {
+            break;
+        }
+    }
+
+    return values;
+}
+
+bool TextParser::nextToken(const char *&begin, const char *&end) {
+    for (;;) {
+        while (m_position < m_size && isSpace(m_buffer[m_position])) {
+            ++m_position;
+        }
+
+        // The number is complete if a whitespace or the end of stream follows it
+        if (m_position < m_size) {
+            const char *first = m_buffer.data() + m_position;
+            const char *last = tokenEnd(first, m_buffer.data() + m_size);
+            if (last < m_buffer.data() + m_size || !m_input.good()) {
+                begin = first;
+                end = last;
+                m_position = last - m_buffer.data();
+                return true;
+            }
+        }
+        else if (!m_input.good()) {
+            return false;
+        }
+
+        fill();
+    }
+}
+
+void TextParser::fill() {
+    // Keep the incomplete number at the begin
+    const std::size_t remaining = m_size - m_position;
+    std::copy(m_buffer.begin() + m_position, m_buffer.begin() + m_size, m_buffer.begin());
+    m_position = 0;
+    m_size = remaining;
+
+    if (m_buffer.size() < m_size + m_blockSize) {
+        m_buffer.resize(m_size + m_blockSize);
+    }
+
+    m_input.read(m_buffer.data() + m_size, m_blockSize);
+    m_size += m_input.gcount();
+}
+
+template std::vector<double> TextParser::parseAll(const char *begin, const char *end, unsigned numThreads);
+template std::vector<std::int64_t> TextParser::parseAll(const char *begin, const char *end, unsigned numThreads);
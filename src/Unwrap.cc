@@ -17,8 +17,8 @@
 
 #include <dsps/Unwrap.h>
 
+#include <algorithm>
 #include <cmath>
-#include <iostream>
 
 #include <dsac/t_pnm.h>
 
@@ -34,21 +34,19 @@ void Unwrap::compute(const std::uint64_t N) {
 
     // Unwrap algo from here
     // https://www.medphysics.wisc.edu/~ethan/phaseunwrap/unwrap.c
-    std::vector<double> p(N);
-    double *dp = new double[N];
-    double *dps = new double[N];
-    double *dp_corr = new double[N];
-    double *cumsum = new double[N];
+    // The scratch buffers are kept between the computes
+    double *dp = getScratch<double>(0, N);
+    double *dps = getScratch<double>(1, N);
+    double *dp_corr = getScratch<double>(2, N);
+    double *cumsum = getScratch<double>(3, N);
     double cutoff = M_PI;               /* default value in matlab */
     std::size_t j;
 
-    // Check if alloc is OK
-    if (dp == nullptr || dps == nullptr || dp_corr == nullptr || cumsum == nullptr) {
-        std::cerr << "Unwrap::compute(): Bad allocation" << std::endl;
-        std::exit(-1);
-    }
-
-    m_inputChannels[0]->receive(p, N);
+    // The phase is unwrapped in the output window
+    double *p = m_outputChannels[0].acquireWrite<double>(N);
+    const double *inValues = m_inputChannels[0]->peek<double>(N);
+    std::copy(inValues, inValues + N, p);
+    m_inputChannels[0]->release<double>(N);
 
    // incremental phase variation
    // MATLAB: dp = diff(p, 1, 1);
@@ -98,13 +96,7 @@ void Unwrap::compute(const std::uint64_t N) {
     }
 
     // Send result
-    m_outputChannels[0].send(p);
-
-    // Free the memory
-    delete[] dp;
-    delete[] dps;
-    delete[] dp_corr;
-    delete[] cumsum;
+    m_outputChannels[0].commit<double>(N);
 }
 
 bool Unwrap::isReady(const std::uint64_t N) const {
@@ -18,41 +18,191 @@
 #include <dsps/Utils.h>
 
 #include <algorithm>
+#include <set>
 
 #include <dsps/Channel.h>
+#include <dsps/ExecutionContext.h>
 #include <dsps/Task.h>
 
 void DSP::processing(std::list<Task*> sourceTask, std::list<Task*> outputChannel, const std::uint64_t N) {
     // Linearisation of DAG
-    bool finished = false;
     auto linearDAG = dagLinearisation(sourceTask);
+    processLinearisation(linearDAG, sourceTask, outputChannel, N);
+}
+
+void DSP::processLinearisation(const std::list<Task*> &linearisation, const std::list<Task*> &sourceTask, const std::list<Task*> &outputTask, const std::uint64_t N) {
+    bool finished = false;
+
+    // Flag the source tasks once
+    std::vector<bool> isSource;
+    for (Task *task: linearisation) {
+        isSource.push_back(sourceTask.end() != std::find(sourceTask.begin(), sourceTask.end(), task));
+    }
 
     do {
-        for (auto it = linearDAG.begin(); it != linearDAG.end(); ++it) {
+        bool computed = false;
+        std::size_t index = 0;
+        for (auto it = linearisation.begin(); it != linearisation.end(); ++it, ++index) {
             Task *task = *it;
-            // If the task is a source task, we compute only once
-            if (sourceTask.end() != std::find(sourceTask.begin(), sourceTask.end(), task)) {
-                task->compute(N);
+            // If the task is a source task, we compute only once (a source at the end of stream is skipped)
+            if (isSource[index]) {
+                if (task->isReady(N)) {
+                    task->compute(N);
+                    computed = true;
+                }
             }
             // Else we compute the task until it wasn't ready
             else {
                 while (task->isReady(N)) {
                     task->compute(N);
+                    computed = true;
                 }
             }
         }
 
         // Check if the DAG was completed
         finished = true;
-        for (auto it = outputChannel.begin(); it != outputChannel.end() && finished; ++it) {
+        for (auto it = outputTask.begin(); it != outputTask.end() && finished; ++it) {
             auto task = *it;
             if (!task->hasFinished(N)) {
                 finished = false;
             }
         }
+
+        // All sources are at the end of stream and nothing remains to compute
+        if (!computed) {
+            finished = true;
+        }
     } while (!finished);
 }
 
+void DSP::processing(std::list<Task*> sourceTask, std::list<Task*> outputChannel, const std::uint64_t N, const ExecutionContext &context) {
+    ExecutionContext::Scope scope(context);
+    processing(sourceTask, outputChannel, N);
+}
+
+void DSP::reserveChannels(std::list<Task*> sourceTask, const std::uint64_t N) {
+    // Limit of simulated passes if the processing never repeats
+    static constexpr std::size_t MaxPasses = 1 << 12;
+
+    auto linearDAG = dagLinearisation(sourceTask);
+    std::vector<Task*> tasks;
+    for (Task *task: linearDAG) {
+        if (tasks.end() == std::find(tasks.begin(), tasks.end(), task)) {
+            tasks.push_back(task);
+        }
+    }
+
+    // List the channels between two tasks
+    struct Edge {
+        Channel *channel;
+        std::size_t dataSize;
+        std::size_t producer;
+        std::uint64_t production;
+        std::size_t consumer;
+        std::uint64_t consumption;
+        std::uint64_t delay;
+    };
+    std::vector<Edge> edges;
+    std::vector<std::uint64_t> tokens;
+
+    for (std::size_t producer = 0; producer < tasks.size(); ++producer) {
+        Task *task = tasks[producer];
+        for (std::size_t i = 0; i < task->countNextTask(); ++i) {
+            Task *nextTask = task->getNextTask(i);
+            auto it = std::find(tasks.begin(), tasks.end(), nextTask);
+            if (it == tasks.end()) {
+                continue;
+            }
+
+            Edge edge;
+            edge.channel = &task->getOutput(i);
+            edge.dataSize = sizeOfChannelType(task->getOutputChannelType());
+            edge.producer = producer;
+            edge.production = task->getOutputRate(i, N);
+            edge.consumer = it - tasks.begin();
+            edge.consumption = 0;
+            edge.delay = 0;
+            for (std::size_t j = 0; j < nextTask->countInputs(); ++j) {
+                if (nextTask->getInput(j) == edge.channel) {
+                    edge.consumption = nextTask->getInputRate(j, N);
+                    edge.delay = nextTask->getInputDelay(j, N);
+                }
+            }
+
+            assert(edge.dataSize > 0 && edge.consumption > 0 && "reserveChannels: Invalid channel");
+            edges.push_back(edge);
+            tokens.push_back(edge.channel->size(edge.dataSize));
+        }
+    }
+
+    // Simulate the processing
+    std::vector<std::uint64_t> peaks = tokens;
+    std::vector<std::uint64_t> fired(tasks.size(), 0);
+    std::set<std::vector<std::uint64_t>> states;
+
+    auto isReady = [&](std::size_t index) {
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            if (edges[i].consumer == index && tokens[i] < edges[i].consumption + (fired[index] ? 0 : edges[i].delay)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto compute = [&](std::size_t index) {
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            if (edges[i].consumer == index) {
+                tokens[i] -= edges[i].consumption + (fired[index] ? 0 : edges[i].delay);
+            }
+        }
+        fired[index] = 1;
+
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            if (edges[i].producer == index) {
+                tokens[i] += edges[i].production;
+                peaks[i] = std::max(peaks[i], tokens[i]);
+            }
+        }
+    };
+
+    for (std::size_t pass = 0; pass < MaxPasses; ++pass) {
+        // Stop when the processing repeats
+        std::vector<std::uint64_t> state = tokens;
+        state.insert(state.end(), fired.begin(), fired.end());
+        if (!states.insert(state).second) {
+            break;
+        }
+
+        for (Task *task: linearDAG) {
+            std::size_t index = std::find(tasks.begin(), tasks.end(), task) - tasks.begin();
+            if (sourceTask.end() != std::find(sourceTask.begin(), sourceTask.end(), task)) {
+                compute(index);
+            }
+            else {
+                while (isReady(index)) {
+                    compute(index);
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        edges[i].channel->reserve(peaks[i], edges[i].dataSize);
+    }
+}
+
+void DSP::setAllocator(std::list<Task*> sourceTask, Allocator &allocator) {
+    auto linearDAG = dagLinearisation(sourceTask);
+    std::vector<Task*> tasks;
+    for (Task *task: linearDAG) {
+        if (tasks.end() == std::find(tasks.begin(), tasks.end(), task)) {
+            tasks.push_back(task);
+            task->setAllocator(allocator);
+        }
+    }
+}
+
 std::list<Task*> DSP::dagLinearisation(std::list<Task*> sourceTask) {
     std::list<Task*> linearisation;
 
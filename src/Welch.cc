@@ -0,0 +1,189 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <dsps/Welch.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <dsps/Channel.h>
+#include <dsps/Utils.h>
+
+Welch::Welch(const std::uint64_t nfft, const std::uint64_t overlap, const double fs, Window window, Averaging averaging, const double alpha, const std::uint64_t segmentsByOutput)
+: Task(ChannelType::Double, 1, ChannelType::Double, 1)
+, m_nfft(nfft)
+, m_overlap(overlap)
+, m_averaging(averaging)
+, m_alpha(alpha)
+, m_segmentsByOutput(segmentsByOutput)
+, m_window(nfft)
+, m_scale(nfft / 2 + 1)
+, m_segment(nfft)
+, m_fill(0)
+, m_windowedSegment(nfft)
+, m_spectrum(nfft / 2 + 1)
+, m_wrapperFFTW(FFTDirection::Forward)
+, m_accum(nfft / 2 + 1, 0.0)
+, m_medians(averaging == Averaging::Median ? nfft / 2 + 1 : 0)
+, m_numberSegments(0) {
+    assert(m_nfft >= 2 && "Welch: The segments are too short");
+    assert(m_overlap < m_nfft && "Welch: The overlap must be lower than nfft");
+    assert(m_alpha > 0.0 && m_alpha <= 1.0 && "Welch: The exponential weight must be in ]0, 1]");
+    assert(m_segmentsByOutput > 0 && "Welch: The output interval must be positive");
+    assert(fs > 0.0 && "Welch: The sampling rate must be positive");
+
+    initWindow(window);
+
+    // Density scale, the bins with a negative frequency mirror are doubled
+    double windowPower = 0.0;
+    for (double w: m_window) {
+        windowPower += w * w;
+    }
+
+    for (std::size_t k = 0; k < m_scale.size(); ++k) {
+        const bool nyquist = (m_nfft % 2 == 0) && (k == m_nfft / 2);
+        m_scale[k] = ((k == 0 || nyquist) ? 1.0 : 2.0) / (fs * windowPower);
+    }
+}
+
+void Welch::compute(const std::uint64_t N) {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "Welch: No input task is connected");
+
+    const double *inValues = m_inputChannels[0]->peek<double>(N);
+
+    std::uint64_t offset = 0;
+    while (offset < N) {
+        // Fill the current segment
+        const std::uint64_t count = std::min(N - offset, m_nfft - m_fill);
+        std::copy_n(inValues + offset, count, m_segment.begin() + m_fill);
+        m_fill += count;
+        offset += count;
+
+        if (m_fill == m_nfft) {
+            computeSegment();
+
+            // The end of segment begins the next one
+            std::copy(m_segment.end() - m_overlap, m_segment.end(), m_segment.begin());
+            m_fill = m_overlap;
+        }
+    }
+
+    m_inputChannels[0]->release<double>(N);
+}
+
+bool Welch::isReady(const std::uint64_t N) const {
+    // Check if the input task is connected
+    assert(m_inputChannels[0] != nullptr && "Welch: No input task is connected");
+
+    return m_inputChannels[0]->size(sizeof(double)) >= N;
+}
+
+bool Welch::hasFinished(const std::uint64_t N) const {
+    USELESS_PARAMETER(N);
+    return m_outputChannels[0].size(sizeof(double)) >= m_nfft / 2 + 1;
+}
+
+std::vector<double> Welch::getPsd() const {
+    std::vector<double> psd(m_accum.size());
+    copyPsd(psd.data());
+
+    return psd;
+}
+
+std::uint64_t Welch::getNumberOfSegments() const {
+    return m_numberSegments;
+}
+
+void Welch::reset() {
+    std::fill(m_accum.begin(), m_accum.end(), 0.0);
+    for (QuantileEstimator &median: m_medians) {
+        median.clear();
+    }
+    m_numberSegments = 0;
+}
+
+void Welch::initWindow(Window window) {
+    // Periodic windows, the segments are consecutive parts of a stream
+    const double step = 2.0 * M_PI / static_cast<double>(m_nfft);
+    for (std::size_t i = 0; i < m_nfft; ++i) {
+        switch (window) {
+        case Window::Rectangular:
+            m_window[i] = 1.0;
+            break;
+        case Window::Hanning:
+            m_window[i] = 0.5 - 0.5 * std::cos(step * i);
+            break;
+        case Window::Hamming:
+            m_window[i] = 0.54 - 0.46 * std::cos(step * i);
+            break;
+        case Window::Blackman:
+            m_window[i] = 0.42 - 0.5 * std::cos(step * i) + 0.08 * std::cos(2.0 * step * i);
+            break;
+        }
+    }
+}
+
+void Welch::computeSegment() {
+    for (std::size_t i = 0; i < m_nfft; ++i) {
+        m_windowedSegment[i] = m_segment[i] * m_window[i];
+    }
+    m_wrapperFFTW.computeR2C(m_windowedSegment.data(), m_spectrum.data(), m_nfft);
+
+    ++m_numberSegments;
+    for (std::size_t k = 0; k < m_spectrum.size(); ++k) {
+        const double periodogram = std::norm(m_spectrum[k]) * m_scale[k];
+
+        switch (m_averaging) {
+        case Averaging::Linear:
+            // Running mean, no sum grows with the stream
+            m_accum[k] += (periodogram - m_accum[k]) / static_cast<double>(m_numberSegments);
+            break;
+        case Averaging::Exponential:
+            m_accum[k] = (m_numberSegments == 1) ? periodogram : m_accum[k] + m_alpha * (periodogram - m_accum[k]);
+            break;
+        case Averaging::Median:
+            m_medians[k].add(periodogram);
+            break;
+        }
+    }
+
+    if (m_numberSegments % m_segmentsByOutput == 0) {
+        sendPsd();
+    }
+}
+
+void Welch::sendPsd() {
+    const std::size_t size = m_accum.size();
+
+    double *outValues = m_outputChannels[0].acquireWrite<double>(size);
+    copyPsd(outValues);
+    m_outputChannels[0].commit<double>(size);
+}
+
+void Welch::copyPsd(double *psd) const {
+    if (m_averaging != Averaging::Median) {
+        std::copy(m_accum.begin(), m_accum.end(), psd);
+        return;
+    }
+
+    // The median of a chi-squared with 2 degrees of freedom is ln(2) times its mean
+    for (std::size_t k = 0; k < m_medians.size(); ++k) {
+        psd[k] = m_medians[k].get() / std::log(2.0);
+    }
+}
@@ -17,39 +17,342 @@
 
 #include <dsps/WrapperFFTW.h>
 
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <thread>
+#include <map>
+#include <mutex>
+#include <tuple>
 
-std::mutex WrapperFFTW::mutexFFTW;
-bool WrapperFFTW::alreadyInit = false;
+#include <dsps/ExecutionContext.h>
 
-WrapperFFTW::WrapperFFTW(FFTDirection direction)
-: m_windowSize(0)
-, m_fftSign(direction)
-, m_inputData(nullptr)
-, m_outputData(nullptr) {
-    if (!alreadyInit) {
-        if (fftw_init_threads() == 0) {
-            std::cerr << "FFTW threads initialisation failed" << std::endl;
-            std::exit(-1);
+namespace {
+    // Functions of FFTW library for a precision
+    template <typename R>
+    struct FFTWLibrary;
+
+    template <>
+    struct FFTWLibrary<double> {
+        typedef FFTWTypes<double>::Complex Complex;
+        typedef FFTWTypes<double>::Plan Plan;
+
+        static constexpr FFTPrecision Precision = FFTPrecision::Double;
+
+        static int initThreads() { return fftw_init_threads(); }
+        static void planWithThreads(int nbThreads) { fftw_plan_with_nthreads(nbThreads); }
+        static void* malloc(std::size_t size) { return fftw_malloc(size); }
+        static void free(void *data) { fftw_free(data); }
+        static Plan* planDft(int n, Complex *in, Complex *out, int sign, unsigned flags) { return fftw_plan_dft_1d(n, in, out, sign, flags); }
+        static Plan* planR2C(int n, double *in, Complex *out, unsigned flags) { return fftw_plan_dft_r2c_1d(n, in, out, flags); }
+        static Plan* planC2R(int n, Complex *in, double *out, unsigned flags) { return fftw_plan_dft_c2r_1d(n, in, out, flags); }
+        static Plan* planManyR2C(int n, int batch, double *in, Complex *out, unsigned flags) { return fftw_plan_many_dft_r2c(1, &n, batch, in, nullptr, 1, n, out, nullptr, 1, n / 2 + 1, flags); }
+        static void destroy(Plan *plan) { fftw_destroy_plan(plan); }
+        static void executeDft(Plan *plan, Complex *in, Complex *out) { fftw_execute_dft(plan, in, out); }
+        static void executeR2C(Plan *plan, double *in, Complex *out) { fftw_execute_dft_r2c(plan, in, out); }
+        static void executeC2R(Plan *plan, Complex *in, double *out) { fftw_execute_dft_c2r(plan, in, out); }
+        static int importWisdom(const char *path) { return fftw_import_wisdom_from_filename(path); }
+        static int exportWisdom(const char *path) { return fftw_export_wisdom_to_filename(path); }
+        static std::string wisdomPath(const std::string &path) { return path; }
+    };
+
+    template <>
+    struct FFTWLibrary<float> {
+        typedef FFTWTypes<float>::Complex Complex;
+        typedef FFTWTypes<float>::Plan Plan;
+
+        static constexpr FFTPrecision Precision = FFTPrecision::Float;
+
+        static int initThreads() { return fftwf_init_threads(); }
+        static void planWithThreads(int nbThreads) { fftwf_plan_with_nthreads(nbThreads); }
+        static void* malloc(std::size_t size) { return fftwf_malloc(size); }
+        static void free(void *data) { fftwf_free(data); }
+        static Plan* planDft(int n, Complex *in, Complex *out, int sign, unsigned flags) { return fftwf_plan_dft_1d(n, in, out, sign, flags); }
+        static Plan* planR2C(int n, float *in, Complex *out, unsigned flags) { return fftwf_plan_dft_r2c_1d(n, in, out, flags); }
+        static Plan* planC2R(int n, Complex *in, float *out, unsigned flags) { return fftwf_plan_dft_c2r_1d(n, in, out, flags); }
+        static Plan* planManyR2C(int n, int batch, float *in, Complex *out, unsigned flags) { return fftwf_plan_many_dft_r2c(1, &n, batch, in, nullptr, 1, n, out, nullptr, 1, n / 2 + 1, flags); }
+        static void destroy(Plan *plan) { fftwf_destroy_plan(plan); }
+        static void executeDft(Plan *plan, Complex *in, Complex *out) { fftwf_execute_dft(plan, in, out); }
+        static void executeR2C(Plan *plan, float *in, Complex *out) { fftwf_execute_dft_r2c(plan, in, out); }
+        static void executeC2R(Plan *plan, Complex *in, float *out) { fftwf_execute_dft_c2r(plan, in, out); }
+        static int importWisdom(const char *path) { return fftwf_import_wisdom_from_filename(path); }
+        static int exportWisdom(const char *path) { return fftwf_export_wisdom_to_filename(path); }
+        static std::string wisdomPath(const std::string &path) { return path + ".float"; }
+    };
+
+    // Plans are shared by all the wrappers with the same key
+    struct PlanKey {
+        std::uint64_t windowSize;
+        FFTDirection direction;
+        FFTPrecision precision;
+        bool inPlace;
+        bool real;
+        std::uint64_t batch;
+        int threads;
+
+        bool operator<(const PlanKey &other) const {
+            return std::make_tuple(windowSize, static_cast<int>(direction), static_cast<int>(precision), inPlace, real, batch, threads)
+                < std::make_tuple(other.windowSize, static_cast<int>(other.direction), static_cast<int>(other.precision), other.inPlace, other.real, other.batch, other.threads);
+        }
+    };
+
+    const char* plannerNames[] = { "estimate", "measure", "patient", "exhaustive" };
+    const FFTPlanner plannerValues[] = { FFTPlanner::Estimate, FFTPlanner::Measure, FFTPlanner::Patient, FFTPlanner::Exhaustive };
+
+    class PlanCache {
+    public:
+        // Never destroyed: the wrappers of static objects can release their plans after the exit
+        static PlanCache& instance() {
+            static PlanCache *cache = new PlanCache;
+            return *cache;
+        }
+
+        template <typename R>
+        std::shared_ptr<typename FFTWLibrary<R>::Plan> getPlan(const PlanKey &key) {
+            typedef FFTWLibrary<R> Library;
+            typedef typename Library::Complex Complex;
+            typedef typename Library::Plan Plan;
+
+            {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                auto it = m_plans.find(key);
+                if (it != m_plans.end()) {
+                    return std::static_pointer_cast<Plan>(it->second);
+                }
+            }
+
+            // The FFTW planner isn't thread safe, but the executions of plans are
+            std::lock_guard<std::mutex> plannerLock(m_plannerMutex);
+            {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                auto it = m_plans.find(key);
+                if (it != m_plans.end()) {
+                    return std::static_pointer_cast<Plan>(it->second);
+                }
+            }
+
+            // The measure overwrites the arrays, the plan is executed later on other arrays with the same alignment
+            const unsigned flags = static_cast<unsigned>(m_planner);
+            Library::planWithThreads(key.threads);
+            Plan *plan = nullptr;
+            if (key.batch > 1) {
+                assert(key.real && key.direction == FFTDirection::Forward && "WrapperFFTW: Only the r2c plans are batched");
+
+                // The signals are contiguous
+                R *real = static_cast<R*>(Library::malloc(sizeof(R) * key.windowSize * key.batch));
+                Complex *spectrum = static_cast<Complex*>(Library::malloc(sizeof(Complex) * (key.windowSize / 2 + 1) * key.batch));
+                plan = Library::planManyR2C(key.windowSize, key.batch, real, spectrum, flags);
+                Library::free(spectrum);
+                Library::free(real);
+            }
+            else if (key.real) {
+                R *real = static_cast<R*>(Library::malloc(sizeof(R) * key.windowSize));
+                Complex *spectrum = static_cast<Complex*>(Library::malloc(sizeof(Complex) * (key.windowSize / 2 + 1)));
+                if (key.direction == FFTDirection::Forward) {
+                    plan = Library::planR2C(key.windowSize, real, spectrum, flags);
+                }
+                else {
+                    plan = Library::planC2R(key.windowSize, spectrum, real, flags);
+                }
+                Library::free(spectrum);
+                Library::free(real);
+            }
+            else {
+                Complex *in = static_cast<Complex*>(Library::malloc(sizeof(Complex) * key.windowSize));
+                Complex *out = key.inPlace ? in : static_cast<Complex*>(Library::malloc(sizeof(Complex) * key.windowSize));
+                plan = Library::planDft(key.windowSize, in, out, static_cast<int>(key.direction), flags);
+                if (!key.inPlace) {
+                    Library::free(out);
+                }
+                Library::free(in);
+            }
+
+            if (plan == nullptr) {
+                std::cerr << "WrapperFFTW: The plan of size " << key.windowSize << " wasn't created" << std::endl;
+                std::exit(-1);
+            }
+
+            std::shared_ptr<Plan> sharedPlan(plan, [this](Plan *plan) {
+                std::lock_guard<std::mutex> lock(m_plannerMutex);
+                Library::destroy(plan);
+            });
+
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_plans[key] = sharedPlan;
+            return sharedPlan;
+        }
+
+        void setPlanner(FFTPlanner planner) {
+            std::lock_guard<std::mutex> lock(m_plannerMutex);
+            m_planner = planner;
         }
 
-        unsigned nbThreads = std::thread::hardware_concurrency();
-        fftw_plan_with_nthreads(nbThreads);
-        alreadyInit = true;
+        FFTPlanner getPlanner() {
+            std::lock_guard<std::mutex> lock(m_plannerMutex);
+            return m_planner;
+        }
+
+        template <typename R>
+        bool importWisdom(const std::string &path) {
+            std::lock_guard<std::mutex> lock(m_plannerMutex);
+            return FFTWLibrary<R>::importWisdom(path.c_str()) != 0;
+        }
+
+        template <typename R>
+        bool exportWisdom(const std::string &path) {
+            std::lock_guard<std::mutex> lock(m_plannerMutex);
+            return FFTWLibrary<R>::exportWisdom(path.c_str()) != 0;
+        }
+
+        std::size_t size() {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            return m_plans.size();
+        }
+
+        void clear() {
+            // The plans are destroyed outside of lock, the deleter takes the planner lock
+            std::map< PlanKey, std::shared_ptr<void> > plans;
+            {
+                std::lock_guard<std::mutex> lock(m_cacheMutex);
+                plans.swap(m_plans);
+            }
+        }
+
+    private:
+        PlanCache()
+        : m_planner(FFTPlanner::Estimate) {
+            const char *planner = std::getenv("DSPS_FFTW_PLANNER");
+            if (planner != nullptr && planner[0] != '\0') {
+                bool found = false;
+                for (std::size_t i = 0; i < sizeof(plannerNames) / sizeof(plannerNames[0]) && !found; ++i) {
+                    if (std::strcmp(planner, plannerNames[i]) == 0) {
+                        m_planner = plannerValues[i];
+                        found = true;
+                    }
+                }
+
+                if (!found) {
+                    std::cerr << "WrapperFFTW: The planner '" << planner << "' of DSPS_FFTW_PLANNER is unknown!" << std::endl;
+                    std::exit(-1);
+                }
+            }
+
+            // The wisdom of previous runs avoids the measures of plans
+            const char *wisdom = std::getenv("DSPS_FFTW_WISDOM");
+            if (wisdom != nullptr && wisdom[0] != '\0') {
+                m_wisdomPath = wisdom;
+                FFTWLibrary<double>::importWisdom(FFTWLibrary<double>::wisdomPath(m_wisdomPath).c_str());
+                FFTWLibrary<float>::importWisdom(FFTWLibrary<float>::wisdomPath(m_wisdomPath).c_str());
+                std::atexit(exportWisdomAtExit);
+            }
+        }
+
+        static void exportWisdomAtExit() {
+            PlanCache &cache = instance();
+            exportWisdomAtExit<double>(cache);
+            exportWisdomAtExit<float>(cache);
+        }
+
+        template <typename R>
+        static void exportWisdomAtExit(PlanCache &cache) {
+            const std::string path = FFTWLibrary<R>::wisdomPath(cache.m_wisdomPath);
+            if (!cache.exportWisdom<R>(path)) {
+                std::cerr << "WrapperFFTW: The wisdom wasn't exported in '" << path << "'" << std::endl;
+            }
+        }
+
+    private:
+        std::mutex m_plannerMutex;
+        std::mutex m_cacheMutex;
+        std::map< PlanKey, std::shared_ptr<void> > m_plans;
+        FFTPlanner m_planner;
+        std::string m_wisdomPath;
+    };
+
+    // The FFTW threads are initialised once by precision, even if two
+    // wrappers are created at the same time by two workers
+    template <typename R>
+    void initThreadsOnce() {
+        static std::once_flag initialised;
+        std::call_once(initialised, []() {
+            if (FFTWLibrary<R>::initThreads() == 0) {
+                std::cerr << "FFTW threads initialisation failed" << std::endl;
+                std::exit(-1);
+            }
+        });
     }
 }
 
-WrapperFFTW::~WrapperFFTW() {
+template <typename R>
+BasicWrapperFFTW<R>::BasicWrapperFFTW(FFTDirection direction)
+: m_windowSize(0)
+, m_inPlace(false)
+, m_real(false)
+, m_batch(1)
+, m_threads(0)
+, m_fftSign(direction)
+, m_inputData(nullptr)
+, m_outputData(nullptr)
+, m_realData(nullptr) {
+    // The number of threads is given to each plan by the execution context
+    initThreadsOnce<R>();
+}
+
+template <typename R>
+BasicWrapperFFTW<R>::~BasicWrapperFFTW() {
     freePlan();
 }
 
-void WrapperFFTW::compute() {
-    fftw_execute(m_fftPlan);
+template <typename R>
+void BasicWrapperFFTW<R>::setPlannerEffort(FFTPlanner planner) {
+    PlanCache::instance().setPlanner(planner);
+}
+
+template <typename R>
+FFTPlanner BasicWrapperFFTW<R>::getPlannerEffort() {
+    return PlanCache::instance().getPlanner();
 }
 
-void WrapperFFTW::initPlan(const std::uint64_t windowSize) {
-    if (m_windowSize == windowSize) {
+template <typename R>
+bool BasicWrapperFFTW<R>::importWisdom(const std::string &path) {
+    return PlanCache::instance().importWisdom<R>(path);
+}
+
+template <typename R>
+bool BasicWrapperFFTW<R>::exportWisdom(const std::string &path) {
+    return PlanCache::instance().exportWisdom<R>(path);
+}
+
+template <typename R>
+std::size_t BasicWrapperFFTW<R>::countCachedPlans() {
+    return PlanCache::instance().size();
+}
+
+template <typename R>
+void BasicWrapperFFTW<R>::clearPlanCache() {
+    PlanCache::instance().clear();
+}
+
+template <typename R>
+void BasicWrapperFFTW<R>::compute() {
+    // The new-array execute lets the wrappers share the plan
+    if (!m_real) {
+        FFTWLibrary<R>::executeDft(m_fftPlan.get(), m_inputData, m_outputData);
+    }
+    else if (m_fftSign == FFTDirection::Forward) {
+        FFTWLibrary<R>::executeR2C(m_fftPlan.get(), m_realData, m_outputData);
+    }
+    else {
+        FFTWLibrary<R>::executeC2R(m_fftPlan.get(), m_inputData, m_realData);
+    }
+}
+
+template <typename R>
+void BasicWrapperFFTW<R>::initPlan(const std::uint64_t windowSize, const bool inPlace, const bool real, const std::size_t batch) {
+    typedef typename FFTWTypes<R>::Complex Complex;
+
+    const int threads = DSP::ExecutionContext::getCurrent().getFFTWThreads();
+    if (m_windowSize == windowSize && m_inPlace == inPlace && m_real == real && m_batch == batch && m_threads == threads) {
         return;
     }
 
@@ -58,22 +361,38 @@ void WrapperFFTW::initPlan(const std::uint64_t windowSize) {
 
     // Init the size
     m_windowSize = windowSize;
+    m_inPlace = inPlace;
+    m_real = real;
+    m_batch = batch;
+    m_threads = threads;
 
-    // Alloc the plan
-    {
-        std::lock_guard<std::mutex> lock(mutexFFTW);
-        m_inputData = static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * m_windowSize));
-        m_outputData = static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * m_windowSize));
-        m_fftPlan = fftw_plan_dft_1d(m_windowSize, m_inputData, m_outputData, static_cast<int>(m_fftSign), FFTW_ESTIMATE);
+    // Get the plan and alloc the data
+    m_fftPlan = PlanCache::instance().getPlan<R>(PlanKey{ m_windowSize, m_fftSign, FFTWLibrary<R>::Precision, m_inPlace, m_real, m_batch, m_threads });
+    if (m_real) {
+        // The half spectrum is the output of r2c and the input of c2r
+        m_realData = static_cast<R*>(FFTWLibrary<R>::malloc(sizeof(R) * m_windowSize * m_batch));
+        m_inputData = static_cast<Complex*>(FFTWLibrary<R>::malloc(sizeof(Complex) * (m_windowSize / 2 + 1) * m_batch));
+        m_outputData = m_inputData;
+    }
+    else {
+        m_inputData = static_cast<Complex*>(FFTWLibrary<R>::malloc(sizeof(Complex) * m_windowSize));
+        m_outputData = m_inPlace ? m_inputData : static_cast<Complex*>(FFTWLibrary<R>::malloc(sizeof(Complex) * m_windowSize));
     }
 }
 
-void WrapperFFTW::freePlan() {
-    if (m_inputData != nullptr) {
-        std::lock_guard<std::mutex> lock(mutexFFTW);
-        // Free the memory
-        fftw_destroy_plan(m_fftPlan);
-        fftw_free(m_inputData);
-        fftw_free(m_outputData);
+template <typename R>
+void BasicWrapperFFTW<R>::freePlan() {
+    // Free the memory
+    if (m_outputData != m_inputData) {
+        FFTWLibrary<R>::free(m_outputData);
     }
+    FFTWLibrary<R>::free(m_inputData);
+    FFTWLibrary<R>::free(m_realData);
+    m_inputData = nullptr;
+    m_outputData = nullptr;
+    m_realData = nullptr;
+    m_fftPlan.reset();
 }
+
+template class BasicWrapperFFTW<double>;
+template class BasicWrapperFFTW<float>;
@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 
 #include <dsps/Channel.h>
+#include <dsps/Simd.h>
 #include <dsps/Abs.h>
 
 #include "local/Utils.h"
@@ -112,5 +113,9 @@ int main(int argc, char *argv[]) {
     ::testing::InitGoogleMock(&argc, argv);
     ::testing::GTEST_FLAG(throw_on_failure) = true;
     ::testing::FLAGS_gtest_death_test_style = "fast";
+
+    // The oracles are compared bit to bit
+    DSP::Simd::setInstructionSet(DSP::Simd::InstructionSet::Scalar);
+
     return RUN_ALL_TESTS();
 }
@@ -0,0 +1,210 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <fstream>
+
+#include <dsps/Allocation.h>
+#include <dsps/AllocationHook.h>
+#include <dsps/Channel.h>
+#include <dsps/Decimation.h>
+#include <dsps/Demodulation.h>
+#include <dsps/Detrend.h>
+#include <dsps/FileSource.h>
+#include <dsps/SignalGenerator.h>
+#include <dsps/Splitter.h>
+#include <dsps/Unwrap.h>
+#include <dsps/Welch.h>
+
+#include "local/Utils.h"
+
+namespace {
+    class ScratchTask: public Task {
+    public:
+        ScratchTask()
+        : Task(ChannelType::None, 0, ChannelType::None, 0) {
+
+        }
+
+        virtual void compute(const std::uint64_t N) override {
+            USELESS_PARAMETER(N);
+        }
+
+        virtual bool isReady(const std::uint64_t N) const override {
+            USELESS_PARAMETER(N);
+            return true;
+        }
+
+        virtual bool hasFinished(const std::uint64_t N) const override {
+            USELESS_PARAMETER(N);
+            return true;
+        }
+
+        template<typename T>
+        T* observerScratch(const std::size_t index, const std::size_t size) {
+            return getScratch<T>(index, size);
+        }
+    };
+
+    void drainChannel(Channel &channel) {
+        const std::size_t size = channel.size(sizeof(double));
+        if (size > 0) {
+            channel.peek<double>(size);
+            channel.release<double>(size);
+        }
+    }
+
+    TEST(AllocationTest, testCounters) {
+        DSP::Allocation::resetCounters();
+        EXPECT_EQ(0u, DSP::Allocation::countAllocations());
+        EXPECT_EQ(0u, DSP::Allocation::countAllocatedBytes());
+
+        // The hook counts the operator new of program
+        std::vector<double> *values = new std::vector<double>(100);
+        ASSERT_NE(nullptr, values);
+        EXPECT_EQ(2u, DSP::Allocation::countAllocations());
+        EXPECT_EQ(sizeof(std::vector<double>) + 100 * sizeof(double), DSP::Allocation::countAllocatedBytes());
+        delete values;
+
+        // The aligned buffers are counted
+        void *data = DSP::Allocation::allocateAligned(1000);
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(data) % DSP::Allocation::CacheLineSize);
+        EXPECT_EQ(3u, DSP::Allocation::countAllocations());
+        DSP::Allocation::deallocateAligned(data);
+
+        DSP::Allocation::resetCounters();
+        EXPECT_EQ(0u, DSP::Allocation::countAllocations());
+        EXPECT_EQ(0u, DSP::Allocation::countAllocatedBytes());
+    }
+
+    TEST(AllocationTest, testScratchReuse) {
+        ScratchTask task;
+
+        double *first = task.observerScratch<double>(0, 1024);
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(first) % DSP::Allocation::CacheLineSize);
+
+        // A smaller or equal size reuses the buffer
+        DSP::Allocation::resetCounters();
+        EXPECT_EQ(first, task.observerScratch<double>(0, 1024));
+        EXPECT_EQ(first, task.observerScratch<double>(0, 10));
+        EXPECT_EQ(0u, DSP::Allocation::countAllocations());
+
+        // The buffers of indexes are distinct
+        double *second = task.observerScratch<double>(1, 1024);
+        EXPECT_NE(first, second);
+        EXPECT_EQ(first, task.observerScratch<double>(0, 1024));
+
+        // A bigger size reallocates the buffer
+        DSP::Allocation::resetCounters();
+        task.observerScratch<double>(0, 4096);
+        EXPECT_LE(1u, DSP::Allocation::countAllocations());
+    }
+
+    TEST(AllocationTest, testSteadyStateChain) {
+        static constexpr std::uint64_t N = 1024;
+        static constexpr std::size_t NumberWarmUp = 8;
+        static constexpr std::size_t NumberWindows = 64;
+
+        // in -> unwrap -> splitter -> decimation -> detrend
+        //                          -> welch (median)
+        Channel in;
+        Unwrap unwrap;
+        Splitter<double> splitter(2);
+        Decimation decimation(2);
+        Detrend detrend;
+        Welch welch(256, 128, 1.0, Welch::Window::Hanning, Welch::Averaging::Median);
+
+        unwrap.setInput(in, 0);
+        Task::connect(unwrap, splitter);
+        Task::connect(splitter, 0, decimation, 0);
+        Task::connect(decimation, detrend);
+        Task::connect(splitter, 1, welch, 0);
+
+        // signal generator -> demodulation
+        SignalGenerator generator(1.0, 10.0, 1000.0);
+        Demodulation demodulation(10.0, 1000.0, 0.0);
+        Task::connect(generator, demodulation);
+
+        // Looping file
+        const std::string filename = "/tmp/dsps_test_allocation.bin";
+        {
+            std::vector<double> values(3 * N + 17, 0.5);
+            std::ofstream file(filename, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+        }
+        FileSource source(filename, FileSource::FileFormat::BinaryDouble);
+
+        // The channels are reserved, the queues never grow or shrink
+        for (Channel *channel: {&in, &unwrap.getOutput(0), &splitter.getOutput(0), &splitter.getOutput(1), &decimation.getOutput(0),
+            &detrend.getOutput(0), &welch.getOutput(0), &generator.getOutput(0), &demodulation.getOutput(0), &demodulation.getOutput(1),
+            &source.getOutput(0)}) {
+            channel->reserve(4 * N, sizeof(double));
+        }
+
+        std::uint64_t index = 0;
+        auto runWindow = [&]() {
+            // Wrapped phase ramp
+            double *phases = in.acquireWrite<double>(N);
+            for (std::size_t i = 0; i < N; ++i, ++index) {
+                phases[i] = std::remainder(0.1 * static_cast<double>(index), 2.0 * M_PI);
+            }
+            in.commit<double>(N);
+
+            unwrap.compute(N);
+            splitter.compute(N);
+            decimation.compute(N / 2);
+            detrend.compute(N / 2);
+            welch.compute(N);
+
+            generator.compute(N);
+            demodulation.compute(N);
+
+            source.compute(N);
+
+            for (Channel *channel: {&detrend.getOutput(0), &welch.getOutput(0), &demodulation.getOutput(0), &demodulation.getOutput(1), &source.getOutput(0)}) {
+                drainChannel(*channel);
+            }
+        };
+
+        // The first windows allocate the scratch buffers and the plans
+        for (std::size_t i = 0; i < NumberWarmUp; ++i) {
+            runWindow();
+        }
+
+        DSP::Allocation::resetCounters();
+        for (std::size_t i = 0; i < NumberWindows; ++i) {
+            runWindow();
+        }
+        const std::uint64_t numberAllocations = DSP::Allocation::countAllocations();
+
+        EXPECT_EQ(0u, numberAllocations);
+        EXPECT_EQ(0u, in.size(sizeof(double)));
+        EXPECT_EQ(0u, splitter.getOutput(0).size(sizeof(double)));
+        EXPECT_EQ(0u, splitter.getOutput(1).size(sizeof(double)));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
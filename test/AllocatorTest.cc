@@ -0,0 +1,252 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <unistd.h>
+
+#include <dsps/Allocator.h>
+#include <dsps/Channel.h>
+#include <dsps/Gain.h>
+#include <dsps/SignalGenerator.h>
+#include <dsps/Task.h>
+
+#include "local/Utils.h"
+
+namespace {
+    bool isAligned(const void *data, const std::size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(data) % alignment == 0;
+    }
+
+    // Allocator which counts its buffers in use
+    class CountingAllocator: public DSP::Allocator {
+    public:
+        CountingAllocator()
+        : numberBuffers(0) {
+
+        }
+
+        virtual void *allocate(const std::size_t size) override {
+            ++numberBuffers;
+            return DSP::Allocator::getDefault().allocate(size);
+        }
+
+        virtual void deallocate(void *data, const std::size_t size) override {
+            if (data != nullptr) {
+                --numberBuffers;
+            }
+            DSP::Allocator::getDefault().deallocate(data, size);
+        }
+
+        int numberBuffers;
+    };
+
+    TEST(AllocatorTest, testDefault) {
+        DSP::Allocator &allocator = DSP::Allocator::getDefault();
+        EXPECT_EQ(&allocator, &DSP::Allocator::getDefault());
+
+        void *data = allocator.allocate(100);
+        EXPECT_TRUE(isAligned(data, DSP::Allocation::CacheLineSize));
+        allocator.deallocate(data, 100);
+    }
+
+    TEST(AllocatorTest, testAlignedPool) {
+        DSP::AlignedPool pool;
+
+        // The small buffers are aligned on a cache line
+        void *small = pool.allocate(100);
+        EXPECT_TRUE(isAligned(small, DSP::Allocation::CacheLineSize));
+        std::memset(small, 0, 100);
+
+        // The big buffers are aligned on a huge page
+        void *big = pool.allocate(DSP::AlignedPool::HugePageSize + 1);
+        EXPECT_TRUE(isAligned(big, DSP::AlignedPool::HugePageSize));
+        std::memset(big, 0, DSP::AlignedPool::HugePageSize + 1);
+
+        // The freed buffers are reused by the same size class
+        EXPECT_EQ(0u, pool.countCachedBuffers());
+        pool.deallocate(small, 100);
+        pool.deallocate(big, DSP::AlignedPool::HugePageSize + 1);
+        EXPECT_EQ(2u, pool.countCachedBuffers());
+
+        DSP::Allocation::resetCounters();
+        EXPECT_EQ(small, pool.allocate(128));
+        EXPECT_EQ(big, pool.allocate(2 * DSP::AlignedPool::HugePageSize));
+        EXPECT_EQ(0u, DSP::Allocation::countAllocations());
+        EXPECT_EQ(0u, pool.countCachedBuffers());
+
+        // Another class allocates a new buffer
+        void *other = pool.allocate(1000);
+        EXPECT_NE(small, other);
+        EXPECT_EQ(1u, DSP::Allocation::countAllocations());
+
+        pool.deallocate(small, 128);
+        pool.deallocate(other, 1000);
+        pool.deallocate(big, 2 * DSP::AlignedPool::HugePageSize);
+        EXPECT_EQ(3u, pool.countCachedBuffers());
+
+        pool.trim();
+        EXPECT_EQ(0u, pool.countCachedBuffers());
+    }
+
+    TEST(AllocatorTest, testArena) {
+        CountingAllocator upstream;
+
+        {
+            DSP::ArenaAllocator arena(4096, upstream);
+            EXPECT_EQ(0u, arena.countChunks());
+
+            // The buffers are cut in the same chunk
+            char *first = static_cast<char*>(arena.allocate(100));
+            char *second = static_cast<char*>(arena.allocate(64));
+            EXPECT_TRUE(isAligned(first, DSP::Allocation::CacheLineSize));
+            EXPECT_EQ(first + 128, second);
+            EXPECT_EQ(1u, arena.countChunks());
+            EXPECT_EQ(192u, arena.getUsedBytes());
+
+            // The deallocate doesn't give back the memory
+            arena.deallocate(second, 64);
+            EXPECT_EQ(192u, arena.getUsedBytes());
+
+            // A new chunk is taken when the current one is full, a big buffer has its own chunk
+            arena.allocate(4000);
+            EXPECT_EQ(2u, arena.countChunks());
+            arena.allocate(10000);
+            EXPECT_EQ(3u, arena.countChunks());
+            EXPECT_EQ(3, upstream.numberBuffers);
+
+            // All the chunks are freed at once
+            arena.release();
+            EXPECT_EQ(0u, arena.countChunks());
+            EXPECT_EQ(0u, arena.getUsedBytes());
+            EXPECT_EQ(0, upstream.numberBuffers);
+
+            arena.allocate(10);
+            EXPECT_EQ(1, upstream.numberBuffers);
+        }
+
+        // The destructor releases the arena
+        EXPECT_EQ(0, upstream.numberBuffers);
+    }
+
+    TEST(AllocatorTest, testNuma) {
+        const int node = DSP::NumaAllocator::getCurrentNode();
+        EXPECT_LE(0, node);
+
+        DSP::NumaAllocator allocator(node);
+        EXPECT_EQ(node, allocator.getNode());
+        EXPECT_EQ(DSP::NumaAllocator::isAvailable(), allocator.isBound());
+
+        const std::size_t size = 3 * sysconf(_SC_PAGESIZE) + 10;
+        char *data = static_cast<char*>(allocator.allocate(size));
+        if (allocator.isBound()) {
+            EXPECT_TRUE(isAligned(data, sysconf(_SC_PAGESIZE)));
+        }
+        EXPECT_TRUE(isAligned(data, DSP::Allocation::CacheLineSize));
+
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(i);
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(static_cast<char>(i), data[i]);
+        }
+
+        allocator.deallocate(data, size);
+        allocator.deallocate(nullptr, 0);
+    }
+
+    TEST(AllocatorTest, testQueueAndChannel) {
+        CountingAllocator allocator;
+
+        {
+            Queue queue(allocator);
+            EXPECT_EQ(&allocator, &queue.getAllocator());
+            EXPECT_EQ(1, allocator.numberBuffers);
+        }
+        EXPECT_EQ(0, allocator.numberBuffers);
+
+        // The pending data are moved to the new allocator
+        Channel channel;
+        std::vector<double> values(1000);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<double>(i);
+        }
+        channel.send(values);
+
+        channel.setAllocator(allocator);
+        EXPECT_EQ(1, allocator.numberBuffers);
+        compareChannelWithVector(values, channel, 0.0);
+
+        // The grows use the allocator
+        channel.reserve(100000, sizeof(double));
+        EXPECT_EQ(1, allocator.numberBuffers);
+        EXPECT_LE(100000u, channel.capacity(sizeof(double)));
+
+        channel.setAllocator(DSP::Allocator::getDefault());
+        EXPECT_EQ(0, allocator.numberBuffers);
+    }
+
+    TEST(AllocatorTest, testGraphArena) {
+        static constexpr std::uint64_t N = 1024;
+
+        // The arena is destroyed after the tasks
+        DSP::ArenaAllocator arena;
+        SignalGenerator generator(1.0, 10.0, 1000.0);
+        Gain<double> gain(2.0);
+        Task::connect(generator, gain);
+        Channel &out = gain.getOutput(0);
+
+        DSP::setAllocator({ &generator }, arena);
+        EXPECT_EQ(1u, arena.countChunks());
+        const std::size_t usedBytes = arena.getUsedBytes();
+        EXPECT_LT(0u, usedBytes);
+
+        // The graph doesn't allocate in the arena after the reserve
+        DSP::reserveChannels({ &generator }, N);
+        const std::size_t reservedBytes = arena.getUsedBytes();
+        EXPECT_LE(usedBytes, reservedBytes);
+
+        SignalGenerator reference(1.0, 10.0, 1000.0);
+        Channel &referenceOut = reference.getOutput(0);
+        for (std::size_t i = 0; i < 10; ++i) {
+            generator.compute(N);
+            gain.compute(N);
+            reference.compute(N);
+
+            const double *values = out.peek<double>(N);
+            const double *expected = referenceOut.peek<double>(N);
+            for (std::size_t j = 0; j < N; ++j) {
+                ASSERT_DOUBLE_EQ(2.0 * expected[j], values[j]);
+            }
+            out.release<double>(N);
+            referenceOut.release<double>(N);
+        }
+
+        EXPECT_EQ(reservedBytes, arena.getUsedBytes());
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include <dsps/AvarSink.h>
+#include <dsps/Channel.h>
+
+namespace {
+    TEST(AvarSinkTest, testCompute) {
+        static constexpr std::size_t N = 256;
+        static constexpr std::size_t M = 20;
+
+        std::mt19937 engine(1337);
+        std::normal_distribution<double> dist(0.0, 1.0);
+        std::vector<double> phases;
+        for (std::size_t i = 0; i < N * M; ++i) {
+            phases.push_back(dist(engine));
+        }
+
+        // Alloc the task
+        AvarSink<double> task(1e-3, 1.0, 256);
+        Channel in;
+        task.setInput(in, 0);
+        EXPECT_EQ(&task, in.getOut());
+        EXPECT_FALSE(task.hasFinished(N));
+
+        for (std::size_t w = 0; w < M; ++w) {
+            EXPECT_FALSE(task.isReady(N));
+            in.send(std::vector<double>(phases.begin() + w * N, phases.begin() + (w + 1) * N));
+            EXPECT_TRUE(task.isReady(N));
+            task.compute(N);
+            EXPECT_TRUE(task.hasFinished(N));
+        }
+
+        // Same result as the whole record
+        Avar avar(1e-3, 1.0, 256);
+        avar.compute(phases);
+        EXPECT_EQ(N * M, task.getAvar().countSamples());
+        EXPECT_EQ(avar.getTaus(), task.getAvar().getTaus());
+
+        const std::vector<double> expected = avar.getResult(Avar::Deviation::Modified);
+        const std::vector<double> result = task.getAvar().getResult(Avar::Deviation::Modified);
+        ASSERT_EQ(expected.size(), result.size());
+        for (std::size_t k = 0; k < result.size(); ++k) {
+            EXPECT_NEAR(expected[k], result[k], 1e-9 * expected[k]);
+        }
+    }
+
+    TEST(AvarSinkTest, testComputeFloat) {
+        static constexpr std::size_t N = 64;
+
+        // Linear phase: a frequency offset isn't seen by the deviations
+        AvarSink<float> task(1.0);
+        Channel in;
+        task.setInput(in, 0);
+
+        std::vector<float> phases(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            phases[i] = static_cast<float>(i);
+        }
+        in.send(phases);
+        task.compute(N);
+
+        for (double deviation: task.getAvar().getResult()) {
+            EXPECT_EQ(0.0, deviation);
+        }
+
+        task.reset();
+        EXPECT_EQ(0u, task.getAvar().countSamples());
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,238 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+#include <dsps/Avar.h>
+
+namespace {
+    class AvarTest : public ::testing::Test {
+    protected:
+        AvarTest()
+        : m_tau0(0.01)
+        , m_engine(1337) {
+            // Random walk of phase with white phase noise
+            std::normal_distribution<double> dist(0.0, 1e-9);
+            double walk = 0.0;
+            for (std::size_t i = 0; i < 5000; ++i) {
+                walk += dist(m_engine);
+                m_phases.push_back(walk + dist(m_engine));
+            }
+        }
+
+        // Direct sums of the definitions
+        double allan(std::size_t m) const {
+            const std::size_t n = m_phases.size();
+            double sum = 0.0;
+            for (std::size_t i = 0; i + 2 * m < n; ++i) {
+                const double d = m_phases[i + 2 * m] - 2.0 * m_phases[i + m] + m_phases[i];
+                sum += d * d;
+            }
+
+            return std::sqrt(sum / (2.0 * m * m * m_tau0 * m_tau0 * (n - 2 * m)));
+        }
+
+        double modified(std::size_t m) const {
+            const std::size_t n = m_phases.size();
+            double sum = 0.0;
+            for (std::size_t j = 0; j + 3 * m <= n; ++j) {
+                double inner = 0.0;
+                for (std::size_t i = j; i < j + m; ++i) {
+                    inner += m_phases[i + 2 * m] - 2.0 * m_phases[i + m] + m_phases[i];
+                }
+                sum += inner * inner;
+            }
+
+            return std::sqrt(sum / (2.0 * m * m * m * m * m_tau0 * m_tau0 * (n - 3 * m + 1)));
+        }
+
+        double hadamard(std::size_t m) const {
+            const std::size_t n = m_phases.size();
+            double sum = 0.0;
+            for (std::size_t i = 0; i + 3 * m < n; ++i) {
+                const double d = m_phases[i + 3 * m] - 3.0 * m_phases[i + 2 * m] + 3.0 * m_phases[i + m] - m_phases[i];
+                sum += d * d;
+            }
+
+            return std::sqrt(sum / (6.0 * m * m * m_tau0 * m_tau0 * (n - 3 * m)));
+        }
+
+        void checkResult(const Avar &avar) const {
+            const std::vector<double> taus = avar.getTaus();
+            const std::vector<double> adev = avar.getResult(Avar::Deviation::Allan);
+            const std::vector<double> mdev = avar.getResult(Avar::Deviation::Modified);
+            const std::vector<double> hdev = avar.getResult(Avar::Deviation::Hadamard);
+
+            // Factors 1 to 2048 have Allan terms for 5000 phases
+            ASSERT_EQ(12u, taus.size());
+            ASSERT_EQ(taus.size(), adev.size());
+            ASSERT_EQ(taus.size(), mdev.size());
+            ASSERT_EQ(taus.size(), hdev.size());
+            EXPECT_EQ(5000u, avar.countSamples());
+
+            for (std::size_t k = 0; k < taus.size(); ++k) {
+                const std::size_t m = 1 << k;
+                EXPECT_DOUBLE_EQ(m * m_tau0, taus[k]);
+                EXPECT_NEAR(allan(m), adev[k], 1e-9 * allan(m));
+
+                if (3 * m <= m_phases.size()) {
+                    EXPECT_NEAR(modified(m), mdev[k], 1e-9 * modified(m));
+                    EXPECT_NEAR(hadamard(m), hdev[k], 1e-9 * hadamard(m));
+                }
+                else {
+                    EXPECT_TRUE(std::isnan(mdev[k]));
+                    EXPECT_TRUE(std::isnan(hdev[k]));
+                }
+            }
+
+            // The first modified deviation is the Allan one
+            EXPECT_DOUBLE_EQ(adev[0], mdev[0]);
+
+            const std::vector<std::uint64_t> counts = avar.countTerms(Avar::Deviation::Modified);
+            EXPECT_EQ(5000u - 3 + 1, counts[0]);
+        }
+
+        double m_tau0;
+        std::mt19937 m_engine;
+        std::vector<double> m_phases;
+    };
+
+    TEST_F(AvarTest, testCompute) {
+        Avar avar(m_tau0);
+        EXPECT_TRUE(avar.getTaus().empty());
+
+        avar.compute(m_phases, 1);
+        checkResult(avar);
+
+        // The threads give the same result
+        Avar parallel(m_tau0);
+        parallel.compute(m_phases, 4);
+        checkResult(parallel);
+        EXPECT_EQ(avar.getResult(Avar::Deviation::Allan), parallel.getResult(Avar::Deviation::Allan));
+    }
+
+    TEST_F(AvarTest, testStream) {
+        Avar avar(m_tau0, 1.0, 4096);
+
+        // The chunks have odd sizes
+        std::size_t begin = 0;
+        for (std::size_t size = 1; begin < m_phases.size(); size = size * 3 + 1) {
+            const std::size_t count = std::min(size, m_phases.size() - begin);
+            avar.push(m_phases.data() + begin, count);
+            begin += count;
+        }
+
+        checkResult(avar);
+
+        // A new stream restarts from zero
+        avar.reset();
+        EXPECT_EQ(0u, avar.countSamples());
+        EXPECT_TRUE(avar.getTaus().empty());
+    }
+
+    TEST_F(AvarTest, testStreamMaxFactor) {
+        // The history is limited, so are the averaging times
+        Avar avar(m_tau0, 1.0, 16);
+        avar.push(m_phases.data(), m_phases.size());
+
+        ASSERT_EQ(5u, avar.getTaus().size());
+        const std::vector<double> mdev = avar.getResult(Avar::Deviation::Modified);
+        for (std::size_t k = 0; k < 5; ++k) {
+            EXPECT_NEAR(modified(1 << k), mdev[k], 1e-9 * modified(1 << k));
+        }
+    }
+
+    TEST_F(AvarTest, testFrequencyDrift) {
+        // x = D t^2 / 2 gives ADEV = MDEV = D tau / sqrt(2) and HDEV = 0
+        static constexpr double DRIFT = 1e-6;
+        std::vector<double> phases;
+        for (std::size_t i = 0; i < 1024; ++i) {
+            const double t = i * m_tau0;
+            phases.push_back(DRIFT * t * t / 2.0);
+        }
+
+        Avar avar(m_tau0);
+        avar.compute(phases);
+        const std::vector<double> taus = avar.getTaus();
+        const std::vector<double> adev = avar.getResult(Avar::Deviation::Allan);
+        const std::vector<double> mdev = avar.getResult(Avar::Deviation::Modified);
+        const std::vector<double> hdev = avar.getResult(Avar::Deviation::Hadamard);
+        for (std::size_t k = 0; k < taus.size(); ++k) {
+            EXPECT_NEAR(DRIFT * taus[k] / std::sqrt(2.0), adev[k], 1e-6 * DRIFT * taus[k]);
+            if (!std::isnan(mdev[k])) {
+                EXPECT_NEAR(DRIFT * taus[k] / std::sqrt(2.0), mdev[k], 1e-6 * DRIFT * taus[k]);
+                EXPECT_NEAR(0.0, hdev[k], 1e-6 * DRIFT * taus[k]);
+            }
+        }
+    }
+
+    TEST_F(AvarTest, testPhaseScale) {
+        // Phases in radians of a 10 MHz signal
+        const double f0 = 10e6;
+        std::vector<double> radians;
+        for (double phase: m_phases) {
+            radians.push_back(phase * 2.0 * M_PI * f0);
+        }
+
+        Avar seconds(m_tau0);
+        seconds.compute(m_phases);
+        Avar scaled(m_tau0, 1.0 / (2.0 * M_PI * f0));
+        scaled.compute(radians);
+
+        const std::vector<double> expected = seconds.getResult();
+        const std::vector<double> result = scaled.getResult();
+        ASSERT_EQ(expected.size(), result.size());
+        for (std::size_t k = 0; k < result.size(); ++k) {
+            EXPECT_NEAR(expected[k], result[k], 1e-9 * expected[k]);
+        }
+    }
+
+    TEST_F(AvarTest, testComputeFile) {
+        // Binary file, used in place
+        std::ofstream binary("/tmp/dsps_test_avar.bin", std::ios::binary);
+        binary.write(reinterpret_cast<const char*>(m_phases.data()), m_phases.size() * sizeof(double));
+        binary.close();
+
+        Avar avar(m_tau0);
+        avar.compute("/tmp/dsps_test_avar.bin");
+        checkResult(avar);
+
+        // Text file
+        std::ofstream text("/tmp/dsps_test_avar.txt");
+        text << std::scientific << std::setprecision(17);
+        for (double phase: m_phases) {
+            text << phase << "\n";
+        }
+        text.close();
+
+        avar.compute("/tmp/dsps_test_avar.txt", false);
+        checkResult(avar);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
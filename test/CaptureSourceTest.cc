@@ -0,0 +1,168 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <complex>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/CaptureSink.h>
+#include <dsps/CaptureSource.h>
+#include <dsps/Channel.h>
+#include <dsps/Mean.h>
+#include <dsps/ParallelProcessor.h>
+#include <dsps/Utils.h>
+
+namespace {
+    const std::string Filename = "/tmp/dsps_test_capture_source.cap";
+
+    std::complex<double> sample(std::size_t channel, std::size_t index) {
+        return std::complex<double>(static_cast<double>(index), static_cast<double>(channel) + 0.5);
+    }
+
+    void writeCapture(std::size_t channels, std::size_t frames, std::uint64_t N) {
+        CaptureSink< std::complex<double> > sink(Filename, channels, 1e3, 1000, Capture::Compression::Zlib);
+        std::vector<Channel> inputs(channels);
+        for (std::size_t c = 0; c < channels; ++c) {
+            sink.setInput(inputs[c], c);
+        }
+
+        std::vector< std::complex<double> > values(N);
+        for (std::size_t first = 0; first < frames; first += N) {
+            EXPECT_FALSE(sink.isReady(N));
+            for (std::size_t c = 0; c < channels; ++c) {
+                for (std::size_t i = 0; i < N; ++i) {
+                    values[i] = sample(c, first + i);
+                }
+                inputs[c].send(values);
+            }
+
+            EXPECT_TRUE(sink.isReady(N));
+            sink.compute(N);
+            EXPECT_TRUE(sink.hasFinished(N));
+        }
+        sink.close();
+    }
+
+    void checkWindow(Channel &out, std::size_t channel, std::size_t first, std::size_t frames, std::uint64_t N) {
+        ASSERT_EQ(N, out.size(sizeof(std::complex<double>)));
+
+        std::vector< std::complex<double> > values(N);
+        out.receive(values, N);
+        for (std::size_t i = 0; i < N; ++i) {
+            EXPECT_EQ(sample(channel, (first + i) % frames), values[i]);
+        }
+    }
+
+    TEST(CaptureSourceTest, testMultiChannel) {
+        const std::uint64_t N = 256;
+        writeCapture(3, 10 * N, N);
+
+        CaptureSource< std::complex<double> > source(Filename, true, 2);
+        EXPECT_EQ(3u, source.countNextTask());
+        EXPECT_EQ(1e3, source.getReader().getSampleRate());
+        EXPECT_EQ(10 * N, source.getReader().countFrames());
+
+        // The windows wrap at the end of capture
+        for (std::size_t w = 0; w < 25; ++w) {
+            EXPECT_TRUE(source.isReady(N));
+            EXPECT_FALSE(source.hasFinished(N));
+            source.compute(N);
+            EXPECT_TRUE(source.hasFinished(N));
+
+            for (std::size_t c = 0; c < 3; ++c) {
+                checkWindow(source.getOutput(c), c, w * N, 10 * N, N);
+            }
+        }
+
+        // Seek anywhere
+        source.seek(1234);
+        EXPECT_EQ(1234u, source.getPosition());
+        source.compute(N);
+        for (std::size_t c = 0; c < 3; ++c) {
+            checkWindow(source.getOutput(c), c, 1234, 10 * N, N);
+        }
+    }
+
+    TEST(CaptureSourceTest, testEndOfStream) {
+        const std::uint64_t N = 100;
+        writeCapture(1, 1000, N);
+
+        CaptureSource< std::complex<double> > source(Filename, false);
+        source.seek(750);
+
+        // The last incomplete window isn't sent
+        for (std::size_t w = 0; w < 2; ++w) {
+            source.compute(N);
+            checkWindow(source.getOutput(0), 0, 750 + w * N, 1000, N);
+        }
+        EXPECT_FALSE(source.isEndOfStream());
+
+        source.compute(N);
+        EXPECT_TRUE(source.isEndOfStream());
+        EXPECT_FALSE(source.isReady(N));
+        EXPECT_EQ(0u, source.getOutput(0).size(sizeof(std::complex<double>)));
+
+        // A seek restarts the stream
+        source.seek(900);
+        source.compute(N);
+        checkWindow(source.getOutput(0), 0, 900, 1000, N);
+        EXPECT_TRUE(source.isEndOfStream());
+    }
+
+    TEST(CaptureSourceTest, testProcessingEndOfStream) {
+        const std::uint64_t N = 100;
+        writeCapture(1, 1000, N);
+
+        // The mean never finishes, the processing ends with the capture
+        for (bool parallel: {false, true}) {
+            CaptureSource< std::complex<double> > source(Filename, false);
+            Mean< std::complex<double> > mean(100);
+            Task::connect(source, mean);
+            source.seek(750);
+
+            if (parallel) {
+                DSP::ParallelProcessor processor(2);
+                processor.processing({ &source }, { &mean }, N);
+            }
+            else {
+                DSP::processing({ &source }, { &mean }, N);
+            }
+
+            // The last incomplete window isn't sent
+            EXPECT_TRUE(source.isEndOfStream());
+            EXPECT_FALSE(mean.hasFinished(N));
+            EXPECT_EQ(2u, mean.getNumberOfMean());
+
+            std::vector< std::complex<double> > means;
+            mean.getMean(means);
+            ASSERT_EQ(N, means.size());
+            for (std::size_t i = 0; i < N; ++i) {
+                EXPECT_EQ((sample(0, 750 + i) + sample(0, 850 + i)) / 2.0, means[i]);
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,142 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Capture.h>
+
+namespace {
+    const std::string Filename = "/tmp/dsps_test_capture.cap";
+
+    // A slow ramp with noise on two channels, compressible by zlib
+    std::vector<std::int64_t> createFrames(std::size_t frames) {
+        std::mt19937 engine(1337);
+        std::uniform_int_distribution<std::int64_t> noise(-3, 3);
+
+        std::vector<std::int64_t> values(frames * 2);
+        for (std::size_t i = 0; i < frames; ++i) {
+            values[2 * i] = static_cast<std::int64_t>(i / 16) + noise(engine);
+            values[2 * i + 1] = -static_cast<std::int64_t>(i) + noise(engine);
+        }
+
+        return values;
+    }
+
+    void writeCapture(const std::vector<std::int64_t> &values, std::uint64_t framesPerChunk, Capture::Compression compression) {
+        Capture::Writer writer(Filename, ChannelType::Int64, 2, 125e6, framesPerChunk, compression);
+
+        // Writes which aren't aligned on the chunks
+        std::size_t done = 0;
+        for (std::size_t size = 1; done < values.size() / 2; size = size * 3 + 1) {
+            const std::size_t count = std::min(size, values.size() / 2 - done);
+            writer.write(values.data() + 2 * done, count);
+            done += count;
+        }
+        EXPECT_EQ(values.size() / 2, writer.countFrames());
+    }
+
+    void checkRead(Capture::Reader &reader, const std::vector<std::int64_t> &values, std::uint64_t first, std::uint64_t count, unsigned numThreads) {
+        std::vector<std::int64_t> frames(2 * count);
+        reader.read(first, count, frames.data(), numThreads);
+
+        for (std::uint64_t i = 0; i < 2 * count; ++i) {
+            ASSERT_EQ(values[2 * first + i], frames[i]) << "first " << first << " count " << count;
+        }
+    }
+
+    TEST(CaptureTest, testHeader) {
+        std::vector<std::int64_t> values = createFrames(10000);
+        writeCapture(values, 1000, Capture::Compression::None);
+
+        Capture::Reader reader(Filename);
+        EXPECT_EQ(ChannelType::Int64, reader.getChannelType());
+        EXPECT_EQ(2u, reader.countChannels());
+        EXPECT_EQ(125e6, reader.getSampleRate());
+        EXPECT_EQ(1000u, reader.getFramesPerChunk());
+        EXPECT_EQ(10000u, reader.countFrames());
+        EXPECT_EQ(10u, reader.countChunks());
+        EXPECT_EQ(0u, reader.countCompressedChunks());
+
+        checkRead(reader, values, 0, 10000, 1);
+    }
+
+    TEST(CaptureTest, testRandomAccess) {
+        // The last chunk is incomplete
+        std::vector<std::int64_t> values = createFrames(100123);
+        writeCapture(values, 4096, Capture::Compression::Zlib);
+
+        Capture::Reader reader(Filename);
+        EXPECT_EQ(25u, reader.countChunks());
+        EXPECT_EQ(25u, reader.countCompressedChunks());
+
+        std::mt19937 engine(42);
+        std::uniform_int_distribution<std::uint64_t> position(0, 100123);
+        for (std::size_t i = 0; i < 200; ++i) {
+            std::uint64_t first = position(engine);
+            std::uint64_t last = position(engine);
+            if (first > last) {
+                std::swap(first, last);
+            }
+
+            checkRead(reader, values, first, last - first, 1 + i % 4);
+        }
+
+        // Reads on the bounds of chunks
+        checkRead(reader, values, 4096, 4096, 2);
+        checkRead(reader, values, 4095, 2, 2);
+        checkRead(reader, values, 100000, 123, 2);
+        checkRead(reader, values, 0, 100123, 0);
+    }
+
+    TEST(CaptureTest, testSequentialRead) {
+        std::vector<std::int64_t> values = createFrames(50000);
+        writeCapture(values, 3000, Capture::Compression::Zlib);
+
+        // Small windows are served by the cached chunk
+        Capture::Reader reader(Filename);
+        for (std::uint64_t first = 0; first + 700 <= 50000; first += 700) {
+            checkRead(reader, values, first, 700, 1);
+        }
+    }
+
+    TEST(CaptureTest, testIncompressible) {
+        std::mt19937_64 engine(7);
+        std::vector<std::int64_t> values(2 * 20000);
+        for (std::int64_t &value: values) {
+            value = static_cast<std::int64_t>(engine());
+        }
+        writeCapture(values, 5000, Capture::Compression::Zlib);
+
+        // The random chunks are stored raw
+        Capture::Reader reader(Filename);
+        EXPECT_EQ(0u, reader.countCompressedChunks());
+        checkRead(reader, values, 123, 15000, 4);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
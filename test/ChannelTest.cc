@@ -151,6 +151,86 @@ namespace {
     }
 }
 
+namespace {
+    void checkBorrowing(Channel &channel) {
+        std::uint64_t current = 0;
+        std::uint64_t expected = 0;
+
+        for (std::size_t step = 0; step < 20; ++step) {
+            double *out = channel.acquireWrite<double>(70);
+            for (std::size_t i = 0; i < 70; ++i) {
+                out[i] = static_cast<double>(current++);
+            }
+            channel.commit<double>(70);
+            EXPECT_EQ(current - expected, channel.size(sizeof(double)));
+
+            const double *in = channel.peek<double>(64);
+            for (std::size_t i = 0; i < 64; ++i) {
+                ASSERT_EQ(static_cast<double>(expected + i), in[i]);
+            }
+            channel.release<double>(64);
+            expected += 64;
+        }
+
+        // The borrowing API is compatible with send/receive
+        std::vector<double> values;
+        channel.receive(values, current - expected);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            EXPECT_EQ(static_cast<double>(expected + i), values[i]);
+        }
+    }
+
+    TEST(ChannelTest, testReserve) {
+        Channel channel;
+        channel.reserve(100000, sizeof(double));
+        EXPECT_LE(static_cast<std::size_t>(100000), channel.capacity(sizeof(double)));
+
+        std::vector<double> values(100000);
+        channel.send(values);
+        channel.receive(values, 100000);
+        EXPECT_EQ(static_cast<std::uint64_t>(0), channel.countGrow());
+        EXPECT_EQ(static_cast<std::uint64_t>(0), channel.countShrink());
+
+        // The ring is replaced only if too small
+        Channel ring;
+        ring.setRingBuffer(1024);
+        ring.reserve(64, sizeof(double));
+        EXPECT_EQ(static_cast<std::size_t>(1024), ring.getRingCapacity());
+        EXPECT_EQ(static_cast<std::uint64_t>(0), ring.countGrow());
+        ring.reserve(1000, sizeof(double));
+        EXPECT_LE(static_cast<std::size_t>(1000), ring.capacity(sizeof(double)));
+        EXPECT_EQ(static_cast<std::uint64_t>(1), ring.countGrow());
+    }
+
+    TEST(ChannelTest, testBorrowingQueue) {
+        Channel channel;
+        checkBorrowing(channel);
+    }
+
+    TEST(ChannelTest, testBorrowingReentry) {
+        Channel channel;
+        std::vector<double> values(16);
+        channel.send(values);
+
+        // The borrowing thread can't use the locked queue, only its size
+        channel.peek<double>(16);
+        EXPECT_EQ(static_cast<std::size_t>(16), channel.size(sizeof(double)));
+        EXPECT_DEATH({ channel.acquireWrite<double>(16); }, "Error the channel is borrowed by this thread!");
+        channel.release<double>(16);
+
+        channel.acquireWrite<double>(16);
+        EXPECT_DEATH({ channel.receive(values, 16); }, "Error the channel is borrowed by this thread!");
+        channel.commit<double>(16);
+        EXPECT_EQ(static_cast<std::size_t>(16), channel.size(sizeof(double)));
+    }
+
+    TEST(ChannelTest, testBorrowingRing) {
+        Channel channel;
+        channel.setRingBuffer(256 * sizeof(double));
+        checkBorrowing(channel);
+    }
+}
+
 int main(int argc, char *argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
     ::testing::InitGoogleMock(&argc, argv);
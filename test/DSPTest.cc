@@ -30,6 +30,7 @@
 #include <dsps/Mean.h>
 #include <dsps/NoiseGenerator.h>
 #include <dsps/NormalizePsddBc.h>
+#include <dsps/SignalGenerator.h>
 #include <dsps/Splitter.h>
 #include <dsps/Sum.h>
 #include <dsps/Unwrap.h>
@@ -132,6 +133,46 @@ namespace {
         EXPECT_EQ(result.end(), it);
     }
 
+    TEST(DSPTest, testReserveChannels) {
+        static constexpr unsigned N = 2048;
+        static constexpr double FS = 250e6;
+        static constexpr double FC = 10e6;
+        static constexpr unsigned D = 10;
+
+        SignalGenerator signalTask(1.0, FC * 1.0001, FS);
+        Demodulation demodulationTask(FC, FS, M_PI/7.0);
+        Fir<double> firITask(std::string(ORACLE_DATA_DIR) + "/kaiser128_40", D);
+        Fir<double> firQTask(std::string(ORACLE_DATA_DIR) + "/kaiser128_40", D);
+        Atan2 atan2Task;
+        Unwrap unwrapTask;
+
+        Task::connect(signalTask, demodulationTask);
+        Task::connect(demodulationTask, 0, firITask, 0);
+        Task::connect(demodulationTask, 1, firQTask, 0);
+        atan2Task.connectIChannel(firITask);
+        atan2Task.connectQChannel(firQTask);
+        Task::connect(atan2Task, unwrapTask);
+
+        DSP::reserveChannels({ &signalTask }, N);
+
+        // The filters need ten windows and their history
+        Channel &demodulationOut = demodulationTask.getOutput(0);
+        EXPECT_LE(static_cast<std::size_t>(D * N + 128), demodulationOut.capacity(sizeof(double)));
+
+        for (std::size_t i = 0; i < 50; ++i) {
+            DSP::processing({ &signalTask }, { &unwrapTask }, N);
+        }
+
+        std::vector<Channel*> channels = {
+            &signalTask.getOutput(0), &demodulationTask.getOutput(0), &demodulationTask.getOutput(1),
+            &firITask.getOutput(0), &firQTask.getOutput(0), &atan2Task.getOutput(0)
+        };
+        for (Channel *channel: channels) {
+            EXPECT_EQ(static_cast<std::uint64_t>(0), channel->countGrow());
+            EXPECT_EQ(static_cast<std::uint64_t>(0), channel->countShrink());
+        }
+    }
+
     TEST(DSPTest, testProcessing) {
         static constexpr unsigned N = 2048;
         static constexpr double FS = 250e6;
@@ -0,0 +1,214 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <dsps/Channel.h>
+#include <dsps/ExecutionContext.h>
+#include <dsps/ParallelProcessor.h>
+#include <dsps/SignalGenerator.h>
+#include <dsps/Task.h>
+#include <dsps/Utils.h>
+#include <dsps/WrapperFFTW.h>
+
+#include "local/Utils.h"
+
+namespace {
+    std::vector<int> getAffinity() {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+
+        std::vector<int> cores;
+        for (int core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &set)) {
+                cores.push_back(core);
+            }
+        }
+
+        return cores;
+    }
+
+    // Sink which records the context of thread of its computes
+    class ProbeTask: public Task {
+    public:
+        ProbeTask()
+        : Task(ChannelType::Double, 1, ChannelType::None, 0)
+        , numberComputes(0)
+        , fftwThreads(0) {
+
+        }
+
+        virtual void compute(const std::uint64_t N) override {
+            m_inputChannels[0]->peek<double>(N);
+            m_inputChannels[0]->release<double>(N);
+
+            ++numberComputes;
+            fftwThreads = DSP::ExecutionContext::getCurrent().getFFTWThreads();
+            cores = getAffinity();
+        }
+
+        virtual bool isReady(const std::uint64_t N) const override {
+            return m_inputChannels[0]->size(sizeof(double)) >= N;
+        }
+
+        virtual bool hasFinished(const std::uint64_t N) const override {
+            USELESS_PARAMETER(N);
+            return numberComputes > 0;
+        }
+
+        std::size_t numberComputes;
+        int fftwThreads;
+        std::vector<int> cores;
+    };
+
+    TEST(ExecutionContextTest, testDefault) {
+        const DSP::ExecutionContext &context = DSP::ExecutionContext::getDefault();
+        EXPECT_TRUE(context.getCores().empty());
+        EXPECT_EQ(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())), context.getFFTWThreads());
+        EXPECT_EQ(context.countThreads(), static_cast<std::size_t>(context.getFFTWThreads()));
+        EXPECT_EQ(&context, &DSP::ExecutionContext::getCurrent());
+        EXPECT_FALSE(context.pinCurrentThread());
+    }
+
+    TEST(ExecutionContextTest, testConstructor) {
+        DSP::ExecutionContext context({ 2, 0, 2 }, 3, DSP::ExecutionContext::Pinning::OneCorePerThread);
+        EXPECT_EQ(std::vector<int>({ 0, 2 }), context.getCores());
+        EXPECT_EQ(3, context.getFFTWThreads());
+        EXPECT_EQ(DSP::ExecutionContext::Pinning::OneCorePerThread, context.getPinning());
+        EXPECT_EQ(2u, context.countThreads());
+
+        // The FFTW threads follow the core set
+        DSP::ExecutionContext automatic({ 0, 1, 2, 3 });
+        EXPECT_EQ(4, automatic.getFFTWThreads());
+
+        EXPECT_DEATH({ DSP::ExecutionContext invalid({ -1 }); }, "");
+    }
+
+    TEST(ExecutionContextTest, testScope) {
+        const std::vector<int> initialCores = getAffinity();
+        DSP::ExecutionContext outer({ 0 }, 2);
+        DSP::ExecutionContext inner(std::vector<int>(), 1);
+
+        {
+            DSP::ExecutionContext::Scope outerScope(outer);
+            EXPECT_TRUE(outerScope.isPinned());
+            EXPECT_EQ(&outer, &DSP::ExecutionContext::getCurrent());
+            EXPECT_EQ(std::vector<int>({ 0 }), getAffinity());
+
+            {
+                // A context without cores keeps the affinity
+                DSP::ExecutionContext::Scope innerScope(inner);
+                EXPECT_FALSE(innerScope.isPinned());
+                EXPECT_EQ(&inner, &DSP::ExecutionContext::getCurrent());
+                EXPECT_EQ(std::vector<int>({ 0 }), getAffinity());
+            }
+
+            EXPECT_EQ(&outer, &DSP::ExecutionContext::getCurrent());
+        }
+
+        EXPECT_EQ(&DSP::ExecutionContext::getDefault(), &DSP::ExecutionContext::getCurrent());
+        EXPECT_EQ(initialCores, getAffinity());
+    }
+
+    TEST(ExecutionContextTest, testProcessing) {
+        static constexpr unsigned N = 1024;
+
+        const std::vector<int> initialCores = getAffinity();
+        DSP::ExecutionContext context({ 0 }, 2);
+
+        SignalGenerator generator(1.0, 10.0, 1000.0);
+        ProbeTask probe;
+        Task::connect(generator, probe);
+
+        DSP::processing({ &generator }, { &probe }, N, context);
+        EXPECT_EQ(1u, probe.numberComputes);
+        EXPECT_EQ(2, probe.fftwThreads);
+        EXPECT_EQ(std::vector<int>({ 0 }), probe.cores);
+
+        // The affinity of caller is restored
+        EXPECT_EQ(initialCores, getAffinity());
+        EXPECT_EQ(&DSP::ExecutionContext::getDefault(), &DSP::ExecutionContext::getCurrent());
+    }
+
+    TEST(ExecutionContextTest, testParallelProcessor) {
+        static constexpr unsigned N = 1024;
+
+        DSP::ExecutionContext context({ 0 }, 3, DSP::ExecutionContext::Pinning::OneCorePerThread);
+        DSP::ParallelProcessor processor(0, 2, context);
+        EXPECT_EQ(1u, processor.countThreads());
+
+        SignalGenerator generator(1.0, 10.0, 1000.0);
+        ProbeTask probe;
+        Task::connect(generator, probe);
+
+        processor.processing({ &generator }, { &probe }, N);
+        EXPECT_LE(1u, probe.numberComputes);
+        EXPECT_EQ(3, probe.fftwThreads);
+        EXPECT_EQ(std::vector<int>({ 0 }), probe.cores);
+    }
+
+    TEST(ExecutionContextTest, testFFTWThreads) {
+        static constexpr unsigned N = 64;
+
+        std::vector< std::complex<double> > input(N, std::complex<double>(1.0, 0.0));
+        std::vector< std::complex<double> > output;
+
+        WrapperFFTW::clearPlanCache();
+        {
+            WrapperFFTW wrapper(FFTDirection::Forward);
+            wrapper.compute(input, output, N);
+        }
+        EXPECT_EQ(1u, WrapperFFTW::countCachedPlans());
+
+        // The plans of contexts with other thread counts are distinct
+        DSP::ExecutionContext context(std::vector<int>(), DSP::ExecutionContext::getDefault().getFFTWThreads() + 1);
+        {
+            DSP::ExecutionContext::Scope scope(context);
+            WrapperFFTW wrapper(FFTDirection::Forward);
+            wrapper.compute(input, output, N);
+        }
+        EXPECT_EQ(2u, WrapperFFTW::countCachedPlans());
+        EXPECT_NEAR(static_cast<double>(N), output[0].real(), 1e-9);
+
+        // A wrapper follows the context of its computes
+        WrapperFFTW::clearPlanCache();
+        {
+            WrapperFFTW wrapper(FFTDirection::Forward);
+            wrapper.compute(input, output, N);
+            EXPECT_EQ(1u, WrapperFFTW::countCachedPlans());
+
+            DSP::ExecutionContext::Scope scope(context);
+            wrapper.compute(input, output, N);
+            EXPECT_EQ(2u, WrapperFFTW::countCachedPlans());
+        }
+
+        WrapperFFTW::clearPlanCache();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
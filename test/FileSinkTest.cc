@@ -157,6 +157,59 @@ namespace {
             expect_eq_double(m_complexValues[i].imag(), imag, 0.0);
         }
     }
+
+    TEST_F(FileSinkTest, testComputeBuffered) {
+        // Buffers which aren't a multiple of windows
+        FileSink<double> task("/tmp/dsps_test_sink.bin", false, 100000, 3, true);
+        Channel in;
+        task.setInput(in, 0);
+        EXPECT_EQ(nullptr, task.getWriter());
+
+        for (std::size_t i = 0; i < 100; ++i) {
+            std::vector<double> inValues(m_realValues.begin() + i * m_N, m_realValues.begin() + (i + 1) * m_N);
+            in.send(inValues);
+            EXPECT_TRUE(task.isReady(m_N));
+            task.compute(m_N);
+            EXPECT_TRUE(task.hasFinished(m_N));
+        }
+
+        // The last buffer is written by the flush
+        task.flush();
+        ASSERT_NE(nullptr, task.getWriter());
+        EXPECT_EQ(0u, task.getWriter()->getQueueDepth());
+        EXPECT_GE(task.getWriter()->getMaxQueueDepth(), 1u);
+        EXPECT_GE(task.getWriter()->countWrittenBytes(), m_realValues.size() * sizeof(double));
+        EXPECT_GT(task.getWriter()->getWriteThroughput(), 0.0);
+
+        std::ifstream file("/tmp/dsps_test_sink.bin", std::ios_base::in|std::ios_base::binary);
+        std::vector<double> values(m_realValues.size() + 1);
+        file.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(double));
+        EXPECT_EQ(static_cast<std::streamsize>(m_realValues.size() * sizeof(double)), file.gcount());
+        values.pop_back();
+        EXPECT_EQ(m_realValues, values);
+    }
+
+    TEST_F(FileSinkTest, testComputeOverride) {
+        FileSink<double> task("/tmp/dsps_test_sink.bin", true);
+        Channel in;
+        task.setInput(in, 0);
+
+        for (std::size_t i = 0; i < 10; ++i) {
+            // The window size decreases
+            const std::size_t size = m_N - i;
+            std::vector<double> inValues(m_realValues.begin() + i * m_N, m_realValues.begin() + i * m_N + size);
+            in.send(inValues);
+            task.compute(size);
+
+            // Only the last window is in the file
+            std::ifstream file("/tmp/dsps_test_sink.bin", std::ios_base::in|std::ios_base::binary);
+            std::vector<double> values(size + 1);
+            file.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(double));
+            EXPECT_EQ(static_cast<std::streamsize>(size * sizeof(double)), file.gcount());
+            values.pop_back();
+            EXPECT_EQ(inValues, values);
+        }
+    }
 }
 
 int main(int argc, char *argv[]) {
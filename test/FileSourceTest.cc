@@ -20,6 +20,9 @@
 
 #include <dsps/Channel.h>
 #include <dsps/FileSource.h>
+#include <dsps/Mean.h>
+#include <dsps/ParallelProcessor.h>
+#include <dsps/Utils.h>
 
 #include "local/Utils.h"
 
@@ -352,6 +355,221 @@ namespace {
             indexOracle = (indexOracle + N) % 100000;
         }
     }
+
+    TEST(FileSourceTest, testMappedBinaryInteger) {
+        std::string filename = std::string(ORACLE_DATA_DIR) + "/oracle_file_source_integer.bin";
+        const std::int64_t N = 1000;
+
+        // Load oracle values
+        std::vector<std::int64_t> oracleValues = loadValuesFromBinaryFile<std::int64_t>(filename);
+
+        // Create the task
+        FileSource task(filename, FileSource::FileFormat::BinaryInteger, FileSource::Access::Mapped);
+        Channel &out = task.getOutput(0);
+
+        // Test the task core, the windows wrap at the end of file
+        std::size_t indexOracle = 0;
+        for (std::size_t i = 0; i < 2000; ++i) {
+            EXPECT_TRUE(task.isReady(N));
+            EXPECT_FALSE(task.hasFinished(N));
+            task.compute(N);
+            EXPECT_TRUE(task.hasFinished(N));
+            EXPECT_FALSE(task.isEndOfStream());
+
+            compareChannelWithVector(oracleValues, indexOracle, out, N);
+
+            indexOracle = (indexOracle + N) % 100000;
+        }
+    }
+
+    TEST(FileSourceTest, testMappedBinaryDouble) {
+        std::string filename = std::string(ORACLE_DATA_DIR) + "/oracle_file_source_double.bin";
+        const std::int64_t N = 768;
+
+        // Load oracle values
+        std::vector<double> oracleValues = loadValuesFromBinaryFile<double>(filename);
+
+        // Create the task with huge pages, the window size doesn't divide the file
+        FileSource task(filename, FileSource::FileFormat::BinaryDouble, FileSource::Access::Mapped, true, true);
+        Channel &out = task.getOutput(0);
+
+        std::vector<double> expected(N);
+        std::size_t indexOracle = 0;
+        for (std::size_t i = 0; i < 500; ++i) {
+            task.compute(N);
+
+            for (std::int64_t j = 0; j < N; ++j) {
+                expected[j] = oracleValues[(indexOracle + j) % oracleValues.size()];
+            }
+            compareChannelWithVector(expected, 0, out, N);
+
+            indexOracle = (indexOracle + N) % oracleValues.size();
+        }
+    }
+
+    TEST(FileSourceTest, testMappedBinaryComplex) {
+        std::string filename = std::string(ORACLE_DATA_DIR) + "/oracle_file_source_complex.bin";
+        const std::int64_t N = 1000;
+
+        // Load oracle values
+        std::vector< std::complex<double> > oracleValues = loadValuesFromBinaryFile< std::complex<double> >(filename);
+
+        // Create the task
+        FileSource task(filename, FileSource::FileFormat::BinaryComplex, FileSource::Access::Mapped);
+        Channel &out = task.getOutput(0);
+
+        std::size_t indexOracle = 0;
+        for (std::size_t i = 0; i < 2000; ++i) {
+            task.compute(N);
+            compareChannelWithVector(oracleValues, indexOracle, out, N);
+
+            indexOracle = (indexOracle + N) % 100000;
+        }
+    }
+
+    TEST(FileSourceTest, testEndOfStream) {
+        const std::string filename = "/tmp/dsps_test_file_source.bin";
+        const std::uint64_t N = 4;
+
+        // 10 values: two complete windows and an incomplete one
+        std::vector<double> values(10);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<double>(i) * 0.5;
+        }
+        {
+            std::ofstream file(filename, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+        }
+
+        for (FileSource::Access access: {FileSource::Access::Stream, FileSource::Access::Mapped}) {
+            FileSource task(filename, FileSource::FileFormat::BinaryDouble, access, false);
+            Channel &out = task.getOutput(0);
+
+            for (std::size_t i = 0; i < 2; ++i) {
+                EXPECT_TRUE(task.isReady(N));
+                task.compute(N);
+                compareChannelWithVector(values, i * N, out, N);
+            }
+
+            // The incomplete window isn't sent
+            task.compute(N);
+            EXPECT_TRUE(task.isEndOfStream());
+            EXPECT_FALSE(task.isReady(N));
+            EXPECT_EQ(0u, out.size(sizeof(double)));
+
+            // Nothing more after the end of stream
+            task.compute(N);
+            EXPECT_EQ(0u, out.size(sizeof(double)));
+        }
+
+        // The end of stream is signaled with the last complete window
+        FileSource task(filename, FileSource::FileFormat::BinaryDouble, FileSource::Access::Mapped, false);
+        task.compute(10);
+        EXPECT_TRUE(task.isEndOfStream());
+        EXPECT_EQ(10u, task.getOutput(0).size(sizeof(double)));
+    }
+
+    TEST(FileSourceTest, testProcessingEndOfStream) {
+        const std::string filename = "/tmp/dsps_test_file_source_processing.bin";
+        const std::uint64_t N = 4;
+
+        // 10 values: two complete windows and an incomplete one
+        std::vector<double> values(10);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<double>(i) * 0.5;
+        }
+        {
+            std::ofstream file(filename, std::ios::binary);
+            file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+        }
+
+        // The mean never finishes, the processing ends with the stream
+        for (bool parallel: {false, true}) {
+            FileSource source(filename, FileSource::FileFormat::BinaryDouble, FileSource::Access::Stream, false);
+            Mean<double> mean(100);
+            Task::connect(source, mean);
+
+            if (parallel) {
+                DSP::ParallelProcessor processor(2);
+                processor.processing({ &source }, { &mean }, N);
+            }
+            else {
+                DSP::processing({ &source }, { &mean }, N);
+            }
+
+            EXPECT_TRUE(source.isEndOfStream());
+            EXPECT_FALSE(mean.hasFinished(N));
+            EXPECT_EQ(2u, mean.getNumberOfMean());
+
+            std::vector<double> means;
+            mean.getMean(means);
+            ASSERT_EQ(N, means.size());
+            for (std::size_t i = 0; i < N; ++i) {
+                expect_eq_double((values[i] + values[N + i]) / 2.0, means[i], 0.0);
+            }
+        }
+    }
+
+    TEST(FileSourceTest, testReadAhead) {
+        std::string filename = std::string(ORACLE_DATA_DIR) + "/oracle_file_source_double.bin";
+        const std::int64_t N = 1000;
+
+        // Load oracle values
+        std::vector<double> oracleValues = loadValuesFromBinaryFile<double>(filename);
+
+        // Small blocks to cross many of them by window
+        FileSource task(filename, FileSource::FileFormat::BinaryDouble);
+        task.enableReadAhead(3, 3000);
+        ASSERT_NE(nullptr, task.getReadAhead());
+        EXPECT_EQ(3u, task.getReadAhead()->getDepth());
+        Channel &out = task.getOutput(0);
+
+        std::size_t indexOracle = 0;
+        for (std::size_t i = 0; i < 300; ++i) {
+            task.compute(N);
+            compareChannelWithVector(oracleValues, indexOracle, out, N);
+
+            indexOracle = (indexOracle + N) % 100000;
+        }
+
+        // The plain values are parsed from the blocks
+        filename = std::string(ORACLE_DATA_DIR) + "/oracle_file_source_integer.txt";
+        std::vector<std::int64_t> plainValues = loadValuesFromPlainFile<std::int64_t>(filename);
+        FileSource plainTask(filename, FileSource::FileFormat::PlainInteger, FileSource::Access::Stream, false);
+        plainTask.enableReadAhead(2, 4096);
+        Channel &plainOut = plainTask.getOutput(0);
+
+        for (std::size_t i = 0; i < plainValues.size() / N; ++i) {
+            plainTask.compute(N);
+            compareChannelWithVector(plainValues, i * N, plainOut, N);
+        }
+        plainTask.compute(N);
+        EXPECT_TRUE(plainTask.isEndOfStream());
+    }
+
+    TEST(FileSourceTest, testConvertToBinary) {
+        const std::string binaryFilename = "/tmp/dsps_test_file_source_converted.bin";
+
+        // Integers
+        std::string filename = std::string(ORACLE_DATA_DIR) + "/oracle_file_source_integer.txt";
+        std::vector<std::int64_t> integerValues = loadValuesFromPlainFile<std::int64_t>(filename);
+        EXPECT_EQ(integerValues.size(), FileSource::convertToBinary(filename, FileSource::FileFormat::PlainInteger, binaryFilename));
+        EXPECT_EQ(integerValues, loadValuesFromBinaryFile<std::int64_t>(binaryFilename));
+
+        // Doubles, the values are identical to operator>>
+        filename = std::string(ORACLE_DATA_DIR) + "/oracle_file_source_double.txt";
+        std::vector<double> doubleValues = loadValuesFromPlainFile<double>(filename);
+        EXPECT_EQ(doubleValues.size(), FileSource::convertToBinary(filename, FileSource::FileFormat::PlainDouble, binaryFilename));
+
+        FileSource task(binaryFilename, FileSource::FileFormat::BinaryDouble, FileSource::Access::Mapped, false);
+        Channel &out = task.getOutput(0);
+        const std::size_t N = 1000;
+        for (std::size_t i = 0; i < doubleValues.size() / N; ++i) {
+            task.compute(N);
+            compareChannelWithVector(doubleValues, i * N, out, N);
+        }
+        EXPECT_TRUE(task.isEndOfStream());
+    }
 }
 
 int main(int argc, char *argv[]) {
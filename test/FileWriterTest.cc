@@ -0,0 +1,118 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/FileWriter.h>
+
+namespace {
+    const std::string Filename = "/tmp/dsps_test_file_writer.bin";
+
+    std::vector<char> readFile() {
+        std::ifstream file(Filename, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::vector<char> createData(std::size_t size) {
+        std::vector<char> data(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(i * 31 + i / 4096);
+        }
+
+        return data;
+    }
+
+    TEST(FileWriterTest, testSynchronous) {
+        std::vector<char> data = createData(10000);
+
+        FileWriter writer(Filename);
+        EXPECT_FALSE(writer.isDirect());
+        writer.append(data.data(), 3000);
+        writer.append(data.data() + 3000, 7000);
+
+        // Each append is in the file at once
+        EXPECT_EQ(data, readFile());
+        EXPECT_EQ(10000u, writer.countWrittenBytes());
+        EXPECT_EQ(0u, writer.getQueueDepth());
+    }
+
+    void checkBuffered(bool directIO, bool syncData) {
+        std::vector<char> data = createData(1000000);
+
+        {
+            // The buffer size is rounded to the alignment
+            FileWriter writer(Filename, 10000, 2, directIO, syncData);
+            for (std::size_t done = 0; done < data.size(); done += 777) {
+                writer.append(data.data() + done, std::min<std::size_t>(777, data.size() - done));
+
+                // A flush in the middle of a buffer
+                if (done == 777 * 500) {
+                    writer.flush();
+                    std::vector<char> content = readFile();
+                    ASSERT_EQ(done + 777, content.size());
+                    EXPECT_TRUE(std::equal(content.begin(), content.end(), data.begin()));
+                }
+            }
+
+            EXPECT_LE(writer.getMaxQueueDepth(), 2u);
+
+            // The flushed bytes are counted once
+            writer.flush();
+            EXPECT_EQ(data.size(), writer.countWrittenBytes());
+        }
+
+        // The destructor writes the last buffer
+        EXPECT_EQ(data, readFile());
+    }
+
+    TEST(FileWriterTest, testBuffered) {
+        checkBuffered(false, false);
+    }
+
+    TEST(FileWriterTest, testDirect) {
+        // The file system may refuse O_DIRECT, the content is the same
+        checkBuffered(true, false);
+        checkBuffered(true, true);
+    }
+
+    TEST(FileWriterTest, testOverwrite) {
+        std::vector<char> data = createData(50000);
+
+        FileWriter writer(Filename, 8192, 2, true);
+        writer.append(data.data(), 50000);
+
+        // The pending data are written before, then replaced
+        writer.overwrite(data.data() + 100, 20000);
+        EXPECT_EQ(std::vector<char>(data.begin() + 100, data.begin() + 20100), readFile());
+
+        writer.overwrite(data.data(), 4096);
+        EXPECT_EQ(std::vector<char>(data.begin(), data.begin() + 4096), readFile());
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
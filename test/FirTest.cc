@@ -74,6 +74,92 @@ namespace {
         }
     }
 
+    template<typename T>
+    void checkOverlapSave(const std::uint64_t NFir, const std::uint64_t D, const double precision, const std::uint64_t N = 512) {
+
+        // Random filter
+        std::mt19937 engine = createRandomEngine();
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        const std::string coeffPath = "/tmp/dsps_fir_overlap_save.txt";
+        {
+            std::ofstream file(coeffPath);
+            file.precision(17);
+            for (std::size_t i = 0; i < NFir; ++i) {
+                file << dist(engine) / NFir << std::endl;
+            }
+        }
+
+        Fir<T> direct(coeffPath, D, 0, Fir<T>::Method::Direct);
+        Fir<T> overlapSave(coeffPath, D, 0, Fir<T>::Method::OverlapSave);
+        EXPECT_FALSE(direct.usesOverlapSave());
+        EXPECT_TRUE(overlapSave.usesOverlapSave());
+
+        Channel inDirect;
+        Channel inOverlapSave;
+        direct.setInput(inDirect, 0);
+        overlapSave.setInput(inOverlapSave, 0);
+
+        // Send the history then some windows
+        std::vector<T> values(NFir);
+        for (std::size_t i = 0; i < 5; ++i) {
+            values.resize(values.size() + N * D);
+            for (T &value: values) {
+                value = dist(engine);
+            }
+            inDirect.send(values);
+            inOverlapSave.send(values);
+            values.clear();
+
+            EXPECT_TRUE(overlapSave.isReady(N));
+            direct.compute(N);
+            overlapSave.compute(N);
+            EXPECT_FALSE(overlapSave.isReady(N));
+        }
+
+        std::vector<T> expected;
+        std::vector<T> actual;
+        direct.getOutput(0).receive(expected, 5 * N);
+        overlapSave.getOutput(0).receive(actual, 5 * N);
+        for (std::size_t i = 0; i < 5 * N; ++i) {
+            expect_eq_double(expected[i], actual[i], precision);
+        }
+    }
+
+    TEST(FirTest, testOverlapSaveDouble) {
+        checkOverlapSave<double>(1000, 1, 1e-12);
+        checkOverlapSave<double>(2100, 10, 1e-12);
+        checkOverlapSave<double>(77, 3, 1e-12);
+
+        // The blocks of 250 samples are aligned by some zeros before the stream
+        checkOverlapSave<double>(1001, 1, 1e-12, 1000);
+    }
+
+    TEST(FirTest, testOverlapSaveFloat) {
+        checkOverlapSave<float>(1000, 1, 1e-5);
+        checkOverlapSave<float>(2100, 10, 1e-5);
+    }
+
+    TEST(FirTest, testOverlapSaveBlockSize) {
+        EXPECT_EQ(static_cast<std::uint64_t>(256), OverlapSave<double>::defaultBlockSize(1000));
+
+        // A divisor of the chunks near the power of two
+        EXPECT_EQ(static_cast<std::uint64_t>(256), OverlapSave<double>::defaultBlockSize(1000, 1536));
+        EXPECT_EQ(static_cast<std::uint64_t>(250), OverlapSave<double>::defaultBlockSize(1000, 1000));
+        EXPECT_EQ(static_cast<std::uint64_t>(225), OverlapSave<double>::defaultBlockSize(1000, 900));
+
+        // No divisor in the range
+        EXPECT_EQ(static_cast<std::uint64_t>(256), OverlapSave<double>::defaultBlockSize(1000, 1009));
+    }
+
+    TEST(FirTest, testOverlapSaveCrossover) {
+        // 128 taps with a decimation of 10 is under the crossover
+        Fir<double> small(std::string(ORACLE_DATA_DIR) + "/kaiser128_40", 10);
+        EXPECT_FALSE(small.usesOverlapSave());
+
+        Fir<double> large(std::string(ORACLE_DATA_DIR) + "/kaiser128_40", 1);
+        EXPECT_TRUE(large.usesOverlapSave());
+    }
+
     TEST(FirTest, testComputeDecim100) {
         static constexpr unsigned N = 2048;
         static constexpr unsigned NFir = 128;
@@ -0,0 +1,164 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Abs.h>
+#include <dsps/Channel.h>
+#include <dsps/ConvertType.h>
+#include <dsps/Fusion.h>
+#include <dsps/Gain.h>
+#include <dsps/Shifter.h>
+
+#include "local/Utils.h"
+
+namespace {
+    // Source of uniform values, the same seed gives the same stream
+    class RandomSource: public Task {
+    public:
+        RandomSource(const unsigned seed)
+        : Task(ChannelType::None, 0, ChannelType::Double, 1)
+        , m_engine(seed)
+        , m_dist(-1.0, 1.0) {
+
+        }
+
+        virtual void compute(const std::uint64_t N) override {
+            std::vector<double> values(N);
+            for (double &value: values) {
+                value = m_dist(m_engine);
+            }
+            m_outputChannels[0].send(values);
+        }
+
+        virtual bool isReady(const std::uint64_t N) const override {
+            USELESS_PARAMETER(N);
+            return true;
+        }
+
+        virtual bool hasFinished(const std::uint64_t N) const override {
+            USELESS_PARAMETER(N);
+            return true;
+        }
+
+    private:
+        std::mt19937 m_engine;
+        std::uniform_real_distribution<double> m_dist;
+    };
+
+    // Source -> Gain -> Abs -> ConvertType -> Shifter
+    struct Chain {
+        Chain()
+        : sourceTask(42)
+        , gainTask(0.8)
+        , convertTask(16, 1.0)
+        , shifterTask(3) {
+            Task::connect(sourceTask, gainTask);
+            Task::connect(gainTask, absTask);
+            Task::connect(absTask, convertTask);
+            Task::connect(convertTask, shifterTask);
+        }
+
+        RandomSource sourceTask;
+        Gain<double> gainTask;
+        Abs<double, double> absTask;
+        ConvertType<double, std::int64_t> convertTask;
+        Shifter<std::int64_t> shifterTask;
+    };
+
+    TEST(FusionTest, testChainFused) {
+        static constexpr unsigned N = 1000;
+
+        Chain chain;
+        DSP::Fusion fusion({ &chain.sourceTask }, { &chain.shifterTask });
+
+        // One fused task after the source
+        ASSERT_EQ(static_cast<std::size_t>(1), fusion.countFusedTasks());
+        ASSERT_EQ(static_cast<std::size_t>(2), fusion.getLinearisation().size());
+        EXPECT_EQ(&chain.sourceTask, fusion.getLinearisation().front());
+        EXPECT_EQ(nullptr, fusion.getFusedTask(&chain.sourceTask));
+
+        const FusedTask *fusedTask = fusion.getFusedTask(&chain.gainTask);
+        ASSERT_NE(nullptr, fusedTask);
+        EXPECT_EQ(fusedTask, fusion.getLinearisation().back());
+        std::vector<Task*> expected = { &chain.gainTask, &chain.absTask, &chain.convertTask, &chain.shifterTask };
+        EXPECT_EQ(expected, fusedTask->getChain());
+
+        // The DAG isn't modified
+        EXPECT_EQ(&chain.gainTask, chain.sourceTask.getOutput(0).getOut());
+        EXPECT_EQ(&chain.sourceTask.getOutput(0), chain.gainTask.getInput(0));
+        EXPECT_EQ(&chain.absTask.getOutput(0), chain.convertTask.getInput(0));
+
+        fusion.processing(N);
+        EXPECT_EQ(static_cast<std::size_t>(0), chain.gainTask.getOutput(0).size(sizeof(double)));
+        EXPECT_EQ(static_cast<std::size_t>(N), chain.shifterTask.getOutput(0).size(sizeof(std::int64_t)));
+    }
+
+    TEST(FusionTest, testSameAsProcessing) {
+        static constexpr unsigned N = 1000;
+
+        Chain fused;
+        Chain reference;
+        DSP::Fusion fusion({ &fused.sourceTask }, { &fused.shifterTask });
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            fusion.processing(N);
+            DSP::processing({ &reference.sourceTask }, { &reference.shifterTask }, N);
+        }
+
+        std::vector<std::int64_t> expected;
+        std::vector<std::int64_t> actual;
+        reference.shifterTask.getOutput(0).receive(expected, 5 * N);
+        fused.shifterTask.getOutput(0).receive(actual, 5 * N);
+        EXPECT_EQ(expected, actual);
+    }
+
+    TEST(FusionTest, testOutputTaskEndsChain) {
+        Chain chain;
+        DSP::Fusion fusion({ &chain.sourceTask }, { &chain.absTask, &chain.shifterTask });
+
+        // Gain -> Abs and ConvertType -> Shifter
+        ASSERT_EQ(static_cast<std::size_t>(2), fusion.countFusedTasks());
+        EXPECT_EQ(static_cast<std::size_t>(3), fusion.getLinearisation().size());
+        EXPECT_EQ(fusion.getFusedTask(&chain.gainTask), fusion.getFusedTask(&chain.absTask));
+        EXPECT_EQ(fusion.getFusedTask(&chain.convertTask), fusion.getFusedTask(&chain.shifterTask));
+        EXPECT_NE(fusion.getFusedTask(&chain.absTask), fusion.getFusedTask(&chain.convertTask));
+
+        // The second chain reads the output of Abs
+        const FusedTask *fusedTask = fusion.getFusedTask(&chain.convertTask);
+        ASSERT_NE(nullptr, fusedTask);
+        EXPECT_EQ(&chain.absTask.getOutput(0), fusedTask->getInput(0));
+    }
+
+    TEST(FusionTest, testSingleTaskNotFused) {
+        RandomSource sourceTask(1);
+        Gain<double> gainTask(2.0);
+        Task::connect(sourceTask, gainTask);
+
+        DSP::Fusion fusion({ &sourceTask }, { &gainTask });
+        EXPECT_EQ(static_cast<std::size_t>(0), fusion.countFusedTasks());
+        EXPECT_EQ(static_cast<std::size_t>(2), fusion.getLinearisation().size());
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    return RUN_ALL_TESTS();
+}
@@ -135,6 +135,44 @@ namespace {
             EXPECT_EQ(VALUE, values[i]);
         }
     }
+
+    TEST(MeanTest, testPublishPeriod) {
+        static constexpr unsigned N = 16;
+
+        // Alloc the task
+        Mean<double> task(2, 2);
+        Channel in;
+        Channel &out = task.getOutput(0);
+        task.setInput(in, 0);
+
+        // The first mean is sent at the limit order, then every period
+        static constexpr std::size_t EXPECTED_MEANS[] = { 0, 1, 1, 2, 2 };
+        for (std::size_t i = 0; i < 5; ++i) {
+            loadChannel<double>(in, static_cast<double>(i), N);
+            task.compute(N);
+            EXPECT_EQ(EXPECTED_MEANS[i] * N, out.size(sizeof(double)));
+        }
+
+        // The pending means are kept in order
+        std::vector<double> values(N);
+        out.receive(values, N);
+        for (std::size_t i = 0; i < N; ++i) {
+            EXPECT_EQ(0.5, values[i]);
+        }
+
+        out.receive(values, N);
+        for (std::size_t i = 0; i < N; ++i) {
+            EXPECT_EQ(1.5, values[i]);
+        }
+
+        // The latest mean is available on demand
+        task.getMean(values);
+        ASSERT_EQ(N, values.size());
+        for (std::size_t i = 0; i < N; ++i) {
+            EXPECT_EQ(2.0, values[i]);
+        }
+        EXPECT_EQ(0u, out.size(sizeof(double)));
+    }
 }
 
 int main(int argc, char *argv[]) {
@@ -0,0 +1,138 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <complex>
+#include <memory>
+#include <random>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Channel.h>
+#include <dsps/Fft.h>
+#include <dsps/MultiChannelFft.h>
+
+#include "local/Utils.h"
+
+namespace {
+    static constexpr std::size_t K = 4;
+
+    template<typename T>
+    std::vector< std::vector<T> > randomSignals(const std::size_t N) {
+        std::mt19937 engine(3);
+        std::uniform_real_distribution<T> dist(-1.0, 1.0);
+
+        std::vector< std::vector<T> > signals(K, std::vector<T>(N));
+        for (auto &signal: signals) {
+            for (auto &value: signal) {
+                value = dist(engine);
+            }
+        }
+
+        return signals;
+    }
+
+    // Spectra computed by one Fft task by channel
+    template<typename T>
+    std::vector< std::vector< std::complex<T> > > referenceSpectra(const std::vector< std::vector<T> > &signals, const std::size_t N) {
+        std::vector< std::vector< std::complex<T> > > spectra(K);
+        for (std::size_t k = 0; k < K; ++k) {
+            Fft<T> task;
+            Channel in;
+            task.setInput(in, 0);
+            in.send(signals[k]);
+            task.compute(N);
+            task.getOutput(0).receive(spectra[k], N);
+        }
+
+        return spectra;
+    }
+
+    TEST(MultiChannelFftTest, testComputeSeparate) {
+        static constexpr std::size_t N = 256;
+
+        MultiChannelFft<double> task(K);
+        ASSERT_EQ(K, task.countNextTask());
+
+        std::vector<Channel> in(K);
+        for (std::size_t k = 0; k < K; ++k) {
+            task.setInput(in[k], k);
+        }
+
+        const auto signals = randomSignals<double>(N);
+        const auto expected = referenceSpectra(signals, N);
+
+        // All the channels must be ready
+        for (std::size_t k = 0; k < K - 1; ++k) {
+            in[k].send(signals[k]);
+        }
+        EXPECT_FALSE(task.isReady(N));
+        in[K - 1].send(signals[K - 1]);
+        EXPECT_TRUE(task.isReady(N));
+        EXPECT_FALSE(task.hasFinished(N));
+
+        task.compute(N);
+        EXPECT_FALSE(task.isReady(N));
+        EXPECT_TRUE(task.hasFinished(N));
+        EXPECT_EQ(N, task.getOutputRate(0, N));
+
+        for (std::size_t k = 0; k < K; ++k) {
+            std::vector< std::complex<double> > actual;
+            task.getOutput(k).receive(actual, N);
+            ASSERT_EQ(expected[k].size(), actual.size());
+            for (std::size_t j = 0; j < N; ++j) {
+                expect_eq_double(expected[k][j].real(), actual[j].real());
+                expect_eq_double(expected[k][j].imag(), actual[j].imag());
+            }
+        }
+    }
+
+    TEST(MultiChannelFftTest, testComputeInterleaved) {
+        static constexpr std::size_t N = 128;
+
+        MultiChannelFft<float> task(K, MultiChannelFft<float>::Layout::Interleaved);
+        ASSERT_EQ(static_cast<std::size_t>(1), task.countNextTask());
+        EXPECT_EQ(N * K, task.getOutputRate(0, N));
+
+        std::vector<Channel> in(K);
+        const auto signals = randomSignals<float>(N);
+        for (std::size_t k = 0; k < K; ++k) {
+            task.setInput(in[k], k);
+            in[k].send(signals[k]);
+        }
+        const auto expected = referenceSpectra(signals, N);
+
+        task.compute(N);
+        EXPECT_TRUE(task.hasFinished(N));
+
+        std::vector< std::complex<float> > actual;
+        task.getOutput(0).receive(actual, N * K);
+        for (std::size_t j = 0; j < N; ++j) {
+            for (std::size_t k = 0; k < K; ++k) {
+                expect_eq_double(expected[k][j].real(), actual[j * K + k].real(), 1e-4);
+                expect_eq_double(expected[k][j].imag(), actual[j * K + k].imag(), 1e-4);
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,131 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Atan2.h>
+#include <dsps/Channel.h>
+#include <dsps/Demodulation.h>
+#include <dsps/Fir.h>
+#include <dsps/ParallelProcessor.h>
+#include <dsps/SignalGenerator.h>
+#include <dsps/Unwrap.h>
+#include <dsps/Utils.h>
+
+#include "local/Utils.h"
+
+namespace {
+    struct PhaseChain {
+        static constexpr double FS = 250e6;
+        static constexpr double FC = 10e6;
+        static constexpr unsigned D = 10;
+
+        PhaseChain()
+        : signalTask(1.0, FC * 1.0001, FS)
+        , demodulationTask(FC, FS, M_PI/7.0)
+        , firITask(std::string(ORACLE_DATA_DIR) + "/kaiser128_40", D)
+        , firQTask(std::string(ORACLE_DATA_DIR) + "/kaiser128_40", D) {
+            Task::connect(signalTask, demodulationTask);
+            Task::connect(demodulationTask, 0, firITask, 0);
+            Task::connect(demodulationTask, 1, firQTask, 0);
+            atan2Task.connectIChannel(firITask);
+            atan2Task.connectQChannel(firQTask);
+            Task::connect(atan2Task, unwrapTask);
+        }
+
+        SignalGenerator signalTask;
+        Demodulation demodulationTask;
+        Fir<double> firITask;
+        Fir<double> firQTask;
+        Atan2 atan2Task;
+        Unwrap unwrapTask;
+    };
+
+    TEST(ParallelProcessorTest, testCountThreads) {
+        DSP::ParallelProcessor processor4(4);
+        EXPECT_EQ(static_cast<std::size_t>(4), processor4.countThreads());
+
+        DSP::ParallelProcessor processorAuto;
+        EXPECT_LE(static_cast<std::size_t>(1), processorAuto.countThreads());
+    }
+
+    TEST(ParallelProcessorTest, testProcessingSameAsSequential) {
+        static constexpr unsigned N = 1024;
+
+        PhaseChain sequential;
+        PhaseChain parallel;
+        DSP::ParallelProcessor processor(4);
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            DSP::processing({ &sequential.signalTask }, { &sequential.unwrapTask }, N);
+            processor.processing({ &parallel.signalTask }, { &parallel.unwrapTask }, N);
+            EXPECT_TRUE(parallel.unwrapTask.hasFinished(N));
+        }
+
+        // The channels use their queue again after the processing
+        EXPECT_EQ(static_cast<std::size_t>(0), parallel.demodulationTask.getOutput(0).getRingCapacity());
+        EXPECT_EQ(static_cast<std::size_t>(0), parallel.unwrapTask.getOutput(0).getRingCapacity());
+
+        // The parallel processing can compute some windows in advance
+        Channel &sequentialOut = sequential.unwrapTask.getOutput(0);
+        Channel &parallelOut = parallel.unwrapTask.getOutput(0);
+        const std::size_t LIMIT = sequentialOut.size(sizeof(double));
+        ASSERT_LE(static_cast<std::size_t>(N), LIMIT);
+        ASSERT_LE(LIMIT, parallelOut.size(sizeof(double)));
+
+        std::vector<double> expected;
+        std::vector<double> actual;
+        sequentialOut.receive(expected, LIMIT);
+        parallelOut.receive(actual, LIMIT);
+
+        for (std::size_t i = 0; i < LIMIT; ++i) {
+            EXPECT_EQ(expected[i], actual[i]);
+        }
+    }
+
+    TEST(ParallelProcessorTest, testProcessingOneThread) {
+        static constexpr unsigned N = 512;
+
+        PhaseChain sequential;
+        PhaseChain parallel;
+        DSP::ParallelProcessor processor(1, 1);
+
+        DSP::processing({ &sequential.signalTask }, { &sequential.unwrapTask }, N);
+        processor.processing({ &parallel.signalTask }, { &parallel.unwrapTask }, N);
+
+        Channel &parallelOut = parallel.unwrapTask.getOutput(0);
+        ASSERT_LE(static_cast<std::size_t>(N), parallelOut.size(sizeof(double)));
+
+        std::vector<double> actual;
+        parallelOut.receive(actual, N);
+        std::vector<double> expected;
+        sequential.unwrapTask.getOutput(0).receive(expected, N);
+
+        for (std::size_t i = 0; i < N; ++i) {
+            EXPECT_EQ(expected[i], actual[i]);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,116 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <fstream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Channel.h>
+#include <dsps/Fir.h>
+#include <dsps/PolyphaseDecimator.h>
+
+#include "local/Utils.h"
+
+namespace {
+    template<typename T, typename Distribution>
+    void checkSameAsFir(const std::uint64_t NFir, const std::uint64_t D, Distribution dist, const double precision, const int64_t maxNOB = 0) {
+        static constexpr unsigned N = 256;
+
+        // Random filter
+        std::mt19937 engine = createRandomEngine();
+        const std::string coeffPath = "/tmp/dsps_polyphase_decimator.txt";
+        {
+            std::ofstream file(coeffPath);
+            file.precision(17);
+            for (std::size_t i = 0; i < NFir; ++i) {
+                file << dist(engine) << std::endl;
+            }
+        }
+
+        Fir<T> fir(coeffPath, D, maxNOB, Fir<T>::Method::Direct);
+        PolyphaseDecimator<T> polyphase(coeffPath, D, maxNOB);
+        EXPECT_EQ(N * D, polyphase.getInputRate(0, N));
+        EXPECT_EQ(NFir, polyphase.getInputDelay(0, N));
+
+        Channel inFir;
+        Channel inPolyphase;
+        fir.setInput(inFir, 0);
+        polyphase.setInput(inPolyphase, 0);
+
+        // Send the history then some windows
+        std::vector<T> values(NFir);
+        for (std::size_t i = 0; i < 6; ++i) {
+            values.resize(values.size() + N * D);
+            for (T &value: values) {
+                value = dist(engine);
+            }
+            inFir.send(values);
+            inPolyphase.send(values);
+            values.clear();
+
+            EXPECT_TRUE(polyphase.isReady(N));
+            EXPECT_EQ(i != 0, polyphase.hasFinished(N));
+            fir.compute(N);
+            polyphase.compute(N);
+            EXPECT_FALSE(polyphase.isReady(N));
+            EXPECT_TRUE(polyphase.hasFinished(N));
+        }
+
+        std::vector<T> expected;
+        std::vector<T> actual;
+        fir.getOutput(0).receive(expected, 6 * N);
+        polyphase.getOutput(0).receive(actual, 6 * N);
+        for (std::size_t i = 0; i < 6 * N; ++i) {
+            expect_eq_double(expected[i], actual[i], precision);
+        }
+    }
+
+    TEST(PolyphaseDecimatorTest, testSameAsFirDouble) {
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        checkSameAsFir<double>(128, 10, dist, 1e-12);
+        checkSameAsFir<double>(77, 3, dist, 1e-12);
+        checkSameAsFir<double>(50, 1, dist, 1e-12);
+        checkSameAsFir<double>(5, 8, dist, 1e-12);
+    }
+
+    TEST(PolyphaseDecimatorTest, testSameAsFirFloat) {
+        std::uniform_real_distribution<float> dist(-1.0, 1.0);
+        checkSameAsFir<float>(128, 10, dist, 1e-4);
+    }
+
+    TEST(PolyphaseDecimatorTest, testSameAsFirInt64) {
+        // The integer sums are exact
+        std::uniform_int_distribution<std::int64_t> dist(-1000, 1000);
+        checkSameAsFir<std::int64_t>(128, 10, dist, 0.0);
+        checkSameAsFir<std::int64_t>(33, 4, dist, 0.0);
+    }
+
+    TEST(PolyphaseDecimatorTest, testSameAsFirInt64MaxNOB) {
+        // The outputs wrap on 12 bits like Fir
+        std::uniform_int_distribution<std::int64_t> dist(-1000, 1000);
+        checkSameAsFir<std::int64_t>(128, 10, dist, 0.0, 12);
+        checkSameAsFir<std::int64_t>(33, 4, dist, 0.0, 12);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    return RUN_ALL_TESTS();
+}
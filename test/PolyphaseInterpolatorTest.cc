@@ -0,0 +1,97 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <fstream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Channel.h>
+#include <dsps/PolyphaseInterpolator.h>
+
+#include "local/Utils.h"
+
+namespace {
+    void checkSameAsZeroStuffing(const std::uint64_t NFir, const std::uint64_t I) {
+        static constexpr unsigned N = 240;
+        static constexpr unsigned NumberWindows = 5;
+
+        // Random filter
+        std::mt19937 engine = createRandomEngine();
+        std::vector<double> coeffs(NFir);
+        computeUniformFloatVector<double>(engine, coeffs, -1.0, 1.0);
+
+        const std::string coeffPath = "/tmp/dsps_polyphase_interpolator.txt";
+        {
+            std::ofstream file(coeffPath);
+            file.precision(17);
+            for (double coeff: coeffs) {
+                file << coeff << std::endl;
+            }
+        }
+
+        PolyphaseInterpolator<double> task(coeffPath, I);
+        EXPECT_EQ(N / I, task.getInputRate(0, N));
+
+        Channel in;
+        task.setInput(in, 0);
+
+        std::vector<double> input(NumberWindows * N / I);
+        computeUniformFloatVector<double>(engine, input, -1.0, 1.0);
+
+        // Send the windows one by one
+        for (std::size_t i = 0; i < NumberWindows; ++i) {
+            std::vector<double> values(input.begin() + i * N / I, input.begin() + (i + 1) * N / I);
+            EXPECT_FALSE(task.isReady(N));
+            in.send(values);
+            EXPECT_TRUE(task.isReady(N));
+            task.compute(N);
+            EXPECT_FALSE(task.isReady(N));
+        }
+        EXPECT_TRUE(task.hasFinished(N));
+
+        // Convolution of the zero stuffed signal
+        std::vector<double> stuffed(NumberWindows * N, 0.0);
+        for (std::size_t m = 0; m < input.size(); ++m) {
+            stuffed[m * I] = input[m];
+        }
+
+        std::vector<double> actual;
+        task.getOutput(0).receive(actual, NumberWindows * N);
+        for (std::size_t n = 0; n < stuffed.size(); ++n) {
+            double expected = 0.0;
+            for (std::size_t k = 0; k < NFir && k <= n; ++k) {
+                expected += coeffs[k] * stuffed[n - k];
+            }
+            expect_eq_double(expected, actual[n], 1e-12);
+        }
+    }
+
+    TEST(PolyphaseInterpolatorTest, testSameAsZeroStuffing) {
+        checkSameAsZeroStuffing(128, 8);
+        checkSameAsZeroStuffing(77, 3);
+        checkSameAsZeroStuffing(33, 1);
+        checkSameAsZeroStuffing(5, 6);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    return RUN_ALL_TESTS();
+}
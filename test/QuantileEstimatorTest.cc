@@ -0,0 +1,64 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <random>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/QuantileEstimator.h>
+
+namespace {
+    TEST(QuantileEstimatorTest, testFirstValues) {
+        QuantileEstimator median;
+        EXPECT_EQ(0.0, median.get());
+
+        // Nearest rank of the values before the markers are set
+        const double values[] = { 4.0, 1.0, 3.0, 2.0 };
+        const double expected[] = { 4.0, 4.0, 3.0, 3.0 };
+        for (std::size_t i = 0; i < 4; ++i) {
+            median.add(values[i]);
+            EXPECT_EQ(i + 1, median.count());
+            EXPECT_EQ(expected[i], median.get());
+        }
+
+        median.clear();
+        EXPECT_EQ(0u, median.count());
+        EXPECT_EQ(0.0, median.get());
+    }
+
+    TEST(QuantileEstimatorTest, testUniform) {
+        std::mt19937 engine(42);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+        for (double quantile: { 0.05, 0.5, 0.95 }) {
+            QuantileEstimator estimator(quantile);
+            for (std::size_t i = 0; i < 100000; ++i) {
+                estimator.add(dist(engine));
+            }
+            EXPECT_NEAR(quantile, estimator.get(), 0.01);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
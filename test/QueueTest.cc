@@ -197,6 +197,122 @@ namespace {
     }
 }
 
+namespace {
+    TEST(QueueTest, testReserveCapacity) {
+        static constexpr std::size_t Burst = 2048 * sizeof(double);
+        std::vector<std::uint8_t> buffer(20 * Burst);
+
+        // Without reserve, the queue grows then shrinks
+        Queue queue;
+        queue.push(buffer.data(), buffer.size());
+        queue.pop(buffer.data(), buffer.size());
+        EXPECT_LT(static_cast<std::uint64_t>(0), queue.countGrow());
+        EXPECT_LT(static_cast<std::uint64_t>(0), queue.countShrink());
+
+        // With reserve, no reallocation is needed
+        Queue reserved;
+        reserved.reserve(buffer.size());
+        EXPECT_LE(buffer.size(), reserved.capacity());
+        for (std::size_t i = 0; i < 10; ++i) {
+            reserved.push(buffer.data(), buffer.size());
+            reserved.pop(buffer.data(), buffer.size() - Burst);
+            reserved.pop(buffer.data(), Burst);
+        }
+        EXPECT_EQ(static_cast<std::uint64_t>(0), reserved.countGrow());
+        EXPECT_EQ(static_cast<std::uint64_t>(0), reserved.countShrink());
+        EXPECT_LE(buffer.size(), reserved.capacity());
+
+        // The shrink can be disabled
+        Queue noShrink;
+        noShrink.setShrinkEnabled(false);
+        noShrink.push(buffer.data(), buffer.size());
+        const std::size_t capacity = noShrink.capacity();
+        noShrink.pop(buffer.data(), buffer.size());
+        EXPECT_EQ(static_cast<std::uint64_t>(0), noShrink.countShrink());
+        EXPECT_EQ(capacity, noShrink.capacity());
+    }
+
+    TEST(QueueTest, testReserveCommitPeekRelease) {
+        Queue queue;
+
+        // Move the tail near the end of the storage to force a wrap
+        std::vector<std::uint64_t> values(500);
+        queue.push(values.data(), values.size() * sizeof(std::uint64_t));
+        queue.pop(values.data(), 400 * sizeof(std::uint64_t));
+
+        std::uint64_t current = 0;
+        for (std::size_t step = 0; step < 10; ++step) {
+            std::uint64_t *out = reinterpret_cast<std::uint64_t*>(queue.acquireWrite(300 * sizeof(std::uint64_t), alignof(std::uint64_t)));
+            ASSERT_EQ(static_cast<std::size_t>(0), reinterpret_cast<std::uintptr_t>(out) % alignof(std::uint64_t));
+            for (std::size_t i = 0; i < 300; ++i) {
+                out[i] = current + i;
+            }
+            queue.commit(300 * sizeof(std::uint64_t));
+            current += 300;
+        }
+        EXPECT_EQ(3100 * sizeof(std::uint64_t), queue.size());
+
+        // Drop the initial data
+        queue.release(100 * sizeof(std::uint64_t));
+
+        std::uint64_t expected = 0;
+        while (queue.size() > 0) {
+            const std::uint64_t *in = reinterpret_cast<const std::uint64_t*>(queue.peek(250 * sizeof(std::uint64_t), alignof(std::uint64_t)));
+            for (std::size_t i = 0; i < 250; ++i) {
+                ASSERT_EQ(expected + i, in[i]);
+            }
+            queue.release(250 * sizeof(std::uint64_t));
+            expected += 250;
+
+            if (queue.size() < 250 * sizeof(std::uint64_t)) {
+                break;
+            }
+        }
+
+        // The remaining data are still readable with pop
+        std::size_t remaining = queue.size() / sizeof(std::uint64_t);
+        queue.pop(values.data(), remaining * sizeof(std::uint64_t));
+        for (std::size_t i = 0; i < remaining; ++i) {
+            EXPECT_EQ(expected + i, values[i]);
+        }
+    }
+
+    TEST(QueueTest, testPeekLinearize) {
+        Queue queue;
+        std::vector<std::uint8_t> values(32000);
+        std::vector<std::uint8_t> popped(values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<std::uint8_t>(i * 7);
+        }
+
+        // Contiguous but misaligned data
+        queue.push(values.data(), 17);
+        queue.pop(popped.data(), 1);
+        const std::uint8_t *in = queue.peek(16, alignof(std::uint64_t));
+        ASSERT_EQ(static_cast<std::size_t>(0), reinterpret_cast<std::uintptr_t>(in) % alignof(std::uint64_t));
+        for (std::size_t i = 0; i < 16; ++i) {
+            ASSERT_EQ(values[1 + i], in[i]);
+        }
+        queue.release(16);
+
+        // Data which wrap at the end of storage
+        queue.push(values.data(), values.size());
+        queue.pop(popped.data(), 31000);
+        queue.push(values.data(), 1500);
+        ASSERT_EQ(static_cast<std::size_t>(2500), queue.size());
+
+        in = queue.peek(2500);
+        for (std::size_t i = 0; i < 1000; ++i) {
+            ASSERT_EQ(values[31000 + i], in[i]);
+        }
+        for (std::size_t i = 0; i < 1500; ++i) {
+            ASSERT_EQ(values[i], in[1000 + i]);
+        }
+        queue.release(2500);
+        EXPECT_EQ(static_cast<std::size_t>(0), queue.size());
+    }
+}
+
 int main(int argc, char *argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
     ::testing::InitGoogleMock(&argc, argv);
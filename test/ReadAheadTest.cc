@@ -0,0 +1,162 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <fstream>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Channel.h>
+#include <dsps/ReadAhead.h>
+#include <dsps/SignalFromFile.h>
+
+namespace {
+    std::vector<char> writeFile(const std::string &filename, std::size_t size) {
+        std::vector<char> bytes(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<char>((i * 7 + i / 251) & 0xFF);
+        }
+
+        std::ofstream file(filename, std::ios::binary);
+        file.write(bytes.data(), bytes.size());
+
+        return bytes;
+    }
+
+    TEST(ReadAheadTest, testSequentialRead) {
+        const std::string filename = "/tmp/dsps_test_read_ahead.bin";
+        std::vector<char> expected = writeFile(filename, 100000);
+
+        // The block size doesn't divide the file
+        ReadAhead buffer(filename, false, 3, 1000);
+        EXPECT_EQ(3u, buffer.getDepth());
+        EXPECT_EQ(1000u, buffer.getBlockSize());
+
+        std::istream input(&buffer);
+        std::vector<char> actual(expected.size());
+
+        // Reads which cross the blocks
+        std::size_t done = 0;
+        while (done < actual.size()) {
+            const std::size_t size = std::min<std::size_t>(1234, actual.size() - done);
+            input.read(actual.data() + done, size);
+            ASSERT_EQ(static_cast<std::streamsize>(size), input.gcount());
+            done += size;
+        }
+        EXPECT_EQ(expected, actual);
+
+        // The end of file
+        char c;
+        EXPECT_FALSE(input.get(c));
+        EXPECT_TRUE(input.eof());
+        EXPECT_FALSE(input.get(c));
+
+        EXPECT_GE(buffer.getStallTime(), 0.0);
+    }
+
+    TEST(ReadAheadTest, testLoop) {
+        const std::string filename = "/tmp/dsps_test_read_ahead.bin";
+        std::vector<char> expected = writeFile(filename, 10000);
+
+        ReadAhead buffer(filename, true, 4, 4096);
+        std::istream input(&buffer);
+
+        // Each lap ends with EOF then restarts from the blocks already read
+        std::vector<char> actual(expected.size() + 1);
+        for (std::size_t lap = 0; lap < 5; ++lap) {
+            input.read(actual.data(), actual.size());
+            EXPECT_EQ(static_cast<std::streamsize>(expected.size()), input.gcount());
+            EXPECT_TRUE(input.eof());
+            actual.resize(expected.size());
+            EXPECT_EQ(expected, actual);
+            actual.resize(expected.size() + 1);
+
+            input.clear();
+            input.seekg(0);
+            EXPECT_TRUE(input.good());
+        }
+    }
+
+    TEST(ReadAheadTest, testSeek) {
+        const std::string filename = "/tmp/dsps_test_read_ahead.bin";
+        std::vector<char> expected = writeFile(filename, 50000);
+
+        ReadAhead buffer(filename, false, 2, 1000);
+        std::istream input(&buffer);
+
+        char c = 0;
+        EXPECT_EQ(0, input.tellg());
+
+        // Inside the current block
+        input.get(c);
+        EXPECT_EQ(1, input.tellg());
+        input.seekg(500);
+        input.get(c);
+        EXPECT_EQ(expected[500], c);
+
+        // Backward and forward outside the blocks read in advance
+        for (std::size_t position: {40000u, 10u, 49999u, 1000u, 2000u}) {
+            input.seekg(position);
+            EXPECT_EQ(static_cast<std::streamoff>(position), input.tellg());
+            input.get(c);
+            EXPECT_EQ(expected[position], c);
+        }
+
+        // Relative to the current position
+        input.seekg(100, std::ios_base::cur);
+        input.get(c);
+        EXPECT_EQ(expected[2101], c);
+    }
+
+    TEST(ReadAheadTest, testSignalFromFile) {
+        const std::string filename = "/tmp/dsps_test_read_ahead.txt";
+        const std::uint64_t N = 7;
+        {
+            std::ofstream file(filename);
+            for (int i = 0; i < 20; ++i) {
+                file << i * 0.25 << "\n";
+            }
+        }
+
+        // The file is repeated and the small blocks cut the numbers
+        SignalFromFile task(filename, true);
+        task.enableReadAhead(2, 3);
+        ASSERT_NE(nullptr, task.getReadAhead());
+        Channel &out = task.getOutput(0);
+
+        std::vector<double> values(N);
+        for (std::size_t i = 0; i < 10; ++i) {
+            task.compute(N);
+            out.receive(values, N);
+
+            for (std::size_t j = 0; j < N; ++j) {
+                EXPECT_DOUBLE_EQ(((i * N + j) % 20) * 0.25, values[j]);
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,208 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Atan2.h>
+#include <dsps/Channel.h>
+#include <dsps/Decimation.h>
+#include <dsps/Demodulation.h>
+#include <dsps/Fir.h>
+#include <dsps/Schedule.h>
+#include <dsps/SignalGenerator.h>
+#include <dsps/Unwrap.h>
+#include <dsps/Utils.h>
+
+#include "local/Utils.h"
+
+namespace {
+    class RateTask: public Task {
+    public:
+        RateTask(const std::size_t numInput, const std::uint64_t inputRate, const std::size_t numOutput, const std::uint64_t outputRate)
+        : Task(ChannelType::Double, numInput, ChannelType::Double, numOutput)
+        , m_inputRate(inputRate)
+        , m_outputRate(outputRate) {
+
+        }
+
+        virtual void compute(const std::uint64_t N) override {
+            USELESS_PARAMETER(N);
+        }
+
+        virtual bool isReady(const std::uint64_t N) const override {
+            USELESS_PARAMETER(N);
+            return true;
+        }
+
+        virtual bool hasFinished(const std::uint64_t N) const override {
+            USELESS_PARAMETER(N);
+            return true;
+        }
+
+        virtual std::uint64_t getInputRate(const std::size_t index, const std::uint64_t N) const override {
+            USELESS_PARAMETER(index);
+            USELESS_PARAMETER(N);
+            return m_inputRate;
+        }
+
+        virtual std::uint64_t getOutputRate(const std::size_t index, const std::uint64_t N) const override {
+            USELESS_PARAMETER(index);
+            USELESS_PARAMETER(N);
+            return m_outputRate;
+        }
+
+    private:
+        std::uint64_t m_inputRate;
+        std::uint64_t m_outputRate;
+    };
+
+    struct PhaseChain {
+        static constexpr double FS = 250e6;
+        static constexpr double FC = 10e6;
+        static constexpr unsigned D = 10;
+
+        PhaseChain()
+        : signalTask(1.0, FC * 1.0001, FS)
+        , demodulationTask(FC, FS, M_PI/7.0)
+        , firITask(std::string(ORACLE_DATA_DIR) + "/kaiser128_40", D)
+        , firQTask(std::string(ORACLE_DATA_DIR) + "/kaiser128_40", D)
+        , decimationTask(4) {
+            Task::connect(signalTask, demodulationTask);
+            Task::connect(demodulationTask, 0, firITask, 0);
+            Task::connect(demodulationTask, 1, firQTask, 0);
+            atan2Task.connectIChannel(firITask);
+            atan2Task.connectQChannel(firQTask);
+            Task::connect(atan2Task, unwrapTask);
+            Task::connect(unwrapTask, decimationTask);
+        }
+
+        SignalGenerator signalTask;
+        Demodulation demodulationTask;
+        Fir<double> firITask;
+        Fir<double> firQTask;
+        Atan2 atan2Task;
+        Unwrap unwrapTask;
+        Decimation decimationTask;
+    };
+
+    TEST(ScheduleTest, testBalanceEquations) {
+        // A produces 2, B consumes 3 and produces 1 for C and D which consume 2
+        RateTask taskA(0, 0, 1, 2);
+        RateTask taskB(1, 3, 2, 1);
+        RateTask taskC(1, 2, 0, 0);
+        RateTask taskD(1, 2, 0, 0);
+
+        Task::connect(taskA, 0, taskB, 0);
+        Task::connect(taskB, 0, taskC, 0);
+        Task::connect(taskB, 1, taskD, 0);
+
+        DSP::Schedule schedule({ &taskA }, 1);
+        EXPECT_EQ(static_cast<std::uint64_t>(3), schedule.getFiringCount(&taskA));
+        EXPECT_EQ(static_cast<std::uint64_t>(2), schedule.getFiringCount(&taskB));
+        EXPECT_EQ(static_cast<std::uint64_t>(1), schedule.getFiringCount(&taskC));
+        EXPECT_EQ(static_cast<std::uint64_t>(1), schedule.getFiringCount(&taskD));
+
+        // No delay, so no prologue
+        EXPECT_EQ(static_cast<std::size_t>(0), schedule.getPrologue().size());
+
+        std::vector<Task*> expected = { &taskA, &taskA, &taskA, &taskB, &taskB, &taskC, &taskD };
+        EXPECT_EQ(expected, schedule.getPeriod());
+
+        EXPECT_EQ(static_cast<std::uint64_t>(6), schedule.getBufferSize(&taskA.getOutput(0)));
+        EXPECT_EQ(static_cast<std::uint64_t>(2), schedule.getBufferSize(&taskB.getOutput(0)));
+        EXPECT_EQ(static_cast<std::uint64_t>(2), schedule.getBufferSize(&taskB.getOutput(1)));
+    }
+
+    TEST(ScheduleTest, testInconsistentRates) {
+        // B and C receive the same flux but produce different rates for D
+        RateTask taskA(0, 0, 2, 1);
+        RateTask taskB(1, 1, 1, 1);
+        RateTask taskC(1, 1, 1, 2);
+        RateTask taskD(2, 1, 0, 0);
+
+        Task::connect(taskA, 0, taskB, 0);
+        Task::connect(taskA, 1, taskC, 0);
+        Task::connect(taskB, 0, taskD, 0);
+        Task::connect(taskC, 0, taskD, 1);
+
+        EXPECT_EXIT({ DSP::Schedule schedule({ &taskA }, 1); }, ::testing::ExitedWithCode(255), "The rates of DAG are inconsistent!");
+    }
+
+    TEST(ScheduleTest, testMultirateChain) {
+        static constexpr unsigned N = 64;
+
+        PhaseChain chain;
+        DSP::Schedule schedule({ &chain.signalTask }, N);
+
+        // The decimation after the unwrap consumes four windows
+        EXPECT_EQ(static_cast<std::uint64_t>(40), schedule.getFiringCount(&chain.signalTask));
+        EXPECT_EQ(static_cast<std::uint64_t>(40), schedule.getFiringCount(&chain.demodulationTask));
+        EXPECT_EQ(static_cast<std::uint64_t>(4), schedule.getFiringCount(&chain.firITask));
+        EXPECT_EQ(static_cast<std::uint64_t>(4), schedule.getFiringCount(&chain.atan2Task));
+        EXPECT_EQ(static_cast<std::uint64_t>(1), schedule.getFiringCount(&chain.decimationTask));
+        EXPECT_EQ(static_cast<std::size_t>(40 + 40 + 4 * 4 + 1), schedule.getPeriod().size());
+
+        // The prologue fills the history of filters (128 taps)
+        EXPECT_EQ(static_cast<std::size_t>(12), std::count(schedule.getPrologue().begin(), schedule.getPrologue().end(), &chain.signalTask));
+        EXPECT_EQ(static_cast<std::size_t>(1), std::count(schedule.getPrologue().begin(), schedule.getPrologue().end(), &chain.firITask));
+
+        // 12 windows less the first compute, then 40 windows each period
+        EXPECT_EQ(static_cast<std::uint64_t>((12 - 10) * N - 128 + 40 * N), schedule.getBufferSize(&chain.demodulationTask.getOutput(0)));
+        EXPECT_EQ(static_cast<std::uint64_t>(4 * N), schedule.getBufferSize(&chain.unwrapTask.getOutput(0)));
+        EXPECT_EQ(static_cast<std::uint64_t>(N), schedule.getBufferSize(&chain.decimationTask.getOutput(0)));
+    }
+
+    TEST(ScheduleTest, testProcessingSameAsDynamic) {
+        static constexpr unsigned N = 256;
+
+        PhaseChain dynamic;
+        PhaseChain scheduled;
+        DSP::Schedule schedule({ &scheduled.signalTask }, N);
+
+        // Each period of schedule produces one window
+        Channel &scheduledOut = scheduled.decimationTask.getOutput(0);
+        for (std::size_t i = 0; i < 3; ++i) {
+            schedule.processing({ &scheduled.decimationTask });
+        }
+        ASSERT_EQ(static_cast<std::size_t>(3 * N), scheduledOut.size(sizeof(double)));
+
+        Channel &dynamicOut = dynamic.decimationTask.getOutput(0);
+        while (dynamicOut.size(sizeof(double)) < 3 * N) {
+            DSP::processing({ &dynamic.signalTask }, { &dynamic.decimationTask }, N);
+        }
+
+        std::vector<double> expected;
+        std::vector<double> actual;
+        dynamicOut.receive(expected, 3 * N);
+        scheduledOut.receive(actual, 3 * N);
+
+        for (std::size_t i = 0; i < 3 * N; ++i) {
+            EXPECT_EQ(expected[i], actual[i]);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,290 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Channel.h>
+#include <dsps/Simd.h>
+
+#include "local/Utils.h"
+
+namespace {
+    using DSP::Simd::InstructionSet;
+
+    // An odd size to check the last incomplete vector
+    static constexpr std::size_t Size = 1037;
+
+    const InstructionSet VectorSets[] = { InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512 };
+
+    // Distance in representable values between two doubles of same sign
+    template<typename T, typename Bits>
+    std::uint64_t ulpDistance(const T expected, const T actual) {
+        if (std::isnan(expected) || std::isnan(actual)) {
+            return (std::isnan(expected) && std::isnan(actual)) ? 0 : std::numeric_limits<std::uint64_t>::max();
+        }
+
+        if (std::signbit(expected) != std::signbit(actual)) {
+            return (expected == 0 && actual == 0) ? 0 : std::numeric_limits<std::uint64_t>::max();
+        }
+
+        Bits expectedBits;
+        Bits actualBits;
+        std::memcpy(&expectedBits, &expected, sizeof(T));
+        std::memcpy(&actualBits, &actual, sizeof(T));
+        return (expectedBits > actualBits) ? expectedBits - actualBits : actualBits - expectedBits;
+    }
+
+    // Run a kernel with the scalar set and with each vector set supported
+    template<typename Kernel, typename Compare>
+    void compareWithScalar(Kernel kernel, Compare compare) {
+        const InstructionSet previousSet = DSP::Simd::getInstructionSet();
+
+        DSP::Simd::setInstructionSet(InstructionSet::Scalar);
+        const auto expected = kernel();
+
+        for (InstructionSet instructionSet: VectorSets) {
+            if (!DSP::Simd::isSupported(instructionSet)) {
+                continue;
+            }
+
+            SCOPED_TRACE(DSP::Simd::getInstructionSetName(instructionSet));
+            DSP::Simd::setInstructionSet(instructionSet);
+            compare(expected, kernel());
+        }
+
+        DSP::Simd::setInstructionSet(previousSet);
+    }
+
+    template<typename T>
+    void expectSameBits(const std::vector<T> &expected, const std::vector<T> &actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(0, std::memcmp(&expected[i], &actual[i], sizeof(T))) << "Index " << i << ": " << expected[i] << " != " << actual[i];
+        }
+    }
+
+    TEST(SimdTest, testInstructionSet) {
+        const InstructionSet bestSet = DSP::Simd::detectInstructionSet();
+        EXPECT_TRUE(DSP::Simd::isSupported(bestSet));
+        EXPECT_TRUE(DSP::Simd::isSupported(InstructionSet::Scalar));
+
+        DSP::Simd::setInstructionSet(InstructionSet::Scalar);
+        EXPECT_EQ(InstructionSet::Scalar, DSP::Simd::getInstructionSet());
+        DSP::Simd::setInstructionSet(bestSet);
+        EXPECT_EQ(bestSet, DSP::Simd::getInstructionSet());
+
+        EXPECT_STREQ("scalar", DSP::Simd::getInstructionSetName(InstructionSet::Scalar));
+        EXPECT_STREQ("avx512", DSP::Simd::getInstructionSetName(InstructionSet::AVX512));
+    }
+
+    TEST(SimdTest, testArithmeticSameAsScalar) {
+        std::mt19937 engine = createRandomEngine();
+        std::vector<double> in1(Size);
+        std::vector<double> in2(Size);
+        std::vector<float> in1Float(Size);
+        std::vector<float> in2Float(Size);
+        std::vector< std::complex<double> > inComplex(Size);
+        std::vector<std::int64_t> inInteger(Size);
+        computeUniformFloatVector<double>(engine, in1, -1e3, 1e3);
+        computeUniformFloatVector<double>(engine, in2, -1e3, 1e3);
+        computeUniformFloatVector<float>(engine, in1Float, -1e3, 1e3);
+        computeUniformFloatVector<float>(engine, in2Float, -1e3, 1e3);
+        computeUniformIntegerVector<std::int64_t>(engine, inInteger, std::numeric_limits<std::int64_t>::min() / 2, std::numeric_limits<std::int64_t>::max() / 2);
+        for (std::size_t i = 0; i < Size; ++i) {
+            inComplex[i] = std::complex<double>(in1[i], in2[i]);
+        }
+        in1[3] = -0.0;
+
+        compareWithScalar([&]() {
+            std::vector<double> out(Size);
+            DSP::Simd::scale(in1.data(), 0.3, out.data(), Size);
+            return out;
+        }, expectSameBits<double>);
+
+        compareWithScalar([&]() {
+            std::vector<float> out(Size);
+            DSP::Simd::scale(in1Float.data(), 0.3f, out.data(), Size);
+            return out;
+        }, expectSameBits<float>);
+
+        compareWithScalar([&]() {
+            std::vector< std::complex<double> > out(Size);
+            DSP::Simd::scale(inComplex.data(), -1.7, out.data(), Size);
+            return out;
+        }, [](const std::vector< std::complex<double> > &expected, const std::vector< std::complex<double> > &actual) {
+            EXPECT_EQ(expected, actual);
+        });
+
+        compareWithScalar([&]() {
+            std::vector<double> out(Size);
+            DSP::Simd::multiply(in1.data(), in2.data(), out.data(), Size);
+            return out;
+        }, expectSameBits<double>);
+
+        compareWithScalar([&]() {
+            std::vector<float> out(Size);
+            DSP::Simd::multiply(in1Float.data(), in2Float.data(), out.data(), Size);
+            return out;
+        }, expectSameBits<float>);
+
+        compareWithScalar([&]() {
+            std::vector<double> out(in1);
+            DSP::Simd::accumulate(in2.data(), out.data(), Size);
+            return out;
+        }, expectSameBits<double>);
+
+        compareWithScalar([&]() {
+            std::vector<std::int64_t> out(inInteger);
+            DSP::Simd::accumulate(inInteger.data(), out.data(), Size);
+            return out;
+        }, expectSameBits<std::int64_t>);
+
+        compareWithScalar([&]() {
+            std::vector<double> out(Size);
+            DSP::Simd::abs(in1.data(), out.data(), Size);
+            return out;
+        }, expectSameBits<double>);
+
+        compareWithScalar([&]() {
+            std::vector<float> out(Size);
+            DSP::Simd::abs(in1Float.data(), out.data(), Size);
+            return out;
+        }, expectSameBits<float>);
+    }
+
+    TEST(SimdTest, testIntegerSameAsScalar) {
+        std::mt19937 engine = createRandomEngine();
+        std::vector<std::int64_t> in(Size);
+        computeUniformIntegerVector<std::int64_t>(engine, in, std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max());
+
+        for (unsigned shift: { 0u, 1u, 13u, 63u }) {
+            compareWithScalar([&]() {
+                std::vector<std::int64_t> out(Size);
+                DSP::Simd::shiftRight(in.data(), shift, out.data(), Size);
+                return out;
+            }, expectSameBits<std::int64_t>);
+        }
+
+        compareWithScalar([&]() {
+            std::vector<double> out(Size);
+            DSP::Simd::convert(in.data(), out.data(), Size);
+            return out;
+        }, expectSameBits<double>);
+
+        // The values at the middle of two integers are rounded away from zero
+        std::vector<double> values(Size);
+        computeUniformFloatVector<double>(engine, values, -1.0, 1.0);
+        const double halves[] = { 0.5, -0.5, 1.5, -1.5, 2.5, -2.5, 0.49999999999999994, -0.0, 4503599627370497.0 };
+        std::copy(std::begin(halves), std::end(halves), values.begin());
+        compareWithScalar([&]() {
+            std::vector<std::int64_t> out(Size);
+            DSP::Simd::quantize(values.data(), 1.0, 1.0, out.data(), 9);
+            DSP::Simd::quantize(values.data() + 9, 8191.0, 1.0 / 0.8, out.data() + 9, Size - 9);
+            return out;
+        }, expectSameBits<std::int64_t>);
+
+        std::vector<float> valuesFloat(values.begin(), values.end());
+        compareWithScalar([&]() {
+            std::vector<std::int64_t> out(Size);
+            DSP::Simd::quantize(valuesFloat.data(), 8191.0f, 1.0f / 0.8f, out.data(), Size);
+            return out;
+        }, expectSameBits<std::int64_t>);
+    }
+
+    TEST(SimdTest, testMagnitude) {
+        std::mt19937 engine = createRandomEngine();
+        std::vector<double> parts(2 * Size);
+        computeUniformFloatVector<double>(engine, parts, -1e3, 1e3);
+
+        std::vector< std::complex<double> > in(Size);
+        std::vector< std::complex<float> > inFloat(Size);
+        for (std::size_t i = 0; i < Size; ++i) {
+            in[i] = std::complex<double>(parts[2 * i], parts[2 * i + 1]);
+            inFloat[i] = std::complex<float>(parts[2 * i], parts[2 * i + 1]);
+        }
+
+        // Extreme and non finite values
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        in[0] = std::complex<double>(0.0, 0.0);
+        in[1] = std::complex<double>(1e300, -1e300);
+        in[2] = std::complex<double>(1e-310, 3e-310);
+        in[3] = std::complex<double>(inf, nan);
+        in[4] = std::complex<double>(nan, 1.0);
+        in[5] = std::complex<double>(-3.0, 1e-200);
+        inFloat[1] = std::complex<float>(1e30f, 1e30f);
+        inFloat[2] = std::complex<float>(1e-30f, 1e-30f);
+
+        compareWithScalar([&]() {
+            std::vector<double> out(Size);
+            DSP::Simd::magnitude(in.data(), out.data(), Size);
+            return out;
+        }, [](const std::vector<double> &expected, const std::vector<double> &actual) {
+            for (std::size_t i = 0; i < Size; ++i) {
+                EXPECT_LE((ulpDistance<double, std::uint64_t>(expected[i], actual[i])), 1u) << "Index " << i << ": " << expected[i] << " != " << actual[i];
+            }
+        });
+
+        compareWithScalar([&]() {
+            std::vector<float> out(Size);
+            DSP::Simd::magnitude(inFloat.data(), out.data(), Size);
+            return out;
+        }, [](const std::vector<float> &expected, const std::vector<float> &actual) {
+            for (std::size_t i = 0; i < Size; ++i) {
+                EXPECT_LE((ulpDistance<float, std::uint32_t>(expected[i], actual[i])), 1u) << "Index " << i << ": " << expected[i] << " != " << actual[i];
+            }
+        });
+    }
+
+    TEST(SimdTest, testAtan2) {
+        std::mt19937 engine = createRandomEngine();
+        std::vector<double> y(Size);
+        std::vector<double> x(Size);
+        computeUniformFloatVector<double>(engine, y, -1.0, 1.0);
+        computeUniformFloatVector<double>(engine, x, -1.0, 1.0);
+
+        // Signed zeros, axes, diagonals and non finite values
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double specialY[] = { 0.0, -0.0, 0.0, -0.0, 1.0, -1.0, 0.0, -0.0, 2.0, -2.0, 1e-300, inf, -inf, nan, 1.0, 1e300 };
+        const double specialX[] = { 0.0, 0.0, -0.0, -0.0, 0.0, -0.0, -1.0, -1.0, 2.0, -2.0, 1.0, inf, 1.0, 1.0, -inf, 1e-300 };
+        std::copy(std::begin(specialY), std::end(specialY), y.begin());
+        std::copy(std::begin(specialX), std::end(specialX), x.begin());
+
+        compareWithScalar([&]() {
+            std::vector<double> out(Size);
+            DSP::Simd::atan2(y.data(), x.data(), out.data(), Size);
+            return out;
+        }, [](const std::vector<double> &expected, const std::vector<double> &actual) {
+            for (std::size_t i = 0; i < Size; ++i) {
+                EXPECT_LE((ulpDistance<double, std::uint64_t>(expected[i], actual[i])), 2u) << "Index " << i << ": " << expected[i] << " != " << actual[i];
+            }
+        });
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    return RUN_ALL_TESTS();
+}
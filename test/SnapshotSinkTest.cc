@@ -0,0 +1,216 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_streambuf.hpp>
+
+#include <dsps/Channel.h>
+#include <dsps/SnapshotSink.h>
+
+namespace {
+    class SnapshotSinkTest : public ::testing::Test {
+    protected:
+        SnapshotSinkTest()
+        : m_N(256)
+        , m_engine(1337) {
+            std::uniform_real_distribution<double> dist(-1e6, +1e6);
+            for (std::size_t i = 0; i < m_N * 10; ++i) {
+                m_realValues.push_back(dist(m_engine));
+                m_complexValues.push_back(std::complex<double>(dist(m_engine), dist(m_engine)));
+            }
+        }
+
+        template<typename T>
+        void computeAll(SnapshotSink<T> &task, Channel &in, const std::vector<T> &values) {
+            for (std::size_t i = 0; i < values.size() / m_N; ++i) {
+                in.send(std::vector<T>(values.begin() + i * m_N, values.begin() + (i + 1) * m_N));
+                ASSERT_TRUE(task.isReady(m_N));
+                task.compute(m_N);
+                EXPECT_TRUE(task.hasFinished(m_N));
+                EXPECT_EQ(0u, in.size(sizeof(T)));
+            }
+        }
+
+        template<typename T>
+        std::vector<T> readBinary(const std::string &filename) {
+            std::ifstream file(filename, std::ios::binary);
+            std::vector<T> values;
+            T value;
+            while (file.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+                values.push_back(value);
+            }
+
+            return values;
+        }
+
+        bool waitDumps(const SnapshotSink<double> &task, std::uint64_t numberDumps) {
+            for (std::size_t i = 0; i < 500 && task.countDumps() < numberDumps; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            return task.countDumps() >= numberDumps;
+        }
+
+        std::uint64_t m_N;
+        std::mt19937 m_engine;
+        std::vector<double> m_realValues;
+        std::vector<std::complex<double>> m_complexValues;
+    };
+
+    TEST_F(SnapshotSinkTest, testKeepLastWindows) {
+        SnapshotSink<double> task("/tmp/dsps_test_snapshot.bin", 3);
+        Channel in;
+        task.setInput(in, 0);
+        EXPECT_EQ(&task, in.getOut());
+        EXPECT_FALSE(task.isReady(m_N));
+
+        // Less windows than slots
+        std::vector<double> snapshot;
+        task.getSnapshot(snapshot);
+        EXPECT_TRUE(snapshot.empty());
+
+        in.send(std::vector<double>(m_realValues.begin(), m_realValues.begin() + m_N));
+        task.compute(m_N);
+        task.getSnapshot(snapshot);
+        EXPECT_EQ(std::vector<double>(m_realValues.begin(), m_realValues.begin() + m_N), snapshot);
+
+        // The ring keeps the three last windows, the oldest first
+        in.send(std::vector<double>(m_realValues.begin() + m_N, m_realValues.end()));
+        while (task.isReady(m_N)) {
+            task.compute(m_N);
+        }
+        EXPECT_EQ(10u, task.countWindows());
+
+        task.getSnapshot(snapshot);
+        EXPECT_EQ(std::vector<double>(m_realValues.end() - 3 * m_N, m_realValues.end()), snapshot);
+    }
+
+    TEST_F(SnapshotSinkTest, testDumpBinary) {
+        SnapshotSink<std::complex<double>> task("/tmp/dsps_test_snapshot.bin", 4);
+        Channel in;
+        task.setInput(in, 0);
+        computeAll(task, in, m_complexValues);
+
+        task.dump();
+        EXPECT_EQ(1u, task.countDumps());
+
+        std::vector<std::complex<double>> expected(m_complexValues.end() - 4 * m_N, m_complexValues.end());
+        EXPECT_EQ(expected, readBinary<std::complex<double>>("/tmp/dsps_test_snapshot.bin"));
+    }
+
+    TEST_F(SnapshotSinkTest, testDumpAscii) {
+        SnapshotSink<double> task("/tmp/dsps_test_snapshot.txt", 2, SnapshotSink<double>::Format::Ascii);
+        Channel in;
+        task.setInput(in, 0);
+        computeAll(task, in, m_realValues);
+        task.dump();
+
+        std::ifstream file("/tmp/dsps_test_snapshot.txt");
+        std::vector<double> values;
+        double value;
+        while (file >> value) {
+            values.push_back(value);
+        }
+
+        ASSERT_EQ(2 * m_N, values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            EXPECT_DOUBLE_EQ(m_realValues[8 * m_N + i], values[i]);
+        }
+    }
+
+    TEST_F(SnapshotSinkTest, testDumpGzip) {
+        SnapshotSink<double> task("/tmp/dsps_test_snapshot.gz", 5, SnapshotSink<double>::Format::Gzip);
+        Channel in;
+        task.setInput(in, 0);
+        computeAll(task, in, m_realValues);
+        task.dump();
+
+        std::ifstream file("/tmp/dsps_test_snapshot.gz", std::ios::binary);
+        boost::iostreams::filtering_streambuf<boost::iostreams::input> decompressed;
+        decompressed.push(boost::iostreams::gzip_decompressor());
+        decompressed.push(file);
+        std::stringstream content;
+        boost::iostreams::copy(decompressed, content);
+
+        const std::string bytes = content.str();
+        ASSERT_EQ(5 * m_N * sizeof(double), bytes.size());
+        std::vector<double> values(5 * m_N);
+        std::memcpy(values.data(), bytes.data(), bytes.size());
+        EXPECT_EQ(std::vector<double>(m_realValues.end() - 5 * m_N, m_realValues.end()), values);
+    }
+
+    TEST_F(SnapshotSinkTest, testDumpWhileComputing) {
+        SnapshotSink<double> task("/tmp/dsps_test_snapshot.bin", 2);
+        Channel in;
+        task.setInput(in, 0);
+
+        // Each snapshot is made of two consecutive windows
+        for (std::size_t i = 0; i < 10; ++i) {
+            in.send(std::vector<double>(m_realValues.begin() + i * m_N, m_realValues.begin() + (i + 1) * m_N));
+            task.compute(m_N);
+            task.requestDump();
+        }
+        task.dump();
+
+        std::vector<double> values = readBinary<double>("/tmp/dsps_test_snapshot.bin");
+        EXPECT_EQ(std::vector<double>(m_realValues.end() - 2 * m_N, m_realValues.end()), values);
+        EXPECT_LE(1u, task.countDumps());
+        EXPECT_GE(11u, task.countDumps());
+    }
+
+    TEST_F(SnapshotSinkTest, testDumpPeriod) {
+        SnapshotSink<double> task("/tmp/dsps_test_snapshot.bin", 1);
+        Channel in;
+        task.setInput(in, 0);
+        computeAll(task, in, m_realValues);
+
+        task.setDumpPeriod(std::chrono::milliseconds(10));
+        EXPECT_TRUE(waitDumps(task, 3));
+
+        task.setDumpPeriod(std::chrono::milliseconds(0));
+        EXPECT_EQ(std::vector<double>(m_realValues.end() - m_N, m_realValues.end()), readBinary<double>("/tmp/dsps_test_snapshot.bin"));
+    }
+
+    TEST_F(SnapshotSinkTest, testDumpOnSignal) {
+        SnapshotSink<double> task("/tmp/dsps_test_snapshot.bin", 1);
+        Channel in;
+        task.setInput(in, 0);
+        computeAll(task, in, m_realValues);
+
+        SnapshotSink<double>::dumpOnSignal(SIGUSR1);
+        std::raise(SIGUSR1);
+        EXPECT_TRUE(waitDumps(task, 1));
+        EXPECT_EQ(std::vector<double>(m_realValues.end() - m_N, m_realValues.end()), readBinary<double>("/tmp/dsps_test_snapshot.bin"));
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
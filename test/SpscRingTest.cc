@@ -0,0 +1,186 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Channel.h>
+#include <dsps/SpscRing.h>
+
+namespace {
+    TEST(SpscRingTest, testCapacityAndWrap) {
+        SpscRing ring(100 * sizeof(double));
+
+        // The capacity is a power of two
+        EXPECT_EQ(static_cast<std::size_t>(1024), ring.capacity());
+        EXPECT_TRUE(ring.isEmpty());
+
+        // Fill the ring many times to cross the end of buffer
+        std::vector<double> values(100);
+        double counter = 0.0;
+        double expected = 0.0;
+        for (unsigned i = 0; i < 20; ++i) {
+            for (auto &value: values) {
+                value = counter++;
+            }
+            EXPECT_TRUE(ring.tryPush(values.data(), values.size() * sizeof(double)));
+            EXPECT_EQ(100 * sizeof(double), ring.size());
+
+            std::vector<double> result(100);
+            EXPECT_TRUE(ring.tryPop(result.data(), result.size() * sizeof(double)));
+            EXPECT_TRUE(ring.isEmpty());
+
+            for (double value: result) {
+                EXPECT_EQ(expected++, value);
+            }
+        }
+    }
+
+    TEST(SpscRingTest, testBackPressure) {
+        SpscRing ring(64 * sizeof(double));
+        std::vector<double> values(64, 1.0);
+
+        // The ring is full
+        EXPECT_TRUE(ring.tryPush(values.data(), values.size() * sizeof(double)));
+        EXPECT_FALSE(ring.tryPush(values.data(), sizeof(double)));
+        EXPECT_EQ(ring.capacity(), ring.size());
+
+        // Nothing to read in an empty ring
+        std::vector<double> result(64);
+        EXPECT_TRUE(ring.tryPop(result.data(), result.size() * sizeof(double)));
+        EXPECT_FALSE(ring.tryPop(result.data(), sizeof(double)));
+    }
+
+    void checkProducerConsumer(SpscRing::WaitMode mode) {
+        static constexpr std::size_t N = 1000;
+        static constexpr std::size_t BURSTS = 500;
+
+        // The bursts are bigger than the ring
+        SpscRing ring(256 * sizeof(std::uint64_t), mode);
+
+        std::thread producer([&ring]() {
+            std::vector<std::uint64_t> values(N);
+            for (std::size_t i = 0; i < BURSTS; ++i) {
+                for (std::size_t j = 0; j < N; ++j) {
+                    values[j] = i * N + j;
+                }
+                ring.push(values.data(), values.size() * sizeof(std::uint64_t));
+            }
+        });
+
+        std::vector<std::uint64_t> result(N / 4);
+        std::uint64_t expected = 0;
+        for (std::size_t i = 0; i < BURSTS * 4; ++i) {
+            ring.pop(result.data(), result.size() * sizeof(std::uint64_t));
+            for (std::uint64_t value: result) {
+                ASSERT_EQ(expected++, value);
+            }
+        }
+
+        producer.join();
+        EXPECT_TRUE(ring.isEmpty());
+    }
+
+    TEST(SpscRingTest, testProducerConsumerBlock) {
+        checkProducerConsumer(SpscRing::WaitMode::Block);
+    }
+
+    TEST(SpscRingTest, testProducerConsumerSpin) {
+        checkProducerConsumer(SpscRing::WaitMode::Spin);
+    }
+
+    TEST(SpscRingTest, testChannelRingBuffer) {
+        Channel channel;
+        EXPECT_EQ(static_cast<std::size_t>(0), channel.getRingCapacity());
+
+        // The pending data are kept
+        std::vector<double> values = { 1.0, 2.0, 3.0 };
+        channel.send(values);
+        channel.setRingBuffer(16 * sizeof(double));
+        EXPECT_EQ(16 * sizeof(double), channel.getRingCapacity());
+        EXPECT_EQ(static_cast<std::size_t>(3), channel.size(sizeof(double)));
+
+        channel.send(values);
+        EXPECT_EQ(static_cast<std::size_t>(6), channel.size(sizeof(double)));
+
+        std::vector<double> result;
+        channel.receive(result, 6);
+        EXPECT_EQ(static_cast<std::size_t>(0), channel.size(sizeof(double)));
+        for (std::size_t i = 0; i < 6; ++i) {
+            EXPECT_EQ(values[i % 3], result[i]);
+        }
+
+        // Back to the queue with the pending data
+        channel.send(values);
+        channel.setQueueBuffer();
+        EXPECT_EQ(static_cast<std::size_t>(0), channel.getRingCapacity());
+        EXPECT_EQ(static_cast<std::size_t>(3), channel.size(sizeof(double)));
+
+        // The idle ring is reused
+        channel.setRingBuffer(8 * sizeof(double));
+        EXPECT_EQ(16 * sizeof(double), channel.getRingCapacity());
+        EXPECT_EQ(static_cast<std::uint64_t>(0), channel.countGrow());
+
+        channel.receive(result, 3);
+        for (std::size_t i = 0; i < 3; ++i) {
+            EXPECT_EQ(values[i], result[i]);
+        }
+    }
+
+    void checkBorrowing(SpscRing &ring) {
+        // Windows of 96 bytes regularly straddle the end of the storage
+        std::uint8_t current = 0;
+        std::uint8_t expected = 0;
+        for (std::size_t step = 0; step < 4 * ring.capacity() / 96; ++step) {
+            std::uint8_t *out = static_cast<std::uint8_t*>(ring.acquireWrite(96));
+            for (std::size_t i = 0; i < 96; ++i) {
+                out[i] = current++;
+            }
+            ring.commit(96);
+
+            const std::uint8_t *in = static_cast<const std::uint8_t*>(ring.peek(96));
+            for (std::size_t i = 0; i < 96; ++i) {
+                ASSERT_EQ(expected++, in[i]);
+            }
+            ring.release(96);
+        }
+        EXPECT_EQ(static_cast<std::size_t>(0), ring.size());
+    }
+
+    TEST(SpscRingTest, testBorrowingStaging) {
+        SpscRing ring(1024);
+        EXPECT_FALSE(ring.isMirrored());
+        checkBorrowing(ring);
+    }
+
+    TEST(SpscRingTest, testBorrowingMirrored) {
+        // Large rings are mapped twice when the system allows it
+        SpscRing ring(1 << 16);
+        checkBorrowing(ring);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,296 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <dsps/Channel.h>
+#include <dsps/Statistics.h>
+
+namespace {
+    typedef Statistics<double>::Statistic Statistic;
+
+    class StatisticsTest : public ::testing::Test {
+    protected:
+        StatisticsTest()
+        : m_N(64)
+        , m_M(200)
+        , m_engine(1337) {
+            std::normal_distribution<double> dist(3.0, 2.0);
+            for (std::size_t i = 0; i < m_N * m_M; ++i) {
+                m_values.push_back(dist(m_engine));
+            }
+        }
+
+        // Feed the windows [0, numberWindows[ and check the result after each of them
+        template<typename Oracle>
+        void checkStatistic(Statistics<double> &task, Oracle oracle, double tolerance) {
+            Channel in;
+            Channel &out = task.getOutput(0);
+            task.setInput(in, 0);
+            EXPECT_EQ(&task, in.getOut());
+            EXPECT_EQ(&task, out.getIn());
+
+            std::vector<double> result;
+            task.getResult(result);
+            EXPECT_TRUE(result.empty());
+
+            for (std::size_t w = 0; w < m_M; ++w) {
+                EXPECT_FALSE(task.isReady(m_N));
+                in.send(std::vector<double>(m_values.begin() + w * m_N, m_values.begin() + (w + 1) * m_N));
+                ASSERT_TRUE(task.isReady(m_N));
+                task.compute(m_N);
+                EXPECT_TRUE(task.hasFinished(m_N));
+                EXPECT_EQ(w + 1, task.countWindows());
+
+                // The published result is the one given on demand
+                std::vector<double> published;
+                out.receive(published, m_N);
+                task.getResult(result);
+                ASSERT_EQ(m_N, result.size());
+                EXPECT_EQ(result, published);
+
+                // The oracle gives NaN when it doesn't know the result
+                for (std::size_t i = 0; i < m_N; ++i) {
+                    const double expected = oracle(w, i);
+                    if (!std::isnan(expected)) {
+                        EXPECT_NEAR(expected, result[i], tolerance);
+                    }
+                }
+            }
+        }
+
+        // Values of bin i in the windows [first, last]
+        std::vector<double> getBin(std::size_t i, std::size_t first, std::size_t last) const {
+            std::vector<double> values;
+            for (std::size_t w = first; w <= last; ++w) {
+                values.push_back(m_values[w * m_N + i]);
+            }
+
+            return values;
+        }
+
+        std::size_t firstWindow(std::size_t w, std::size_t length) const {
+            return (length == 0 || w < length) ? 0 : w + 1 - length;
+        }
+
+        static double mean(const std::vector<double> &values) {
+            double sum = 0.0;
+            for (double value: values) {
+                sum += value;
+            }
+
+            return sum / values.size();
+        }
+
+        static double variance(const std::vector<double> &values) {
+            if (values.size() < 2) {
+                return 0.0;
+            }
+
+            const double m = mean(values);
+            double sum = 0.0;
+            for (double value: values) {
+                sum += (value - m) * (value - m);
+            }
+
+            return sum / (values.size() - 1);
+        }
+
+        std::uint64_t m_N;
+        std::uint64_t m_M;
+        std::mt19937 m_engine;
+        std::vector<double> m_values;
+    };
+
+    TEST_F(StatisticsTest, testMean) {
+        Statistics<double> task(Statistic::Mean);
+        checkStatistic(task, [this](std::size_t w, std::size_t i) {
+            return mean(getBin(i, 0, w));
+        }, 1e-12);
+    }
+
+    TEST_F(StatisticsTest, testSlidingMean) {
+        const std::size_t length = 7;
+        Statistics<double> task(Statistic::Mean, length);
+        checkStatistic(task, [this, length](std::size_t w, std::size_t i) {
+            return mean(getBin(i, firstWindow(w, length), w));
+        }, 1e-12);
+    }
+
+    TEST_F(StatisticsTest, testVariance) {
+        Statistics<double> task(Statistic::Variance);
+        checkStatistic(task, [this](std::size_t w, std::size_t i) {
+            return variance(getBin(i, 0, w));
+        }, 1e-11);
+    }
+
+    TEST_F(StatisticsTest, testSlidingVariance) {
+        const std::size_t length = 10;
+        Statistics<double> task(Statistic::Variance, length);
+        checkStatistic(task, [this, length](std::size_t w, std::size_t i) {
+            return variance(getBin(i, firstWindow(w, length), w));
+        }, 1e-11);
+    }
+
+    TEST_F(StatisticsTest, testExponential) {
+        const double alpha = 0.1;
+        Statistics<double> meanTask(Statistic::ExponentialMean, 0, alpha);
+        Statistics<double> varianceTask(Statistic::ExponentialVariance, 0, alpha);
+
+        std::vector<double> m(m_N * m_M);
+        std::vector<double> v(m_N * m_M);
+        for (std::size_t i = 0; i < m_N; ++i) {
+            m[i] = m_values[i];
+            for (std::size_t w = 1; w < m_M; ++w) {
+                const double previous = m[(w - 1) * m_N + i];
+                const double delta = m_values[w * m_N + i] - previous;
+                m[w * m_N + i] = previous + alpha * delta;
+                v[w * m_N + i] = (1.0 - alpha) * (v[(w - 1) * m_N + i] + alpha * delta * delta);
+            }
+        }
+
+        checkStatistic(meanTask, [this, &m](std::size_t w, std::size_t i) { return m[w * m_N + i]; }, 1e-12);
+        checkStatistic(varianceTask, [this, &v](std::size_t w, std::size_t i) { return v[w * m_N + i]; }, 1e-12);
+    }
+
+    TEST_F(StatisticsTest, testHold) {
+        Statistics<double> minTask(Statistic::MinHold);
+        checkStatistic(minTask, [this](std::size_t w, std::size_t i) {
+            std::vector<double> values = getBin(i, 0, w);
+            return *std::min_element(values.begin(), values.end());
+        }, 0.0);
+
+        Statistics<double> maxTask(Statistic::MaxHold);
+        checkStatistic(maxTask, [this](std::size_t w, std::size_t i) {
+            std::vector<double> values = getBin(i, 0, w);
+            return *std::max_element(values.begin(), values.end());
+        }, 0.0);
+    }
+
+    TEST_F(StatisticsTest, testSlidingHold) {
+        const std::size_t length = 5;
+        Statistics<double> minTask(Statistic::MinHold, length);
+        checkStatistic(minTask, [this, length](std::size_t w, std::size_t i) {
+            std::vector<double> values = getBin(i, firstWindow(w, length), w);
+            return *std::min_element(values.begin(), values.end());
+        }, 0.0);
+
+        Statistics<double> maxTask(Statistic::MaxHold, length);
+        checkStatistic(maxTask, [this, length](std::size_t w, std::size_t i) {
+            std::vector<double> values = getBin(i, firstWindow(w, length), w);
+            return *std::max_element(values.begin(), values.end());
+        }, 0.0);
+    }
+
+    TEST_F(StatisticsTest, testPercentile) {
+        // The P-square estimate converges toward the quantile of distribution
+        static constexpr std::size_t N = 8;
+        static constexpr std::size_t M = 20000;
+        const double quantiles[] = { 0.1, 0.5, 0.9 };
+        const double expected[] = { -1.2815515655, 0.0, 1.2815515655 };
+
+        for (std::size_t q = 0; q < 3; ++q) {
+            Statistics<double> task(Statistic::Percentile, 0, quantiles[q], 0);
+            Channel in;
+            task.setInput(in, 0);
+
+            std::normal_distribution<double> dist(0.0, 1.0);
+            for (std::size_t w = 0; w < M; ++w) {
+                std::vector<double> values(N);
+                for (double &value: values) {
+                    value = dist(m_engine);
+                }
+                in.send(values);
+                task.compute(N);
+            }
+            EXPECT_TRUE(task.hasFinished(N));
+            EXPECT_EQ(0u, task.getOutput(0).size(sizeof(double)));
+
+            std::vector<double> result;
+            task.getResult(result);
+            ASSERT_EQ(N, result.size());
+            for (std::size_t i = 0; i < N; ++i) {
+                EXPECT_NEAR(expected[q], result[i], 0.05);
+            }
+        }
+    }
+
+    TEST_F(StatisticsTest, testPercentileFirstWindows) {
+        Statistics<double> task(Statistic::Percentile, 0, 0.5);
+        checkStatistic(task, [this](std::size_t w, std::size_t i) {
+            std::vector<double> values = getBin(i, 0, w);
+            std::sort(values.begin(), values.end());
+            return (w < 5) ? values[static_cast<std::size_t>(std::round(0.5 * w))] : std::numeric_limits<double>::quiet_NaN();
+        }, 0.0);
+    }
+
+    TEST_F(StatisticsTest, testPublishPeriod) {
+        Statistics<double> task(Statistic::Mean, 0, 0.5, 4);
+        Channel in;
+        Channel &out = task.getOutput(0);
+        task.setInput(in, 0);
+
+        for (std::size_t w = 0; w < 10; ++w) {
+            in.send(std::vector<double>(m_values.begin() + w * m_N, m_values.begin() + (w + 1) * m_N));
+            task.compute(m_N);
+            EXPECT_EQ(((w + 1) / 4) * m_N, out.size(sizeof(double)));
+        }
+
+        // On demand
+        task.publish();
+        EXPECT_EQ(3 * m_N, out.size(sizeof(double)));
+
+        // The accumulators restart after a reset
+        task.clearAccum();
+        EXPECT_EQ(0u, task.countWindows());
+        std::vector<double> result;
+        task.getResult(result);
+        EXPECT_TRUE(result.empty());
+    }
+
+    TEST(StatisticsFloatTest, testMean) {
+        static constexpr std::size_t N = 16;
+        Statistics<float> task(Statistics<float>::Statistic::Mean, 3);
+        Channel in;
+        task.setInput(in, 0);
+
+        for (std::size_t w = 0; w < 10; ++w) {
+            in.send(std::vector<float>(N, static_cast<float>(w)));
+            task.compute(N);
+        }
+
+        std::vector<float> result;
+        task.getResult(result);
+        ASSERT_EQ(N, result.size());
+        for (float value: result) {
+            EXPECT_FLOAT_EQ(8.0f, value);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
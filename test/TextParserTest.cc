@@ -0,0 +1,157 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/TextParser.h>
+
+namespace {
+    void expectSameAsStrtod(const std::string &text) {
+        double expected = std::strtod(text.c_str(), nullptr);
+        double actual = 0.0;
+        const char *end = TextParser::parse(text.data(), text.data() + text.size(), actual);
+
+        EXPECT_EQ(text.data() + text.size(), end) << text;
+        EXPECT_EQ(0, std::memcmp(&expected, &actual, sizeof(double))) << text << ": " << expected << " != " << actual;
+    }
+
+    TEST(TextParserTest, testDouble) {
+        for (const char *text: {"0", "-0", "+0.000e+10", "1", "-1", "+1.0000000000000001e-01", "3.0000000000000004e-01",
+                "1e22", "1e23", "9007199254740993", "18446744073709551615", "123456789012345678901234567890",
+                "0.1", ".5", "5.", "1.7976931348623157e308", "2.2250738585072014e-308", "4.9e-324", "1e-400",
+                "1e400", "+1.0000000000000000000000e+04", "0.000000000000000000000000000123456", "7.2057594037927933e+16"}) {
+            expectSameAsStrtod(text);
+        }
+
+        // Random values in all formats
+        std::mt19937_64 generator(42);
+        std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+        std::uniform_int_distribution<int> exponent(-30, 30);
+        char text[64];
+        for (std::size_t i = 0; i < 100000; ++i) {
+            const double value = mantissa(generator) * std::pow(10.0, exponent(generator));
+            for (const char *format: {"%.17g", "%+.16e", "%.15g", "%.6f", "%.20e"}) {
+                std::snprintf(text, sizeof(text), format, value);
+                expectSameAsStrtod(text);
+            }
+        }
+    }
+
+    TEST(TextParserTest, testInvalidDouble) {
+        double value = 0.0;
+
+        // The number stops before an exponent without digits
+        std::string text = "1.5e+";
+        EXPECT_EQ(text.data() + 3, TextParser::parse(text.data(), text.data() + text.size(), value));
+        EXPECT_EQ(1.5, value);
+
+        text = "abc";
+        EXPECT_EQ(text.data(), TextParser::parse(text.data(), text.data() + text.size(), value));
+    }
+
+    TEST(TextParserTest, testInteger) {
+        std::int64_t value = 0;
+
+        for (std::int64_t expected: {std::int64_t(0), std::int64_t(-42), std::int64_t(99999), std::numeric_limits<std::int64_t>::max(), std::numeric_limits<std::int64_t>::min()}) {
+            std::string text = std::to_string(expected);
+            EXPECT_EQ(text.data() + text.size(), TextParser::parse(text.data(), text.data() + text.size(), value));
+            EXPECT_EQ(expected, value);
+        }
+
+        std::string text = "+17";
+        EXPECT_EQ(text.data() + text.size(), TextParser::parse(text.data(), text.data() + text.size(), value));
+        EXPECT_EQ(17, value);
+
+        // Overflow
+        text = "9223372036854775808";
+        EXPECT_EQ(text.data(), TextParser::parse(text.data(), text.data() + text.size(), value));
+    }
+
+    TEST(TextParserTest, testStream) {
+        // The blocks cut the numbers
+        std::istringstream input("  1.25\t-2e3\n\n+0.5 7\r\n-1.0e-2 3.5 4.5");
+        TextParser parser(input, 3);
+
+        double value = 0.0;
+        for (double expected: {1.25, -2e3, 0.5, 7.0, -1.0e-2}) {
+            ASSERT_TRUE(parser.read(value));
+            EXPECT_EQ(expected, value);
+        }
+
+        std::complex<double> complex;
+        ASSERT_TRUE(parser.read(complex));
+        EXPECT_EQ(std::complex<double>(3.5, 4.5), complex);
+
+        // The last number has no newline
+        EXPECT_FALSE(parser.read(value));
+
+        // Read again after a rewind
+        input.clear();
+        input.seekg(0);
+        parser.reset();
+        ASSERT_TRUE(parser.read(value));
+        EXPECT_EQ(1.25, value);
+    }
+
+    TEST(TextParserTest, testParseAll) {
+        // Many chunks of 1 MiB
+        std::mt19937_64 generator(7);
+        std::normal_distribution<double> distribution(0.0, 1e-3);
+        std::string text;
+        std::vector<double> expected;
+        char line[64];
+        while (text.size() < (std::size_t(5) << 20)) {
+            std::snprintf(line, sizeof(line), "%+.16e\n", distribution(generator));
+            text += line;
+            expected.push_back(std::strtod(line, nullptr));
+        }
+
+        std::vector<double> values = TextParser::parseAll<double>(text.data(), text.data() + text.size(), 4);
+        ASSERT_EQ(expected.size(), values.size());
+        EXPECT_EQ(0, std::memcmp(expected.data(), values.data(), expected.size() * sizeof(double)));
+
+        // The parse stops at the first invalid number
+        text.replace(text.size() / 2, 1, "x");
+        values = TextParser::parseAll<double>(text.data(), text.data() + text.size(), 4);
+        EXPECT_LT(values.size(), expected.size());
+        EXPECT_GT(values.size(), expected.size() / 2 - 2);
+        EXPECT_EQ(0, std::memcmp(expected.data(), values.data(), values.size() * sizeof(double)));
+
+        std::string integers = "1 2 3\n-4";
+        std::vector<std::int64_t> numbers = TextParser::parseAll<std::int64_t>(integers.data(), integers.data() + integers.size());
+        EXPECT_EQ(std::vector<std::int64_t>({1, 2, 3, -4}), numbers);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    ::testing::FLAGS_gtest_death_test_style = "fast";
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,193 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <cmath>
+#include <complex>
+#include <numeric>
+#include <random>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Channel.h>
+#include <dsps/Welch.h>
+
+#include "local/Utils.h"
+
+namespace {
+    std::vector<double> whiteNoise(const std::size_t size, const double stddev) {
+        std::mt19937 engine(11);
+        std::normal_distribution<double> dist(0.0, stddev);
+
+        std::vector<double> values(size);
+        for (auto &value: values) {
+            value = dist(engine);
+        }
+
+        return values;
+    }
+
+    // Send the signal by windows of N samples
+    void feed(Welch &task, Channel &in, const std::vector<double> &values, const std::size_t N) {
+        for (std::size_t i = 0; i + N <= values.size(); i += N) {
+            in.send(std::vector<double>(values.begin() + i, values.begin() + i + N));
+            ASSERT_TRUE(task.isReady(N));
+            task.compute(N);
+            EXPECT_FALSE(task.isReady(N));
+        }
+    }
+
+    // Direct periodogram of one segment with the Hann window
+    std::vector<double> periodogram(const double *segment, const std::size_t nfft, const double fs) {
+        std::vector<double> window(nfft);
+        double windowPower = 0.0;
+        for (std::size_t i = 0; i < nfft; ++i) {
+            window[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / nfft);
+            windowPower += window[i] * window[i];
+        }
+
+        std::vector<double> psd(nfft / 2 + 1);
+        for (std::size_t k = 0; k < psd.size(); ++k) {
+            std::complex<double> bin;
+            for (std::size_t n = 0; n < nfft; ++n) {
+                bin += segment[n] * window[n] * std::polar(1.0, -2.0 * M_PI * static_cast<double>(k * n) / nfft);
+            }
+            const double factor = (k == 0 || 2 * k == nfft) ? 1.0 : 2.0;
+            psd[k] = factor * std::norm(bin) / (fs * windowPower);
+        }
+
+        return psd;
+    }
+
+    TEST(WelchTest, testSegments) {
+        static constexpr std::size_t N = 250;
+        static constexpr std::size_t NFFT = 100;
+        static constexpr std::size_t OVERLAP = 50;
+        static constexpr double FS = 1e3;
+
+        Welch task(NFFT, OVERLAP, FS);
+        Channel in;
+        task.setInput(in, 0);
+
+        const std::vector<double> values = whiteNoise(1000, 1.0);
+        feed(task, in, values, N);
+
+        // 1 + (1000 - 100) / 50 segments, one PSD by segment
+        EXPECT_EQ(static_cast<std::uint64_t>(19), task.getNumberOfSegments());
+        EXPECT_TRUE(task.hasFinished(N));
+        EXPECT_EQ(19 * (NFFT / 2 + 1), task.getOutput(0).size(sizeof(double)));
+
+        // Mean of the periodograms of segments
+        std::vector<double> expected(NFFT / 2 + 1, 0.0);
+        for (std::size_t s = 0; s < 19; ++s) {
+            const std::vector<double> psd = periodogram(values.data() + s * OVERLAP, NFFT, FS);
+            for (std::size_t k = 0; k < expected.size(); ++k) {
+                expected[k] += psd[k] / 19.0;
+            }
+        }
+
+        const std::vector<double> actual = task.getPsd();
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t k = 0; k < expected.size(); ++k) {
+            expect_eq_double(expected[k], actual[k], 1e-12);
+        }
+
+        // The last sent PSD is the current estimate
+        std::vector<double> sent;
+        task.getOutput(0).receive(sent, 19 * (NFFT / 2 + 1));
+        for (std::size_t k = 0; k < expected.size(); ++k) {
+            EXPECT_EQ(actual[k], sent[18 * (NFFT / 2 + 1) + k]);
+        }
+    }
+
+    TEST(WelchTest, testWhiteNoiseLevel) {
+        static constexpr std::size_t N = 1024;
+        static constexpr std::size_t NFFT = 128;
+        static constexpr double FS = 1e3;
+        static constexpr double STDDEV = 2.0;
+
+        const std::vector<double> values = whiteNoise(200 * N, STDDEV);
+        const Welch::Averaging averagings[] = { Welch::Averaging::Linear, Welch::Averaging::Exponential, Welch::Averaging::Median };
+
+        for (Welch::Averaging averaging: averagings) {
+            Welch task(NFFT, NFFT / 2, FS, Welch::Window::Hanning, averaging, 0.01, 1000);
+            Channel in;
+            task.setInput(in, 0);
+            feed(task, in, values, N);
+
+            // The one-sided density of white noise is 2 * sigma^2 / fs
+            const std::vector<double> psd = task.getPsd();
+            const double level = std::accumulate(psd.begin() + 1, psd.end() - 1, 0.0) / (psd.size() - 2);
+            expect_eq_double(2.0 * STDDEV * STDDEV / FS, level, 0.05 * 2.0 * STDDEV * STDDEV / FS);
+        }
+    }
+
+    TEST(WelchTest, testSinePower) {
+        static constexpr std::size_t N = 512;
+        static constexpr std::size_t NFFT = 256;
+        static constexpr double FS = 1e3;
+        static constexpr double AMPLITUDE = 3.0;
+
+        // The sine is on the bin 32
+        std::vector<double> values(16 * N);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = AMPLITUDE * std::sin(2.0 * M_PI * 32.0 * i / NFFT);
+        }
+
+        Welch task(NFFT, 0, FS, Welch::Window::Rectangular);
+        Channel in;
+        task.setInput(in, 0);
+        feed(task, in, values, N);
+
+        // The sum of density is the power of sine
+        const std::vector<double> psd = task.getPsd();
+        const double power = std::accumulate(psd.begin(), psd.end(), 0.0) * FS / NFFT;
+        expect_eq_double(AMPLITUDE * AMPLITUDE / 2.0, power, 1e-9);
+        expect_eq_double(AMPLITUDE * AMPLITUDE / 2.0, psd[32] * FS / NFFT, 1e-9);
+    }
+
+    TEST(WelchTest, testExponentialLastSegment) {
+        static constexpr std::size_t NFFT = 64;
+        static constexpr double FS = 1.0;
+
+        // With a weight of 1, only the last segment is kept
+        Welch task(NFFT, 16, FS, Welch::Window::Hanning, Welch::Averaging::Exponential, 1.0);
+        Channel in;
+        task.setInput(in, 0);
+
+        const std::vector<double> values = whiteNoise(4 * NFFT, 1.0);
+        feed(task, in, values, NFFT);
+
+        // Segments start at 0, 48, 96, 144, 192
+        const std::vector<double> expected = periodogram(values.data() + 192, NFFT, FS);
+        const std::vector<double> actual = task.getPsd();
+        for (std::size_t k = 0; k < expected.size(); ++k) {
+            expect_eq_double(expected[k], actual[k], 1e-12);
+        }
+
+        // The reset restarts the averaging
+        task.reset();
+        EXPECT_EQ(static_cast<std::uint64_t>(0), task.getNumberOfSegments());
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,237 @@
+/* DSPS - library to build a digital signal processing simulation
+ * Copyright (C) 2019  Arthur HUGEAT
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <dsps/Channel.h>
+#include <dsps/WrapperFFTW.h>
+
+#include "local/Utils.h"
+
+namespace {
+    std::vector< std::complex<double> > randomSignal(const std::size_t size) {
+        std::mt19937 engine(7);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+        std::vector< std::complex<double> > values(size);
+        for (auto &value: values) {
+            value = std::complex<double>(dist(engine), dist(engine));
+        }
+
+        return values;
+    }
+
+    // Direct computation of the DFT
+    std::vector< std::complex<double> > naiveDFT(const std::vector< std::complex<double> > &values) {
+        const std::size_t N = values.size();
+        std::vector< std::complex<double> > spectrum(N);
+        for (std::size_t k = 0; k < N; ++k) {
+            for (std::size_t n = 0; n < N; ++n) {
+                spectrum[k] += values[n] * std::polar(1.0, -2.0 * M_PI * static_cast<double>(k * n) / static_cast<double>(N));
+            }
+        }
+
+        return spectrum;
+    }
+
+    void expectSameSpectrum(const std::vector< std::complex<double> > &expected, const std::vector< std::complex<double> > &actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            expect_eq_double(expected[i].real(), actual[i].real(), 1e-9);
+            expect_eq_double(expected[i].imag(), actual[i].imag(), 1e-9);
+        }
+    }
+
+    TEST(WrapperFFTWTest, testCompute) {
+        static constexpr std::size_t N = 100;
+
+        const std::vector< std::complex<double> > values = randomSignal(N);
+        std::vector< std::complex<double> > spectrum;
+
+        WrapperFFTW wrapper(FFTDirection::Forward);
+        wrapper.compute(values, spectrum, N);
+        expectSameSpectrum(naiveDFT(values), spectrum);
+
+        // The in-place plan gives the same result
+        std::vector< std::complex<double> > inPlace = values;
+        wrapper.compute(inPlace, inPlace, N);
+        expectSameSpectrum(spectrum, inPlace);
+    }
+
+    TEST(WrapperFFTWTest, testComputeReal) {
+        static constexpr std::size_t N = 100;
+
+        std::vector<double> values(N);
+        std::vector< std::complex<double> > complexValues = randomSignal(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            values[i] = complexValues[i].real();
+            complexValues[i].imag(0.0);
+        }
+        const std::vector< std::complex<double> > expected = naiveDFT(complexValues);
+
+        // The full spectrum is rebuilt by symmetry
+        WrapperFFTW forward(FFTDirection::Forward);
+        std::vector< std::complex<double> > spectrum;
+        forward.compute(values, spectrum, N);
+        expectSameSpectrum(expected, spectrum);
+
+        // Only the non-redundant bins
+        std::vector< std::complex<double> > halfSpectrum;
+        forward.computeR2C(values, halfSpectrum, N);
+        expectSameSpectrum(std::vector< std::complex<double> >(expected.begin(), expected.begin() + N / 2 + 1), halfSpectrum);
+
+        // The inverse gives N times the signal
+        WrapperFFTW backward(FFTDirection::Backward);
+        std::vector<double> inverse;
+        backward.computeC2R(halfSpectrum, inverse, N);
+        ASSERT_EQ(N, inverse.size());
+        for (std::size_t i = 0; i < N; ++i) {
+            expect_eq_double(values[i] * N, inverse[i]);
+        }
+    }
+
+    TEST(WrapperFFTWTest, testComputeFloat) {
+        static constexpr std::size_t N = 128;
+
+        const std::vector< std::complex<double> > values = randomSignal(N);
+        std::vector<float> realValues(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            realValues[i] = static_cast<float>(values[i].real());
+        }
+
+        std::vector< std::complex<float> > floatSpectrum;
+        std::vector< std::complex<double> > doubleSpectrum;
+        std::vector< std::complex<double> > doubleValues(realValues.begin(), realValues.end());
+
+        // Same spectrum with the single precision
+        WrapperFFTWF forward(FFTDirection::Forward);
+        WrapperFFTW reference(FFTDirection::Forward);
+        forward.computeR2C(realValues, floatSpectrum, N);
+        reference.compute(doubleValues, doubleSpectrum, N);
+        ASSERT_EQ(N / 2 + 1, floatSpectrum.size());
+        for (std::size_t i = 0; i < N / 2 + 1; ++i) {
+            expect_eq_double(doubleSpectrum[i].real(), floatSpectrum[i].real(), 1e-4);
+            expect_eq_double(doubleSpectrum[i].imag(), floatSpectrum[i].imag(), 1e-4);
+        }
+
+        // The round trip gives N times the signal
+        WrapperFFTWF backward(FFTDirection::Backward);
+        std::vector<float> inverse;
+        backward.computeC2R(floatSpectrum, inverse, N);
+        for (std::size_t i = 0; i < N; ++i) {
+            expect_eq_double(realValues[i] * N, inverse[i], 1e-3);
+        }
+    }
+
+    TEST(WrapperFFTWTest, testSharedPlans) {
+        static constexpr std::size_t N = 128;
+
+        WrapperFFTW::clearPlanCache();
+        EXPECT_EQ(static_cast<std::size_t>(0), WrapperFFTW::countCachedPlans());
+
+        std::vector< std::complex<double> > values = randomSignal(N);
+        std::vector< std::complex<double> > spectrum1;
+        std::vector< std::complex<double> > spectrum2;
+
+        // Same key, one plan
+        WrapperFFTW wrapper1(FFTDirection::Forward);
+        WrapperFFTW wrapper2(FFTDirection::Forward);
+        wrapper1.compute(values, spectrum1, N);
+        wrapper2.compute(values, spectrum2, N);
+        EXPECT_EQ(static_cast<std::size_t>(1), WrapperFFTW::countCachedPlans());
+        EXPECT_EQ(spectrum1, spectrum2);
+
+        // The direction, the size and the in-place are in the key
+        WrapperFFTW backward(FFTDirection::Backward);
+        backward.compute(spectrum1, spectrum2, N);
+        EXPECT_EQ(static_cast<std::size_t>(2), WrapperFFTW::countCachedPlans());
+        wrapper1.compute(values, spectrum1, N / 2);
+        EXPECT_EQ(static_cast<std::size_t>(3), WrapperFFTW::countCachedPlans());
+        wrapper1.compute(values, values, N);
+        EXPECT_EQ(static_cast<std::size_t>(4), WrapperFFTW::countCachedPlans());
+
+        // The size changes back without a new plan
+        wrapper1.compute(spectrum2, spectrum1, N / 2);
+        EXPECT_EQ(static_cast<std::size_t>(4), WrapperFFTW::countCachedPlans());
+
+        // The precision is in the key
+        std::vector< std::complex<float> > floatValues(values.begin(), values.end());
+        WrapperFFTWF floatWrapper(FFTDirection::Forward);
+        floatWrapper.compute(floatValues, floatValues, N);
+        EXPECT_EQ(static_cast<std::size_t>(5), WrapperFFTW::countCachedPlans());
+
+        // The wrappers keep their plans after the clear
+        WrapperFFTW::clearPlanCache();
+        EXPECT_EQ(static_cast<std::size_t>(0), WrapperFFTW::countCachedPlans());
+        wrapper2.compute(values, spectrum2, N);
+        EXPECT_EQ(static_cast<std::size_t>(0), WrapperFFTW::countCachedPlans());
+    }
+
+    TEST(WrapperFFTWTest, testPlannerEffort) {
+        static constexpr std::size_t N = 256;
+
+        const FFTPlanner planner = WrapperFFTW::getPlannerEffort();
+        const std::vector< std::complex<double> > values = randomSignal(N);
+        std::vector< std::complex<double> > estimated;
+        std::vector< std::complex<double> > measured;
+
+        WrapperFFTW::clearPlanCache();
+        WrapperFFTW::setPlannerEffort(FFTPlanner::Estimate);
+        {
+            WrapperFFTW wrapper(FFTDirection::Forward);
+            wrapper.compute(values, estimated, N);
+        }
+
+        WrapperFFTW::clearPlanCache();
+        WrapperFFTW::setPlannerEffort(FFTPlanner::Measure);
+        EXPECT_EQ(FFTPlanner::Measure, WrapperFFTW::getPlannerEffort());
+        {
+            WrapperFFTW wrapper(FFTDirection::Forward);
+            wrapper.compute(values, measured, N);
+        }
+
+        expectSameSpectrum(estimated, measured);
+        WrapperFFTW::setPlannerEffort(planner);
+    }
+
+    TEST(WrapperFFTWTest, testWisdom) {
+        const std::string path = "WrapperFFTWTest.wisdom";
+
+        EXPECT_TRUE(WrapperFFTW::exportWisdom(path));
+        EXPECT_TRUE(WrapperFFTW::importWisdom(path));
+        std::remove(path.c_str());
+
+        EXPECT_TRUE(WrapperFFTWF::exportWisdom(path));
+        EXPECT_TRUE(WrapperFFTWF::importWisdom(path));
+        std::remove(path.c_str());
+
+        EXPECT_FALSE(WrapperFFTW::importWisdom("/nonexistent/WrapperFFTWTest.wisdom"));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+    ::testing::GTEST_FLAG(throw_on_failure) = true;
+    return RUN_ALL_TESTS();
+}